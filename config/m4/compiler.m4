@@ -153,6 +153,16 @@ CHECK_SPECIFIC_ATTRIBUTE([optimize], [NOOPTIMIZE],
                          [int foo (int arg) __attribute__ ((optimize("O0")));])
 
 
+#
+# Check for compiler attribute which compiles a function for a specific
+# instruction set, used to select copy routines in runtime.
+#
+CHECK_SPECIFIC_ATTRIBUTE([target], [TARGET],
+                         [#include <immintrin.h>
+                          __attribute__ ((target("avx512f"))) void foo(void *d, const void *s)
+                          { _mm512_stream_si512(d, _mm512_loadu_si512(s)); }])
+
+
 #
 # Set C++ optimization/debug flags to be the same as for C
 #
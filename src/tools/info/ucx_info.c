@@ -27,6 +27,8 @@ static void usage() {
     printf("                'a' : atomic operations\n");
     printf("                'r' : remote memory access\n");
     printf("                't' : tag matching \n");
+    printf("                's' : stream\n");
+    printf("                'm' : active messages\n");
     printf("                'w' : wakeup\n");
     printf("  -n         Estimated UCP endpoint count (for ucp_init)\n");
     printf("  -a         Show also hidden configuration\n");
@@ -105,6 +107,12 @@ int main(int argc, char **argv)
                 case 't':
                     ucp_features |= UCP_FEATURE_TAG;
                     break;
+                case 's':
+                    ucp_features |= UCP_FEATURE_STREAM;
+                    break;
+                case 'm':
+                    ucp_features |= UCP_FEATURE_AM;
+                    break;
                 case 'w':
                     ucp_features |= UCP_FEATURE_WAKEUP;
                     break;
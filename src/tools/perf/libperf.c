@@ -693,6 +693,7 @@ static ucs_status_t ucp_perf_test_check_params(ucx_perf_params_t *params,
                                                uint64_t *features)
 {
     ucs_status_t status, message_size;
+    size_t it;
 
     message_size = ucx_perf_get_message_size(params);
     switch (params->command) {
@@ -719,6 +720,12 @@ static ucs_status_t ucp_perf_test_check_params(ucx_perf_params_t *params,
     case UCX_PERF_CMD_TAG:
         *features = UCP_FEATURE_TAG;
         break;
+    case UCX_PERF_CMD_STREAM:
+        *features = UCP_FEATURE_STREAM;
+        break;
+    case UCX_PERF_CMD_AM:
+        *features = UCP_FEATURE_AM;
+        break;
     default:
         if (params->flags & UCX_PERF_TEST_FLAG_VERBOSE) {
             ucs_error("Invalid test command");
@@ -731,6 +738,19 @@ static ucs_status_t ucp_perf_test_check_params(ucx_perf_params_t *params,
         return status;
     }
 
+    /* strided datatype is made of blocks of the same size */
+    if ((UCP_PERF_DATATYPE_STRIDED == params->ucp.send_datatype) ||
+        (UCP_PERF_DATATYPE_STRIDED == params->ucp.recv_datatype)) {
+        for (it = 1; it < params->msg_size_cnt; ++it) {
+            if (params->msg_size_list[it] != params->msg_size_list[0]) {
+                if (params->flags & UCX_PERF_TEST_FLAG_VERBOSE) {
+                    ucs_error("Strided datatype requires equal buffer sizes");
+                }
+                return UCS_ERR_INVALID_PARAM;
+            }
+        }
+    }
+
     return UCS_OK;
 }
 
@@ -36,6 +36,7 @@ typedef enum {
     UCX_PERF_CMD_SWAP,
     UCX_PERF_CMD_CSWAP,
     UCX_PERF_CMD_TAG,
+    UCX_PERF_CMD_STREAM,
     UCX_PERF_CMD_LAST
 } ucx_perf_cmd_t;
 
@@ -51,6 +52,7 @@ typedef enum {
 typedef enum {
     UCP_PERF_DATATYPE_CONTIG,
     UCP_PERF_DATATYPE_IOV,
+    UCP_PERF_DATATYPE_STRIDED,
 } ucp_perf_datatype_t;
 
 
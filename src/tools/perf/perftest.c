@@ -118,6 +118,18 @@ test_type_t tests[] = {
     {"tag_bw", UCX_PERF_API_UCP, UCX_PERF_CMD_TAG, UCX_PERF_TEST_TYPE_STREAM_UNI,
      "UCP tag match bandwidth"},
 
+    {"stream_lat", UCX_PERF_API_UCP, UCX_PERF_CMD_STREAM, UCX_PERF_TEST_TYPE_PINGPONG,
+     "UCP stream latency"},
+
+    {"stream_bw", UCX_PERF_API_UCP, UCX_PERF_CMD_STREAM, UCX_PERF_TEST_TYPE_STREAM_UNI,
+     "UCP stream bandwidth"},
+
+    {"ucp_am_lat", UCX_PERF_API_UCP, UCX_PERF_CMD_AM, UCX_PERF_TEST_TYPE_PINGPONG,
+     "UCP active message latency"},
+
+    {"ucp_am_bw", UCX_PERF_API_UCP, UCX_PERF_CMD_AM, UCX_PERF_TEST_TYPE_STREAM_UNI,
+     "UCP active message bandwidth"},
+
     {"ucp_put_lat", UCX_PERF_API_UCP, UCX_PERF_CMD_PUT, UCX_PERF_TEST_TYPE_PINGPONG,
      "UCP put latency"},
 
@@ -326,6 +338,8 @@ static void usage(struct perftest_context *ctx, const char *program)
     printf("                                 zcopy : Use zero-copy API (cannot used for atomics).\n");
     printf("                                contig : Use continuous datatype in UCP tests.\n");
     printf("                                   iov : Use IOV datatype in UCP tests.\n");
+    printf("                               strided : Use strided datatype in UCP tests, made of\n");
+    printf("                                         equal blocks of the buffer sizes, -i apart.\n");
     printf("\n");
     printf("     -d <device>    Device to use for testing.\n");
     printf("     -x <tl>        Transport to use for testing.\n");
@@ -344,7 +358,8 @@ static void usage(struct perftest_context *ctx, const char *program)
     printf("     -O <count>     Maximal number of uncompleted outstanding sends. (%u)\n",
                                 ctx->params.max_outstanding);
     printf("     -i <count>     Distance between starting address of consecutive "
-                                "IOV entries. The same as UCT uct_iov_t stride.\n");
+                                "IOV entries or strided blocks. The same as UCT "
+                                "uct_iov_t stride.\n");
     printf("     -N             Use numeric formatting - thousands separator.\n");
     printf("     -f             Print only final numbers.\n");
     printf("     -v             Print CSV-formatted output.\n");
@@ -383,15 +398,19 @@ static const char *__basename(const char *path)
 static ucs_status_t parse_ucp_datatype_params(const char *optarg,
                                               ucp_perf_datatype_t *datatype)
 {
-    const char  *iov_type         = "iov";
-    const size_t iov_type_size    = strlen("iov");
-    const char  *contig_type      = "contig";
-    const size_t contig_type_size = strlen("contig");
+    const char  *iov_type          = "iov";
+    const size_t iov_type_size     = strlen("iov");
+    const char  *contig_type       = "contig";
+    const size_t contig_type_size  = strlen("contig");
+    const char  *strided_type      = "strided";
+    const size_t strided_type_size = strlen("strided");
 
     if (0 == strncmp(optarg, iov_type, iov_type_size)) {
         *datatype = UCP_PERF_DATATYPE_IOV;
     } else if (0 == strncmp(optarg, contig_type, contig_type_size)) {
         *datatype = UCP_PERF_DATATYPE_CONTIG;
+    } else if (0 == strncmp(optarg, strided_type, strided_type_size)) {
+        *datatype = UCP_PERF_DATATYPE_STRIDED;
     } else {
         return UCS_ERR_INVALID_PARAM;
     }
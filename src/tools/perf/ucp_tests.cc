@@ -19,14 +19,16 @@ extern "C" {
 template <ucx_perf_cmd_t CMD, ucx_perf_test_type_t TYPE, bool ONESIDED>
 class ucp_perf_test_runner {
 public:
-    static const ucp_tag_t TAG = 0x1337a880u;
+    static const ucp_tag_t TAG   = 0x1337a880u;
+    static const uint16_t  AM_ID = 0;
 
     typedef uint8_t psn_t;
 
     ucp_perf_test_runner(ucx_perf_context_t &perf) :
         m_perf(perf),
         m_outstanding(0),
-        m_max_outstanding(m_perf.params.max_outstanding)
+        m_max_outstanding(m_perf.params.max_outstanding),
+        m_am_rx_count(0)
 
     {
         ucs_assert_always(m_max_outstanding > 0);
@@ -57,15 +59,35 @@ public:
                                               size_t *length, void **buffer_p)
     {
         ucp_datatype_t type = ucp_dt_make_contig(1);
-        if (UCX_PERF_CMD_TAG == CMD) {
+        ucs_status_t status;
+        size_t block_size;
+
+        if ((UCX_PERF_CMD_TAG == CMD) || (UCX_PERF_CMD_STREAM == CMD) ||
+            (UCX_PERF_CMD_AM == CMD)) {
             if (UCP_PERF_DATATYPE_IOV == datatype) {
                 *buffer_p = iov;
                 *length   = m_perf.params.msg_size_cnt;
                 type      = ucp_dt_make_iov();
+            } else if (UCP_PERF_DATATYPE_STRIDED == datatype) {
+                block_size = m_perf.params.msg_size_list[0];
+                status     = ucp_dt_create_strided(ucp_dt_make_contig(block_size),
+                                                   m_perf.params.msg_size_cnt,
+                                                   m_perf.params.iov_stride ?
+                                                   m_perf.params.iov_stride :
+                                                   block_size, &type);
+                ucs_assert_always(status == UCS_OK);
+                *length   = 1;
             }
         }
         return type;
     }
+
+    void ucp_perf_test_release_datatype(ucp_datatype_t datatype)
+    {
+        if ((datatype & UCP_DATATYPE_CLASS_MASK) == UCP_DATATYPE_STRIDED) {
+            ucp_dt_destroy(datatype);
+        }
+    }
     /**
      * Make ucp_dt_iov_t iov[msg_size_cnt] array with pointer elements to
      * original buffer
@@ -80,6 +102,15 @@ public:
         }
     }
 
+    static ucs_status_t am_handler(void *arg, void *data, size_t length,
+                                   ucp_ep_h reply_ep, unsigned flags)
+    {
+        ucp_perf_test_runner *self = (ucp_perf_test_runner*)arg;
+
+        ++self->m_am_rx_count;
+        return UCS_OK;
+    }
+
     void UCS_F_ALWAYS_INLINE progress_responder() {
         if (!ONESIDED) {
             ucp_worker_progress(m_perf.ucp.worker);
@@ -119,6 +150,14 @@ public:
             request = ucp_tag_send_nb(ep, buffer, length, datatype, TAG,
                                       (ucp_send_callback_t)ucs_empty_function);
             return wait(request, true);
+        case UCX_PERF_CMD_STREAM:
+            request = ucp_stream_send_nb(ep, buffer, length, datatype,
+                                         (ucp_send_callback_t)ucs_empty_function);
+            return wait(request, true);
+        case UCX_PERF_CMD_AM:
+            request = ucp_am_send_nb(ep, AM_ID, buffer, length, datatype,
+                                     (ucp_send_callback_t)ucs_empty_function, 0);
+            return wait(request, true);
         case UCX_PERF_CMD_PUT:
             *((uint8_t*)buffer + length - 1) = sn;
             return ucp_put(ep, buffer, length, remote_addr, rkey);
@@ -162,10 +201,11 @@ public:
     }
 
     ucs_status_t UCS_F_ALWAYS_INLINE
-    recv(ucp_worker_h worker, void *buffer, unsigned length, ucp_datatype_t datatype,
-         uint8_t sn)
+    recv(ucp_worker_h worker, ucp_ep_h ep, void *buffer, unsigned length,
+         ucp_datatype_t datatype, uint8_t sn)
     {
         volatile uint8_t *ptr;
+        size_t recv_length;
         void *request;
 
         /* coverity[switch_selector_expr_is_constant] */
@@ -174,6 +214,17 @@ public:
             request = ucp_tag_recv_nb(worker, buffer, length, datatype, TAG, 0,
                                       (ucp_tag_recv_callback_t)ucs_empty_function);
             return wait(request, false);
+        case UCX_PERF_CMD_STREAM:
+            request = ucp_stream_recv_nb(ep, buffer, length, datatype,
+                                         (ucp_stream_recv_callback_t)ucs_empty_function,
+                                         &recv_length, UCP_STREAM_RECV_FLAG_WAITALL);
+            return wait(request, false);
+        case UCX_PERF_CMD_AM:
+            while (m_am_rx_count == 0) {
+                progress_responder();
+            }
+            --m_am_rx_count;
+            return UCS_OK;
         case UCX_PERF_CMD_PUT:
             /* coverity[switch_selector_expr_is_constant] */
             switch (TYPE) {
@@ -250,13 +301,13 @@ public:
         if (my_index == 0) {
             UCX_PERF_TEST_FOREACH(&m_perf) {
                 send(ep, send_buffer, send_length, send_datatype, sn, remote_addr, rkey);
-                recv(worker, recv_buffer, recv_length, recv_datatype, sn);
+                recv(worker, ep, recv_buffer, recv_length, recv_datatype, sn);
                 ucx_perf_update(&m_perf, 1, length);
                 ++sn;
             }
         } else if (my_index == 1) {
             UCX_PERF_TEST_FOREACH(&m_perf) {
-                recv(worker, recv_buffer, recv_length, recv_datatype, sn);
+                recv(worker, ep, recv_buffer, recv_length, recv_datatype, sn);
                 send(ep, send_buffer, send_length, send_datatype, sn, remote_addr, rkey);
                 ucx_perf_update(&m_perf, 1, length);
                 ++sn;
@@ -265,6 +316,8 @@ public:
 
         ucp_worker_flush(m_perf.ucp.worker);
         rte_call(&m_perf, barrier);
+        ucp_perf_test_release_datatype(send_datatype);
+        ucp_perf_test_release_datatype(recv_datatype);
         return UCS_OK;
     }
 
@@ -309,7 +362,7 @@ public:
 
         if (my_index == 0) {
             UCX_PERF_TEST_FOREACH(&m_perf) {
-                recv(worker, recv_buffer, recv_length, recv_datatype, sn);
+                recv(worker, ep, recv_buffer, recv_length, recv_datatype, sn);
                 ucx_perf_update(&m_perf, 1, length);
                 ++sn;
             }
@@ -323,10 +376,12 @@ public:
 
         ucp_worker_flush(m_perf.ucp.worker);
         rte_call(&m_perf, barrier);
+        ucp_perf_test_release_datatype(send_datatype);
+        ucp_perf_test_release_datatype(recv_datatype);
         return UCS_OK;
     }
 
-    ucs_status_t run()
+    ucs_status_t run_test()
     {
         /* coverity[switch_selector_expr_is_constant] */
         switch (TYPE) {
@@ -340,10 +395,32 @@ public:
         }
     }
 
+    ucs_status_t run()
+    {
+        ucs_status_t status;
+
+        if (UCX_PERF_CMD_AM != CMD) {
+            return run_test();
+        }
+
+        /* The handler is set before the test starts with a barrier, so it is
+         * ready when the first message arrives */
+        status = ucp_worker_set_am_handler(m_perf.ucp.worker, AM_ID, am_handler,
+                                           this);
+        if (status != UCS_OK) {
+            return status;
+        }
+
+        status = run_test();
+        ucp_worker_set_am_handler(m_perf.ucp.worker, AM_ID, NULL, NULL);
+        return status;
+    }
+
 private:
     ucx_perf_context_t &m_perf;
     unsigned           m_outstanding;
     const unsigned     m_max_outstanding;
+    unsigned           m_am_rx_count;
 };
 
 
@@ -365,6 +442,10 @@ ucs_status_t ucp_perf_test_dispatch(ucx_perf_context_t *perf)
     UCS_PP_FOREACH(TEST_CASE_ALL_OSD, perf,
         (UCX_PERF_CMD_TAG,   UCX_PERF_TEST_TYPE_PINGPONG),
         (UCX_PERF_CMD_TAG,   UCX_PERF_TEST_TYPE_STREAM_UNI),
+        (UCX_PERF_CMD_STREAM, UCX_PERF_TEST_TYPE_PINGPONG),
+        (UCX_PERF_CMD_STREAM, UCX_PERF_TEST_TYPE_STREAM_UNI),
+        (UCX_PERF_CMD_AM,    UCX_PERF_TEST_TYPE_PINGPONG),
+        (UCX_PERF_CMD_AM,    UCX_PERF_TEST_TYPE_STREAM_UNI),
         (UCX_PERF_CMD_PUT,   UCX_PERF_TEST_TYPE_PINGPONG),
         (UCX_PERF_CMD_PUT,   UCX_PERF_TEST_TYPE_STREAM_UNI),
         (UCX_PERF_CMD_GET,   UCX_PERF_TEST_TYPE_STREAM_UNI),
@@ -6,6 +6,7 @@
 
 #include <ucs/debug/profile.h>
 #include <ucs/datastruct/khash.h>
+#include <ucs/sys/math.h>
 
 #include <sys/signal.h>
 #include <sys/fcntl.h>
@@ -13,6 +14,7 @@
 #include <sys/mman.h>
 #include <sys/stat.h>
 #include <stdlib.h>
+#include <inttypes.h>
 #include <getopt.h>
 #include <unistd.h>
 #include <string.h>
@@ -44,20 +46,34 @@ typedef enum {
 
 typedef struct options {
     const char                   *filename;
+    const char                   *trace_filename;
     int                          raw;
     time_units_t                 time_units;
 } options_t;
 
 
+typedef struct {
+    const ucs_profile_thread_header_t   *header;
+    const ucs_profile_thread_location_t *locations;
+    const ucs_profile_record_t          *records;
+} profile_thread_data_t;
+
+
 typedef struct {
     void                         *mem;
     size_t                       length;
     const ucs_profile_header_t   *header;
     const ucs_profile_location_t *locations;
-    const ucs_profile_record_t   *records;
+    profile_thread_data_t        *threads;
 } profile_data_t;
 
 
+typedef struct {
+    const ucs_profile_location_t        *super;
+    const ucs_profile_thread_location_t *thread;
+} profile_sorted_location_t;
+
+
 /* Used to redirect output to a "less" command */
 static int output_pipefds[2] = {-1, -1};
 
@@ -73,7 +89,10 @@ static const char* time_units_str[] = {
 
 static int read_profile_data(const char *file_name, profile_data_t *data)
 {
+    profile_thread_data_t *thread;
     struct stat stat;
+    const void *ptr;
+    unsigned i;
     int ret, fd;
 
     fd = open(file_name, O_RDONLY);
@@ -100,10 +119,36 @@ static int read_profile_data(const char *file_name, profile_data_t *data)
 
     data->header    = data->mem;
     data->locations = (const void*)(data->header + 1);
-    data->records   = (const void*)(data->locations + data->header->num_locations);
+    data->threads   = calloc(data->header->num_threads, sizeof(*data->threads));
+    if (data->threads == NULL) {
+        fprintf(stderr, "Failed to allocate threads array\n");
+        ret = -1;
+        goto out_unmap;
+    }
+
+    ptr = (const void*)(data->locations + data->header->num_locations);
+    for (i = 0; i < data->header->num_threads; ++i) {
+        thread            = &data->threads[i];
+        thread->header    = ptr;
+        thread->locations = (const void*)(thread->header + 1);
+        thread->records   = (const void*)(thread->locations +
+                                          data->header->num_locations);
+        ptr               = (const void*)(thread->records +
+                                          thread->header->num_records);
+        if (ptr > data->mem + data->length) {
+            fprintf(stderr, "%s: thread %u data is truncated\n", file_name, i);
+            ret = -1;
+            goto out_free_threads;
+        }
+    }
 
     ret = 0;
+    goto out_close;
 
+out_free_threads:
+    free(data->threads);
+out_unmap:
+    munmap(data->mem, data->length);
 out_close:
     close(fd);
 out:
@@ -112,6 +157,7 @@ out:
 
 static void release_profile_data(profile_data_t *data)
 {
+    free(data->threads);
     munmap(data->mem, data->length);
 }
 
@@ -129,18 +175,22 @@ static double time_to_usec(profile_data_t *data, options_t *opts, uint64_t time)
 
 static int compare_locations(const void *l1, const void *l2)
 {
-    const ucs_profile_location_t *loc1 = l1;
-    const ucs_profile_location_t *loc2 = l2;
-    return (loc1->total_time > loc2->total_time) ? -1 :
-           (loc1->total_time < loc2->total_time) ? +1 :
+    const profile_sorted_location_t *loc1 = l1;
+    const profile_sorted_location_t *loc2 = l2;
+    return (loc1->thread->total_time > loc2->thread->total_time) ? -1 :
+           (loc1->thread->total_time < loc2->thread->total_time) ? +1 :
            0;
 }
 
-static void show_profile_data_accum(profile_data_t *data, options_t *opts)
+static void show_profile_data_accum(profile_data_t *data,
+                                    profile_thread_data_t *thread,
+                                    options_t *opts)
 {
     uint32_t num_locations = data->header->num_locations;
-    ucs_profile_location_t *sorted_locations;
-    ucs_profile_location_t *loc;
+    profile_sorted_location_t *sorted_locations;
+    const ucs_profile_thread_location_t *thread_loc;
+    const ucs_profile_location_t *loc;
+    unsigned i;
 
     sorted_locations = malloc(sizeof(*sorted_locations) * num_locations);
     if (sorted_locations == NULL) {
@@ -148,28 +198,37 @@ static void show_profile_data_accum(profile_data_t *data, options_t *opts)
     }
 
     /* Sort locations */
-    memcpy(sorted_locations, data->locations, sizeof(*sorted_locations) * num_locations);
+    for (i = 0; i < num_locations; ++i) {
+        sorted_locations[i].super  = &data->locations[i];
+        sorted_locations[i].thread = &thread->locations[i];
+    }
     qsort(sorted_locations, num_locations, sizeof(*sorted_locations), compare_locations);
 
     /* Print locations */
     printf("%30s %13s %13s %10s                FILE     FUNCTION\n",
            "NAME", "AVG", "TOTAL", "COUNT");
-    for (loc = sorted_locations; loc < sorted_locations + num_locations; ++loc) {
+    for (i = 0; i < num_locations; ++i) {
+        loc        = sorted_locations[i].super;
+        thread_loc = sorted_locations[i].thread;
+        if (thread_loc->count == 0) {
+            continue;
+        }
+
         switch (loc->type) {
         case UCS_PROFILE_TYPE_SAMPLE:
             printf("%30s %13s %13s %10ld %18s:%-4d %s()\n",
                    loc->name,
                    "-",
                    "-",
-                   (long)loc->count,
+                   (long)thread_loc->count,
                    loc->file, loc->line, loc->function);
             break;
         case UCS_PROFILE_TYPE_SCOPE_END:
             printf("%30s %13.3f %13.0f %10ld %18s:%-4d %s()\n",
                    loc->name,
-                   time_to_usec(data, opts, loc->total_time) / loc->count,
-                   time_to_usec(data, opts, loc->total_time),
-                   (long)loc->count,
+                   time_to_usec(data, opts, thread_loc->total_time) / thread_loc->count,
+                   time_to_usec(data, opts, thread_loc->total_time),
+                   (long)thread_loc->count,
                    loc->file, loc->line, loc->function);
             break;
         case UCS_PROFILE_TYPE_REQUEST_EVENT:
@@ -177,7 +236,7 @@ static void show_profile_data_accum(profile_data_t *data, options_t *opts)
                    loc->name,
                    "n/a",
                    "n/a",
-                   (long)loc->count,
+                   (long)thread_loc->count,
                    loc->file, loc->line, loc->function);
             break;
         default:
@@ -190,9 +249,11 @@ static void show_profile_data_accum(profile_data_t *data, options_t *opts)
 
 KHASH_MAP_INIT_INT64(request_ids, int)
 
-static void show_profile_data_log(profile_data_t *data, options_t *opts)
+static void show_profile_data_log(profile_data_t *data,
+                                  profile_thread_data_t *thread,
+                                  options_t *opts)
 {
-    size_t num_recods               = data->header->num_records;
+    size_t num_recods               = thread->header->num_records;
     const ucs_profile_record_t **stack[UCS_PROFILE_STACK_MAX * 2];
     const ucs_profile_record_t **scope_ends;
     const ucs_profile_location_t *loc;
@@ -234,11 +295,11 @@ static void show_profile_data_log(profile_data_t *data, options_t *opts)
     /* Find the first record with minimal nesting level, which is the base of call stack */
     nesting         = 0;
     min_nesting     = 0;
-    for (rec = data->records; rec < data->records + num_recods; ++rec) {
+    for (rec = thread->records; rec < thread->records + num_recods; ++rec) {
         loc = &data->locations[rec->location];
         switch (loc->type) {
         case UCS_PROFILE_TYPE_SCOPE_BEGIN:
-            stack[nesting + UCS_PROFILE_STACK_MAX] = &scope_ends[rec - data->records];
+            stack[nesting + UCS_PROFILE_STACK_MAX] = &scope_ends[rec - thread->records];
             ++nesting;
             break;
         case UCS_PROFILE_TYPE_SCOPE_END:
@@ -257,7 +318,7 @@ static void show_profile_data_log(profile_data_t *data, options_t *opts)
     }
 
     if (num_recods > 0) {
-        prev_time = data->records[0].timestamp;
+        prev_time = thread->records[0].timestamp;
     } else {
         prev_time = 0;
     }
@@ -266,11 +327,11 @@ static void show_profile_data_log(profile_data_t *data, options_t *opts)
 
     /* Display records */
     nesting = -min_nesting;
-    for (rec = data->records; rec < data->records + num_recods; ++rec) {
+    for (rec = thread->records; rec < thread->records + num_recods; ++rec) {
         loc = &data->locations[rec->location];
         switch (loc->type) {
         case UCS_PROFILE_TYPE_SCOPE_BEGIN:
-            se = scope_ends[rec - data->records];
+            se = scope_ends[rec - thread->records];
             if (se != NULL) {
                 snprintf(buf, sizeof(buf), RECORD_FMT"  %s%s%s %s%.3f%s {",
                          RECORD_ARG(rec->timestamp - prev_time),
@@ -352,13 +413,15 @@ static void close_pipes()
     close(output_pipefds[1]);
 }
 
-static int redirect_output(const ucs_profile_header_t *hdr)
+static int redirect_output(profile_data_t *data)
 {
+    const ucs_profile_header_t *hdr = data->header;
     char *less_argv[] = {LESS_COMMAND,
                          "-R" /* show colors */,
                          NULL};;
     struct winsize wsz;
     uint64_t num_lines;
+    unsigned i;
     pid_t pid;
     int ret;
 
@@ -369,11 +432,14 @@ static int redirect_output(const ucs_profile_header_t *hdr)
     }
 
     num_lines = 6 + /* header */
-                ((hdr->mode & UCS_BIT(UCS_PROFILE_MODE_ACCUM)) ?
-                                (hdr->num_locations + 2) : 0) +
-                ((hdr->mode & UCS_BIT(UCS_PROFILE_MODE_LOG)) ?
-                                (hdr->num_records    + 1) : 0) +
-                1; /* footer */
+                1;  /* footer */
+    for (i = 0; i < hdr->num_threads; ++i) {
+        num_lines += 2 + /* thread header */
+                     ((hdr->mode & UCS_BIT(UCS_PROFILE_MODE_ACCUM)) ?
+                                     (hdr->num_locations + 2) : 0) +
+                     ((hdr->mode & UCS_BIT(UCS_PROFILE_MODE_LOG)) ?
+                                     (data->threads[i].header->num_records + 1) : 0);
+    }
 
     if (num_lines <= wsz.ws_row) {
         return 0; /* no need to use 'less' */
@@ -429,12 +495,24 @@ static void show_header(profile_data_t *data, options_t *opts)
     printf("\n");
 }
 
+static void show_thread_header(profile_data_t *data,
+                               profile_thread_data_t *thread, options_t *opts)
+{
+    printf("%sthread %d%s, %.3f %s\n\n",
+           opts->raw ? "" : TERM_COLOR_GREEN, thread->header->tid,
+           opts->raw ? "" : TERM_COLOR_CLEAR,
+           time_to_usec(data, opts, thread->header->end_time -
+                                    thread->header->start_time),
+           time_units_str[opts->time_units]);
+}
+
 static int show_profile_data(profile_data_t *data, options_t *opts)
 {
+    profile_thread_data_t *thread;
     int ret;
 
     if (!opts->raw) {
-        ret = redirect_output(data->header);
+        ret = redirect_output(data);
         if (ret < 0) {
             return ret;
         }
@@ -442,16 +520,152 @@ static int show_profile_data(profile_data_t *data, options_t *opts)
 
     show_header(data, opts);
 
-    if (data->header->mode & UCS_BIT(UCS_PROFILE_MODE_ACCUM)) {
-        show_profile_data_accum(data, opts);
-        printf("\n");
+    for (thread = data->threads;
+         thread < data->threads + data->header->num_threads; ++thread) {
+        show_thread_header(data, thread, opts);
+
+        if (data->header->mode & UCS_BIT(UCS_PROFILE_MODE_ACCUM)) {
+            show_profile_data_accum(data, thread, opts);
+            printf("\n");
+        }
+
+        if (data->header->mode & UCS_BIT(UCS_PROFILE_MODE_LOG)) {
+            show_profile_data_log(data, thread, opts);
+            printf("\n");
+        }
     }
 
-    if (data->header->mode & UCS_BIT(UCS_PROFILE_MODE_LOG)) {
-        show_profile_data_log(data, opts);
-        printf("\n");
+    return 0;
+}
+
+static void write_json_string(FILE *stream, const char *str)
+{
+    fputc('"', stream);
+    for (; *str != '\0'; ++str) {
+        if ((*str == '"') || (*str == '\\')) {
+            fputc('\\', stream);
+        }
+        fputc(*str, stream);
+    }
+    fputc('"', stream);
+}
+
+/* Write the common fields of a trace event, and leave the event object open
+ * for additional fields */
+static void write_trace_event(FILE *stream, profile_data_t *data,
+                              profile_thread_data_t *thread,
+                              const ucs_profile_location_t *loc,
+                              const char *phase, const char *name,
+                              uint64_t base_time, uint64_t timestamp,
+                              int *first)
+{
+    fprintf(stream, "%s\n{\"ph\":\"%s\",\"pid\":%u,\"tid\":%u,"
+            "\"ts\":%.3f,\"name\":", *first ? "" : ",", phase,
+            data->header->pid, thread->header->tid,
+            (timestamp - base_time) * 1e6 / data->header->one_second);
+    write_json_string(stream, name);
+    fprintf(stream, ",\"args\":{\"location\":\"%s:%d\",\"function\":",
+            loc->file, loc->line);
+    write_json_string(stream, loc->function);
+    fprintf(stream, "}");
+    *first = 0;
+}
+
+/*
+ * Write the log records in Chrome trace-event format, which can be loaded by
+ * chrome://tracing or Perfetto UI. Scopes become complete ("X") events, and
+ * each request becomes an async slice identified by its address.
+ */
+static int write_chrome_trace(profile_data_t *data, options_t *opts)
+{
+    const ucs_profile_record_t *stack[UCS_PROFILE_STACK_MAX];
+    const ucs_profile_record_t *rec, *begin;
+    const ucs_profile_location_t *loc;
+    profile_thread_data_t *thread;
+    uint64_t base_time;
+    int nesting, first;
+    FILE *stream;
+
+    stream = fopen(opts->trace_filename, "w");
+    if (stream == NULL) {
+        fprintf(stderr, "Failed to open %s: %m\n", opts->trace_filename);
+        return -1;
+    }
+
+    /* Use the earliest thread start time as time 0 */
+    base_time = UINT64_MAX;
+    for (thread = data->threads;
+         thread < data->threads + data->header->num_threads; ++thread) {
+        base_time = ucs_min(base_time, thread->header->start_time);
+        if (thread->header->num_records > 0) {
+            base_time = ucs_min(base_time, thread->records[0].timestamp);
+        }
+    }
+
+    fprintf(stream, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[");
+    first = 1;
+    for (thread = data->threads;
+         thread < data->threads + data->header->num_threads; ++thread) {
+        fprintf(stream, "%s\n{\"ph\":\"M\",\"pid\":%u,\"tid\":%u,"
+                "\"name\":\"thread_name\",\"args\":{\"name\":\"thread %u\"}}",
+                first ? "" : ",", data->header->pid, thread->header->tid,
+                thread->header->tid);
+        first = 0;
+
+        /* Scope ends without a beginning, e.g due to log wraparound, are
+         * skipped */
+        nesting = 0;
+        for (rec = thread->records;
+             rec < thread->records + thread->header->num_records; ++rec) {
+            loc = &data->locations[rec->location];
+            switch (loc->type) {
+            case UCS_PROFILE_TYPE_SCOPE_BEGIN:
+                if (nesting < UCS_PROFILE_STACK_MAX) {
+                    stack[nesting] = rec;
+                }
+                ++nesting;
+                break;
+            case UCS_PROFILE_TYPE_SCOPE_END:
+                if (nesting == 0) {
+                    break;
+                }
+                --nesting;
+                if (nesting >= UCS_PROFILE_STACK_MAX) {
+                    break;
+                }
+                begin = stack[nesting];
+                write_trace_event(stream, data, thread, loc, "X", loc->name,
+                                  base_time, begin->timestamp, &first);
+                fprintf(stream, ",\"dur\":%.3f}",
+                        (rec->timestamp - begin->timestamp) * 1e6 /
+                        data->header->one_second);
+                break;
+            case UCS_PROFILE_TYPE_SAMPLE:
+                write_trace_event(stream, data, thread, loc, "i", loc->name,
+                                  base_time, rec->timestamp, &first);
+                fprintf(stream, ",\"s\":\"t\"}");
+                break;
+            case UCS_PROFILE_TYPE_REQUEST_NEW:
+            case UCS_PROFILE_TYPE_REQUEST_EVENT:
+            case UCS_PROFILE_TYPE_REQUEST_FREE:
+                write_trace_event(stream, data, thread, loc,
+                                  (loc->type == UCS_PROFILE_TYPE_REQUEST_NEW)   ? "b" :
+                                  (loc->type == UCS_PROFILE_TYPE_REQUEST_EVENT) ? "n" :
+                                                                                  "e",
+                                  (loc->type == UCS_PROFILE_TYPE_REQUEST_EVENT) ?
+                                  loc->name : "request",
+                                  base_time, rec->timestamp, &first);
+                fprintf(stream, ",\"cat\":\"request\",\"id\":\"0x%"PRIx64"\"}",
+                        rec->param64);
+                break;
+            default:
+                break;
+            }
+        }
     }
 
+    fprintf(stream, "\n]}\n");
+    fclose(stream);
     return 0;
 }
 
@@ -459,14 +673,18 @@ int parse_args(int argc, char **argv, options_t *opts)
 {
     int c;
 
-    opts->raw         = !isatty(fileno(stdout));
-    opts->time_units  = TIME_UNITS_USEC;
+    opts->raw            = !isatty(fileno(stdout));
+    opts->time_units     = TIME_UNITS_USEC;
+    opts->trace_filename = NULL;
 
-    while ( (c = getopt(argc, argv, "hrt:")) != -1 ) {
+    while ( (c = getopt(argc, argv, "hrt:c:")) != -1 ) {
         switch (c) {
         case 'r':
             opts->raw = 1;
             break;
+        case 'c':
+            opts->trace_filename = optarg;
+            break;
         case 't':
             if (!strcasecmp(optarg, "sec")) {
                 opts->time_units = TIME_UNITS_SEC;
@@ -505,6 +723,7 @@ int main(int argc, char **argv)
         printf("Options:\n");
         printf("      -r             raw output\n");
         printf("      -t UNITS       select time units (sec/msec/usec/nsec)\n");
+        printf("      -c FILE        also write the log in Chrome trace-event JSON format\n");
         printf("\n");
         return -1;
     }
@@ -513,7 +732,15 @@ int main(int argc, char **argv)
         return -1;
     }
 
+    if (opts.trace_filename != NULL) {
+        ret = write_chrome_trace(&data, &opts);
+        if (ret < 0) {
+            goto out;
+        }
+    }
+
     ret = show_profile_data(&data, &opts);
+out:
     release_profile_data(&data);
     return ret;
 }
@@ -0,0 +1,83 @@
+/**
+ * Copyright (C) Mellanox Technologies Ltd. 2001-2017.  ALL RIGHTS RESERVED.
+ *
+ * See file LICENSE for terms.
+ */
+
+#ifndef UCP_AM_H_
+#define UCP_AM_H_
+
+#include <ucp/core/ucp_request.h>
+#include <ucp/core/ucp_worker.h>
+#include <ucs/sys/compiler.h>
+
+
+/*
+ * AM_SINGLE
+ * All the headers which precede the user data end with this one, so the
+ * receive descriptor can be found from the data pointer.
+ */
+typedef struct {
+    uint16_t                  am_id;       /* User active message id */
+    uint16_t                  flags;       /* ucp_am_send_flags */
+    uint32_t                  padding;
+} UCS_S_PACKED ucp_am_hdr_t;
+
+
+/*
+ * AM_SINGLE_REPLY
+ */
+typedef struct {
+    uint64_t                  sender_uuid; /* Identifies the reply endpoint */
+    ucp_am_hdr_t              super;
+} UCS_S_PACKED ucp_am_reply_hdr_t;
+
+
+/*
+ * AM_MIDDLE
+ */
+typedef struct {
+    uint64_t                  sender_uuid;
+    uint64_t                  msg_id;
+} UCS_S_PACKED ucp_am_middle_hdr_t;
+
+
+/*
+ * AM_FIRST
+ */
+typedef struct {
+    ucp_am_middle_hdr_t       frag;
+    uint64_t                  total_len;   /* Length of the whole message */
+    ucp_am_hdr_t              super;
+} UCS_S_PACKED ucp_am_first_hdr_t;
+
+
+/**
+ * Multi-fragment message being reassembled. The data follows the header,
+ * which follows the receive descriptor, as for a single-fragment message.
+ */
+typedef struct ucp_am_frag {
+    ucp_am_frag_key_t         key;         /* Key in worker fragments hash */
+    size_t                    recv_len;    /* Length of data received so far */
+    uint16_t                  flags;       /* Send flags of the message */
+    ucp_recv_desc_t           rdesc;
+    ucp_am_hdr_t              hdr;
+} ucp_am_frag_t;
+
+
+/*
+ * Size of the header which precedes the data of a single-fragment message, or
+ * of a reassembled one.
+ */
+static UCS_F_ALWAYS_INLINE size_t ucp_am_single_hdr_size(uint16_t flags)
+{
+    return (flags & UCP_AM_SEND_REPLY) ? sizeof(ucp_am_reply_hdr_t) :
+                                         sizeof(ucp_am_hdr_t);
+}
+
+
+void ucp_am_worker_init(ucp_worker_h worker);
+
+void ucp_am_worker_cleanup(ucp_worker_h worker);
+
+#endif
@@ -0,0 +1,263 @@
+/**
+ * Copyright (C) Mellanox Technologies Ltd. 2001-2017.  ALL RIGHTS RESERVED.
+ *
+ * See file LICENSE for terms.
+ */
+
+#include "am.h"
+
+#include <ucp/core/ucp_context.h>
+#include <inttypes.h>
+#include <string.h>
+
+
+static UCS_F_ALWAYS_INLINE ucs_status_t
+ucp_am_invoke_handler(ucp_worker_h worker, uint16_t am_id, uint16_t send_flags,
+                      uint64_t sender_uuid, void *data, size_t length,
+                      unsigned cb_flags)
+{
+    ucp_worker_am_handler_t *handler;
+    ucp_ep_h reply_ep;
+
+    if (ucs_unlikely((am_id >= worker->am.num_handlers) ||
+                     (worker->am.handlers[am_id].cb == NULL))) {
+        ucs_warn("worker %p: no handler for active message id %u, dropping "
+                 "%zu bytes", worker, am_id, length);
+        return UCS_OK;
+    }
+
+    handler = &worker->am.handlers[am_id];
+    if (send_flags & UCP_AM_SEND_REPLY) {
+        reply_ep = ucp_worker_get_reply_ep(worker, sender_uuid);
+    } else {
+        reply_ep = NULL;
+    }
+
+    return handler->cb(handler->arg, data, length, reply_ep, cb_flags);
+}
+
+/*
+ * Pass a single-fragment message to the user handler, and keep the transport
+ * descriptor if the handler asks for it.
+ */
+static UCS_F_ALWAYS_INLINE ucs_status_t
+ucp_am_handler_common(ucp_worker_h worker, void *am_data, size_t am_length,
+                      unsigned am_flags, size_t hdr_len, uint64_t sender_uuid)
+{
+    ucp_am_hdr_t *hdr = (ucp_am_hdr_t*)((char*)am_data + hdr_len) - 1;
+    ucp_recv_desc_t *rdesc;
+    ucs_status_t status;
+
+    ucs_assert(am_length >= hdr_len);
+    status = ucp_am_invoke_handler(worker, hdr->am_id, hdr->flags, sender_uuid,
+                                   hdr + 1, am_length - hdr_len,
+                                   (am_flags & UCT_CB_FLAG_DESC) ?
+                                   UCP_CB_PARAM_FLAG_DATA : 0);
+    if (status != UCS_INPROGRESS) {
+        return UCS_OK;
+    }
+
+    if (ucs_unlikely(!(am_flags & UCT_CB_FLAG_DESC))) {
+        ucs_error("active message handler for id %u cannot keep the data "
+                  "without UCP_CB_PARAM_FLAG_DATA", hdr->am_id);
+        return UCS_OK;
+    }
+
+    rdesc          = (ucp_recv_desc_t*)am_data - 1;
+    rdesc->flags   = UCP_RECV_DESC_FLAG_UCT_DESC;
+    rdesc->length  = am_length;
+    rdesc->hdr_len = hdr_len;
+    return UCS_INPROGRESS;
+}
+
+static ucs_status_t ucp_am_single_handler(void *am_arg, void *am_data,
+                                          size_t am_length, unsigned am_flags)
+{
+    return ucp_am_handler_common(am_arg, am_data, am_length, am_flags,
+                                 sizeof(ucp_am_hdr_t), 0);
+}
+
+static ucs_status_t ucp_am_single_reply_handler(void *am_arg, void *am_data,
+                                                size_t am_length,
+                                                unsigned am_flags)
+{
+    ucp_am_reply_hdr_t *hdr = am_data;
+
+    return ucp_am_handler_common(am_arg, am_data, am_length, am_flags,
+                                 sizeof(*hdr), hdr->sender_uuid);
+}
+
+static ucs_status_t ucp_am_first_handler(void *am_arg, void *am_data,
+                                         size_t am_length, unsigned am_flags)
+{
+    ucp_worker_h worker     = am_arg;
+    ucp_am_first_hdr_t *hdr = am_data;
+    size_t length           = am_length - sizeof(*hdr);
+    ucp_am_frag_t *frag;
+    khiter_t iter;
+    int ret;
+
+    ucs_assert(hdr->total_len > length);
+
+    /* The data is placed after a copy of the message header, with the reply
+     * flag cleared, so it is released the same way as single-fragment data */
+    frag = ucs_malloc(sizeof(*frag) + hdr->total_len, "ucp_am_frag");
+    if (frag == NULL) {
+        ucs_error("failed to allocate %zu bytes for active message id %u",
+                  (size_t)hdr->total_len, hdr->super.am_id);
+        return UCS_OK;
+    }
+
+    frag->key.sender_uuid = hdr->frag.sender_uuid;
+    frag->key.msg_id      = hdr->frag.msg_id;
+    frag->recv_len        = length;
+    frag->flags           = hdr->super.flags;
+    frag->rdesc.flags     = 0;
+    frag->rdesc.length    = hdr->total_len;
+    frag->rdesc.hdr_len   = sizeof(frag->hdr);
+    frag->hdr             = hdr->super;
+    frag->hdr.flags       = 0;
+    memcpy(&frag->hdr + 1, hdr + 1, length);
+
+    iter = kh_put(ucp_am_frag_hash, &worker->am.frag_hash, frag->key, &ret);
+    if (iter == kh_end(&worker->am.frag_hash)) {
+        ucs_error("failed to add active message id %u to fragments hash",
+                  hdr->super.am_id);
+        ucs_free(frag);
+        return UCS_OK;
+    }
+
+    ucs_assertv(ret != 0, "duplicate message %"PRIu64" from %"PRIx64,
+                frag->key.msg_id, frag->key.sender_uuid);
+    kh_value(&worker->am.frag_hash, iter) = frag;
+    return UCS_OK;
+}
+
+static ucs_status_t ucp_am_middle_handler(void *am_arg, void *am_data,
+                                          size_t am_length, unsigned am_flags)
+{
+    ucp_worker_h worker      = am_arg;
+    ucp_am_middle_hdr_t *hdr = am_data;
+    size_t length            = am_length - sizeof(*hdr);
+    ucp_am_frag_key_t key;
+    ucp_am_frag_t *frag;
+    ucs_status_t status;
+    khiter_t iter;
+
+    key.sender_uuid = hdr->sender_uuid;
+    key.msg_id      = hdr->msg_id;
+    iter            = kh_get(ucp_am_frag_hash, &worker->am.frag_hash, key);
+    if (iter == kh_end(&worker->am.frag_hash)) {
+        /* The first fragment was dropped */
+        ucs_debug("worker %p: dropping fragment of message %"PRIu64" from "
+                  "%"PRIx64, worker, hdr->msg_id, hdr->sender_uuid);
+        return UCS_OK;
+    }
+
+    frag = kh_value(&worker->am.frag_hash, iter);
+    ucs_assert(frag->recv_len + length <= frag->rdesc.length);
+    memcpy((char*)(&frag->hdr + 1) + frag->recv_len, hdr + 1, length);
+    frag->recv_len += length;
+    if (frag->recv_len < frag->rdesc.length) {
+        return UCS_OK;
+    }
+
+    kh_del(ucp_am_frag_hash, &worker->am.frag_hash, iter);
+    status = ucp_am_invoke_handler(worker, frag->hdr.am_id, frag->flags,
+                                   frag->key.sender_uuid, &frag->hdr + 1,
+                                   frag->rdesc.length, UCP_CB_PARAM_FLAG_DATA);
+    if (status != UCS_INPROGRESS) {
+        ucs_free(frag);
+    }
+    return UCS_OK;
+}
+
+void ucp_am_data_release(ucp_worker_h worker, void *data)
+{
+    ucp_am_hdr_t *hdr = (ucp_am_hdr_t*)data - 1;
+    ucp_recv_desc_t *rdesc;
+
+    /* Reassembled data is found the same way as single-fragment data, so the
+     * header must follow the receive descriptor with no padding */
+    UCS_STATIC_ASSERT(ucs_offsetof(ucp_am_frag_t, hdr) ==
+                      ucs_offsetof(ucp_am_frag_t, rdesc) +
+                      sizeof(ucp_recv_desc_t));
+
+    rdesc = (ucp_recv_desc_t*)((char*)data - ucp_am_single_hdr_size(hdr->flags)) - 1;
+
+    UCP_THREAD_CS_ENTER_CONDITIONAL(&worker->mt_lock);
+    if (rdesc->flags & UCP_RECV_DESC_FLAG_UCT_DESC) {
+        uct_iface_release_desc(rdesc);
+    } else {
+        ucs_free(ucs_container_of(rdesc, ucp_am_frag_t, rdesc));
+    }
+    UCP_THREAD_CS_EXIT_CONDITIONAL(&worker->mt_lock);
+}
+
+void ucp_am_worker_init(ucp_worker_h worker)
+{
+    worker->am.handlers     = NULL;
+    worker->am.num_handlers = 0;
+    kh_init_inplace(ucp_am_frag_hash, &worker->am.frag_hash);
+}
+
+void ucp_am_worker_cleanup(ucp_worker_h worker)
+{
+    ucp_am_frag_t *frag;
+
+    kh_foreach_value(&worker->am.frag_hash, frag, ucs_free(frag));
+    kh_destroy_inplace(ucp_am_frag_hash, &worker->am.frag_hash);
+
+    ucs_free(worker->am.handlers);
+}
+
+static void ucp_am_dump(ucp_worker_h worker, uct_am_trace_type_t type,
+                        uint8_t id, const void *data, size_t length,
+                        char *buffer, size_t max)
+{
+    const ucp_am_reply_hdr_t *reply_hdr = data;
+    const ucp_am_middle_hdr_t *mid_hdr  = data;
+    const ucp_am_first_hdr_t *first_hdr = data;
+    const ucp_am_hdr_t *hdr             = data;
+    size_t header_len;
+    char *p;
+
+    switch (id) {
+    case UCP_AM_ID_AM_SINGLE:
+        snprintf(buffer, max, "AM id %u", hdr->am_id);
+        header_len = sizeof(*hdr);
+        break;
+    case UCP_AM_ID_AM_SINGLE_REPLY:
+        snprintf(buffer, max, "AM id %u uuid %"PRIx64, reply_hdr->super.am_id,
+                 reply_hdr->sender_uuid);
+        header_len = sizeof(*reply_hdr);
+        break;
+    case UCP_AM_ID_AM_FIRST:
+        snprintf(buffer, max, "AM_F id %u uuid %"PRIx64" msg_id %"PRIu64
+                 " len %"PRIu64, first_hdr->super.am_id,
+                 first_hdr->frag.sender_uuid, first_hdr->frag.msg_id,
+                 first_hdr->total_len);
+        header_len = sizeof(*first_hdr);
+        break;
+    case UCP_AM_ID_AM_MIDDLE:
+        snprintf(buffer, max, "AM_M uuid %"PRIx64" msg_id %"PRIu64,
+                 mid_hdr->sender_uuid, mid_hdr->msg_id);
+        header_len = sizeof(*mid_hdr);
+        break;
+    default:
+        return;
+    }
+
+    p = buffer + strlen(buffer);
+    ucp_dump_payload(worker->context, p, buffer + max - p, data + header_len,
+                     length - header_len);
+}
+
+UCP_DEFINE_AM(UCP_FEATURE_AM, UCP_AM_ID_AM_SINGLE, ucp_am_single_handler,
+              ucp_am_dump, UCT_AM_CB_FLAG_SYNC);
+UCP_DEFINE_AM(UCP_FEATURE_AM, UCP_AM_ID_AM_SINGLE_REPLY,
+              ucp_am_single_reply_handler, ucp_am_dump, UCT_AM_CB_FLAG_SYNC);
+UCP_DEFINE_AM(UCP_FEATURE_AM, UCP_AM_ID_AM_FIRST, ucp_am_first_handler,
+              ucp_am_dump, UCT_AM_CB_FLAG_SYNC);
+UCP_DEFINE_AM(UCP_FEATURE_AM, UCP_AM_ID_AM_MIDDLE, ucp_am_middle_handler,
+              ucp_am_dump, UCT_AM_CB_FLAG_SYNC);
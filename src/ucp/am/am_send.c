@@ -0,0 +1,316 @@
+/**
+ * Copyright (C) Mellanox Technologies Ltd. 2001-2017.  ALL RIGHTS RESERVED.
+ *
+ * See file LICENSE for terms.
+ */
+
+#include "am.h"
+
+#include <ucp/core/ucp_request.inl>
+#include <ucp/proto/proto.h>
+#include <ucp/proto/proto_am.inl>
+
+
+static UCS_F_ALWAYS_INLINE void ucp_am_hdr_init(ucp_am_hdr_t *hdr,
+                                                ucp_request_t *req)
+{
+    hdr->am_id   = req->send.am.id;
+    hdr->flags   = req->send.am.flags;
+    hdr->padding = 0;
+}
+
+static UCS_F_ALWAYS_INLINE uint8_t ucp_am_single_id(ucp_request_t *req)
+{
+    return (req->send.am.flags & UCP_AM_SEND_REPLY) ?
+           UCP_AM_ID_AM_SINGLE_REPLY : UCP_AM_ID_AM_SINGLE;
+}
+
+static void ucp_am_middle_hdr_init(ucp_am_middle_hdr_t *hdr,
+                                   ucp_request_t *req)
+{
+    hdr->sender_uuid = req->send.ep->worker->uuid;
+    hdr->msg_id      = req->send.am.msg_id;
+}
+
+static void ucp_am_first_hdr_init(ucp_am_first_hdr_t *hdr, ucp_request_t *req)
+{
+    ucp_am_middle_hdr_init(&hdr->frag, req);
+    hdr->total_len = req->send.length;
+    ucp_am_hdr_init(&hdr->super, req);
+}
+
+static size_t ucp_am_pack_single_dt(void *dest, void *arg)
+{
+    ucp_request_t *req = arg;
+    ucp_am_reply_hdr_t *reply_hdr;
+    ucp_am_hdr_t *hdr;
+    size_t length;
+
+    if (req->send.am.flags & UCP_AM_SEND_REPLY) {
+        reply_hdr              = dest;
+        reply_hdr->sender_uuid = req->send.ep->worker->uuid;
+        hdr                    = &reply_hdr->super;
+    } else {
+        hdr                    = dest;
+    }
+    ucp_am_hdr_init(hdr, req);
+
+    ucs_assert(req->send.state.offset == 0);
+    length = ucp_dt_pack(req->send.datatype, hdr + 1, req->send.buffer,
+                         &req->send.state, req->send.length, req->send.length);
+    ucs_assert(length == req->send.length);
+    return ucp_am_single_hdr_size(req->send.am.flags) + length;
+}
+
+static size_t ucp_am_pack_first_dt(void *dest, void *arg)
+{
+    ucp_am_first_hdr_t *hdr = dest;
+    ucp_request_t *req      = arg;
+    size_t length;
+
+    length = ucp_ep_config(req->send.ep)->am.max_bcopy - sizeof(*hdr);
+    ucp_am_first_hdr_init(hdr, req);
+
+    ucs_debug("pack am_first paylen %zu", length);
+    ucs_assert(req->send.state.offset == 0);
+    ucs_assert(req->send.length > length);
+    return sizeof(*hdr) + ucp_dt_pack(req->send.datatype, hdr + 1,
+                                      req->send.buffer, &req->send.state,
+                                      length, req->send.length);
+}
+
+static size_t ucp_am_pack_middle_dt(void *dest, void *arg)
+{
+    ucp_am_middle_hdr_t *hdr = dest;
+    ucp_request_t *req       = arg;
+    size_t length;
+
+    length = ucp_ep_config(req->send.ep)->am.max_bcopy - sizeof(*hdr);
+    ucp_am_middle_hdr_init(hdr, req);
+
+    ucs_debug("pack am_middle paylen %zu offset %zu", length,
+              req->send.state.offset);
+    return sizeof(*hdr) + ucp_dt_pack(req->send.datatype, hdr + 1,
+                                      req->send.buffer, &req->send.state,
+                                      length, req->send.length);
+}
+
+static size_t ucp_am_pack_last_dt(void *dest, void *arg)
+{
+    ucp_am_middle_hdr_t *hdr = dest;
+    ucp_request_t *req       = arg;
+    size_t length, ret_length;
+
+    length     = req->send.length - req->send.state.offset;
+    ucp_am_middle_hdr_init(hdr, req);
+    ret_length = ucp_dt_pack(req->send.datatype, hdr + 1, req->send.buffer,
+                             &req->send.state, length, req->send.length);
+    ucs_debug("pack am_last paylen %zu offset %zu", length,
+              req->send.state.offset);
+    ucs_assertv(ret_length == length, "length=%zu, max_length=%zu",
+                ret_length, length);
+    return sizeof(*hdr) + ret_length;
+}
+
+static inline ucs_status_t ucp_am_send_short(ucp_ep_t *ep, uint16_t id,
+                                             const void *buffer, size_t length)
+{
+    union {
+        ucp_am_hdr_t hdr;
+        uint64_t     u64;
+    } am_hdr;
+
+    UCS_STATIC_ASSERT(sizeof(ucp_am_hdr_t) == sizeof(uint64_t));
+    am_hdr.hdr.am_id   = id;
+    am_hdr.hdr.flags   = 0;
+    am_hdr.hdr.padding = 0;
+    return uct_ep_am_short(ucp_ep_get_am_uct_ep(ep), UCP_AM_ID_AM_SINGLE,
+                           am_hdr.u64, buffer, length);
+}
+
+static ucs_status_t ucp_am_contig_short(uct_pending_req_t *self)
+{
+    ucp_request_t *req = ucs_container_of(self, ucp_request_t, send.uct);
+    ucs_status_t status;
+
+    req->send.lane = ucp_ep_get_am_lane(req->send.ep);
+    status = ucp_am_send_short(req->send.ep, req->send.am.id, req->send.buffer,
+                               req->send.length);
+    if (status != UCS_OK) {
+        return status;
+    }
+
+    ucp_request_complete_send(req, UCS_OK);
+    return UCS_OK;
+}
+
+static ucs_status_t ucp_am_bcopy_single(uct_pending_req_t *self)
+{
+    ucp_request_t *req = ucs_container_of(self, ucp_request_t, send.uct);
+    ucs_status_t status;
+
+    status = ucp_do_am_bcopy_single(self, ucp_am_single_id(req),
+                                    ucp_am_pack_single_dt);
+    if (status == UCS_OK) {
+        ucp_request_send_generic_dt_finish(req);
+        ucp_request_complete_send(req, UCS_OK);
+    }
+    return status;
+}
+
+static ucs_status_t ucp_am_bcopy_multi(uct_pending_req_t *self)
+{
+    ucs_status_t status = ucp_do_am_bcopy_multi(self,
+                                                UCP_AM_ID_AM_FIRST,
+                                                UCP_AM_ID_AM_MIDDLE,
+                                                UCP_AM_ID_AM_MIDDLE,
+                                                sizeof(ucp_am_middle_hdr_t),
+                                                ucp_am_pack_first_dt,
+                                                ucp_am_pack_middle_dt,
+                                                ucp_am_pack_last_dt);
+    if (status == UCS_OK) {
+        ucp_request_t *req = ucs_container_of(self, ucp_request_t, send.uct);
+        ucp_request_send_generic_dt_finish(req);
+        ucp_request_complete_send(req, UCS_OK);
+    }
+    return status;
+}
+
+static void ucp_am_zcopy_req_complete(ucp_request_t *req)
+{
+    ucp_request_send_buffer_dereg(req, req->send.lane);
+    ucp_request_complete_send(req, UCS_OK);
+}
+
+static ucs_status_t ucp_am_zcopy_single(uct_pending_req_t *self)
+{
+    ucp_request_t *req = ucs_container_of(self, ucp_request_t, send.uct);
+    ucp_am_reply_hdr_t reply_hdr;
+    void *hdr;
+
+    reply_hdr.sender_uuid = req->send.ep->worker->uuid;
+    ucp_am_hdr_init(&reply_hdr.super, req);
+    if (req->send.am.flags & UCP_AM_SEND_REPLY) {
+        hdr = &reply_hdr;
+    } else {
+        hdr = &reply_hdr.super;
+    }
+
+    return ucp_do_am_zcopy_single(self, ucp_am_single_id(req), hdr,
+                                  ucp_am_single_hdr_size(req->send.am.flags),
+                                  ucp_am_zcopy_req_complete);
+}
+
+static ucs_status_t ucp_am_zcopy_multi(uct_pending_req_t *self)
+{
+    ucp_request_t *req = ucs_container_of(self, ucp_request_t, send.uct);
+    ucp_am_first_hdr_t first_hdr;
+    ucp_am_middle_hdr_t middle_hdr;
+
+    ucp_am_first_hdr_init(&first_hdr, req);
+    ucp_am_middle_hdr_init(&middle_hdr, req);
+    return ucp_do_am_zcopy_multi(self,
+                                 UCP_AM_ID_AM_FIRST,
+                                 UCP_AM_ID_AM_MIDDLE,
+                                 UCP_AM_ID_AM_MIDDLE,
+                                 &first_hdr, sizeof(first_hdr),
+                                 &middle_hdr, sizeof(middle_hdr),
+                                 ucp_am_zcopy_req_complete);
+}
+
+static void ucp_am_zcopy_completion(uct_completion_t *self,
+                                    ucs_status_t status)
+{
+    ucp_request_t *req = ucs_container_of(self, ucp_request_t, send.uct_comp);
+    ucp_am_zcopy_req_complete(req);
+}
+
+static const ucp_proto_t ucp_am_proto = {
+    .contig_short            = ucp_am_contig_short,
+    .bcopy_single            = ucp_am_bcopy_single,
+    .bcopy_multi             = ucp_am_bcopy_multi,
+    .zcopy_single            = ucp_am_zcopy_single,
+    .zcopy_multi             = ucp_am_zcopy_multi,
+    .zcopy_completion        = ucp_am_zcopy_completion,
+    .only_hdr_size           = sizeof(ucp_am_reply_hdr_t),
+    .first_hdr_size          = sizeof(ucp_am_first_hdr_t),
+    .mid_hdr_size            = sizeof(ucp_am_middle_hdr_t)
+};
+
+UCS_PROFILE_FUNC(ucs_status_ptr_t, ucp_am_send_nb,
+                 (ep, id, buffer, count, datatype, cb, flags),
+                 ucp_ep_h ep, uint16_t id, const void *buffer, size_t count,
+                 uintptr_t datatype, ucp_send_callback_t cb, unsigned flags)
+{
+    ucs_status_t status;
+    ucp_request_t *req;
+    size_t length;
+    ucs_status_ptr_t ret;
+
+    UCP_THREAD_CS_ENTER_CONDITIONAL(&ep->worker->mt_lock);
+
+    ucs_trace_req("am_send_nb id %u buffer %p count %zu to %s cb %p flags 0x%x",
+                  id, buffer, count, ucp_ep_peer_name(ep), cb, flags);
+
+    if (flags & UCP_AM_SEND_REPLY) {
+        /* The reply endpoint on the remote side must be connected to us */
+        ucp_ep_connect_remote(ep);
+    } else if (ucs_likely(UCP_DT_IS_CONTIG(datatype))) {
+        length = ucp_contig_dt_length(datatype, count);
+        if (ucs_likely((ssize_t)length <= ucp_ep_config(ep)->am.max_eager_short)) {
+            status = UCS_PROFILE_CALL(ucp_am_send_short, ep, id, buffer,
+                                      length);
+            if (ucs_likely(status != UCS_ERR_NO_RESOURCE)) {
+                ret = UCS_STATUS_PTR(status); /* UCS_OK also goes here */
+                goto out;
+            }
+        }
+    }
+
+    req = ucp_request_get(ep->worker);
+    if (req == NULL) {
+        ret = UCS_STATUS_PTR(UCS_ERR_NO_MEMORY);
+        goto out;
+    }
+
+    req->flags             = 0;
+    req->send.ep           = ep;
+    req->send.buffer       = buffer;
+    req->send.datatype     = datatype;
+    req->send.state.offset = 0;
+    req->send.am.msg_id    = ep->worker->msg_id++;
+    req->send.am.id        = id;
+    req->send.am.flags     = flags;
+#if ENABLE_ASSERT
+    req->send.lane         = UCP_NULL_LANE;
+#endif
+
+    /* The short protocol has no room for the sender uuid, so it is not used
+     * for messages which allow a reply */
+    status = ucp_proto_am_req_start(req, count,
+                                    (flags & UCP_AM_SEND_REPLY) ? -1 :
+                                    ucp_ep_config(ep)->am.max_eager_short,
+                                    &ucp_am_proto);
+    if (status != UCS_OK) {
+        ucp_request_put(req);
+        ret = UCS_STATUS_PTR(status);
+        goto out;
+    }
+
+    status = ucp_request_start_send(req);
+    if (req->flags & UCP_REQUEST_FLAG_COMPLETED) {
+        ucs_trace_req("releasing am send request %p, returning status %s",
+                      req, ucs_status_string(status));
+        ucp_request_put(req);
+        ret = UCS_STATUS_PTR(status);
+        goto out;
+    }
+
+    ucp_request_set_callback(req, send.cb, cb)
+    ucs_trace_req("returning am send request %p", req);
+    ret = req + 1;
+
+out:
+    UCP_THREAD_CS_EXIT_CONDITIONAL(&ep->worker->mt_lock);
+    return ret;
+}
@@ -138,8 +138,49 @@ enum ucp_feature {
                                            operations support */
     UCP_FEATURE_AMO64  = UCS_BIT(3),  /**< Request 64-bit atomic
                                            operations support */
-    UCP_FEATURE_WAKEUP = UCS_BIT(4)   /**< Request interrupt notification
+    UCP_FEATURE_WAKEUP = UCS_BIT(4),  /**< Request interrupt notification
                                            support */
+    UCP_FEATURE_STREAM = UCS_BIT(5),  /**< Request stream support */
+    UCP_FEATURE_AM     = UCS_BIT(6)   /**< Request active message support */
+};
+
+
+/**
+ * @ingroup UCP_COMM
+ * @brief Flags for a stream receive operation.
+ *
+ * The enumeration allows specifying when a @ref ucp_stream_recv_nb
+ * "stream receive" operation is considered completed.
+ */
+enum ucp_stream_recv_flags {
+    UCP_STREAM_RECV_FLAG_WAITALL = UCS_BIT(0)  /**< Complete the receive only
+                                                    when the whole buffer is
+                                                    filled, rather than when
+                                                    any data arrives */
+};
+
+
+/**
+ * @ingroup UCP_COMM
+ * @brief Flags for an active message send operation.
+ */
+enum ucp_am_send_flags {
+    UCP_AM_SEND_REPLY = UCS_BIT(0)  /**< Pass the receiver's endpoint to the
+                                         sender to the active message handler,
+                                         so it can reply */
+};
+
+
+/**
+ * @ingroup UCP_COMM
+ * @brief Flags passed to an active message handler.
+ */
+enum ucp_cb_param_flags {
+    UCP_CB_PARAM_FLAG_DATA = UCS_BIT(0)  /**< The data is held by a receive
+                                              descriptor, which the handler may
+                                              keep by returning UCS_INPROGRESS,
+                                              and release later with
+                                              @ref ucp_am_data_release */
 };
 
 
@@ -1071,10 +1112,15 @@ void ucp_worker_release_address(ucp_worker_h worker, ucp_address_t *address);
  * @li The state of communication can be advanced (progressed) by blocking
  * routines. Nevertheless, the non-blocking routines can not be used for
  * communication progress.
+ * @li The return value allows building hybrid polling loops, which keep
+ * calling this routine while it finds events, and go to sleep with
+ * @ref ucp_worker_arm and @ref ucp_worker_wait once the worker is idle.
  *
  * @param [in]  worker    Worker to progress.
+ *
+ * @return Non-zero if any communication was progressed, zero otherwise.
  */
-void ucp_worker_progress(ucp_worker_h worker);
+unsigned ucp_worker_progress(ucp_worker_h worker);
 
 
 /**
@@ -1125,6 +1171,12 @@ ucs_status_t ucp_worker_get_efd(ucp_worker_h worker, int *fd);
  * notification and may not progress some of the requests as it would when
  * calling @ref ucp_worker_progress (which is not invoked in that duration).
  *
+ * @note If UCX_WAKEUP_POLL_TIME is set, this routine first keeps calling
+ * @ref ucp_worker_progress for up to that time, and returns as soon as it
+ * finds events, so completion callbacks may be invoked from this routine.
+ * The polling backs off gradually while the worker is idle, and the routine
+ * blocks only if no events were found during that time.
+ *
  * @note UCP @ref ucp_feature "features" have to be triggered
  *   with @ref UCP_FEATURE_WAKEUP to select proper transport
  *
@@ -1135,6 +1187,35 @@ ucs_status_t ucp_worker_get_efd(ucp_worker_h worker, int *fd);
 ucs_status_t ucp_worker_wait(ucp_worker_h worker);
 
 
+/**
+ * @ingroup UCP_WAKEUP
+ * @brief Wait for an event of the worker, with a timeout.
+ *
+ * This routine is similar to @ref ucp_worker_wait, but blocks for up to
+ * @a timeout milliseconds. It does not allocate memory, so it is suitable for
+ * event loops which wake up frequently.
+ *
+ * @note Internal timers of the worker (for example, retransmission timers of
+ * some transports) are handled while waiting, and the routine returns UCS_OK
+ * before the timeout expires only if they need the worker to be progressed.
+ * The caller is expected to call @ref ucp_worker_progress after any UCS_OK
+ * return.
+ *
+ * @note UCP @ref ucp_feature "features" have to be triggered
+ *   with @ref UCP_FEATURE_WAKEUP to select proper transport
+ *
+ * @param [in]  worker    Worker to wait for events on.
+ * @param [in]  timeout   Maximal time to wait, in milliseconds. A negative
+ *                        value means to wait without a timeout, same as
+ *                        @ref ucp_worker_wait.
+ *
+ * @return UCS_OK                 An event may have happened.
+ * @return UCS_ERR_TIMED_OUT      The timeout expired without events.
+ * @return Other                  Error code as defined by @ref ucs_status_t
+ */
+ucs_status_t ucp_worker_wait_timeout(ucp_worker_h worker, int timeout);
+
+
 /**
  * @ingroup UCP_WAKEUP
  * @brief Wait for memory update on the address
@@ -1702,6 +1783,169 @@ ucs_status_ptr_t ucp_tag_send_sync_nb(ucp_ep_h ep, const void *buffer, size_t co
                                       ucp_send_callback_t cb);
 
 
+/**
+ * @ingroup UCP_COMM
+ * @brief Non-blocking stream send operation.
+ *
+ * This routine sends data that is described by the local address @a buffer,
+ * size @a count, and @a datatype object to the destination endpoint @a ep.
+ * The data is appended to the byte stream of the endpoint, and is delivered
+ * to the @ref ucp_stream_recv_nb "receiver" in the order it was sent, without
+ * preserving the boundaries between the send operations. The routine is
+ * non-blocking and therefore returns immediately, however the actual send
+ * operation may be delayed. The send operation is considered completed when
+ * it is safe to reuse the source @e buffer. If the send operation is
+ * completed immediately the routine returns UCS_OK and the call-back function
+ * @a cb is @b not invoked. If the operation is @b not completed immediately
+ * and no error reported then the UCP library will schedule to invoke the
+ * call-back @a cb whenever the send operation will be completed.
+ *
+ * @note The user should not modify any part of the @a buffer after this
+ *       operation is called, until the operation completes.
+ *
+ * @param [in]  ep          Destination endpoint handle.
+ * @param [in]  buffer      Pointer to the data to send.
+ * @param [in]  count       Number of elements to send
+ * @param [in]  datatype    Datatype descriptor for the elements in the buffer.
+ * @param [in]  cb          Callback function that is invoked whenever the
+ *                          send operation is completed. It is important to note
+ *                          that the call-back is only invoked in a case when
+ *                          the operation cannot be completed in place.
+ *
+ * @return UCS_OK           - The send operation was completed immediately.
+ * @return UCS_PTR_IS_ERR(_ptr) - The send operation failed.
+ * @return otherwise        - Operation was scheduled for send and can be
+ *                          completed in any point in time. The request handle
+ *                          is returned to the application in order to track
+ *                          progress of the operation. The application is
+ *                          responsible to release the handle using
+ *                          @ref ucp_request_free "ucp_request_free()" routine.
+ */
+ucs_status_ptr_t ucp_stream_send_nb(ucp_ep_h ep, const void *buffer, size_t count,
+                                    ucp_datatype_t datatype,
+                                    ucp_send_callback_t cb);
+
+
+/**
+ * @ingroup UCP_COMM
+ * @brief Non-blocking stream receive operation.
+ *
+ * This routine receives data from the byte stream of the endpoint @a ep, to
+ * the local address @a buffer, size @a count, and @a datatype object. Data
+ * which has already arrived is copied to the buffer immediately. Otherwise,
+ * the receive is posted on the endpoint, and the data is placed directly in
+ * the @a buffer when it arrives. Receives posted on the same endpoint are
+ * filled in the order they were posted.
+ *
+ * By default, the receive operation is completed as soon as some data was
+ * placed in the buffer, which may be less than its size. If
+ * @ref UCP_STREAM_RECV_FLAG_WAITALL is passed in @a flags, the operation is
+ * completed only when the whole buffer is filled.
+ *
+ * @param [in]  ep          UCP endpoint to receive the data from.
+ * @param [in]  buffer      Pointer to the buffer to receive the data to.
+ * @param [in]  count       Number of elements to receive
+ * @param [in]  datatype    Datatype descriptor for the elements in the buffer.
+ * @param [in]  cb          Callback function that is invoked whenever the
+ *                          receive operation is completed and the data is ready
+ *                          in the receive @a buffer. The call-back is only
+ *                          invoked in a case when the operation cannot be
+ *                          completed in place.
+ * @param [out] length      Filled with the number of bytes received, if the
+ *                          operation was completed immediately.
+ * @param [in]  flags       Flags defined in @ref ucp_stream_recv_flags.
+ *
+ * @return UCS_OK           - The receive operation was completed immediately,
+ *                            and @a length was filled.
+ * @return UCS_PTR_IS_ERR(_ptr) - The receive operation failed.
+ * @return otherwise        - Operation was scheduled for receive. The request
+ *                            handle is returned to the application in order
+ *                            to track progress of the operation. The
+ *                            application is responsible to release the handle
+ *                            using @ref ucp_request_free "ucp_request_free()"
+ *                            routine.
+ */
+ucs_status_ptr_t ucp_stream_recv_nb(ucp_ep_h ep, void *buffer, size_t count,
+                                    ucp_datatype_t datatype,
+                                    ucp_stream_recv_callback_t cb,
+                                    size_t *length, unsigned flags);
+
+
+/**
+ * @ingroup UCP_WORKER
+ * @brief Register an active message handler.
+ *
+ * This routine installs a handler for the active messages with id @a id,
+ * which arrive at the worker @a worker. The handler replaces the one which
+ * was installed for the id before, if any.
+ *
+ * @param [in]  worker      UCP worker on which to install the handler.
+ * @param [in]  id          Active message id.
+ * @param [in]  cb          Active message handler, or NULL to remove the
+ *                          handler of @a id.
+ * @param [in]  arg         User-defined argument passed to the handler.
+ *
+ * @return Error code as defined by @ref ucs_status_t
+ */
+ucs_status_t ucp_worker_set_am_handler(ucp_worker_h worker, uint16_t id,
+                                       ucp_am_callback_t cb, void *arg);
+
+
+/**
+ * @ingroup UCP_COMM
+ * @brief Non-blocking active message send operation.
+ *
+ * This routine sends an active message with id @a id, and the data described
+ * by the local address @a buffer, size @a count, and @a datatype object, to
+ * the destination endpoint @a ep. When the message arrives, the
+ * @ref ucp_worker_set_am_handler "handler" which the receiving worker
+ * registered for @a id is invoked with the data. Messages whose id has no
+ * handler are dropped. The routine is non-blocking and therefore returns
+ * immediately, however the actual send operation may be delayed. The send
+ * operation is considered completed when it is safe to reuse the source
+ * @e buffer. If the send operation is completed immediately the routine
+ * returns UCS_OK and the call-back function @a cb is @b not invoked.
+ * Otherwise the call-back @a cb is invoked whenever the send operation is
+ * completed.
+ *
+ * @param [in]  ep          Destination endpoint handle.
+ * @param [in]  id          Active message id.
+ * @param [in]  buffer      Pointer to the data to send.
+ * @param [in]  count       Number of elements to send.
+ * @param [in]  datatype    Datatype descriptor for the elements in the buffer.
+ * @param [in]  cb          Callback function that is invoked whenever the
+ *                          send operation is completed. It is important to note
+ *                          that the call-back is only invoked in a case when
+ *                          the operation cannot be completed in place.
+ * @param [in]  flags       Flags defined in @ref ucp_am_send_flags.
+ *
+ * @return UCS_OK           - The send operation was completed immediately.
+ * @return UCS_PTR_IS_ERR(_ptr) - The send operation failed.
+ * @return otherwise        - Operation was scheduled for send and can be
+ *                          completed in any point in time. The request handle
+ *                          is returned to the application in order to track
+ *                          progress of the operation. The application is
+ *                          responsible to release the handle using
+ *                          @ref ucp_request_free "ucp_request_free()" routine.
+ */
+ucs_status_ptr_t ucp_am_send_nb(ucp_ep_h ep, uint16_t id, const void *buffer,
+                                size_t count, ucp_datatype_t datatype,
+                                ucp_send_callback_t cb, unsigned flags);
+
+
+/**
+ * @ingroup UCP_COMM
+ * @brief Release active message data.
+ *
+ * This routine releases the data of an active message, which the
+ * @ref ucp_am_callback_t "handler" kept by returning UCS_INPROGRESS.
+ *
+ * @param [in]  worker      Worker which received the message.
+ * @param [in]  data        Data pointer passed to the handler.
+ */
+void ucp_am_data_release(ucp_worker_h worker, void *data);
+
+
 /**
  * @ingroup UCP_COMM
  * @brief Non-blocking tagged-receive operation.
@@ -1916,6 +2160,52 @@ ucs_status_t ucp_put_nbi(ucp_ep_h ep, const void *buffer, size_t length,
                          uint64_t remote_addr, ucp_rkey_h rkey);
 
 
+/**
+ * @ingroup UCP_COMM
+ * @brief Non-blocking remote memory put operation.
+ *
+ * This routine initiates a storage of contiguous block of data that is
+ * described by the local address @a buffer in the remote contiguous memory
+ * region described by @a remote_addr address and the @ref ucp_rkey_h "memory
+ * handle" @a rkey. The routine returns immediately and @b does @b not
+ * guarantee re-usability of the source address @e buffer. If the operation is
+ * completed immediately the routine returns UCS_OK, and the call-back routine
+ * @a cb is @b not invoked. Otherwise, the UCP library returns a request handle
+ * and invokes the call-back routine @a cb when the source address @e buffer
+ * can be reused.
+ *
+ * @note Completion of the request does not guarantee that the data was stored
+ * in the remote memory. A user can use @ref ucp_ep_flush "ucp_ep_flush()" or
+ * @ref ucp_worker_flush "ucp_worker_flush()" for that.
+ *
+ * @param [in]  ep           Remote endpoint handle.
+ * @param [in]  buffer       Pointer to the local source address.
+ * @param [in]  length       Length of the data (in bytes) stored under the
+ *                           source address.
+ * @param [in]  remote_addr  Pointer to the destination remote address
+ *                           to write to.
+ * @param [in]  rkey         Remote memory key associated with the
+ *                           remote address.
+ * @param [in]  cb           Call-back function that is invoked whenever the
+ *                           put operation is completed. It is important to
+ *                           note that the call-back function is only invoked
+ *                           in a case when the operation cannot be completed
+ *                           in place.
+ *
+ * @return UCS_OK               - The operation was completed immediately.
+ * @return UCS_PTR_IS_ERR(_ptr) - The operation failed.
+ * @return otherwise            - Operation was scheduled and can be
+ *                              completed at any point in time. The request handle
+ *                              is returned to the application in order to track
+ *                              progress of the operation. The application is
+ *                              responsible for releasing the handle using
+ *                              @ref ucp_request_free "ucp_request_free()" routine.
+ */
+ucs_status_ptr_t ucp_put_nb(ucp_ep_h ep, const void *buffer, size_t length,
+                            uint64_t remote_addr, ucp_rkey_h rkey,
+                            ucp_send_callback_t cb);
+
+
 /**
  * @ingroup UCP_COMM
  * @brief Blocking remote memory get operation.
@@ -1971,6 +2261,47 @@ ucs_status_t ucp_get_nbi(ucp_ep_h ep, void *buffer, size_t length,
                          uint64_t remote_addr, ucp_rkey_h rkey);
 
 
+/**
+ * @ingroup UCP_COMM
+ * @brief Non-blocking remote memory get operation.
+ *
+ * This routine initiates a load of contiguous block of data that is described
+ * by the remote address @a remote_addr and the @ref ucp_rkey_h "memory handle"
+ * @a rkey in the local contiguous memory region described by @a buffer
+ * address. The routine returns immediately and @b does @b not guarantee that
+ * remote data is loaded and stored under the local address @e buffer. If the
+ * operation is completed immediately the routine returns UCS_OK, and the
+ * call-back routine @a cb is @b not invoked. Otherwise, the UCP library
+ * returns a request handle and invokes the call-back routine @a cb when the
+ * remote data is stored under the local address @e buffer.
+ *
+ * @param [in]  ep           Remote endpoint handle.
+ * @param [in]  buffer       Pointer to the local destination address.
+ * @param [in]  length       Length of the data (in bytes) to load.
+ * @param [in]  remote_addr  Pointer to the source remote address
+ *                           to read from.
+ * @param [in]  rkey         Remote memory key associated with the
+ *                           remote address.
+ * @param [in]  cb           Call-back function that is invoked whenever the
+ *                           get operation is completed. It is important to
+ *                           note that the call-back function is only invoked
+ *                           in a case when the operation cannot be completed
+ *                           in place.
+ *
+ * @return UCS_OK               - The operation was completed immediately.
+ * @return UCS_PTR_IS_ERR(_ptr) - The operation failed.
+ * @return otherwise            - Operation was scheduled and can be
+ *                              completed at any point in time. The request handle
+ *                              is returned to the application in order to track
+ *                              progress of the operation. The application is
+ *                              responsible for releasing the handle using
+ *                              @ref ucp_request_free "ucp_request_free()" routine.
+ */
+ucs_status_ptr_t ucp_get_nb(ucp_ep_h ep, void *buffer, size_t length,
+                            uint64_t remote_addr, ucp_rkey_h rkey,
+                            ucp_send_callback_t cb);
+
+
 /**
  * @ingroup UCP_COMM
  * @brief Blocking atomic add operation for 32 bit integers
@@ -2318,6 +2649,25 @@ ucp_atomic_fetch_nb(ucp_ep_h ep, ucp_atomic_fetch_op_t opcode,
 ucs_status_t ucp_request_test(void *request, ucp_tag_recv_info_t *info);
 
 
+/**
+ * @ingroup UCP_COMM
+ * @brief Check the status of a non-blocking stream receive request.
+ *
+ * This routine checks the state of a request returned by
+ * @ref ucp_stream_recv_nb "ucp_stream_recv_nb()" and returns its current
+ * status. Any value different from UCS_INPROGRESS means that request is in a
+ * completed state.
+ *
+ * @param [in]  request     Non-blocking stream receive request to check.
+ *
+ * @param [out] length_p    If request is in completed state, it is filled with
+ *                          the size of the received data, in bytes.
+ *
+ * @return Error code as defined by @ref ucs_status_t
+ */
+ucs_status_t ucp_stream_recv_request_test(void *request, size_t *length_p);
+
+
 /**
  * @ingroup UCP_COMM
  * @brief Cancel an outstanding communications request.
@@ -2380,6 +2730,37 @@ ucs_status_t ucp_dt_create_generic(const ucp_generic_dt_ops_t *ops, void *contex
                                    ucp_datatype_t *datatype_p);
 
 
+/**
+ * @ingroup UCP_DATATYPE
+ * @brief Create a strided datatype.
+ *
+ * This routine creates a datatype which consists of @a count elements of
+ * @a elem_datatype, placed @a stride bytes apart from each other. The element
+ * datatype can be either contiguous or strided, so a multi-dimensional layout,
+ * such as a sub-array of a matrix, is described by nesting strided datatypes.
+ * When the datatype is used in a communication routine, consecutive items of
+ * the buffer are placed at a distance of the datatype extent, which is the
+ * size of the memory spanned by a single item. The element datatype is not
+ * referenced by the new datatype, and may be destroyed once it is created.
+ * The application is responsible to release the @a datatype_p object using
+ * @ref ucp_dt_destroy "ucp_dt_destroy()" routine.
+ *
+ * @param [in]  elem_datatype  Datatype of a single element, created by
+ *                             @ref ucp_dt_make_contig "ucp_dt_make_contig()"
+ *                             or by this routine.
+ * @param [in]  count          Number of elements.
+ * @param [in]  stride         Distance between the beginnings of consecutive
+ *                             elements in bytes. It must not be smaller than
+ *                             the extent of @a elem_datatype, unless
+ *                             @a count is 1.
+ * @param [out] datatype_p     A pointer to datatype object.
+ *
+ * @return Error code as defined by @ref ucs_status_t
+ */
+ucs_status_t ucp_dt_create_strided(ucp_datatype_t elem_datatype, size_t count,
+                                   size_t stride, ucp_datatype_t *datatype_p);
+
+
 /**
  * @ingroup UCP_DATATYPE
  * @brief Destroy a datatype and release its resources.
@@ -2387,7 +2768,8 @@ ucs_status_t ucp_dt_create_generic(const ucp_generic_dt_ops_t *ops, void *contex
  * This routine destroys the @a datatype object and
  * releases any resources that are associated with the object.
  * The @a datatype object must be allocated using @ref ucp_dt_create_generic
- * "ucp_dt_create_generic()" routine.
+ * "ucp_dt_create_generic()" or @ref ucp_dt_create_strided
+ * "ucp_dt_create_strided()" routine.
  *
  * @warning
  * @li Once the @a datatype object is released an access to this object may
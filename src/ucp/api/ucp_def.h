@@ -272,6 +272,51 @@ typedef void (*ucp_send_callback_t)(void *request, ucs_status_t status);
 typedef void (*ucp_tag_recv_callback_t)(void *request, ucs_status_t status,
                                         ucp_tag_recv_info_t *info);
 
+
+/**
+ * @ingroup UCP_COMM
+ * @brief Completion callback for non-blocking stream receives.
+ *
+ * This callback routine is invoked whenever the @ref ucp_stream_recv_nb
+ * "receive operation" is completed and the data is ready in the receive buffer.
+ *
+ * @param [in]  request   The completed receive request.
+ * @param [in]  status    Completion status. If the receive operation was
+ *                        completed successfully UCS_OK is returned. If the
+ *                        endpoint was destroyed before data arrived
+ *                        UCS_ERR_CANCELED is returned. Otherwise, an
+ *                        @ref ucs_status_t "error status" is returned.
+ * @param [in]  length    The number of bytes received into the buffer.
+ */
+typedef void (*ucp_stream_recv_callback_t)(void *request, ucs_status_t status,
+                                           size_t length);
+
+
+/**
+ * @ingroup UCP_COMM
+ * @brief Active message handler.
+ *
+ * This callback routine is invoked on the receiver when an active message,
+ * sent by @ref ucp_am_send_nb "ucp_am_send_nb()", arrives, with the id the
+ * handler was registered for by
+ * @ref ucp_worker_set_am_handler "ucp_worker_set_am_handler()". It is called
+ * from the context of @ref ucp_worker_progress "ucp_worker_progress()".
+ *
+ * @param [in]  arg       User-defined argument passed on registration.
+ * @param [in]  data      Points to the message payload.
+ * @param [in]  length    Length of the payload, in bytes.
+ * @param [in]  reply_ep  Endpoint to the sender, if the message was sent with
+ *                        @ref UCP_AM_SEND_REPLY. NULL otherwise.
+ * @param [in]  flags     Flags defined in @ref ucp_cb_param_flags.
+ *
+ * @return UCS_OK if the handler is done with the data, or UCS_INPROGRESS to
+ *         keep it. The data may be kept only if @ref UCP_CB_PARAM_FLAG_DATA is
+ *         set, and must then be released by
+ *         @ref ucp_am_data_release "ucp_am_data_release()".
+ */
+typedef ucs_status_t (*ucp_am_callback_t)(void *arg, void *data, size_t length,
+                                          ucp_ep_h reply_ep, unsigned flags);
+
 /**
  * @ingroup UCP_WORKER
  * @brief UCP worker wakeup events mask.
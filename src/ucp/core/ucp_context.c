@@ -97,6 +97,29 @@ static ucs_config_field_t ucp_config_table[] = {
    "the eager_zcopy protocol",
    ucs_offsetof(ucp_config_t, ctx.rndv_perf_diff), UCS_CONFIG_TYPE_DOUBLE},
 
+  {"MAX_RNDV_LANES", "2",
+   "Maximal number of devices on which a rendezvous data transfer could be\n"
+   "split. Only devices which share the same memory domain are used together,\n"
+   "and each device is used by at most one of the lanes.",
+   ucs_offsetof(ucp_config_t, ctx.max_rndv_lanes), UCS_CONFIG_TYPE_UINT},
+
+  {"RNDV_FRAG_SIZE", "64k",
+   "Size of a fragment of the pipelined rendezvous protocol. It is used for\n"
+   "messages which can't be read directly by the receiver, such as generic\n"
+   "datatypes, and packs the data to pre-registered staging buffers.",
+   ucs_offsetof(ucp_config_t, ctx.rndv_frag_size), UCS_CONFIG_TYPE_MEMUNITS},
+
+  {"RNDV_PIPELINE_DEPTH", "4",
+   "Maximal number of fragments of a single pipelined rendezvous message which\n"
+   "could be in flight, while the next fragment is being packed.",
+   ucs_offsetof(ucp_config_t, ctx.rndv_pipeline_depth), UCS_CONFIG_TYPE_UINT},
+
+  {"RNDV_RKEY_CACHE_SIZE", "64",
+   "Maximal number of remote keys of rendezvous send buffers, which are kept\n"
+   "unpacked by each worker, so repeated transfers from the same buffer do not\n"
+   "unpack its key again. 0 disables the cache.",
+   ucs_offsetof(ucp_config_t, ctx.rndv_rkey_cache_size), UCS_CONFIG_TYPE_UINT},
+
   {"ZCOPY_THRESH", "auto",
    "Threshold for switching from buffer copy to zero copy protocol",
    ucs_offsetof(ucp_config_t, ctx.zcopy_thresh), UCS_CONFIG_TYPE_MEMUNITS},
@@ -105,6 +128,23 @@ static ucs_config_field_t ucp_config_table[] = {
    "Estimation of buffer copy bandwidth",
    ucs_offsetof(ucp_config_t, ctx.bcopy_bw), UCS_CONFIG_TYPE_MEMUNITS},
 
+  {"TUNE_THRESH", "n",
+   "Recalculate the zero-copy and rendezvous thresholds at runtime, from the\n"
+   "bandwidth measured for eager bcopy, eager zcopy and rendezvous tag sends,\n"
+   "instead of the estimated transport bandwidth and BCOPY_BW. Only thresholds\n"
+   "which are set to \"auto\" are tuned.",
+   ucs_offsetof(ucp_config_t, ctx.tune_thresh), UCS_CONFIG_TYPE_BOOL},
+
+  {"TUNE_THRESH_WINDOW", "256",
+   "Number of sends of each protocol the bandwidth is measured over. The\n"
+   "thresholds are recalculated every time this many sends have completed.",
+   ucs_offsetof(ucp_config_t, ctx.tune_thresh_window), UCS_CONFIG_TYPE_UINT},
+
+  {"TUNE_THRESH_RANGE", "4",
+   "Maximal factor by which a tuned threshold may differ from the one which\n"
+   "is calculated when the endpoint configuration is created.",
+   ucs_offsetof(ucp_config_t, ctx.tune_thresh_range), UCS_CONFIG_TYPE_DOUBLE},
+
   {"ATOMIC_MODE", "guess",
    "Atomic operations synchronization mode.\n"
    " cpu    - atomic operations are consistent with respect to the CPU.\n"
@@ -129,6 +169,27 @@ static ucs_config_field_t ucp_config_table[] = {
    "y      - Use mutex for multithreading support in UCP.\n",
    ucs_offsetof(ucp_config_t, ctx.use_mt_mutex), UCS_CONFIG_TYPE_BOOL},
 
+  {"MPOOL_HUGETLB", "y",
+   "Allocate request and active message buffer pools with huge pages. If huge\n"
+   "pages are not available, transparent huge pages are requested instead.",
+   ucs_offsetof(ucp_config_t, ctx.mpool_hugetlb), UCS_CONFIG_TYPE_BOOL},
+
+  {"MPOOL_NUMA_LOCAL", "y",
+   "Place request and active message buffer pools on the NUMA node of the\n"
+   "thread which grows them.",
+   ucs_offsetof(ucp_config_t, ctx.mpool_numa_local), UCS_CONFIG_TYPE_BOOL},
+
+  {"MPOOL_PREFAULT", "n",
+   "Fault in the memory of request and active message buffer pools when they\n"
+   "grow, rather than on first use.",
+   ucs_offsetof(ucp_config_t, ctx.mpool_prefault), UCS_CONFIG_TYPE_BOOL},
+
+  {"WAKEUP_POLL_TIME", "0",
+   "How long ucp_worker_wait() keeps progressing the worker before it goes to\n"
+   "sleep. Polling continues as long as progress finds events, and backs off\n"
+   "gradually while the worker is idle. 0 means to go to sleep immediately.",
+   ucs_offsetof(ucp_config_t, ctx.wakeup_poll_time), UCS_CONFIG_TYPE_TIME},
+
   {NULL}
 };
 
@@ -31,10 +31,24 @@ typedef struct ucp_context_config {
     /** The percentage allowed for performance difference between rendezvous
      *  and the eager_zcopy protocol */
     double                                 rndv_perf_diff;
+    /** Maximal number of lanes to split rendezvous data transfers across */
+    unsigned                               max_rndv_lanes;
+    /** Fragment size of the pipelined rendezvous protocol */
+    size_t                                 rndv_frag_size;
+    /** Maximal number of pipelined rendezvous fragments in flight */
+    unsigned                               rndv_pipeline_depth;
+    /** Maximal number of cached remote keys of rendezvous send buffers */
+    unsigned                               rndv_rkey_cache_size;
     /** Threshold for switching UCP to zero copy protocol */
     size_t                                 zcopy_thresh;
     /** Estimation of bcopy bandwidth */
     size_t                                 bcopy_bw;
+    /** Tune the zero-copy and rendezvous thresholds at runtime */
+    int                                    tune_thresh;
+    /** Number of sends the bandwidth is measured over, for tuning */
+    unsigned                               tune_thresh_window;
+    /** Maximal factor between tuned and calculated thresholds */
+    double                                 tune_thresh_range;
     /** Size of packet data that is dumped to the log system in debug mode */
     size_t                                 log_data_size;
     /** Maximal size of worker name for debugging */
@@ -43,6 +57,14 @@ typedef struct ucp_context_config {
     ucp_atomic_mode_t                      atomic_mode;
     /** If use mutex for MT support or not */
     int                                    use_mt_mutex;
+    /** Use huge pages for request and AM buffer pools */
+    int                                    mpool_hugetlb;
+    /** Bind request and AM buffer pools to the local NUMA node */
+    int                                    mpool_numa_local;
+    /** Prefault request and AM buffer pools when they grow */
+    int                                    mpool_prefault;
+    /** How long to keep polling the worker before blocking in ucp_worker_wait */
+    double                                 wakeup_poll_time;
 } ucp_context_config_t;
 
 
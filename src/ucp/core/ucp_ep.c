@@ -11,6 +11,7 @@
 
 #include <ucp/wireup/stub_ep.h>
 #include <ucp/wireup/wireup.h>
+#include <ucp/stream/stream.h>
 #include <ucp/tag/eager.h>
 #include <ucs/debug/memtrack.h>
 #include <ucs/debug/log.h>
@@ -36,11 +37,11 @@ void ucp_ep_config_key_reset(ucp_ep_config_key_t *key)
     memset(key, 0, sizeof(*key));
     key->num_lanes        = 0;
     key->am_lane          = UCP_NULL_LANE;
-    key->rndv_lane        = UCP_NULL_LANE;
     key->wireup_lane      = UCP_NULL_LANE;
     key->reachable_md_map = 0;
     memset(key->rma_lanes, UCP_NULL_LANE, sizeof(key->rma_lanes));
     memset(key->amo_lanes, UCP_NULL_LANE, sizeof(key->amo_lanes));
+    memset(key->rndv_lanes, UCP_NULL_LANE, sizeof(key->rndv_lanes));
 }
 
 ucs_status_t ucp_ep_new(ucp_worker_h worker, uint64_t dest_uuid,
@@ -66,6 +67,7 @@ ucs_status_t ucp_ep_new(ucp_worker_h worker, uint64_t dest_uuid,
     ep->cfg_index        = ucp_worker_get_ep_config(worker, &key);
     ep->am_lane          = UCP_NULL_LANE;
     ep->flags            = 0;
+    ucp_stream_ep_init(ep);
 #if ENABLE_DEBUG_DATA
     ucs_snprintf_zero(ep->peer_name, UCP_WORKER_NAME_MAX, "%s", peer_name);
 #endif
@@ -137,7 +139,7 @@ ucs_status_t ucp_ep_create_stub(ucp_worker_h worker, uint64_t dest_uuid,
     key.lanes[0].rsc_index    = UCP_NULL_RESOURCE;
     key.lanes[0].dst_md_index = UCP_NULL_RESOURCE;
     key.am_lane               = 0;
-    key.rndv_lane             = 0;
+    key.rndv_lanes[0]         = 0;
     key.wireup_lane           = 0;
 
     ep->cfg_index        = ucp_worker_get_ep_config(worker, &key);
@@ -429,6 +431,8 @@ void ucp_ep_destroy_internal(ucp_ep_h ep, const char *message)
         uct_ep_destroy(uct_ep);
     }
 
+    ucp_stream_ep_cleanup(ep);
+    ucp_rkey_cache_purge_sender(&ep->worker->rkey_cache, ep->dest_uuid);
     UCS_STATS_NODE_FREE(ep->stats);
     ucs_free(ep);
 }
@@ -554,9 +558,9 @@ int ucp_ep_config_is_equal(const ucp_ep_config_key_t *key1,
     if ((key1->num_lanes        != key2->num_lanes) ||
         memcmp(key1->rma_lanes, key2->rma_lanes, sizeof(key1->rma_lanes)) ||
         memcmp(key1->amo_lanes, key2->amo_lanes, sizeof(key1->amo_lanes)) ||
+        memcmp(key1->rndv_lanes, key2->rndv_lanes, sizeof(key1->rndv_lanes)) ||
         (key1->reachable_md_map != key2->reachable_md_map) ||
         (key1->am_lane          != key2->am_lane) ||
-        (key1->rndv_lane        != key2->rndv_lane) ||
         (key1->wireup_lane      != key2->wireup_lane))
     {
         return 0;
@@ -573,10 +577,29 @@ int ucp_ep_config_is_equal(const ucp_ep_config_key_t *key1,
     return 1;
 }
 
+static size_t ucp_ep_config_calc_zcopy_thresh(size_t iovcnt,
+                                              const uct_linear_growth_t *reg_cost,
+                                              double bcopy_bw, double bandwidth)
+{
+    double zcopy_thresh;
+
+    zcopy_thresh = (iovcnt * reg_cost->overhead) /
+                   ((1.0 / bcopy_bw) - (1.0 / bandwidth) - (iovcnt * reg_cost->growth));
+
+    if ((zcopy_thresh < 0.0) || (zcopy_thresh > SIZE_MAX)) {
+        return SIZE_MAX;
+    }
+
+    return zcopy_thresh;
+}
+
 static size_t ucp_ep_config_calc_rndv_thresh(ucp_context_h context,
                                              uct_iface_attr_t *iface_attr,
                                              uct_md_attr_t *md_attr,
-                                             size_t bcopy_bw, int recv_reg_cost)
+                                             double bandwidth,
+                                             double eager_bcopy_bw,
+                                             double rndv_bcopy_bw,
+                                             int recv_reg_cost)
 {
     double numerator, denumerator;
     double diff_percent = 1.0 - context->config.ext.rndv_perf_diff / 100.0;
@@ -610,8 +633,8 @@ static size_t ucp_ep_config_calc_rndv_thresh(ucp_context_h context,
                 md_attr->reg_cost.overhead - iface_attr->overhead;
 
     denumerator = md_attr->reg_cost.growth +
-                  ucs_max((1.0 / iface_attr->bandwidth), (1.0 / context->config.ext.bcopy_bw)) -
-                  (diff_percent * (ucs_max((1.0 / iface_attr->bandwidth), (1.0 / bcopy_bw)) +
+                  ucs_max((1.0 / bandwidth), (1.0 / eager_bcopy_bw)) -
+                  (diff_percent * (ucs_max((1.0 / bandwidth), (1.0 / rndv_bcopy_bw)) +
                   md_attr->reg_cost.growth * (1 + recv_reg_cost)));
 
     if ((numerator > 0) && (denumerator > 0)) {
@@ -633,6 +656,8 @@ static void ucp_ep_config_set_am_rndv_thresh(ucp_context_h context, uct_iface_at
     if (context->config.ext.rndv_thresh == UCS_CONFIG_MEMUNITS_AUTO) {
         /* auto - Make UCX calculate the AM rndv threshold on its own.*/
         rndv_thresh = ucp_ep_config_calc_rndv_thresh(context, iface_attr, md_attr,
+                                                     iface_attr->bandwidth,
+                                                     context->config.ext.bcopy_bw,
                                                      context->config.ext.bcopy_bw,
                                                      0);
         ucs_trace("Active Message rendezvous threshold is %zu", rndv_thresh);
@@ -655,6 +680,7 @@ void ucp_ep_config_init(ucp_worker_h worker, ucp_ep_config_t *config)
     uct_md_attr_t *md_attr;
     ucp_lane_index_t lane;
     size_t zcopy_thresh, rndv_thresh, it;
+    double rndv_bw = 0;
 
     /* Default settings */
     for (it = 0; it < UCP_MAX_IOV; ++it) {
@@ -664,8 +690,9 @@ void ucp_ep_config_init(ucp_worker_h worker, ucp_ep_config_t *config)
     config->am.zcopy_auto_thresh  = 0;
     config->bcopy_thresh          = context->config.ext.bcopy_thresh;
     config->rndv.rma_thresh       = SIZE_MAX;
-    config->rndv.max_get_zcopy    = SIZE_MAX;
     config->rndv.am_thresh        = SIZE_MAX;
+    config->rndv.num_lanes        = 0;
+    config->rndv.frag_size        = 0;
     config->p2p_lanes             = 0;
 
     /* Collect p2p lanes */
@@ -724,6 +751,14 @@ void ucp_ep_config_init(ucp_worker_h worker, ucp_ep_config_t *config)
                 }
             }
 
+            /* staging buffers of the pipelined rendezvous are sent with
+             * zcopy, and are registered on every memory domain which needs it */
+            if ((iface_attr->cap.flags & UCT_IFACE_FLAG_AM_ZCOPY) &&
+                (iface_attr->cap.am.max_iov > 0)) {
+                config->rndv.frag_size = ucs_min(context->config.ext.rndv_frag_size,
+                                                 iface_attr->cap.am.max_zcopy);
+            }
+
             /* calculate an rndv threshold for AM Rendezvous */
             ucp_ep_config_set_am_rndv_thresh(context, iface_attr, md_attr, config);
         } else {
@@ -782,19 +817,33 @@ void ucp_ep_config_init(ucp_worker_h worker, ucp_ep_config_t *config)
     }
 
     /* Configuration for Rendezvous data */
-    if (config->key.rndv_lane != UCP_NULL_LANE) {
-        lane        = config->key.rndv_lane;
-        rsc_index   = config->key.lanes[lane].rsc_index;
-        if (rsc_index != UCP_NULL_RESOURCE) {
-            iface_attr = &worker->iface_attrs[rsc_index];
-            md_attr    = &context->tl_mds[context->tl_rscs[rsc_index].md_index].attr;
-            ucs_assert_always(iface_attr->cap.flags & UCT_IFACE_FLAG_GET_ZCOPY);
+    for (it = 0; it < UCP_MAX_LANES; ++it) {
+        lane = config->key.rndv_lanes[it];
+        if (lane == UCP_NULL_LANE) {
+            break;
+        }
+
+        rsc_index = config->key.lanes[lane].rsc_index;
+        if (rsc_index == UCP_NULL_RESOURCE) {
+            ucs_debug("rendezvous (get_zcopy) protocol is not supported ");
+            break;
+        }
+
+        iface_attr = &worker->iface_attrs[rsc_index];
+        ucs_assert_always(iface_attr->cap.flags & UCT_IFACE_FLAG_GET_ZCOPY);
+        ucs_assert(iface_attr->cap.get.min_zcopy <= iface_attr->cap.get.max_zcopy);
 
+        config->rndv.max_get_zcopy[it] = iface_attr->cap.get.max_zcopy;
+        ++config->rndv.num_lanes;
+
+        if (it == 0) {
+            md_attr = &context->tl_mds[context->tl_rscs[rsc_index].md_index].attr;
             if (context->config.ext.rndv_thresh == UCS_CONFIG_MEMUNITS_AUTO) {
                 /* auto - Make UCX calculate the RMA (get_zcopy) rndv threshold on its own.*/
                 rndv_thresh = ucp_ep_config_calc_rndv_thresh(context, iface_attr, md_attr,
-                                                             SIZE_MAX,
-                                                             1);
+                                                             iface_attr->bandwidth,
+                                                             context->config.ext.bcopy_bw,
+                                                             SIZE_MAX, 1);
             } else {
                 /* In order to disable rendezvous, need to set the threshold to
                  * infinite (-1).
@@ -803,16 +852,196 @@ void ucp_ep_config_init(ucp_worker_h worker, ucp_ep_config_t *config)
             }
 
             /* use rendezvous only starting from minimal zero-copy get size */
-            ucs_assert(iface_attr->cap.get.min_zcopy <= iface_attr->cap.get.max_zcopy);
-            rndv_thresh                = ucs_max(rndv_thresh,
-                                                 iface_attr->cap.get.min_zcopy);
+            config->rndv.rma_thresh = ucs_max(rndv_thresh,
+                                              iface_attr->cap.get.min_zcopy);
+            rndv_bw                 = iface_attr->bandwidth;
+        }
 
-            config->rndv.max_get_zcopy = iface_attr->cap.get.max_zcopy;
-            config->rndv.rma_thresh    = rndv_thresh;
-        } else {
-            ucs_debug("rendezvous (get_zcopy) protocol is not supported ");
+        /* Each lane gets a share of the data proportional to its bandwidth */
+        config->rndv.bw_scale[it] = iface_attr->bandwidth / rndv_bw;
+    }
+
+    /* Thresholds set by the user are never tuned */
+    config->tune.enabled = context->config.ext.tune_thresh &&
+                           (context->config.ext.tune_thresh_window > 0) &&
+                           (config->am.zcopy_auto_thresh ||
+                            (context->config.ext.rndv_thresh ==
+                             UCS_CONFIG_MEMUNITS_AUTO));
+}
+
+/*
+ * Bound a tuned threshold to the configured range around the one which was
+ * calculated from the transport attributes.
+ */
+static size_t ucp_ep_config_tune_bound(ucp_context_h context, size_t thresh,
+                                       size_t calc_thresh)
+{
+    double range = ucs_max(context->config.ext.tune_thresh_range, 1.0);
+    double value;
+
+    if (calc_thresh == SIZE_MAX) {
+        /* The protocol is not worth using, whatever was measured */
+        return SIZE_MAX;
+    }
+
+    value = ucs_max((double)thresh, calc_thresh / range);
+    value = ucs_min(value, calc_thresh * range);
+    return (value >= (double)SIZE_MAX) ? SIZE_MAX : (size_t)value;
+}
+
+/*
+ * Recalculate the thresholds which are set to "auto" with the measured
+ * bandwidth instead of the transport attributes, once both buffered copy and
+ * zero-copy transfers were measured.
+ */
+static void ucp_ep_config_tune_thresh(ucp_worker_h worker,
+                                      ucp_ep_config_t *config)
+{
+    ucp_context_h context = worker->context;
+    uct_iface_attr_t *iface_attr;
+    ucp_rsc_index_t rsc_index;
+    uct_md_attr_t *md_attr;
+    ucp_lane_index_t lane;
+    size_t thresh, calc_thresh, it;
+    double bcopy_bw, link_bw;
+
+    /* Zero-copy sends and rendezvous move the data over the same link, and the
+     * faster of them is the closest to its actual bandwidth */
+    bcopy_bw = config->tune.bw[UCP_EP_TUNE_PROTO_BCOPY];
+    link_bw  = ucs_max(config->tune.bw[UCP_EP_TUNE_PROTO_ZCOPY],
+                       config->tune.bw[UCP_EP_TUNE_PROTO_RNDV]);
+
+    /* Comparing a measured bandwidth with an estimated one would favor the
+     * protocol which was not measured yet */
+    if ((bcopy_bw == 0) || (link_bw == 0)) {
+        return;
+    }
+
+    lane = config->key.am_lane;
+    if ((lane != UCP_NULL_LANE) &&
+        (config->key.lanes[lane].rsc_index != UCP_NULL_RESOURCE)) {
+        rsc_index  = config->key.lanes[lane].rsc_index;
+        iface_attr = &worker->iface_attrs[rsc_index];
+        md_attr    = &context->tl_mds[context->tl_rscs[rsc_index].md_index].attr;
+
+        if (config->am.zcopy_auto_thresh) {
+            for (it = 0; it < UCP_MAX_IOV; ++it) {
+                calc_thresh = ucp_ep_config_get_zcopy_auto_thresh(
+                                  it + 1, &md_attr->reg_cost, context,
+                                  iface_attr->bandwidth);
+                thresh      = ucp_ep_config_calc_zcopy_thresh(
+                                  it + 1, &md_attr->reg_cost, bcopy_bw,
+                                  link_bw);
+                thresh      = ucp_ep_config_tune_bound(context, thresh,
+                                                       calc_thresh);
+                config->am.sync_zcopy_thresh[it] = thresh;
+                config->am.zcopy_thresh[it]      = ucs_max(thresh,
+                                                           iface_attr->cap.am.min_zcopy);
+            }
+        }
+
+        if (context->config.ext.rndv_thresh == UCS_CONFIG_MEMUNITS_AUTO) {
+            calc_thresh = ucp_ep_config_calc_rndv_thresh(context, iface_attr,
+                                                         md_attr,
+                                                         iface_attr->bandwidth,
+                                                         context->config.ext.bcopy_bw,
+                                                         context->config.ext.bcopy_bw,
+                                                         0);
+            thresh      = ucp_ep_config_calc_rndv_thresh(context, iface_attr,
+                                                         md_attr, link_bw,
+                                                         bcopy_bw, bcopy_bw, 0);
+            thresh      = ucp_ep_config_tune_bound(context, thresh, calc_thresh);
+            config->rndv.am_thresh = ucs_max(thresh, iface_attr->cap.am.min_zcopy);
+        }
+    }
+
+    if ((config->rndv.num_lanes > 0) &&
+        (context->config.ext.rndv_thresh == UCS_CONFIG_MEMUNITS_AUTO)) {
+        rsc_index   = config->key.lanes[config->key.rndv_lanes[0]].rsc_index;
+        iface_attr  = &worker->iface_attrs[rsc_index];
+        md_attr     = &context->tl_mds[context->tl_rscs[rsc_index].md_index].attr;
+        calc_thresh = ucp_ep_config_calc_rndv_thresh(context, iface_attr,
+                                                     md_attr,
+                                                     iface_attr->bandwidth,
+                                                     context->config.ext.bcopy_bw,
+                                                     SIZE_MAX, 1);
+        thresh      = ucp_ep_config_calc_rndv_thresh(context, iface_attr,
+                                                     md_attr, link_bw,
+                                                     bcopy_bw, SIZE_MAX, 1);
+        thresh      = ucp_ep_config_tune_bound(context, thresh, calc_thresh);
+        config->rndv.rma_thresh = ucs_max(thresh, iface_attr->cap.get.min_zcopy);
+    }
+
+    ucs_debug("worker %p: tuned thresholds: bcopy_bw %.2f MB/s link_bw %.2f MB/s "
+              "zcopy %zu rndv_rma %zu rndv_am %zu", worker, bcopy_bw / UCS_MBYTE,
+              link_bw / UCS_MBYTE, config->am.zcopy_thresh[0],
+              config->rndv.rma_thresh, config->rndv.am_thresh);
+    ++config->tune.count;
+}
+
+/*
+ * Bandwidth in bytes/sec from a least-squares fit of send time to message
+ * size, which leaves out the fixed cost of every send. Returns 0 if there are
+ * no samples.
+ */
+double ucp_ep_tune_stats_bw(const ucp_ep_tune_stats_t *stats)
+{
+    double var, slope;
+
+    if (stats->count == 0) {
+        return 0;
+    }
+
+    var = (stats->count * stats->sum_size2) - (stats->sum_size * stats->sum_size);
+    if (var > (1e-6 * stats->count * stats->sum_size2)) {
+        slope = ((stats->count * stats->sum_size_time) -
+                 (stats->sum_size * stats->sum_time)) / var;
+        if (slope > 0) {
+            return 1.0 / slope;
         }
     }
+
+    /* All messages have about the same size, so the fixed cost can't be told
+     * apart from the transfer time */
+    if (stats->sum_time <= 0) {
+        return 0;
+    }
+    return stats->sum_size / stats->sum_time;
+}
+
+void ucp_ep_config_tune_sample(ucp_worker_h worker, ucp_ep_config_t *config,
+                               unsigned proto, size_t length, ucs_time_t time)
+{
+    ucp_ep_tune_stats_t *cur  = &config->tune.cur[proto];
+    ucp_ep_tune_stats_t *prev = &config->tune.prev[proto];
+    double size               = length;
+    double sec                = ucs_time_to_sec(time);
+    ucp_ep_tune_stats_t window;
+
+    ucs_assert(proto < UCP_EP_TUNE_PROTO_LAST);
+
+    cur->count         += 1;
+    cur->sum_size      += size;
+    cur->sum_time      += sec;
+    cur->sum_size2     += size * size;
+    cur->sum_size_time += size * sec;
+    if (cur->count < worker->context->config.ext.tune_thresh_window) {
+        return;
+    }
+
+    /* Measure over the last two windows, so every update is based on at least
+     * a full window of recent sends */
+    window.count         = cur->count         + prev->count;
+    window.sum_size      = cur->sum_size      + prev->sum_size;
+    window.sum_time      = cur->sum_time      + prev->sum_time;
+    window.sum_size2     = cur->sum_size2     + prev->sum_size2;
+    window.sum_size_time = cur->sum_size_time + prev->sum_size_time;
+
+    config->tune.bw[proto] = ucp_ep_tune_stats_bw(&window);
+    *prev                  = *cur;
+    memset(cur, 0, sizeof(*cur));
+
+    ucp_ep_config_tune_thresh(worker, config);
 }
 
 static void ucp_ep_config_print_tag_proto(FILE *stream, const char *name,
@@ -849,6 +1078,26 @@ static void ucp_ep_config_print_tag_proto(FILE *stream, const char *name,
     fprintf(stream, "(inf)\n");
 }
 
+static void ucp_ep_config_print_tune(FILE *stream,
+                                     const ucp_ep_config_t *config)
+{
+    static const char *proto_names[] = {
+        [UCP_EP_TUNE_PROTO_BCOPY] = "egr/bcopy",
+        [UCP_EP_TUNE_PROTO_ZCOPY] = "egr/zcopy",
+        [UCP_EP_TUNE_PROTO_RNDV]  = "rndv"
+    };
+    unsigned proto;
+
+    fprintf(stream, "# %23s: %u updates", "tune_thresh", config->tune.count);
+    for (proto = 0; proto < UCP_EP_TUNE_PROTO_LAST; ++proto) {
+        if (config->tune.bw[proto] > 0) {
+            fprintf(stream, ", <%s> %.2f MB/s", proto_names[proto],
+                    config->tune.bw[proto] / UCS_MBYTE);
+        }
+    }
+    fprintf(stream, "\n");
+}
+
 static void ucp_ep_config_print_rma_proto(FILE *stream, const char *name,
                                           ucp_lane_index_t lane,
                                           size_t bcopy_thresh, size_t zcopy_thresh)
@@ -929,8 +1178,9 @@ void ucp_ep_config_lane_info_str(ucp_context_h context,
         p += strlen(p);
     }
 
-    if (lane == key->rndv_lane) {
-        snprintf(p, endp - p, " zcopy_rndv");
+    prio = ucp_ep_config_get_rma_prio(key->rndv_lanes, lane);
+    if (prio != -1) {
+        snprintf(p, endp - p, " zcopy_rndv#%d", prio);
         p += strlen(p);
     }
 
@@ -972,6 +1222,23 @@ static void ucp_ep_config_print(FILE *stream, ucp_worker_h worker,
                                        config->am.sync_zcopy_thresh[0],
                                        config->rndv.rma_thresh,
                                        config->rndv.am_thresh);
+         if (config->tune.enabled) {
+             ucp_ep_config_print_tune(stream, config);
+         }
+     }
+
+     if (context->config.features & UCP_FEATURE_STREAM) {
+         ucp_ep_config_print_tag_proto(stream, "stream_send",
+                                       config->am.max_eager_short,
+                                       config->am.zcopy_thresh[0],
+                                       SIZE_MAX, SIZE_MAX);
+     }
+
+     if (context->config.features & UCP_FEATURE_AM) {
+         ucp_ep_config_print_tag_proto(stream, "am_send",
+                                       config->am.max_eager_short,
+                                       config->am.zcopy_thresh[0],
+                                       SIZE_MAX, SIZE_MAX);
      }
 
      if (context->config.features & UCP_FEATURE_RMA) {
@@ -1029,15 +1296,7 @@ size_t ucp_ep_config_get_zcopy_auto_thresh(size_t iovcnt,
                                            const ucp_context_h context,
                                            double bandwidth)
 {
-    double zcopy_thresh;
-    double bcopy_bw = context->config.ext.bcopy_bw;
-
-    zcopy_thresh = (iovcnt * reg_cost->overhead) /
-                   ((1.0 / bcopy_bw) - (1.0 / bandwidth) - (iovcnt * reg_cost->growth));
-
-    if ((zcopy_thresh < 0.0) || (zcopy_thresh > SIZE_MAX)) {
-        return SIZE_MAX;
-    }
-
-    return zcopy_thresh;
+    return ucp_ep_config_calc_zcopy_thresh(iovcnt, reg_cost,
+                                           context->config.ext.bcopy_bw,
+                                           bandwidth);
 }
@@ -10,6 +10,7 @@
 #include "ucp_types.h"
 
 #include <uct/api/uct.h>
+#include <ucs/datastruct/list_types.h>
 #include <ucs/debug/log.h>
 #include <ucs/stats/stats.h>
 #include <limits.h>
@@ -62,9 +63,12 @@ typedef struct ucp_ep_config_key {
     } lanes[UCP_MAX_LANES];
 
     ucp_lane_index_t       am_lane;      /* Lane for AM (can be NULL) */
-    ucp_lane_index_t       rndv_lane;    /* Lane for zcopy Rendezvous (can be NULL) */
     ucp_lane_index_t       wireup_lane;  /* Lane for wireup messages (can be NULL) */
 
+    /* Lanes for zcopy Rendezvous, sorted by bandwidth, highest first. All of
+     * them share the same local and remote memory domains. */
+    ucp_lane_index_t       rndv_lanes[UCP_MAX_LANES];
+
     /* Lanes for remote memory access, sorted by priority, highest first */
     ucp_lane_index_t       rma_lanes[UCP_MAX_LANES];
 
@@ -79,6 +83,30 @@ typedef struct ucp_ep_config_key {
 } ucp_ep_config_key_t;
 
 
+/*
+ * Send protocols whose bandwidth is measured to tune the thresholds
+ */
+enum {
+    UCP_EP_TUNE_PROTO_BCOPY,
+    UCP_EP_TUNE_PROTO_ZCOPY,
+    UCP_EP_TUNE_PROTO_RNDV,
+    UCP_EP_TUNE_PROTO_LAST
+};
+
+
+/*
+ * Sums for a least-squares fit of send time to message size, over a window
+ * of completed sends
+ */
+typedef struct ucp_ep_tune_stats {
+    double                 count;
+    double                 sum_size;
+    double                 sum_time;
+    double                 sum_size2;
+    double                 sum_size_time;
+} ucp_ep_tune_stats_t;
+
+
 /*
  * Configuration for RMA protocols
  */
@@ -125,13 +153,31 @@ typedef struct ucp_ep_config {
     size_t                     bcopy_thresh;
 
     struct {
-        /* Maximal total size of rndv_get_zcopy */
-        size_t                 max_get_zcopy;
+        /* Number of lanes used for zcopy Rendezvous */
+        ucp_lane_index_t       num_lanes;
+        /* Maximal total size of rndv_get_zcopy, per rendezvous lane */
+        size_t                 max_get_zcopy[UCP_MAX_LANES];
+        /* Bandwidth of each rendezvous lane relative to the first one */
+        double                 bw_scale[UCP_MAX_LANES];
         /* Threshold for switching from eager to RMA based rendezvous */
         size_t                 rma_thresh;
         /* Threshold for switching from eager to AM based rendezvous */
         size_t                 am_thresh;
+        /* Fragment size of the pipelined rendezvous, 0 if not supported */
+        size_t                 frag_size;
     } rndv;
+
+    /* Runtime tuning of the zero-copy and rendezvous thresholds */
+    struct {
+        /* Statistics of the current and the previous window, per protocol */
+        ucp_ep_tune_stats_t    cur[UCP_EP_TUNE_PROTO_LAST];
+        ucp_ep_tune_stats_t    prev[UCP_EP_TUNE_PROTO_LAST];
+        /* Measured bandwidth, per protocol, 0 if not known yet */
+        double                 bw[UCP_EP_TUNE_PROTO_LAST];
+        /* Number of times the thresholds were recalculated */
+        unsigned               count;
+        uint8_t                enabled;
+    } tune;
 } ucp_ep_config_t;
 
 
@@ -149,6 +195,11 @@ typedef struct ucp_ep {
 
     UCS_STATS_NODE_DECLARE(stats);
 
+    struct {
+        ucs_list_link_t           rdesc_list;    /* Received data not consumed yet */
+        ucs_list_link_t           recv_list;     /* Posted receives, waiting for data */
+    } stream;
+
 #if ENABLE_DEBUG_DATA
     char                          peer_name[UCP_WORKER_NAME_MAX];
 #endif
@@ -192,4 +243,9 @@ size_t ucp_ep_config_get_zcopy_auto_thresh(size_t iovcnt,
                                            const ucp_context_h context,
                                            double bandwidth);
 
+double ucp_ep_tune_stats_bw(const ucp_ep_tune_stats_t *stats);
+
+void ucp_ep_config_tune_sample(ucp_worker_h worker, ucp_ep_config_t *config,
+                               unsigned proto, size_t length, ucs_time_t time);
+
 #endif
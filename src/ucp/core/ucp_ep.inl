@@ -34,13 +34,13 @@ static inline ucp_lane_index_t ucp_ep_get_wireup_msg_lane(ucp_ep_h ep)
 
 static inline ucp_lane_index_t ucp_ep_get_rndv_get_lane(ucp_ep_h ep)
 {
-    ucs_assert(ucp_ep_config(ep)->key.rndv_lane != UCP_NULL_RESOURCE);
-    return ucp_ep_config(ep)->key.rndv_lane;
+    ucs_assert(ucp_ep_config(ep)->key.rndv_lanes[0] != UCP_NULL_RESOURCE);
+    return ucp_ep_config(ep)->key.rndv_lanes[0];
 }
 
 static inline int ucp_ep_is_rndv_lane_present(ucp_ep_h ep)
 {
-    return ucp_ep_config(ep)->key.rndv_lane != UCP_NULL_RESOURCE;
+    return ucp_ep_config(ep)->key.rndv_lanes[0] != UCP_NULL_RESOURCE;
 }
 
 static inline uct_ep_h ucp_ep_get_am_uct_ep(ucp_ep_h ep)
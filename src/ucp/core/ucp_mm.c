@@ -6,6 +6,7 @@
 
 #include "ucp_mm.h"
 #include "ucp_context.h"
+#include "ucp_worker.h"
 
 #include <ucs/debug/log.h>
 #include <ucs/debug/memtrack.h>
@@ -444,3 +445,73 @@ ucp_mem_advise(ucp_context_h context, ucp_mem_h memh,
     UCP_THREAD_CS_EXIT(&context->mt_lock);
     return status;
 }
+
+static size_t ucp_reg_mpool_hdr_size(ucp_context_h context)
+{
+    return ucs_align_up_pow2(sizeof(ucp_mem_t) +
+                             context->num_mds * sizeof(uct_mem_h),
+                             UCS_SYS_CACHE_LINE_SIZE);
+}
+
+static ucs_status_t ucp_reg_mpool_chunk_alloc(ucs_mpool_t *mp, size_t *size_p,
+                                              void **chunk_p)
+{
+    ucp_worker_h worker   = *(ucp_worker_h*)ucs_mpool_priv(mp);
+    ucp_context_h context = worker->context;
+    size_t hdr_size       = ucp_reg_mpool_hdr_size(context);
+    ucs_status_t status;
+    ucp_mem_h memh;
+    size_t length;
+    void *ptr;
+
+    length = hdr_size + *size_p;
+    status = ucs_mpool_chunk_mmap(mp, &length, &ptr);
+    if (status != UCS_OK) {
+        return status;
+    }
+
+    /* The memory handle is kept at the beginning of the chunk */
+    memh               = ptr;
+    memh->address      = ptr + hdr_size;
+    memh->length       = length - hdr_size;
+    memh->alloc_method = UCT_ALLOC_METHOD_LAST;
+    memh->alloc_md     = NULL;
+
+    status = ucp_memh_reg_mds(context, memh, 0, UCT_MEM_HANDLE_NULL);
+    if (status != UCS_OK) {
+        ucs_error("mpool %s: failed to register %zu bytes", ucs_mpool_name(mp),
+                  memh->length);
+        ucs_mpool_chunk_munmap(mp, ptr);
+        return status;
+    }
+
+    *size_p  = memh->length;
+    *chunk_p = memh->address;
+    return UCS_OK;
+}
+
+static void ucp_reg_mpool_chunk_release(ucs_mpool_t *mp, void *chunk)
+{
+    ucp_worker_h worker   = *(ucp_worker_h*)ucs_mpool_priv(mp);
+    ucp_context_h context = worker->context;
+    ucp_mem_h memh        = chunk - ucp_reg_mpool_hdr_size(context);
+    uct_mem_h dummy_memh;
+
+    ucp_memh_dereg_mds(context, memh, &dummy_memh);
+    ucs_mpool_chunk_munmap(mp, memh);
+}
+
+static void ucp_reg_mpool_obj_init(ucs_mpool_t *mp, void *obj, void *chunk)
+{
+    ucp_worker_h worker  = *(ucp_worker_h*)ucs_mpool_priv(mp);
+    ucp_mem_desc_t *desc = obj;
+
+    desc->memh = chunk - ucp_reg_mpool_hdr_size(worker->context);
+}
+
+ucs_mpool_ops_t ucp_reg_mpool_ops = {
+    .chunk_alloc   = ucp_reg_mpool_chunk_alloc,
+    .chunk_release = ucp_reg_mpool_chunk_release,
+    .obj_init      = ucp_reg_mpool_obj_init,
+    .obj_cleanup   = NULL
+};
@@ -12,9 +12,14 @@
 #include <ucp/core/ucp_ep.h>
 #include <uct/api/uct.h>
 #include <ucs/arch/bitops.h>
+#include <ucs/datastruct/khash.h>
+#include <ucs/datastruct/list.h>
+#include <ucs/datastruct/mpool.h>
 #include <ucs/debug/log.h>
+#include <ucs/sys/math.h>
 
 #include <inttypes.h>
+#include <string.h>
 
 
 /**
@@ -54,8 +59,117 @@ typedef struct ucp_mem {
 } ucp_mem_t;
 
 
+/**
+ * Header of a memory pool element, which is registered on all memory domains.
+ * The memory pool private area holds the worker which owns the pool.
+ */
+typedef struct ucp_mem_desc {
+    ucp_mem_h                     memh;         /* Handle of the containing chunk */
+} ucp_mem_desc_t;
+
+
+/**
+ * Identifies a packed remote key: the remote worker which packed it, and the
+ * packed key bytes.
+ */
+typedef struct ucp_rkey_cache_key {
+    uint64_t                      sender_uuid;  /* Worker which packed the key */
+    const void                    *buffer;      /* Packed key */
+    size_t                        size;         /* Size of the packed key */
+} ucp_rkey_cache_key_t;
+
+
+/**
+ * Cached unpacked remote key. The packed key bytes follow the structure.
+ */
+typedef struct ucp_rkey_cache_entry {
+    ucp_rkey_cache_key_t          key;
+    uct_rkey_bundle_t             rkey_bundle;  /* Unpacked key */
+    unsigned                      refcount;     /* Number of users of the key */
+    ucs_list_link_t               list;         /* Entry in the LRU list, when
+                                                   the key is not used */
+} ucp_rkey_cache_entry_t;
+
+
+static inline khint32_t ucp_rkey_cache_key_hash(ucp_rkey_cache_key_t key)
+{
+    return ucs_calc_crc32(kh_int64_hash_func(key.sender_uuid), key.buffer,
+                          key.size);
+}
+
+#define ucp_rkey_cache_key_equal(_key1, _key2) \
+    (((_key1).sender_uuid == (_key2).sender_uuid) && \
+     ((_key1).size == (_key2).size) && \
+     !memcmp((_key1).buffer, (_key2).buffer, (_key1).size))
+
+KHASH_INIT(ucp_rkey_cache_hash, ucp_rkey_cache_key_t, ucp_rkey_cache_entry_t*,
+           1, ucp_rkey_cache_key_hash, ucp_rkey_cache_key_equal);
+
+
+/**
+ * Cache of unpacked remote keys, so repeated transfers from the same remote
+ * buffer would not unpack its key again. Keys which are not used by any
+ * request are kept on an LRU list, and the least recently used ones are
+ * released when the cache exceeds its maximal size. Keys in use are never
+ * released, so the size may be exceeded temporarily.
+ */
+typedef struct ucp_rkey_cache {
+    khash_t(ucp_rkey_cache_hash)  hash;         /* Cached keys */
+    ucs_list_link_t               lru;          /* Unused keys, least recently
+                                                   used first */
+    unsigned                      count;        /* Number of cached keys */
+    unsigned                      max_count;    /* Maximal number of keys */
+} ucp_rkey_cache_t;
+
+
+extern ucs_mpool_ops_t ucp_reg_mpool_ops;
+
+
 void ucp_rkey_resolve_inner(ucp_rkey_h rkey, ucp_ep_h ep);
 
+void ucp_rkey_cache_init(ucp_rkey_cache_t *cache, unsigned max_count);
+
+void ucp_rkey_cache_cleanup(ucp_rkey_cache_t *cache);
+
+/**
+ * Find or unpack a remote key, and take a reference to it.
+ *
+ * @param [in]  cache        Cache to look up.
+ * @param [in]  sender_uuid  Remote worker which packed the key.
+ * @param [in]  buffer       Packed key.
+ * @param [in]  size         Size of the packed key.
+ * @param [out] entry_p      Filled with the cached key, which must be released
+ *                           by @ref ucp_rkey_cache_put.
+ */
+ucs_status_t ucp_rkey_cache_get(ucp_rkey_cache_t *cache, uint64_t sender_uuid,
+                                const void *buffer, size_t size,
+                                ucp_rkey_cache_entry_t **entry_p);
+
+void ucp_rkey_cache_put(ucp_rkey_cache_t *cache, ucp_rkey_cache_entry_t *entry);
+
+/**
+ * Release the unused keys which were packed by a remote worker. Keys which are
+ * still in use are released by the LRU policy after they are put.
+ *
+ * @param [in]  cache        Cache to purge.
+ * @param [in]  sender_uuid  Remote worker whose keys to release.
+ */
+void ucp_rkey_cache_purge_sender(ucp_rkey_cache_t *cache, uint64_t sender_uuid);
+
+
+/**
+ * @return UCT memory handle of a memory domain, or UCT_MEM_HANDLE_NULL if the
+ *         memory is not registered on it.
+ */
+static inline uct_mem_h ucp_memh2uct(ucp_mem_h memh, ucp_md_index_t md_index)
+{
+    if (!(memh->md_map & UCS_BIT(md_index))) {
+        return UCT_MEM_HANDLE_NULL;
+    }
+
+    return memh->uct[ucs_count_one_bits(memh->md_map & UCS_MASK(md_index))];
+}
+
 
 #define UCP_RKEY_RESOLVE(_rkey, _ep, _op_type) \
     ({ \
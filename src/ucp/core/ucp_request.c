@@ -34,6 +34,20 @@ ucs_status_t ucp_request_test(void *request, ucp_tag_recv_info_t *info)
     return UCS_INPROGRESS;
 }
 
+ucs_status_t ucp_stream_recv_request_test(void *request, size_t *length_p)
+{
+    ucp_request_t *req = (ucp_request_t*)request - 1;
+
+    ucs_assert(req->flags & UCP_REQUEST_FLAG_STREAM_RECV);
+
+    if (req->flags & UCP_REQUEST_FLAG_COMPLETED) {
+        *length_p = req->recv.state.offset;
+        ucs_assert(req->status != UCS_INPROGRESS);
+        return req->status;
+    }
+    return UCS_INPROGRESS;
+}
+
 static UCS_F_ALWAYS_INLINE void
 ucp_request_release_common(void *request, uint8_t cb_flag, const char *debug_name)
 {
@@ -42,6 +56,19 @@ ucp_request_release_common(void *request, uint8_t cb_flag, const char *debug_nam
                                                         ucp_worker_t, req_mp);
     uint16_t flags;
 
+    /* A completed request is no longer accessed by the worker, and the request
+     * pool is thread-safe in multi-threaded mode, so it can be returned without
+     * taking the worker lock */
+    flags = req->flags;
+    if (ucs_likely(flags & UCP_REQUEST_FLAG_COMPLETED)) {
+        ucs_trace_req("%s request %p (%p) "UCP_REQUEST_FLAGS_FMT, debug_name,
+                      req, req + 1, UCP_REQUEST_FLAGS_ARG(flags));
+        ucs_assert(!(flags & UCP_REQUEST_DEBUG_FLAG_EXTERNAL));
+        ucs_assert(!(flags & UCP_REQUEST_FLAG_RELEASED));
+        ucp_request_put(req);
+        return;
+    }
+
     UCP_THREAD_CS_ENTER_CONDITIONAL(&worker->mt_lock);
 
     flags = req->flags;
@@ -89,6 +116,13 @@ UCS_PROFILE_FUNC_VOID(ucp_request_cancel, (worker, request),
         ucp_request_complete_recv(req, UCS_ERR_CANCELED);
 
         UCP_THREAD_CS_EXIT_CONDITIONAL(&worker->context->mt_lock);
+        UCP_THREAD_CS_EXIT_CONDITIONAL(&worker->mt_lock);
+    } else if (req->flags & UCP_REQUEST_FLAG_STREAM_RECV) {
+        UCP_THREAD_CS_ENTER_CONDITIONAL(&worker->mt_lock);
+
+        ucs_list_del(&req->recv.list);
+        ucp_request_complete_stream_recv(req, UCS_ERR_CANCELED);
+
         UCP_THREAD_CS_EXIT_CONDITIONAL(&worker->mt_lock);
     }
 }
@@ -116,8 +150,8 @@ static void ucp_worker_request_fini_proxy(ucs_mpool_t *mp, void *obj)
 }
 
 ucs_mpool_ops_t ucp_request_mpool_ops = {
-    .chunk_alloc   = ucs_mpool_hugetlb_malloc,
-    .chunk_release = ucs_mpool_hugetlb_free,
+    .chunk_alloc   = ucs_mpool_chunk_mmap,
+    .chunk_release = ucs_mpool_chunk_munmap,
     .obj_init      = ucp_worker_request_init_proxy,
     .obj_cleanup   = ucp_worker_request_fini_proxy
 };
@@ -171,6 +205,7 @@ UCS_PROFILE_FUNC(ucs_status_t, ucp_request_send_buffer_reg, (req, lane),
 {
     uct_md_h uct_md       = ucp_ep_md(req->send.ep, lane);
     ucp_dt_state_t *state = &req->send.state;
+    ucp_dt_strided_t *dt_strided;
     size_t iov_it, iovcnt;
     const ucp_dt_iov_t *iov;
     uct_mem_h *memh;
@@ -182,6 +217,14 @@ UCS_PROFILE_FUNC(ucs_status_t, ucp_request_send_buffer_reg, (req, lane),
         status = uct_md_mem_reg(uct_md, (void *)req->send.buffer, req->send.length,
                                 0, &state->dt.contig.memh);
         break;
+    case UCP_DATATYPE_STRIDED:
+        /* register the memory spanned by all items, to send any block */
+        dt_strided = ucp_dt_strided(req->send.datatype);
+        status     = uct_md_mem_reg(uct_md, (void *)req->send.buffer,
+                                    (req->send.length / dt_strided->length) *
+                                    dt_strided->extent, 0,
+                                    &state->dt.strided.memh);
+        break;
     case UCP_DATATYPE_IOV:
         iovcnt = state->dt.iov.iovcnt;
         iov    = req->send.buffer;
@@ -236,6 +279,11 @@ UCS_PROFILE_FUNC_VOID(ucp_request_send_buffer_dereg, (req, lane),
             uct_md_mem_dereg(uct_md, state->dt.contig.memh);
         }
         break;
+    case UCP_DATATYPE_STRIDED:
+        if (state->dt.strided.memh != UCT_MEM_HANDLE_NULL) {
+            uct_md_mem_dereg(uct_md, state->dt.strided.memh);
+        }
+        break;
     case UCP_DATATYPE_IOV:
         memh = state->dt.iov.memh;
         for (iov_it = 0; iov_it < state->dt.iov.iovcnt; ++iov_it) {
@@ -14,6 +14,7 @@
 #include <ucp/api/ucp.h>
 #include <uct/api/uct.h>
 #include <ucs/datastruct/mpool.h>
+#include <ucs/datastruct/list_types.h>
 #include <ucs/datastruct/queue_types.h>
 #include <ucp/dt/dt.h>
 #include <ucp/wireup/wireup.h>
@@ -33,6 +34,9 @@ enum {
     UCP_REQUEST_FLAG_RECV                 = UCS_BIT(7),
     UCP_REQUEST_FLAG_SYNC                 = UCS_BIT(8),
     UCP_REQUEST_FLAG_RNDV                 = UCS_BIT(9),
+    UCP_REQUEST_FLAG_STREAM_RECV          = UCS_BIT(10),
+    UCP_REQUEST_FLAG_STREAM_RECV_WAITALL  = UCS_BIT(11),
+    UCP_REQUEST_FLAG_TUNE                 = UCS_BIT(12),
 
 #if ENABLE_ASSERT
     UCP_REQUEST_DEBUG_FLAG_EXTERNAL       = UCS_BIT(15)
@@ -75,9 +79,20 @@ struct ucp_request {
             ucp_send_callback_t   cb;       /* Completion callback */
 
             union {
-                ucp_tag_t         tag;      /* Tagged send */
+                struct {
+                    ucp_tag_t     tag;      /* Tagged send */
+                    uint64_t      msg_id;   /* Message id, to identify the
+                                               fragments of a message */
+                };
                 ucp_wireup_msg_t  wireup;
 
+                struct {
+                    uint64_t      msg_id;   /* Message id, to identify the
+                                               fragments of a message */
+                    uint16_t      id;       /* User active message id */
+                    uint16_t      flags;    /* ucp_am_send_flags */
+                } am;
+
                 struct {
                     uint64_t      remote_addr; /* Remote address */
                     ucp_rkey_h    rkey;     /* Remote memory key */
@@ -95,11 +110,21 @@ struct ucp_request {
                     ucp_stub_ep_t*    stub_ep;
                 } proxy;
 
+                struct {
+                    uintptr_t     rreq_ptr; /* receive request ptr on the recv side */
+                    unsigned      inflight; /* number of fragments in flight */
+                    uint8_t       stalled;  /* waiting for a fragment to complete */
+                    ucs_status_t  status;   /* first fragment error */
+                    ucs_callbackq_slow_elem_t cbq_elem; /* Resume after a stall */
+                } rndv_pipe;
+
                 struct {
                     uint64_t      remote_address; /* address of the sender's data buffer */
                     uintptr_t     remote_request; /* pointer to the sender's send request */
-                    uct_rkey_bundle_t rkey_bundle;
+                    uct_rkey_t    rkey;     /* key of the sender's data buffer */
+                    struct ucp_rkey_cache_entry *rkey_entry; /* cached key, or NULL */
                     ucp_request_t *rreq;    /* receive request on the recv side */
+                    ucp_lane_index_t lane_idx; /* rendezvous lane of the next fragment */
                 } rndv_get;
 
                 struct {
@@ -117,6 +142,11 @@ struct ucp_request {
                 } amo;
             };
 
+            struct {
+                ucs_time_t        start_time; /* When the send was started */
+                uint8_t           proto;      /* Protocol whose bandwidth is measured */
+            } tune;
+
             ucp_lane_index_t      lane;     /* Lane on which this request is being sent */
             ucp_dt_state_t        state;    /* Position in the send buffer */
             uct_pending_req_t     uct;      /* UCT pending request */
@@ -124,13 +154,19 @@ struct ucp_request {
         } send;
 
         struct {
-            ucs_queue_elem_t      queue;    /* Expected queue element */
+            ucs_list_link_t       list;     /* Element in expected queue */
+            uint64_t              sn;       /* Sequence number in expected queue */
+            ucp_tag_frag_key_t    frag;     /* Message being received, if it
+                                               has more than one fragment */
             void                  *buffer;  /* Buffer to receive data to */
             ucp_datatype_t        datatype; /* Receive type */
             size_t                length;   /* Total length, in bytes */
             ucp_tag_t             tag;      /* Expected tag */
             ucp_tag_t             tag_mask; /* Expected tag mask */
-            ucp_tag_recv_callback_t cb;     /* Completion callback */
+            union {
+                ucp_tag_recv_callback_t    cb;        /* Completion callback */
+                ucp_stream_recv_callback_t stream_cb; /* Stream completion callback */
+            };
             ucp_tag_recv_info_t   info;     /* Completion info to fill */
             ucp_dt_state_t        state;
         } recv;
@@ -142,7 +178,13 @@ struct ucp_request {
  * Unexpected receive descriptor.
  */
 typedef struct ucp_recv_desc {
-    ucs_queue_elem_t              queue;    /* Queue element */
+    union {
+        ucs_list_link_t           tag_list[UCP_RDESC_LAST]; /* Unexpected queue lists */
+        struct {
+            ucs_list_link_t       list;     /* Element in endpoint stream queue */
+            size_t                offset;   /* Offset of the data not consumed yet */
+        } stream;
+    };
     size_t                        length;   /* Received length */
     uint16_t                      hdr_len;  /* Header size */
     uint16_t                      flags;    /* Flags */
@@ -123,6 +123,12 @@ ucp_request_complete_send(ucp_request_t *req, ucs_status_t status)
                   req, req + 1, UCP_REQUEST_FLAGS_ARG(req->flags),
                   ucs_status_string(status));
     UCS_PROFILE_REQUEST_EVENT(req, "complete_send", status);
+    if (ucs_unlikely(req->flags & UCP_REQUEST_FLAG_TUNE) && (status == UCS_OK)) {
+        ucp_ep_config_tune_sample(req->send.ep->worker,
+                                  ucp_ep_config(req->send.ep),
+                                  req->send.tune.proto, req->send.length,
+                                  ucs_get_time() - req->send.tune.start_time);
+    }
     ucp_request_complete(req, send.cb, status);
 }
 
@@ -160,6 +166,18 @@ void ucp_request_recv_generic_dt_finish(ucp_request_t *req)
     }
 }
 
+static UCS_F_ALWAYS_INLINE void
+ucp_request_complete_stream_recv(ucp_request_t *req, ucs_status_t status)
+{
+    ucs_trace_req("completing stream receive request %p (%p) "
+                  UCP_REQUEST_FLAGS_FMT" len %zu, %s",
+                  req, req + 1, UCP_REQUEST_FLAGS_ARG(req->flags),
+                  req->recv.state.offset, ucs_status_string(status));
+    ucp_request_recv_generic_dt_finish(req);
+    UCS_PROFILE_REQUEST_EVENT(req, "complete_stream_recv", status);
+    ucp_request_complete(req, recv.stream_cb, status, req->recv.state.offset);
+}
+
 static UCS_F_ALWAYS_INLINE void 
 ucp_request_wait_uct_comp(ucp_request_t *req)
 {
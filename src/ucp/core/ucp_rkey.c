@@ -8,6 +8,7 @@
 #include "ucp_request.h"
 #include "ucp_ep.inl"
 
+#include <ucs/debug/profile.h>
 #include <inttypes.h>
 
 
@@ -273,3 +274,134 @@ void ucp_rkey_resolve_inner(ucp_rkey_h rkey, ucp_ep_h ep)
               ep->cfg_index, rkey->cache.rma_lane, rkey->cache.amo_lane);
 }
 
+
+void ucp_rkey_cache_init(ucp_rkey_cache_t *cache, unsigned max_count)
+{
+    kh_init_inplace(ucp_rkey_cache_hash, &cache->hash);
+    ucs_list_head_init(&cache->lru);
+    cache->count     = 0;
+    cache->max_count = max_count;
+}
+
+static void ucp_rkey_cache_release(ucp_rkey_cache_t *cache,
+                                   ucp_rkey_cache_entry_t *entry)
+{
+    khiter_t iter;
+
+    ucs_trace("releasing cached rkey 0x%lx from uuid 0x%"PRIx64,
+              entry->rkey_bundle.rkey, entry->key.sender_uuid);
+
+    iter = kh_get(ucp_rkey_cache_hash, &cache->hash, entry->key);
+    ucs_assert(iter != kh_end(&cache->hash));
+    kh_del(ucp_rkey_cache_hash, &cache->hash, iter);
+    --cache->count;
+
+    uct_rkey_release(&entry->rkey_bundle);
+    ucs_free(entry);
+}
+
+/* Release unused keys, least recently used first, to fit the maximal size */
+static void ucp_rkey_cache_purge(ucp_rkey_cache_t *cache)
+{
+    ucp_rkey_cache_entry_t *entry;
+
+    while ((cache->count > cache->max_count) && !ucs_list_is_empty(&cache->lru)) {
+        entry = ucs_list_extract_head(&cache->lru, ucp_rkey_cache_entry_t, list);
+        ucp_rkey_cache_release(cache, entry);
+    }
+}
+
+void ucp_rkey_cache_purge_sender(ucp_rkey_cache_t *cache, uint64_t sender_uuid)
+{
+    ucp_rkey_cache_entry_t *entry, *tmp;
+
+    ucs_list_for_each_safe(entry, tmp, &cache->lru, list) {
+        if (entry->key.sender_uuid == sender_uuid) {
+            ucs_list_del(&entry->list);
+            ucp_rkey_cache_release(cache, entry);
+        }
+    }
+}
+
+void ucp_rkey_cache_cleanup(ucp_rkey_cache_t *cache)
+{
+    cache->max_count = 0;
+    ucp_rkey_cache_purge(cache);
+    if (cache->count > 0) {
+        ucs_warn("%u cached remote keys are still in use", cache->count);
+    }
+    kh_destroy_inplace(ucp_rkey_cache_hash, &cache->hash);
+}
+
+ucs_status_t ucp_rkey_cache_get(ucp_rkey_cache_t *cache, uint64_t sender_uuid,
+                                const void *buffer, size_t size,
+                                ucp_rkey_cache_entry_t **entry_p)
+{
+    ucp_rkey_cache_entry_t *entry;
+    ucp_rkey_cache_key_t key;
+    ucs_status_t status;
+    khiter_t iter;
+    int ret;
+
+    key.sender_uuid = sender_uuid;
+    key.buffer      = buffer;
+    key.size        = size;
+
+    iter = kh_get(ucp_rkey_cache_hash, &cache->hash, key);
+    if (iter != kh_end(&cache->hash)) {
+        entry = kh_value(&cache->hash, iter);
+        if (entry->refcount++ == 0) {
+            ucs_list_del(&entry->list);
+        }
+        *entry_p = entry;
+        return UCS_OK;
+    }
+
+    entry = ucs_malloc(sizeof(*entry) + size, "ucp_rkey_cache_entry");
+    if (entry == NULL) {
+        return UCS_ERR_NO_MEMORY;
+    }
+
+    status = UCS_PROFILE_CALL(uct_rkey_unpack, buffer, &entry->rkey_bundle);
+    if (status != UCS_OK) {
+        goto err_free;
+    }
+
+    memcpy(entry + 1, buffer, size);
+    entry->key.sender_uuid = sender_uuid;
+    entry->key.buffer      = entry + 1;
+    entry->key.size        = size;
+    entry->refcount        = 1;
+
+    iter = kh_put(ucp_rkey_cache_hash, &cache->hash, entry->key, &ret);
+    if (iter == kh_end(&cache->hash)) {
+        status = UCS_ERR_NO_MEMORY;
+        goto err_release;
+    }
+
+    kh_value(&cache->hash, iter) = entry;
+    ++cache->count;
+    ucs_trace("cached rkey 0x%lx from uuid 0x%"PRIx64, entry->rkey_bundle.rkey,
+              sender_uuid);
+
+    ucp_rkey_cache_purge(cache);
+    *entry_p = entry;
+    return UCS_OK;
+
+err_release:
+    uct_rkey_release(&entry->rkey_bundle);
+err_free:
+    ucs_free(entry);
+    return status;
+}
+
+void ucp_rkey_cache_put(ucp_rkey_cache_t *cache, ucp_rkey_cache_entry_t *entry)
+{
+    ucs_assert(entry->refcount > 0);
+    if (--entry->refcount > 0) {
+        return;
+    }
+
+    ucs_list_add_tail(&cache->lru, &entry->list);
+    ucp_rkey_cache_purge(cache);
+}
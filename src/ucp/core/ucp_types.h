@@ -65,6 +65,14 @@ enum {
                                           rndv (bcopy) */
     UCP_AM_ID_RNDV_DATA_LAST    =  13, /* The last rndv data fragment when using
                                           software rndv (bcopy) */
+    UCP_AM_ID_STREAM_DATA       =  14, /* Stream data fragment */
+
+    UCP_AM_ID_AM_SINGLE         =  15, /* Single packet user active message */
+    UCP_AM_ID_AM_SINGLE_REPLY   =  16, /* Single packet user active message,
+                                          with the sender uuid for a reply */
+    UCP_AM_ID_AM_FIRST          =  17, /* First user active message fragment */
+    UCP_AM_ID_AM_MIDDLE         =  18, /* Middle or last user active message
+                                          fragment */
     UCP_AM_ID_LAST
 };
 
@@ -8,12 +8,21 @@
 #include "ucp_worker.h"
 #include "ucp_request.inl"
 
+#include <ucp/am/am.h>
 #include <ucp/wireup/address.h>
 #include <ucp/wireup/stub_ep.h>
 #include <ucp/tag/eager.h>
+#include <ucp/tag/rndv.h>
+#include <ucs/arch/cpu.h>
 #include <ucs/datastruct/mpool.inl>
 #include <ucs/type/cpu_set.h>
 #include <ucs/sys/string.h>
+#include <sched.h>
+
+
+/* Maximal number of idle loop iterations between progress calls while polling
+ * in ucp_worker_wait(), before starting to yield the CPU */
+#define UCP_WORKER_WAIT_MAX_BACKOFF  1024
 
 
 #if ENABLE_STATS
@@ -33,8 +42,8 @@ static ucs_stats_class_t ucp_worker_stats_class = {
 
 
 ucs_mpool_ops_t ucp_am_mpool_ops = {
-    .chunk_alloc   = ucs_mpool_hugetlb_malloc,
-    .chunk_release = ucs_mpool_hugetlb_free,
+    .chunk_alloc   = ucs_mpool_chunk_mmap,
+    .chunk_release = ucs_mpool_chunk_munmap,
     .obj_init      = ucs_empty_function,
     .obj_cleanup   = ucs_empty_function
 };
@@ -140,10 +149,19 @@ static ucs_status_t ucp_worker_wakeup_context_init(ucp_worker_wakeup_t *wakeup,
         return UCS_ERR_NO_MEMORY;
     }
 
+    /* One entry for every interface, and one for the signal pipe */
+    wakeup->max_events = num_tls + 1;
+    wakeup->events     = ucs_malloc(wakeup->max_events * sizeof(*wakeup->events),
+                                    "ucp wakeup events");
+    if (wakeup->events == NULL) {
+        status = UCS_ERR_NO_MEMORY;
+        goto free_handles;
+    }
+
     if (pipe(wakeup->wakeup_pipe) != 0) {
         ucs_error("Failed to create pipe: %m");
         status = UCS_ERR_IO_ERROR;
-        goto free_handles;
+        goto free_events;
     }
 
     status = ucs_sys_fcntl_modfl(wakeup->wakeup_pipe[0], O_NONBLOCK, 0);
@@ -164,6 +182,8 @@ static ucs_status_t ucp_worker_wakeup_context_init(ucp_worker_wakeup_t *wakeup,
 pipe_cleanup:
     close(wakeup->wakeup_pipe[0]);
     close(wakeup->wakeup_pipe[1]);
+free_events:
+    ucs_free(wakeup->events);
 free_handles:
     ucs_free(wakeup->iface_wakeups);
     return status;
@@ -191,6 +211,7 @@ static void ucp_worker_wakeup_context_cleanup(ucp_worker_wakeup_t *wakeup)
     if (wakeup->wakeup_efd != -1) {
         close(wakeup->wakeup_efd);
     }
+    ucs_free(wakeup->events);
     ucs_free(wakeup->iface_wakeups);
     close(wakeup->wakeup_pipe[0]);
     close(wakeup->wakeup_pipe[1]);
@@ -451,6 +472,28 @@ static void ucp_worker_init_atomic_tls(ucp_worker_h worker)
     }
 }
 
+static unsigned ucp_worker_mpool_flags(ucp_worker_h worker)
+{
+    ucp_context_config_t *config = &worker->context->config.ext;
+    unsigned flags               = 0;
+
+    /* Requests and AM buffers may be allocated and released by any thread, so
+     * they use thread-safe pools to avoid serializing on the worker lock */
+    if (UCP_THREAD_IS_REQUIRED(&worker->mt_lock)) {
+        flags |= UCS_MPOOL_FLAG_THREAD_SAFE;
+    }
+    if (config->mpool_hugetlb) {
+        flags |= UCS_MPOOL_FLAG_HUGETLB;
+    }
+    if (config->mpool_numa_local) {
+        flags |= UCS_MPOOL_FLAG_NUMA_LOCAL;
+    }
+    if (config->mpool_prefault) {
+        flags |= UCS_MPOOL_FLAG_PREFAULT;
+    }
+    return flags;
+}
+
 static ucs_status_t ucp_worker_init_am_mpool(ucp_worker_h worker,
                                              size_t rx_headroom)
 {
@@ -473,9 +516,32 @@ static ucs_status_t ucp_worker_init_am_mpool(ucp_worker_h worker,
     return ucs_mpool_init(&worker->am_mp, 0,
                           max_am_mp_entry_size,
                           0, UCS_SYS_CACHE_LINE_SIZE, 128, UINT_MAX,
+                          ucp_worker_mpool_flags(worker),
                           &ucp_am_mpool_ops, "ucp_am_bufs");
 }
 
+static ucs_status_t ucp_worker_init_rndv_frag_mpool(ucp_worker_h worker)
+{
+    ucp_context_h context = worker->context;
+    ucs_status_t status;
+
+    /* Staging buffers are registered on all memory domains, so any lane could
+     * send from them. Chunks are allocated only when the pipelined rendezvous
+     * protocol is used. */
+    status = ucs_mpool_init(&worker->rndv_frag_mp, sizeof(ucp_worker_h),
+                            sizeof(ucp_rndv_frag_t) + context->config.ext.rndv_frag_size,
+                            sizeof(ucp_rndv_frag_t), UCS_SYS_CACHE_LINE_SIZE,
+                            ucs_max(context->config.ext.rndv_pipeline_depth, 1),
+                            UINT_MAX, ucp_worker_mpool_flags(worker),
+                            &ucp_reg_mpool_ops, "ucp_rndv_frags");
+    if (status != UCS_OK) {
+        return status;
+    }
+
+    *(ucp_worker_h*)ucs_mpool_priv(&worker->rndv_frag_mp) = worker;
+    return UCS_OK;
+}
+
 /* All the ucp endpoints will share the configurations. No need for every ep to
  * have it's own configuration (to save memory footprint). Same config can be used
  * by different eps.
@@ -554,6 +620,7 @@ ucs_status_t ucp_worker_create(ucp_context_h context,
 
     worker->context         = context;
     worker->uuid            = ucs_generate_uuid((uintptr_t)worker);
+    worker->msg_id          = 0;
     worker->stub_pend_count = 0;
     worker->inprogress      = 0;
     worker->ep_config_max   = config_count;
@@ -565,6 +632,9 @@ ucs_status_t ucp_worker_create(ucp_context_h context,
                       getpid());
 
     kh_init_inplace(ucp_worker_ep_hash, &worker->ep_hash);
+    ucp_am_worker_init(worker);
+    ucp_rkey_cache_init(&worker->rkey_cache,
+                        context->config.ext.rndv_rkey_cache_size);
 
     worker->ifaces = ucs_calloc(context->num_tls, sizeof(*worker->ifaces),
                                 "ucp iface");
@@ -607,6 +677,7 @@ ucs_status_t ucp_worker_create(ucp_context_h context,
     status = ucs_mpool_init(&worker->req_mp, 0,
                             sizeof(ucp_request_t) + context->config.request.size,
                             0, UCS_SYS_CACHE_LINE_SIZE, 128, UINT_MAX,
+                            ucp_worker_mpool_flags(worker),
                             &ucp_request_mpool_ops, "ucp_requests");
     if (status != UCS_OK) {
         goto err_destroy_uct_worker;
@@ -639,12 +710,20 @@ ucs_status_t ucp_worker_create(ucp_context_h context,
         goto err_close_ifaces;
     }
 
+    /* Init rendezvous staging buffers memory pool */
+    status = ucp_worker_init_rndv_frag_mpool(worker);
+    if (status != UCS_OK) {
+        goto err_am_mp_cleanup;
+    }
+
     /* Select atomic resources */
     ucp_worker_init_atomic_tls(worker);
 
     *worker_p = worker;
     return UCS_OK;
 
+err_am_mp_cleanup:
+    ucs_mpool_cleanup(&worker->am_mp, 1);
 err_close_ifaces:
     ucp_worker_close_ifaces(worker);
     ucs_mpool_cleanup(&worker->req_mp, 1);
@@ -661,6 +740,7 @@ err_free_attrs:
 err_free_ifaces:
     ucs_free(worker->ifaces);
 err_free:
+    ucp_rkey_cache_cleanup(&worker->rkey_cache);
     UCP_THREAD_LOCK_FINALIZE(&worker->mt_lock);
     ucs_free(worker);
     return status;
@@ -680,6 +760,9 @@ void ucp_worker_destroy(ucp_worker_h worker)
     ucs_trace_func("worker=%p", worker);
     ucp_worker_remove_am_handlers(worker);
     ucp_worker_destroy_eps(worker);
+    ucp_am_worker_cleanup(worker);
+    ucp_rkey_cache_cleanup(&worker->rkey_cache);
+    ucs_mpool_cleanup(&worker->rndv_frag_mp, 1);
     ucs_mpool_cleanup(&worker->am_mp, 1);
     ucp_worker_close_ifaces(worker);
     ucs_mpool_cleanup(&worker->req_mp, 1);
@@ -694,6 +777,40 @@ void ucp_worker_destroy(ucp_worker_h worker)
     ucs_free(worker);
 }
 
+ucs_status_t ucp_worker_set_am_handler(ucp_worker_h worker, uint16_t id,
+                                       ucp_am_callback_t cb, void *arg)
+{
+    ucp_worker_am_handler_t *handlers;
+    ucs_status_t status;
+    unsigned num_handlers;
+
+    UCP_THREAD_CS_ENTER_CONDITIONAL(&worker->mt_lock);
+
+    if (id >= worker->am.num_handlers) {
+        num_handlers = id + 1;
+        handlers     = ucs_realloc(worker->am.handlers,
+                                   num_handlers * sizeof(*handlers),
+                                   "ucp_am_handlers");
+        if (handlers == NULL) {
+            status = UCS_ERR_NO_MEMORY;
+            goto out;
+        }
+
+        memset(handlers + worker->am.num_handlers, 0,
+               (num_handlers - worker->am.num_handlers) * sizeof(*handlers));
+        worker->am.handlers     = handlers;
+        worker->am.num_handlers = num_handlers;
+    }
+
+    worker->am.handlers[id].cb  = cb;
+    worker->am.handlers[id].arg = arg;
+    status = UCS_OK;
+
+out:
+    UCP_THREAD_CS_EXIT_CONDITIONAL(&worker->mt_lock);
+    return status;
+}
+
 ucs_status_t ucp_worker_query(ucp_worker_h worker,
                               ucp_worker_attr_t *attr)
 {
@@ -708,21 +825,25 @@ ucs_status_t ucp_worker_query(ucp_worker_h worker,
     return UCS_OK;
 }
 
-void ucp_worker_progress(ucp_worker_h worker)
+unsigned ucp_worker_progress(ucp_worker_h worker)
 {
+    unsigned count;
+
     /* worker->inprogress is used only for assertion check.
      * coverity[assert_side_effect]
      */
     UCP_THREAD_CS_ENTER_CONDITIONAL(&worker->mt_lock);
 
     ucs_assert(worker->inprogress++ == 0);
-    uct_worker_progress(worker->uct);
+    count = uct_worker_progress(worker->uct);
     ucs_async_check_miss(&worker->async);
 
     /* coverity[assert_side_effect] */
     ucs_assert(--worker->inprogress == 0);
 
     UCP_THREAD_CS_EXIT_CONDITIONAL(&worker->mt_lock);
+
+    return count;
 }
 
 ucs_status_t ucp_worker_get_efd(ucp_worker_h worker, int *fd)
@@ -816,55 +937,153 @@ void ucp_worker_wait_mem(ucp_worker_h worker, void *address)
    ucs_arch_wait_mem(address);
 }
 
-ucs_status_t ucp_worker_wait(ucp_worker_h worker)
+/*
+ * Progress the worker until it finds events, or until the deadline expires.
+ * While the worker is idle, the delay between progress calls grows
+ * exponentially, and once it reaches the limit the thread yields the CPU
+ * between calls.
+ *
+ * @return Non-zero if any events were processed.
+ */
+static unsigned ucp_worker_wait_poll(ucp_worker_h worker, ucs_time_t deadline)
 {
-    int res;
-    int epoll_fd;
-    ucs_status_t status;
-    struct epoll_event *events;
-    ucp_context_h context = worker->context;
+    unsigned backoff, i;
 
-    UCP_THREAD_CS_ENTER_CONDITIONAL(&worker->mt_lock);
+    backoff = 1;
+    while (ucp_worker_progress(worker) == 0) {
+        if (ucs_get_time() >= deadline) {
+            return 0;
+        }
 
-    status = ucp_worker_get_efd(worker, &epoll_fd);
-    if (status != UCS_OK) {
-        goto out;
+        if (backoff < UCP_WORKER_WAIT_MAX_BACKOFF) {
+            for (i = 0; i < backoff; ++i) {
+                ucs_cpu_relax();
+            }
+            backoff *= 2;
+        } else {
+            sched_yield();
+        }
     }
 
-    status = ucp_worker_arm(worker);
-    if (UCS_ERR_BUSY == status) { /* if UCS_ERR_BUSY returned - no poll() must called */
-        status = UCS_OK;
-        goto out;
-    } else if (status != UCS_OK) {
-        goto out;
+    return 1;
+}
+
+/*
+ * Calculate the epoll_wait() timeout, in milliseconds, until the deadline.
+ * The timeout is also bounded by the shortest async timer of the worker, so
+ * timer events which were missed while the worker was blocked get handled.
+ *
+ * @return -1 for infinite timeout.
+ */
+static int ucp_worker_wait_epoll_timeout(ucp_worker_h worker,
+                                         ucs_time_t deadline, int *bounded_p)
+{
+    ucs_time_t timer_interval = ucs_async_get_timer_interval(&worker->async);
+    ucs_time_t now, timeout;
+
+    if (deadline == UCS_TIME_INFINITY) {
+        timeout = UCS_TIME_INFINITY;
+    } else {
+        now     = ucs_get_time();
+        timeout = (deadline > now) ? (deadline - now) : 0;
     }
 
-    events = ucs_malloc(context->num_tls * sizeof(*events), "wakeup events");
-    if (events == NULL) {
-        status = UCS_ERR_NO_MEMORY;
+    *bounded_p = (timer_interval < timeout);
+    if (*bounded_p) {
+        timeout = timer_interval;
+    }
+
+    if (timeout == UCS_TIME_INFINITY) {
+        return -1;
+    }
+
+    /* Round up, to not wake up before the deadline */
+    return ucs_min(ucs_div_round_up(timeout, ucs_time_from_msec(1)),
+                   (ucs_time_t)INT_MAX);
+}
+
+static ucs_status_t ucp_worker_wait_deadline(ucp_worker_h worker,
+                                             ucs_time_t deadline)
+{
+    ucp_context_h context = worker->context;
+    int res, epoll_fd, timeout, bounded;
+    ucs_time_t poll_deadline;
+    ucs_status_t status;
+
+    if (context->config.ext.wakeup_poll_time > 0) {
+        poll_deadline = ucs_get_time() +
+                        ucs_time_from_sec(context->config.ext.wakeup_poll_time);
+        if (ucp_worker_wait_poll(worker, ucs_min(poll_deadline, deadline))) {
+            return UCS_OK;
+        }
+    }
+
+    UCP_THREAD_CS_ENTER_CONDITIONAL(&worker->mt_lock);
+
+    status = ucp_worker_get_efd(worker, &epoll_fd);
+    if (status != UCS_OK) {
         goto out;
     }
 
+    /* When the wait is cut short by the timer interval, check for missed
+     * timer events and keep waiting if there were none */
     do {
-        ucs_debug("epoll_wait loop with epfd %d maxevents %d timeout %d",
-                   epoll_fd, context->num_tls, -1);
-        res = epoll_wait(epoll_fd, events, context->num_tls, -1);
-    } while ((res == -1) && (errno == EINTR));
+        status = ucp_worker_arm(worker);
+        if (UCS_ERR_BUSY == status) {
+            /* if UCS_ERR_BUSY returned - no poll() must called */
+            status = UCS_OK;
+            goto out;
+        } else if (status != UCS_OK) {
+            goto out;
+        }
+
+        /* Timer events which were missed would not wake up the worker */
+        UCS_ASYNC_BLOCK(&worker->async);
+        res = ucs_async_check_miss(&worker->async);
+        UCS_ASYNC_UNBLOCK(&worker->async);
+        if (res) {
+            status = UCS_OK;
+            goto out;
+        }
 
-    free(events);
+        do {
+            timeout = ucp_worker_wait_epoll_timeout(worker, deadline, &bounded);
+            ucs_trace_poll("epoll_wait loop with epfd %d maxevents %d timeout %d",
+                           epoll_fd, worker->wakeup.max_events, timeout);
+            res = epoll_wait(epoll_fd, worker->wakeup.events,
+                             worker->wakeup.max_events, timeout);
+        } while ((res == -1) && (errno == EINTR));
+    } while ((res == 0) && bounded);
 
     if (res == -1) {
         ucs_error("Polling internally for events failed: %m");
         status = UCS_ERR_IO_ERROR;
-        goto out;
+    } else if (res == 0) {
+        status = UCS_ERR_TIMED_OUT;
+    } else {
+        status = UCS_OK;
     }
 
-    status = UCS_OK;
 out:
     UCP_THREAD_CS_EXIT_CONDITIONAL(&worker->mt_lock);
     return status;
 }
 
+ucs_status_t ucp_worker_wait(ucp_worker_h worker)
+{
+    return ucp_worker_wait_deadline(worker, UCS_TIME_INFINITY);
+}
+
+ucs_status_t ucp_worker_wait_timeout(ucp_worker_h worker, int timeout)
+{
+    if (timeout < 0) {
+        return ucp_worker_wait_deadline(worker, UCS_TIME_INFINITY);
+    }
+
+    return ucp_worker_wait_deadline(worker, ucs_get_time() +
+                                    ucs_time_from_msec(timeout));
+}
+
 ucs_status_t ucp_worker_signal(ucp_worker_h worker)
 {
     char buf = 0;
@@ -9,6 +9,7 @@
 #define UCP_WORKER_H_
 
 #include "ucp_ep.h"
+#include "ucp_mm.h"
 #include "ucp_thread.h"
 
 #include <ucs/datastruct/mpool.h>
@@ -18,6 +19,30 @@
 KHASH_MAP_INIT_INT64(ucp_worker_ep_hash, ucp_ep_t *);
 
 
+/**
+ * Identifies an active message being reassembled: the remote worker which sent
+ * it, and the message sequence number on that worker.
+ */
+typedef struct {
+    uint64_t                  sender_uuid;
+    uint64_t                  msg_id;
+} UCS_S_PACKED ucp_am_frag_key_t;
+
+
+static inline khint32_t ucp_am_frag_key_hash(ucp_am_frag_key_t key)
+{
+    uint64_t h = key.sender_uuid ^ (key.msg_id * 0x9e3779b97f4a7c15ull);
+    return kh_int64_hash_func(h);
+}
+
+#define ucp_am_frag_key_equal(_key1, _key2) \
+    (((_key1).sender_uuid == (_key2).sender_uuid) && \
+     ((_key1).msg_id == (_key2).msg_id))
+
+KHASH_INIT(ucp_am_frag_hash, ucp_am_frag_key_t, struct ucp_am_frag*, 1,
+           ucp_am_frag_key_hash, ucp_am_frag_key_equal);
+
+
 enum {
     UCP_UCT_IFACE_ATOMIC32_FLAGS =
         UCT_IFACE_FLAG_ATOMIC_ADD32  |
@@ -68,6 +93,15 @@ enum {
                              UCP_WORKER_STAT_TAG_RX_RNDV_##_is_exp, 1);
 
 
+/**
+ * User active message handler.
+ */
+typedef struct ucp_worker_am_handler {
+    ucp_am_callback_t             cb;            /* Handler, NULL if not set */
+    void                          *arg;          /* Handler argument */
+} ucp_worker_am_handler_t;
+
+
 /**
  * UCP worker wake-up context.
  */
@@ -75,6 +109,8 @@ typedef struct ucp_worker_wakeup {
     int                           wakeup_efd;     /* Allocated (on-demand) epoll fd for wakeup */
     int                           wakeup_pipe[2]; /* Pipe to support signal() calls */
     uct_wakeup_h                  *iface_wakeups; /* Array of interface wake-up handles */
+    struct epoll_event            *events;        /* Events array for epoll_wait() */
+    int                           max_events;     /* Size of the events array */
 } ucp_worker_wakeup_t;
 
 
@@ -85,6 +121,8 @@ typedef struct ucp_worker {
     ucs_async_context_t           async;         /* Async context for this worker */
     ucp_context_h                 context;       /* Back-reference to UCP context */
     uint64_t                      uuid;          /* Unique ID for wireup */
+    uint64_t                      msg_id;        /* Next id of a sent multi-fragment
+                                                    message */
     uct_worker_h                  uct;           /* UCT worker handle */
     ucs_mpool_t                   req_mp;        /* Memory pool for requests */
     ucp_worker_wakeup_t           wakeup;        /* Wakeup-related context */
@@ -99,6 +137,13 @@ typedef struct ucp_worker {
     uct_iface_h                   *ifaces;       /* Array of interfaces, one for each resource */
     uct_iface_attr_t              *iface_attrs;  /* Array of interface attributes */
     ucs_mpool_t                   am_mp;         /* Memory pool for AM receives */
+    ucs_mpool_t                   rndv_frag_mp;  /* Memory pool for rendezvous staging buffers */
+    ucp_rkey_cache_t              rkey_cache;    /* Unpacked keys of rendezvous send buffers */
+    struct {
+        ucp_worker_am_handler_t   *handlers;     /* User handlers, by message id */
+        unsigned                  num_handlers;  /* Size of handlers array */
+        khash_t(ucp_am_frag_hash) frag_hash;     /* Messages being reassembled */
+    } am;
     UCS_STATS_NODE_DECLARE(stats);
     unsigned                      ep_config_max; /* Maximal number of configurations */
     unsigned                      ep_config_count; /* Current number of configurations */
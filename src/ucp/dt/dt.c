@@ -8,8 +8,9 @@
 
 
 size_t ucp_dt_pack(ucp_datatype_t datatype, void *dest, const void *src,
-                   ucp_dt_state_t *state, size_t length)
+                   ucp_dt_state_t *state, size_t length, size_t total_length)
 {
+    int nontemporal   = ucs_memcpy_is_nontemporal(total_length);
     ucp_dt_generic_t *dt;
     size_t result_len = 0;
 
@@ -19,14 +20,21 @@ size_t ucp_dt_pack(ucp_datatype_t datatype, void *dest, const void *src,
 
     switch (datatype & UCP_DATATYPE_CLASS_MASK) {
     case UCP_DATATYPE_CONTIG:
-        UCS_PROFILE_CALL(memcpy, dest, src + state->offset, length);
+        UCS_PROFILE_CALL_VOID(ucs_memcpy_fragment, dest, src + state->offset,
+                              length, nontemporal);
+        result_len = length;
+        break;
+
+    case UCP_DATATYPE_STRIDED:
+        UCS_PROFILE_CALL_VOID(ucp_dt_strided_pack, ucp_dt_strided(datatype),
+                              dest, src, state->offset, length, nontemporal);
         result_len = length;
         break;
 
     case UCP_DATATYPE_IOV:
         UCS_PROFILE_CALL_VOID(ucp_dt_iov_gather, dest, src, length,
                               &state->dt.iov.iov_offset,
-                              &state->dt.iov.iovcnt_offset);
+                              &state->dt.iov.iovcnt_offset, nontemporal);
         result_len = length;
         break;
 
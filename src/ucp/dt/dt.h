@@ -11,8 +11,10 @@
 #include "dt_contig.h"
 #include "dt_iov.h"
 #include "dt_generic.h"
+#include "dt_strided.h"
 
 #include <uct/api/uct.h>
+#include <ucs/arch/memcpy.h>
 #include <ucs/debug/profile.h>
 #include <string.h>
 
@@ -32,6 +34,9 @@ typedef struct ucp_dt_state {
             size_t                iovcnt;         /* Number of IOV buffers */
             uct_mem_h             *memh;          /* Pointer to IOV memh[iovcnt] */
         } iov;
+        struct {
+            uct_mem_h             memh;           /* Spans all the items */
+        } strided;
         struct {
             void                  *state;
         } generic;
@@ -52,6 +57,9 @@ size_t ucp_dt_length(ucp_datatype_t datatype, size_t count,
     case UCP_DATATYPE_CONTIG:
         return ucp_contig_dt_length(datatype, count);
 
+    case UCP_DATATYPE_STRIDED:
+        return ucp_dt_strided_length(datatype, count);
+
     case UCP_DATATYPE_IOV:
         ucs_assert(NULL != iov);
         return ucp_dt_iov_length(iov, count);
@@ -69,16 +77,66 @@ size_t ucp_dt_length(ucp_datatype_t datatype, size_t count,
     return 0;
 }
 
+/**
+ * Initialize the state of receiving to a buffer
+ */
+static UCS_F_ALWAYS_INLINE void
+ucp_dt_recv_state_init(ucp_dt_state_t *state, void *buffer, size_t count,
+                       ucp_datatype_t datatype)
+{
+    ucp_dt_generic_t *dt_gen;
+
+    state->offset = 0;
+
+    switch (datatype & UCP_DATATYPE_CLASS_MASK) {
+    case UCP_DATATYPE_IOV:
+        state->dt.iov.iov_offset    = 0;
+        state->dt.iov.iovcnt_offset = 0;
+        state->dt.iov.iovcnt        = count;
+        state->dt.iov.memh          = UCT_MEM_HANDLE_NULL;
+        break;
+
+    case UCP_DATATYPE_STRIDED:
+        state->dt.strided.memh      = UCT_MEM_HANDLE_NULL;
+        break;
+
+    case UCP_DATATYPE_GENERIC:
+        dt_gen = ucp_dt_generic(datatype);
+        state->dt.generic.state =
+                        UCS_PROFILE_NAMED_CALL("dt_start", dt_gen->ops.start_unpack,
+                                               dt_gen->context, buffer, count);
+        ucs_debug("buffer %p count %zu dt_gen state=%p", buffer, count,
+                  state->dt.generic.state);
+        break;
+
+    default:
+        break;
+    }
+}
+
+/**
+ * Pack the next fragment of a send buffer.
+ *
+ * @param [in]  length        Size of the fragment to pack.
+ * @param [in]  total_length  Size of the whole message, which decides whether
+ *                            the data is copied with non-temporal stores.
+ */
 size_t ucp_dt_pack(ucp_datatype_t datatype, void *dest, const void *src,
-                   ucp_dt_state_t *state, size_t length);
+                   ucp_dt_state_t *state, size_t length, size_t total_length);
 
+/*
+ * Unpack the next fragment to a receive buffer. Whether the data bypasses the
+ * cache is decided by the size of the whole receive buffer, rather than by the
+ * fragment size.
+ */
 static UCS_F_ALWAYS_INLINE ucs_status_t
 ucp_dt_unpack(ucp_datatype_t datatype, void *buffer, size_t buffer_size,
               ucp_dt_state_t *state, const void *recv_data,
               size_t recv_length, int last)
 {
     ucp_dt_generic_t *dt_gen;
-    size_t offset = state->offset;
+    size_t offset   = state->offset;
+    int nontemporal = ucs_memcpy_is_nontemporal(buffer_size);
     ucs_status_t status;
 
     if (ucs_unlikely((recv_length + offset) > buffer_size)) {
@@ -92,14 +150,21 @@ ucp_dt_unpack(ucp_datatype_t datatype, void *buffer, size_t buffer_size,
 
     switch (datatype & UCP_DATATYPE_CLASS_MASK) {
     case UCP_DATATYPE_CONTIG:
-        UCS_PROFILE_NAMED_CALL("memcpy_recv", memcpy, buffer + offset,
-                               recv_data, recv_length);
+        UCS_PROFILE_NAMED_CALL_VOID("memcpy_recv", ucs_memcpy_fragment,
+                                    buffer + offset, recv_data, recv_length,
+                                    nontemporal);
+        return UCS_OK;
+
+    case UCP_DATATYPE_STRIDED:
+        UCS_PROFILE_CALL_VOID(ucp_dt_strided_unpack, ucp_dt_strided(datatype),
+                              buffer, offset, recv_data, recv_length,
+                              nontemporal);
         return UCS_OK;
 
     case UCP_DATATYPE_IOV:
         UCS_PROFILE_CALL(ucp_dt_iov_scatter, buffer, state->dt.iov.iovcnt,
                          recv_data, recv_length, &state->dt.iov.iov_offset,
-                         &state->dt.iov.iovcnt_offset);
+                         &state->dt.iov.iovcnt_offset, nontemporal);
         return UCS_OK;
 
     case UCP_DATATYPE_GENERIC:
@@ -45,9 +45,12 @@ static inline size_t ucp_dt_iov_length(const ucp_dt_iov_t *iov, size_t iovcnt)
  *                                belongs to the @a iov_offset. The point to start
  *                                copying from should be selected as
  *                                iov[iovcnt_offset].buffer + iov_offset
+ * @param [in]     nontemporal    Whether to copy with non-temporal stores, as
+ *                                decided for the whole message.
  */
 void ucp_dt_iov_gather(void *dest, const ucp_dt_iov_t *iov, size_t length,
-                       size_t *iov_offset, size_t *iovcnt_offset);
+                       size_t *iov_offset, size_t *iovcnt_offset,
+                       int nontemporal);
 
 /**
  * Copy contiguous buffer @a src into @ref ucp_dt_iov_t data buffers in @a iov
@@ -65,12 +68,15 @@ void ucp_dt_iov_gather(void *dest, const ucp_dt_iov_t *iov, size_t length,
  *                                belongs to the @a iov_offset. The point to
  *                                start copying from should be selected as
  *                                iov[iovcnt_offset].buffer + iov_offset
+ * @param [in]     nontemporal    Whether to copy with non-temporal stores, as
+ *                                decided for the whole message.
  *
  * @return Size in bytes that is actually copied from @a src to @a iov. It must
  *         be less or equal to @a length.
  */
 size_t ucp_dt_iov_scatter(ucp_dt_iov_t *iov, size_t iovcnt, const void *src,
-                          size_t length, size_t *iov_offset, size_t *iovcnt_offset);
+                          size_t length, size_t *iov_offset, size_t *iovcnt_offset,
+                          int nontemporal);
 
 
 #endif
@@ -0,0 +1,222 @@
+/**
+ * Copyright (C) Mellanox Technologies Ltd. 2001-2017.  ALL RIGHTS RESERVED.
+ *
+ * See file LICENSE for terms.
+ */
+
+#include "dt_strided.h"
+#include "dt_contig.h"
+
+#include <ucs/arch/cpu.h>
+#include <ucs/arch/memcpy.h>
+#include <ucs/debug/log.h>
+#include <ucs/debug/memtrack.h>
+#include <ucs/sys/math.h>
+
+#include <string.h>
+
+
+/* Copy blocks of a constant size, which the compiler replaces by single
+ * (vector) loads and stores */
+#define UCP_DT_STRIDED_COPY_BLOCKS(_packed, _strided, _size, _stride, _count, \
+                                   _pack) \
+    for (; (_count) > 0; --(_count)) { \
+        if (_pack) { \
+            memcpy(_packed, _strided, _size); \
+        } else { \
+            memcpy(_strided, _packed, _size); \
+        } \
+        (_packed)  += (_size); \
+        (_strided) += (_stride); \
+    }
+
+
+static UCS_F_ALWAYS_INLINE void
+ucp_dt_strided_copy_blocks(char *packed, char *strided, size_t block_size,
+                           size_t stride, size_t count, int pack,
+                           int nontemporal)
+{
+    switch (block_size) {
+    case 1:
+        UCP_DT_STRIDED_COPY_BLOCKS(packed, strided, 1, stride, count, pack);
+        break;
+    case 2:
+        UCP_DT_STRIDED_COPY_BLOCKS(packed, strided, 2, stride, count, pack);
+        break;
+    case 4:
+        UCP_DT_STRIDED_COPY_BLOCKS(packed, strided, 4, stride, count, pack);
+        break;
+    case 8:
+        UCP_DT_STRIDED_COPY_BLOCKS(packed, strided, 8, stride, count, pack);
+        break;
+    case 16:
+        UCP_DT_STRIDED_COPY_BLOCKS(packed, strided, 16, stride, count, pack);
+        break;
+    default:
+        for (; count > 0; --count) {
+            if (pack) {
+                ucs_memcpy_fragment(packed, strided, block_size, nontemporal);
+            } else {
+                ucs_memcpy_fragment(strided, packed, block_size, nontemporal);
+            }
+            packed  += block_size;
+            strided += stride;
+        }
+        break;
+    }
+}
+
+/*
+ * Walk the blocks of the packed data range [offset, offset + length), keeping
+ * the index of the current block in every dimension. Full blocks of the
+ * innermost dimension are copied in a tight loop.
+ */
+static UCS_F_ALWAYS_INLINE void
+ucp_dt_strided_copy(const ucp_dt_strided_t *dt, char *packed, char *strided,
+                    size_t offset, size_t length, int pack, int nontemporal)
+{
+    const size_t block_size = dt->block_size;
+    ucp_dt_strided_dim_t dims[UCP_DT_STRIDED_MAX_DIMS + 1];
+    size_t index[UCP_DT_STRIDED_MAX_DIMS + 1];
+    size_t block_index, block_offset, copy_len, count;
+    unsigned i, num_dims;
+
+    /* Streaming blocks smaller than a cache line would leave partially
+     * written lines */
+    nontemporal = nontemporal && (block_size >= UCS_ARCH_CACHE_LINE_SIZE);
+
+    /* The items in the buffer are the outermost dimension, which is unbounded */
+    num_dims = dt->num_dims;
+    memcpy(dims, dt->dims, sizeof(*dims) * num_dims);
+    dims[num_dims].count  = SIZE_MAX;
+    dims[num_dims].stride = dt->extent;
+    ++num_dims;
+
+    block_index  = offset / block_size;
+    block_offset = offset % block_size;
+    for (i = 0; i < num_dims; ++i) {
+        index[i]     = block_index % dims[i].count;
+        block_index /= dims[i].count;
+        strided     += index[i] * dims[i].stride;
+    }
+
+    while (length > 0) {
+        if ((block_offset == 0) && (length >= block_size)) {
+            /* Full blocks up to the end of the innermost dimension */
+            count     = ucs_min(dims[0].count - index[0], length / block_size);
+            index[0] += count;
+            length   -= count * block_size;
+            ucp_dt_strided_copy_blocks(packed, strided, block_size,
+                                       dims[0].stride, count, pack, nontemporal);
+            packed   += count * block_size;
+            strided  += count * dims[0].stride;
+        } else {
+            /* Part of a block, at the beginning or the end of the range */
+            copy_len = ucs_min(block_size - block_offset, length);
+            if (pack) {
+                memcpy(packed, strided + block_offset, copy_len);
+            } else {
+                memcpy(strided + block_offset, packed, copy_len);
+            }
+            packed       += copy_len;
+            length       -= copy_len;
+            block_offset += copy_len;
+            if (block_offset < block_size) {
+                break;
+            }
+
+            block_offset = 0;
+            ++index[0];
+            strided     += dims[0].stride;
+        }
+
+        /* Move to the next element of the outer dimensions */
+        for (i = 0; (i < num_dims - 1) && (index[i] == dims[i].count); ++i) {
+            strided     -= index[i] * dims[i].stride;
+            index[i]     = 0;
+            ++index[i + 1];
+            strided     += dims[i + 1].stride;
+        }
+    }
+}
+
+void ucp_dt_strided_pack(const ucp_dt_strided_t *dt, void *dest,
+                         const void *src, size_t offset, size_t length,
+                         int nontemporal)
+{
+    ucp_dt_strided_copy(dt, dest, (char*)src, offset, length, 1, nontemporal);
+}
+
+void ucp_dt_strided_unpack(const ucp_dt_strided_t *dt, void *dest,
+                           size_t offset, const void *src, size_t length,
+                           int nontemporal)
+{
+    ucp_dt_strided_copy(dt, (char*)src, dest, offset, length, 0, nontemporal);
+}
+
+ucs_status_t ucp_dt_create_strided(ucp_datatype_t elem_datatype, size_t count,
+                                   size_t stride, ucp_datatype_t *datatype_p)
+{
+    ucp_dt_strided_dim_t *top;
+    ucp_dt_strided_t *dt;
+
+    dt = ucs_memalign(UCS_BIT(UCP_DATATYPE_SHIFT), sizeof(*dt), "strided_dt");
+    if (dt == NULL) {
+        return UCS_ERR_NO_MEMORY;
+    }
+
+    switch (elem_datatype & UCP_DATATYPE_CLASS_MASK) {
+    case UCP_DATATYPE_CONTIG:
+        dt->block_size = ucp_contig_dt_elem_size(elem_datatype);
+        dt->length     = dt->block_size;
+        dt->extent     = dt->block_size;
+        dt->num_dims   = 0;
+        break;
+    case UCP_DATATYPE_STRIDED:
+        *dt = *ucp_dt_strided(elem_datatype);
+        break;
+    default:
+        ucs_error("unsupported strided element datatype %lx", elem_datatype);
+        goto err_free;
+    }
+
+    if ((dt->block_size == 0) || (count == 0)) {
+        ucs_error("cannot create an empty strided datatype");
+        goto err_free;
+    }
+
+    if ((count > 1) && (stride < dt->extent)) {
+        ucs_error("strided datatype stride %zu is smaller than the element "
+                  "extent %zu", stride, dt->extent);
+        goto err_free;
+    }
+
+    top = (dt->num_dims > 0) ? &dt->dims[dt->num_dims - 1] : NULL;
+    if (count == 1) {
+        /* nothing to add */
+    } else if ((dt->num_dims == 0) && (stride == dt->block_size)) {
+        /* contiguous elements make a larger block */
+        dt->block_size *= count;
+    } else if ((top != NULL) && (stride == top->count * top->stride)) {
+        /* the elements continue the outermost dimension */
+        top->count *= count;
+    } else if (dt->num_dims < UCP_DT_STRIDED_MAX_DIMS) {
+        dt->dims[dt->num_dims].count  = count;
+        dt->dims[dt->num_dims].stride = stride;
+        ++dt->num_dims;
+    } else {
+        ucs_error("strided datatype exceeds %d dimensions",
+                  UCP_DT_STRIDED_MAX_DIMS);
+        ucs_free(dt);
+        return UCS_ERR_EXCEEDS_LIMIT;
+    }
+
+    dt->extent += (count - 1) * stride;
+    dt->length *= count;
+    *datatype_p = ((uintptr_t)dt) | UCP_DATATYPE_STRIDED;
+    return UCS_OK;
+
+err_free:
+    ucs_free(dt);
+    return UCS_ERR_INVALID_PARAM;
+}
@@ -0,0 +1,133 @@
+/**
+ * Copyright (C) Mellanox Technologies Ltd. 2001-2017.  ALL RIGHTS RESERVED.
+ *
+ * See file LICENSE for terms.
+ */
+
+
+#ifndef UCP_DT_STRIDED_H_
+#define UCP_DT_STRIDED_H_
+
+#include <ucp/api/ucp.h>
+
+
+/* Maximal number of strided dimensions, after merging the ones which describe
+ * contiguous memory */
+#define UCP_DT_STRIDED_MAX_DIMS    4
+
+
+#define UCP_DT_IS_STRIDED(_datatype) \
+    (((_datatype) & UCP_DATATYPE_CLASS_MASK) == UCP_DATATYPE_STRIDED)
+
+
+/**
+ * Dimension of a strided datatype.
+ */
+typedef struct ucp_dt_strided_dim {
+    size_t                   count;   /* Number of elements in the dimension */
+    size_t                   stride;  /* Distance between the elements, in bytes */
+} ucp_dt_strided_dim_t;
+
+
+/**
+ * Strided datatype structure. The data is made of contiguous blocks, whose
+ * locations are described by the dimensions, from the innermost one.
+ */
+typedef struct ucp_dt_strided {
+    size_t                   block_size;  /* Size of a contiguous block */
+    size_t                   length;      /* Size of the packed data */
+    size_t                   extent;      /* Distance between consecutive items */
+    unsigned                 num_dims;    /* Number of dimensions */
+    ucp_dt_strided_dim_t     dims[UCP_DT_STRIDED_MAX_DIMS];
+} ucp_dt_strided_t;
+
+
+static inline ucp_dt_strided_t* ucp_dt_strided(ucp_datatype_t datatype)
+{
+    return (ucp_dt_strided_t*)(void*)(datatype & ~UCP_DATATYPE_CLASS_MASK);
+}
+
+
+/**
+ * Get the total length of the data in @a count strided items
+ */
+static inline size_t ucp_dt_strided_length(ucp_datatype_t datatype, size_t count)
+{
+    return count * ucp_dt_strided(datatype)->length;
+}
+
+
+/**
+ * Get the number of contiguous blocks which hold the packed data range
+ * [@a offset, @a offset + @a length)
+ */
+static inline size_t ucp_dt_strided_num_blocks(const ucp_dt_strided_t *dt,
+                                               size_t offset, size_t length)
+{
+    return (length == 0) ? 0 :
+           (((offset + length - 1) / dt->block_size) -
+            (offset / dt->block_size) + 1);
+}
+
+
+/**
+ * Get the address of a contiguous block
+ *
+ * @param [in]  dt           Strided datatype.
+ * @param [in]  buffer       Buffer of the first item.
+ * @param [in]  block_index  Index of the block, counting the blocks of all
+ *                           items in the buffer.
+ */
+static inline void* ucp_dt_strided_block_addr(const ucp_dt_strided_t *dt,
+                                              const void *buffer,
+                                              size_t block_index)
+{
+    size_t blocks_per_item = dt->length / dt->block_size;
+    const char *addr;
+    unsigned i;
+
+    addr         = (const char*)buffer +
+                   ((block_index / blocks_per_item) * dt->extent);
+    block_index %= blocks_per_item;
+    for (i = 0; i < dt->num_dims; ++i) {
+        addr        += (block_index % dt->dims[i].count) * dt->dims[i].stride;
+        block_index /= dt->dims[i].count;
+    }
+
+    return (void*)addr;
+}
+
+
+/**
+ * Copy strided items to a contiguous buffer
+ *
+ * @param [in]  dt      Strided datatype.
+ * @param [in]  dest    Destination contiguous buffer.
+ * @param [in]  src     Buffer of the first strided item.
+ * @param [in]  offset  Offset in the packed data to start copying from.
+ * @param [in]  length  Number of bytes to copy.
+ * @param [in]  nontemporal  Whether to copy with non-temporal stores, as
+ *                           decided for the whole message.
+ */
+void ucp_dt_strided_pack(const ucp_dt_strided_t *dt, void *dest,
+                         const void *src, size_t offset, size_t length,
+                         int nontemporal);
+
+
+/**
+ * Copy a contiguous buffer to strided items
+ *
+ * @param [in]  dt      Strided datatype.
+ * @param [in]  dest    Buffer of the first strided item.
+ * @param [in]  offset  Offset in the packed data to start copying to.
+ * @param [in]  src     Source contiguous buffer.
+ * @param [in]  length  Number of bytes to copy.
+ * @param [in]  nontemporal  Whether to copy with non-temporal stores, as
+ *                           decided for the whole message.
+ */
+void ucp_dt_strided_unpack(const ucp_dt_strided_t *dt, void *dest,
+                           size_t offset, const void *src, size_t length,
+                           int nontemporal);
+
+
+#endif
@@ -52,6 +52,15 @@ typedef struct ucp_proto {
 ucs_status_t ucp_proto_progress_am_bcopy_single(uct_pending_req_t *self);
 
 
+/*
+ * Set the length of a send request, and select its short, bcopy or zcopy
+ * protocol on the active message lane. Non-contiguous datatypes are always
+ * packed to bcopy fragments.
+ */
+ucs_status_t ucp_proto_am_req_start(ucp_request_t *req, size_t count,
+                                    ssize_t max_short, const ucp_proto_t *proto);
+
+
 /*
  * Make sure the remote worker would be able to send replies to our endpoint.
  * Should be used before sending a message which requires a reply.
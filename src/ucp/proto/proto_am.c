@@ -39,3 +39,82 @@ ucs_status_t ucp_proto_progress_am_bcopy_single(uct_pending_req_t *self)
     return status;
 }
 
+ucs_status_t ucp_proto_am_req_start(ucp_request_t *req, size_t count,
+                                    ssize_t max_short, const ucp_proto_t *proto)
+{
+    ucp_ep_config_t *config = ucp_ep_config(req->send.ep);
+    ucp_dt_generic_t *dt_gen;
+    size_t zcopy_thresh;
+    ucs_status_t status;
+    size_t length;
+
+    zcopy_thresh = SIZE_MAX;
+    switch (req->send.datatype & UCP_DATATYPE_CLASS_MASK) {
+    case UCP_DATATYPE_CONTIG:
+        length       = ucp_contig_dt_length(req->send.datatype, count);
+        zcopy_thresh = config->am.zcopy_thresh[0];
+        break;
+    case UCP_DATATYPE_STRIDED:
+        length = ucp_dt_strided_length(req->send.datatype, count);
+        break;
+    case UCP_DATATYPE_IOV:
+        req->send.state.dt.iov.iovcnt_offset = 0;
+        req->send.state.dt.iov.iov_offset    = 0;
+        req->send.state.dt.iov.iovcnt        = count;
+        length = ucp_dt_iov_length(req->send.buffer, count);
+        break;
+    case UCP_DATATYPE_GENERIC:
+        dt_gen = ucp_dt_generic(req->send.datatype);
+        req->send.state.dt.generic.state =
+                        dt_gen->ops.start_pack(dt_gen->context, req->send.buffer,
+                                               count);
+        length = dt_gen->ops.packed_size(req->send.state.dt.generic.state);
+        break;
+    default:
+        ucs_error("Invalid data type");
+        return UCS_ERR_INVALID_PARAM;
+    }
+    req->send.length = length;
+
+    ucs_trace_req("select request(%p) progress algorithm datatype=%lx "
+                  "buffer=%p length=%zu max_short=%zd zcopy_thresh=%zu", req,
+                  req->send.datatype, req->send.buffer, length, max_short,
+                  zcopy_thresh);
+
+    if (((ssize_t)length <= max_short) && UCP_DT_IS_CONTIG(req->send.datatype)) {
+        /* short */
+        req->send.uct.func = proto->contig_short;
+        UCS_PROFILE_REQUEST_EVENT(req, "start_am_short", req->send.length);
+    } else if (length < zcopy_thresh) {
+        /* bcopy */
+        if (length <= (config->am.max_bcopy - proto->only_hdr_size)) {
+            req->send.uct.func = proto->bcopy_single;
+            UCS_PROFILE_REQUEST_EVENT(req, "start_am_bcopy_single",
+                                      req->send.length);
+        } else {
+            req->send.uct.func = proto->bcopy_multi;
+            UCS_PROFILE_REQUEST_EVENT(req, "start_am_bcopy_multi",
+                                      req->send.length);
+        }
+    } else {
+        /* zcopy */
+        status = ucp_request_send_buffer_reg(req, ucp_ep_get_am_lane(req->send.ep));
+        if (status != UCS_OK) {
+            return status;
+        }
+
+        req->send.uct_comp.func  = proto->zcopy_completion;
+        req->send.uct_comp.count = 1;
+
+        if (length <= (config->am.max_zcopy - proto->only_hdr_size)) {
+            req->send.uct.func = proto->zcopy_single;
+            UCS_PROFILE_REQUEST_EVENT(req, "start_am_zcopy_single",
+                                      req->send.length);
+        } else {
+            req->send.uct.func = proto->zcopy_multi;
+            UCS_PROFILE_REQUEST_EVENT(req, "start_am_zcopy_multi",
+                                      req->send.length);
+        }
+    }
+    return UCS_OK;
+}
@@ -93,7 +93,8 @@ size_t ucp_dt_iov_copy_uct(uct_iov_t *iov, size_t *iovcnt, size_t max_dst_iov,
                            ucp_dt_state_t *state, const ucp_dt_iov_t *src_iov,
                            ucp_datatype_t datatype, size_t length_max)
 {
-    size_t iov_offset, max_src_iov, src_it, dst_it;
+    size_t iov_offset, max_src_iov, src_it, dst_it, block_index;
+    const ucp_dt_strided_t *dt_strided;
     const uct_mem_h *memh;
     size_t length_it = 0;
 
@@ -108,6 +109,30 @@ size_t ucp_dt_iov_copy_uct(uct_iov_t *iov, size_t *iovcnt, size_t max_dst_iov,
         *iovcnt   = 1;
         length_it = iov[0].length;
         break;
+    case UCP_DATATYPE_STRIDED:
+        /* an entry per contiguous block, since transports do not support
+         * strided IOV entries */
+        dt_strided  = ucp_dt_strided(datatype);
+        block_index = state->offset / dt_strided->block_size;
+        iov_offset  = state->offset % dt_strided->block_size;
+        dst_it      = 0;
+        while ((dst_it < max_dst_iov) && (length_it < length_max)) {
+            iov[dst_it].buffer = ucp_dt_strided_block_addr(dt_strided, src_iov,
+                                                           block_index) +
+                                 iov_offset;
+            iov[dst_it].length = ucs_min(dt_strided->block_size - iov_offset,
+                                         length_max - length_it);
+            iov[dst_it].memh   = state->dt.strided.memh;
+            iov[dst_it].stride = 0;
+            iov[dst_it].count  = 1;
+            length_it         += iov[dst_it].length;
+            iov_offset         = 0;
+            ++block_index;
+            ++dst_it;
+        }
+
+        *iovcnt = dst_it;
+        break;
     case UCP_DATATYPE_IOV:
         memh                        = state->dt.iov.memh;
         iov_offset                  = state->dt.iov.iov_offset;
@@ -209,6 +234,11 @@ ucs_status_t ucp_do_am_zcopy_multi(uct_pending_req_t *self, uint8_t am_id_first,
         /* This flag should guarantee middle stage usage if iovcnt exceeded */
         flag_iov_mid = ((state->dt.iov.iovcnt_offset + max_iov) <
                         state->dt.iov.iovcnt);
+    } else if (UCP_DT_IS_STRIDED(req->send.datatype)) {
+        flag_iov_mid = (ucp_dt_strided_num_blocks(ucp_dt_strided(req->send.datatype),
+                                                  offset,
+                                                  req->send.length - offset) >
+                        max_iov);
     }
 
     if (offset == 0) {
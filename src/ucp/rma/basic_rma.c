@@ -12,6 +12,7 @@
 #include <ucp/core/ucp_context.h>
 #include <ucp/dt/dt_contig.h>
 #include <ucs/debug/profile.h>
+#include <ucs/arch/memcpy.h>
 
 #include <ucp/core/ucp_request.inl>
 #include <ucs/datastruct/mpool.inl>
@@ -27,6 +28,14 @@
         return UCS_ERR_INVALID_PARAM; \
     }
 
+#define UCP_RMA_CHECK_PARAMS_PTR(_buffer, _length) \
+    if ((_length) == 0) { \
+        return UCS_STATUS_PTR(UCS_OK); \
+    } \
+    if (ENABLE_PARAMS_CHECK && ((_buffer) == NULL)) { \
+        return UCS_STATUS_PTR(UCS_ERR_INVALID_PARAM); \
+    }
+
 /* request can be released if 
  *  - all fragments were sent (length == 0) (bcopy & zcopy mix)
  *  - all zcopy fragments are done (uct_comp.count == 0)
@@ -61,6 +70,10 @@ ucp_rma_request_advance(ucp_request_t *req, ssize_t frag_length,
         req->send.rma.remote_addr += frag_length;
         return UCS_INPROGRESS;
     } else {
+        /* No more fragments are sent. If some are still in flight, the last
+         * completion callback completes the request with the error status */
+        req->status      = status;
+        req->send.length = 0;
         return status;
     }
 }
@@ -71,7 +84,7 @@ static void ucp_rma_request_bcopy_completion(uct_completion_t *self,
     ucp_request_t *req = ucs_container_of(self, ucp_request_t, send.uct_comp);
 
     if (ucs_likely(req->send.length == 0)) {
-        ucp_request_complete_send(req, UCS_OK);
+        ucp_request_complete_send(req, req->status);
     }
 }
 
@@ -82,7 +95,7 @@ static void ucp_rma_request_zcopy_completion(uct_completion_t *self,
 
     if (ucs_likely(req->send.length == 0)) {
         ucp_request_send_buffer_dereg(req, req->send.lane);
-        ucp_request_complete_send(req, UCS_OK);
+        ucp_request_complete_send(req, req->status);
     }
 }
 
@@ -92,6 +105,7 @@ ucp_rma_request_init(ucp_request_t *req, ucp_ep_h ep, const void *buffer,
                      uct_pending_callback_t cb, size_t zcopy_thresh, int flags)
 {
     req->flags                = flags; /* Implicit release */
+    req->status               = UCS_OK;
     req->send.ep              = ep;
     req->send.buffer          = buffer;
     req->send.datatype        = ucp_dt_make_contig(1);
@@ -189,7 +203,7 @@ static ucs_status_t ucp_progress_get(uct_pending_req_t *self)
         frag_length = ucs_min(rma_config->max_get_bcopy, req->send.length);
         status = UCS_PROFILE_CALL(uct_ep_get_bcopy,
                                   ep->uct_eps[lane],
-                                  (uct_unpack_callback_t)memcpy,
+                                  ucs_memcpy_relaxed,
                                   (void*)req->send.buffer,
                                   frag_length,
                                   req->send.rma.remote_addr,
@@ -276,6 +290,47 @@ ucp_rma_nonblocking(ucp_ep_h ep, const void *buffer, size_t length,
     return ucp_request_start_send(req);
 }
 
+static UCS_F_ALWAYS_INLINE ucs_status_ptr_t
+ucp_rma_nonblocking_cb(ucp_ep_h ep, const void *buffer, size_t length,
+                       uint64_t remote_addr, ucp_rkey_h rkey,
+                       uct_pending_callback_t progress_cb, size_t zcopy_thresh,
+                       ucp_send_callback_t cb)
+{
+    ucs_status_t status;
+    ucp_request_t *req;
+
+    req = ucp_request_get(ep->worker);
+    if (req == NULL) {
+        return UCS_STATUS_PTR(UCS_ERR_NO_MEMORY);
+    }
+
+    status = ucp_rma_request_init(req, ep, buffer, length, remote_addr, rkey,
+                                  progress_cb, zcopy_thresh, 0);
+    if (ucs_unlikely(status != UCS_OK)) {
+        ucp_request_put(req);
+        return UCS_STATUS_PTR(status);
+    }
+
+    status = ucp_request_start_send(req);
+    if ((req->flags & UCP_REQUEST_FLAG_COMPLETED) ||
+        ((status < 0) && (req->send.uct_comp.count == 0))) {
+        /* completed, or failed without any fragment in flight */
+        ucs_trace_req("releasing send request %p, returning status %s", req,
+                      ucs_status_string(status));
+        if (!(req->flags & UCP_REQUEST_FLAG_COMPLETED) &&
+            (req->send.state.dt.contig.memh != UCT_MEM_HANDLE_NULL)) {
+            ucp_request_send_buffer_dereg(req, req->send.lane);
+        }
+        ucp_request_put(req);
+        return UCS_STATUS_PTR(status);
+    }
+
+    ucs_trace_req("returning rma request %p, status %s", req,
+                  ucs_status_string(status));
+    ucp_request_set_callback(req, send.cb, cb);
+    return req + 1;
+}
+
 UCS_PROFILE_FUNC(ucs_status_t, ucp_put, (ep, buffer, length, remote_addr, rkey),
                  ucp_ep_h ep, const void *buffer, size_t length,
                  uint64_t remote_addr, ucp_rkey_h rkey)
@@ -396,6 +451,70 @@ out_unlock:
     return status;
 }
 
+UCS_PROFILE_FUNC(ucs_status_ptr_t, ucp_put_nb,
+                 (ep, buffer, length, remote_addr, rkey, cb),
+                 ucp_ep_h ep, const void *buffer, size_t length,
+                 uint64_t remote_addr, ucp_rkey_h rkey, ucp_send_callback_t cb)
+{
+    ucp_ep_rma_config_t *rma_config;
+    ucs_status_ptr_t ptr_status;
+    ucs_status_t status;
+
+    UCP_RMA_CHECK_PARAMS_PTR(buffer, length);
+    UCP_THREAD_CS_ENTER_CONDITIONAL(&ep->worker->mt_lock);
+
+    status = UCP_RKEY_RESOLVE(rkey, ep, rma);
+    if (status != UCS_OK) {
+        ptr_status = UCS_STATUS_PTR(status);
+        goto out_unlock;
+    }
+
+    /* Fast path for a single short message */
+    if (ucs_likely(length <= rkey->cache.max_put_short)) {
+        status = UCS_PROFILE_CALL(uct_ep_put_short, ep->uct_eps[rkey->cache.rma_lane],
+                                  buffer, length, remote_addr, rkey->cache.rma_rkey);
+        if (ucs_likely(status != UCS_ERR_NO_RESOURCE)) {
+            ptr_status = UCS_STATUS_PTR(status);
+            goto out_unlock;
+        }
+    }
+
+    rma_config = &ucp_ep_config(ep)->rma[rkey->cache.rma_lane];
+    ptr_status = ucp_rma_nonblocking_cb(ep, buffer, length, remote_addr, rkey,
+                                        ucp_progress_put,
+                                        rma_config->put_zcopy_thresh, cb);
+out_unlock:
+    UCP_THREAD_CS_EXIT_CONDITIONAL(&ep->worker->mt_lock);
+    return ptr_status;
+}
+
+UCS_PROFILE_FUNC(ucs_status_ptr_t, ucp_get_nb,
+                 (ep, buffer, length, remote_addr, rkey, cb),
+                 ucp_ep_h ep, void *buffer, size_t length,
+                 uint64_t remote_addr, ucp_rkey_h rkey, ucp_send_callback_t cb)
+{
+    ucp_ep_rma_config_t *rma_config;
+    ucs_status_ptr_t ptr_status;
+    ucs_status_t status;
+
+    UCP_RMA_CHECK_PARAMS_PTR(buffer, length);
+    UCP_THREAD_CS_ENTER_CONDITIONAL(&ep->worker->mt_lock);
+
+    status = UCP_RKEY_RESOLVE(rkey, ep, rma);
+    if (status != UCS_OK) {
+        ptr_status = UCS_STATUS_PTR(status);
+        goto out_unlock;
+    }
+
+    rma_config = &ucp_ep_config(ep)->rma[rkey->cache.rma_lane];
+    ptr_status = ucp_rma_nonblocking_cb(ep, buffer, length, remote_addr, rkey,
+                                        ucp_progress_get,
+                                        rma_config->get_zcopy_thresh, cb);
+out_unlock:
+    UCP_THREAD_CS_EXIT_CONDITIONAL(&ep->worker->mt_lock);
+    return ptr_status;
+}
+
 UCS_PROFILE_FUNC(ucs_status_t, ucp_worker_fence, (worker), ucp_worker_h worker)
 {
     unsigned rsc_index;
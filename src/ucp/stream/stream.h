@@ -0,0 +1,27 @@
+/**
+ * Copyright (C) Mellanox Technologies Ltd. 2001-2017.  ALL RIGHTS RESERVED.
+ *
+ * See file LICENSE for terms.
+ */
+
+#ifndef UCP_STREAM_H_
+#define UCP_STREAM_H_
+
+#include <ucp/core/ucp_ep.h>
+#include <ucs/sys/compiler.h>
+
+
+/*
+ * STREAM_DATA
+ */
+typedef struct {
+    uint64_t                  sender_uuid; /* Identifies the stream endpoint
+                                              on the receiver */
+} UCS_S_PACKED ucp_stream_am_hdr_t;
+
+
+void ucp_stream_ep_init(ucp_ep_h ep);
+
+void ucp_stream_ep_cleanup(ucp_ep_h ep);
+
+#endif
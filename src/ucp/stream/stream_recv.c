@@ -0,0 +1,230 @@
+/**
+ * Copyright (C) Mellanox Technologies Ltd. 2001-2017.  ALL RIGHTS RESERVED.
+ *
+ * See file LICENSE for terms.
+ */
+
+#include "stream.h"
+
+#include <ucp/core/ucp_context.h>
+#include <ucp/core/ucp_worker.h>
+#include <ucp/core/ucp_request.inl>
+#include <ucs/datastruct/list.h>
+#include <ucs/datastruct/mpool.inl>
+#include <string.h>
+
+
+static UCS_F_ALWAYS_INLINE void *ucp_stream_rdesc_data(ucp_recv_desc_t *rdesc)
+{
+    return (void*)(rdesc + 1) + rdesc->stream.offset;
+}
+
+static UCS_F_ALWAYS_INLINE void ucp_stream_rdesc_release(ucp_recv_desc_t *rdesc)
+{
+    if (ucs_unlikely(rdesc->flags & UCP_RECV_DESC_FLAG_UCT_DESC)) {
+        uct_iface_release_desc(rdesc); /* uct desc is slowpath */
+    } else {
+        ucs_mpool_put_inline(rdesc);
+    }
+}
+
+/*
+ * A receive is completed when its buffer is full, or when it has any data and
+ * the user did not ask to wait for all of it.
+ */
+static UCS_F_ALWAYS_INLINE int ucp_stream_recv_is_done(ucp_request_t *req)
+{
+    return (req->recv.state.offset == req->recv.length) ||
+           ((req->recv.state.offset > 0) &&
+            !(req->flags & UCP_REQUEST_FLAG_STREAM_RECV_WAITALL));
+}
+
+/*
+ * Copy stream data to the buffer of a receive request, as much as fits.
+ * @a length_p is updated to the amount of data consumed.
+ */
+static UCS_F_ALWAYS_INLINE ucs_status_t
+ucp_stream_recv_unpack(ucp_request_t *req, const void *data, size_t *length_p)
+{
+    size_t length = ucs_min(*length_p,
+                            req->recv.length - req->recv.state.offset);
+    ucs_status_t status;
+
+    UCS_PROFILE_REQUEST_EVENT(req, "stream_recv", length);
+    status = ucp_dt_unpack(req->recv.datatype, req->recv.buffer,
+                           req->recv.length, &req->recv.state, data, length, 0);
+    req->recv.state.offset += length;
+    *length_p               = length;
+    return status;
+}
+
+static ucs_status_t ucp_stream_am_handler(void *am_arg, void *am_data,
+                                          size_t am_length, unsigned am_flags)
+{
+    ucp_worker_h worker      = am_arg;
+    ucp_stream_am_hdr_t *hdr = am_data;
+    size_t offset            = sizeof(*hdr);
+    ucp_recv_desc_t *rdesc;
+    ucp_request_t *req;
+    ucs_status_t status;
+    size_t length;
+    ucp_ep_h ep;
+
+    ucs_assert(am_length >= sizeof(*hdr));
+    ep = ucp_worker_get_reply_ep(worker, hdr->sender_uuid);
+
+    /* Place the data directly in the buffers of posted receives */
+    while ((offset < am_length) && !ucs_list_is_empty(&ep->stream.recv_list)) {
+        req     = ucs_list_head(&ep->stream.recv_list, ucp_request_t, recv.list);
+        length  = am_length - offset;
+        status  = ucp_stream_recv_unpack(req, am_data + offset, &length);
+        offset += length;
+        if ((status != UCS_OK) || ucp_stream_recv_is_done(req)) {
+            ucs_list_del(&req->recv.list);
+            ucp_request_complete_stream_recv(req, status);
+        }
+    }
+
+    if (offset == am_length) {
+        return UCS_OK;
+    }
+
+    /* Keep the rest of the data until a receive is posted */
+    if (ucs_unlikely(am_flags & UCT_CB_FLAG_DESC)) {
+        rdesc                = (ucp_recv_desc_t*)am_data - 1;
+        rdesc->flags         = UCP_RECV_DESC_FLAG_UCT_DESC;
+        rdesc->length        = am_length;
+        rdesc->stream.offset = offset;
+        status               = UCS_INPROGRESS;
+    } else {
+        rdesc = (ucp_recv_desc_t*)ucs_mpool_get_inline(&worker->am_mp);
+        if (rdesc == NULL) {
+            ucs_error("ucp recv descriptor is not allocated");
+            return UCS_ERR_NO_MEMORY;
+        }
+
+        rdesc->flags         = 0;
+        rdesc->length        = am_length - offset;
+        rdesc->stream.offset = 0;
+        memcpy(rdesc + 1, am_data + offset, rdesc->length);
+        status               = UCS_OK;
+    }
+
+    rdesc->hdr_len = 0;
+    ucs_trace_req("ep %p: stream recv length %zu desc %p", ep,
+                  rdesc->length - rdesc->stream.offset, rdesc);
+    ucs_list_add_tail(&ep->stream.rdesc_list, &rdesc->stream.list);
+    return status;
+}
+
+UCS_PROFILE_FUNC(ucs_status_ptr_t, ucp_stream_recv_nb,
+                 (ep, buffer, count, datatype, cb, length, flags),
+                 ucp_ep_h ep, void *buffer, size_t count,
+                 uintptr_t datatype, ucp_stream_recv_callback_t cb,
+                 size_t *length, unsigned flags)
+{
+    ucs_status_t status = UCS_OK;
+    ucp_recv_desc_t *rdesc;
+    ucp_request_t *req;
+    ucs_status_ptr_t ret;
+    size_t recv_len;
+
+    UCP_THREAD_CS_ENTER_CONDITIONAL(&ep->worker->mt_lock);
+
+    ucs_trace_req("stream_recv_nb buffer %p count %zu from %s flags 0x%x",
+                  buffer, count, ucp_ep_peer_name(ep), flags);
+
+    req = ucp_request_get(ep->worker);
+    if (ucs_unlikely(req == NULL)) {
+        ret = UCS_STATUS_PTR(UCS_ERR_NO_MEMORY);
+        goto out;
+    }
+
+    req->flags = UCP_REQUEST_FLAG_RECV | UCP_REQUEST_FLAG_STREAM_RECV;
+    if (flags & UCP_STREAM_RECV_FLAG_WAITALL) {
+        req->flags |= UCP_REQUEST_FLAG_STREAM_RECV_WAITALL;
+    }
+    req->recv.buffer   = buffer;
+    req->recv.datatype = datatype;
+    ucp_dt_recv_state_init(&req->recv.state, buffer, count, datatype);
+    req->recv.length   = ucp_dt_length(datatype, count, buffer,
+                                       &req->recv.state);
+
+    /* Consume the data which has already arrived. If there are posted
+     * receives, all the data went to them and this list is empty. */
+    while (!ucp_stream_recv_is_done(req) &&
+           !ucs_list_is_empty(&ep->stream.rdesc_list)) {
+        rdesc    = ucs_list_head(&ep->stream.rdesc_list, ucp_recv_desc_t,
+                                 stream.list);
+        recv_len = rdesc->length - rdesc->stream.offset;
+        status   = ucp_stream_recv_unpack(req, ucp_stream_rdesc_data(rdesc),
+                                          &recv_len);
+        rdesc->stream.offset += recv_len;
+        if (rdesc->stream.offset == rdesc->length) {
+            ucs_list_del(&rdesc->stream.list);
+            ucp_stream_rdesc_release(rdesc);
+        }
+        if (status != UCS_OK) {
+            break;
+        }
+    }
+
+    if ((status != UCS_OK) || ucp_stream_recv_is_done(req)) {
+        ucs_trace_req("stream_recv_nb completed in place, length %zu, %s",
+                      req->recv.state.offset, ucs_status_string(status));
+        ucp_request_recv_generic_dt_finish(req);
+        *length = req->recv.state.offset;
+        ucp_request_put(req);
+        ret = UCS_STATUS_PTR(status);
+        goto out;
+    }
+
+    ucp_request_set_callback(req, recv.stream_cb, cb);
+    ucs_list_add_tail(&ep->stream.recv_list, &req->recv.list);
+    ucs_trace_req("stream_recv_nb returning request %p (%p)", req, req + 1);
+    ret = req + 1;
+
+out:
+    UCP_THREAD_CS_EXIT_CONDITIONAL(&ep->worker->mt_lock);
+    return ret;
+}
+
+void ucp_stream_ep_init(ucp_ep_h ep)
+{
+    ucs_list_head_init(&ep->stream.rdesc_list);
+    ucs_list_head_init(&ep->stream.recv_list);
+}
+
+void ucp_stream_ep_cleanup(ucp_ep_h ep)
+{
+    ucp_recv_desc_t *rdesc;
+    ucp_request_t *req;
+
+    while (!ucs_list_is_empty(&ep->stream.rdesc_list)) {
+        rdesc = ucs_list_extract_head(&ep->stream.rdesc_list, ucp_recv_desc_t,
+                                      stream.list);
+        ucp_stream_rdesc_release(rdesc);
+    }
+
+    while (!ucs_list_is_empty(&ep->stream.recv_list)) {
+        req = ucs_list_extract_head(&ep->stream.recv_list, ucp_request_t,
+                                    recv.list);
+        ucp_request_complete_stream_recv(req, UCS_ERR_CANCELED);
+    }
+}
+
+static void ucp_stream_dump(ucp_worker_h worker, uct_am_trace_type_t type,
+                            uint8_t id, const void *data, size_t length,
+                            char *buffer, size_t max)
+{
+    const ucp_stream_am_hdr_t *hdr = data;
+    char *p;
+
+    snprintf(buffer, max, "STREAM uuid %"PRIx64, hdr->sender_uuid);
+    p = buffer + strlen(buffer);
+    ucp_dump_payload(worker->context, p, buffer + max - p, data + sizeof(*hdr),
+                     length - sizeof(*hdr));
+}
+
+UCP_DEFINE_AM(UCP_FEATURE_STREAM, UCP_AM_ID_STREAM_DATA, ucp_stream_am_handler,
+              ucp_stream_dump, UCT_AM_CB_FLAG_SYNC);
@@ -0,0 +1,248 @@
+/**
+ * Copyright (C) Mellanox Technologies Ltd. 2001-2017.  ALL RIGHTS RESERVED.
+ *
+ * See file LICENSE for terms.
+ */
+
+#include "stream.h"
+
+#include <ucp/core/ucp_worker.h>
+#include <ucp/core/ucp_request.inl>
+#include <ucp/proto/proto.h>
+#include <ucp/proto/proto_am.inl>
+
+
+/* All the fragments of the stream carry the same header, since the receiver
+ * only appends the data to the stream of the sending endpoint */
+
+static size_t ucp_stream_pack_am_single_dt(void *dest, void *arg)
+{
+    ucp_stream_am_hdr_t *hdr = dest;
+    ucp_request_t *req       = arg;
+    size_t length;
+
+    hdr->sender_uuid = req->send.ep->worker->uuid;
+
+    ucs_assert(req->send.state.offset == 0);
+    length = ucp_dt_pack(req->send.datatype, hdr + 1, req->send.buffer,
+                         &req->send.state, req->send.length, req->send.length);
+    ucs_assert(length == req->send.length);
+    return sizeof(*hdr) + length;
+}
+
+static size_t ucp_stream_pack_am_middle_dt(void *dest, void *arg)
+{
+    ucp_stream_am_hdr_t *hdr = dest;
+    ucp_request_t *req       = arg;
+    size_t length;
+
+    length           = ucp_ep_config(req->send.ep)->am.max_bcopy - sizeof(*hdr);
+    hdr->sender_uuid = req->send.ep->worker->uuid;
+
+    ucs_debug("pack stream_middle paylen %zu offset %zu", length,
+              req->send.state.offset);
+    ucs_assert(req->send.length > req->send.state.offset + length);
+    return sizeof(*hdr) + ucp_dt_pack(req->send.datatype, hdr + 1,
+                                      req->send.buffer, &req->send.state,
+                                      length, req->send.length);
+}
+
+static size_t ucp_stream_pack_am_last_dt(void *dest, void *arg)
+{
+    ucp_stream_am_hdr_t *hdr = dest;
+    ucp_request_t *req       = arg;
+    size_t length, ret_length;
+
+    length           = req->send.length - req->send.state.offset;
+    hdr->sender_uuid = req->send.ep->worker->uuid;
+    ret_length       = ucp_dt_pack(req->send.datatype, hdr + 1,
+                                   req->send.buffer, &req->send.state, length,
+                                   req->send.length);
+    ucs_debug("pack stream_last paylen %zu offset %zu", length,
+              req->send.state.offset);
+    ucs_assertv(ret_length == length, "length=%zu, max_length=%zu",
+                ret_length, length);
+    return sizeof(*hdr) + ret_length;
+}
+
+static inline ucs_status_t
+ucp_stream_send_am_short(ucp_ep_t *ep, const void *buffer, size_t length)
+{
+    UCS_STATIC_ASSERT(sizeof(ucp_stream_am_hdr_t) == sizeof(uint64_t));
+    return uct_ep_am_short(ucp_ep_get_am_uct_ep(ep), UCP_AM_ID_STREAM_DATA,
+                           ep->worker->uuid, buffer, length);
+}
+
+static ucs_status_t ucp_stream_contig_am_short(uct_pending_req_t *self)
+{
+    ucp_request_t *req = ucs_container_of(self, ucp_request_t, send.uct);
+    ucs_status_t status;
+
+    req->send.lane = ucp_ep_get_am_lane(req->send.ep);
+    status = ucp_stream_send_am_short(req->send.ep, req->send.buffer,
+                                      req->send.length);
+    if (status != UCS_OK) {
+        return status;
+    }
+
+    ucp_request_complete_send(req, UCS_OK);
+    return UCS_OK;
+}
+
+static ucs_status_t ucp_stream_bcopy_single(uct_pending_req_t *self)
+{
+    ucs_status_t status = ucp_do_am_bcopy_single(self, UCP_AM_ID_STREAM_DATA,
+                                                 ucp_stream_pack_am_single_dt);
+    if (status == UCS_OK) {
+        ucp_request_t *req = ucs_container_of(self, ucp_request_t, send.uct);
+        ucp_request_send_generic_dt_finish(req);
+        ucp_request_complete_send(req, UCS_OK);
+    }
+    return status;
+}
+
+static ucs_status_t ucp_stream_bcopy_multi(uct_pending_req_t *self)
+{
+    ucs_status_t status = ucp_do_am_bcopy_multi(self,
+                                                UCP_AM_ID_STREAM_DATA,
+                                                UCP_AM_ID_STREAM_DATA,
+                                                UCP_AM_ID_STREAM_DATA,
+                                                sizeof(ucp_stream_am_hdr_t),
+                                                ucp_stream_pack_am_middle_dt,
+                                                ucp_stream_pack_am_middle_dt,
+                                                ucp_stream_pack_am_last_dt);
+    if (status == UCS_OK) {
+        ucp_request_t *req = ucs_container_of(self, ucp_request_t, send.uct);
+        ucp_request_send_generic_dt_finish(req);
+        ucp_request_complete_send(req, UCS_OK);
+    }
+    return status;
+}
+
+static void ucp_stream_zcopy_req_complete(ucp_request_t *req)
+{
+    ucp_request_send_buffer_dereg(req, req->send.lane);
+    ucp_request_complete_send(req, UCS_OK);
+}
+
+static ucs_status_t ucp_stream_zcopy_single(uct_pending_req_t *self)
+{
+    ucp_request_t *req = ucs_container_of(self, ucp_request_t, send.uct);
+    ucp_stream_am_hdr_t hdr;
+
+    hdr.sender_uuid = req->send.ep->worker->uuid;
+    return ucp_do_am_zcopy_single(self, UCP_AM_ID_STREAM_DATA, &hdr,
+                                  sizeof(hdr), ucp_stream_zcopy_req_complete);
+}
+
+static ucs_status_t ucp_stream_zcopy_multi(uct_pending_req_t *self)
+{
+    ucp_request_t *req = ucs_container_of(self, ucp_request_t, send.uct);
+    ucp_stream_am_hdr_t hdr;
+
+    hdr.sender_uuid = req->send.ep->worker->uuid;
+    return ucp_do_am_zcopy_multi(self,
+                                 UCP_AM_ID_STREAM_DATA,
+                                 UCP_AM_ID_STREAM_DATA,
+                                 UCP_AM_ID_STREAM_DATA,
+                                 &hdr, sizeof(hdr),
+                                 &hdr, sizeof(hdr),
+                                 ucp_stream_zcopy_req_complete);
+}
+
+static void ucp_stream_zcopy_completion(uct_completion_t *self,
+                                        ucs_status_t status)
+{
+    ucp_request_t *req = ucs_container_of(self, ucp_request_t, send.uct_comp);
+    ucp_stream_zcopy_req_complete(req);
+}
+
+static const ucp_proto_t ucp_stream_am_proto = {
+    .contig_short            = ucp_stream_contig_am_short,
+    .bcopy_single            = ucp_stream_bcopy_single,
+    .bcopy_multi             = ucp_stream_bcopy_multi,
+    .zcopy_single            = ucp_stream_zcopy_single,
+    .zcopy_multi             = ucp_stream_zcopy_multi,
+    .zcopy_completion        = ucp_stream_zcopy_completion,
+    .only_hdr_size           = sizeof(ucp_stream_am_hdr_t),
+    .first_hdr_size          = sizeof(ucp_stream_am_hdr_t),
+    .mid_hdr_size            = sizeof(ucp_stream_am_hdr_t)
+};
+
+UCS_PROFILE_FUNC(ucs_status_ptr_t, ucp_stream_send_nb,
+                 (ep, buffer, count, datatype, cb),
+                 ucp_ep_h ep, const void *buffer, size_t count,
+                 uintptr_t datatype, ucp_send_callback_t cb)
+{
+    ucs_status_t status;
+    ucp_request_t *req;
+    size_t length;
+    ucs_status_ptr_t ret;
+
+    UCP_THREAD_CS_ENTER_CONDITIONAL(&ep->worker->mt_lock);
+
+    ucs_trace_req("stream_send_nb buffer %p count %zu to %s cb %p",
+                  buffer, count, ucp_ep_peer_name(ep), cb);
+
+    /* Remote side needs an endpoint to queue the data on, so have it connect
+     * to us */
+    ucp_ep_connect_remote(ep);
+
+    if (ucs_likely(UCP_DT_IS_CONTIG(datatype))) {
+        length = ucp_contig_dt_length(datatype, count);
+        if (ucs_likely((ssize_t)length <= ucp_ep_config(ep)->am.max_eager_short)) {
+            status = UCS_PROFILE_CALL(ucp_stream_send_am_short, ep, buffer,
+                                      length);
+            if (ucs_likely(status != UCS_ERR_NO_RESOURCE)) {
+                ret = UCS_STATUS_PTR(status); /* UCS_OK also goes here */
+                goto out;
+            }
+        }
+    }
+
+    req = ucp_request_get(ep->worker);
+    if (req == NULL) {
+        ret = UCS_STATUS_PTR(UCS_ERR_NO_MEMORY);
+        goto out;
+    }
+
+    req->flags             = 0;
+    req->send.ep           = ep;
+    req->send.buffer       = buffer;
+    req->send.datatype     = datatype;
+    req->send.state.offset = 0;
+#if ENABLE_ASSERT
+    req->send.lane         = UCP_NULL_LANE;
+#endif
+
+    status = ucp_proto_am_req_start(req, count,
+                                    ucp_ep_config(ep)->am.max_eager_short,
+                                    &ucp_stream_am_proto);
+    if (status != UCS_OK) {
+        ucp_request_put(req);
+        ret = UCS_STATUS_PTR(status);
+        goto out;
+    }
+
+    /*
+     * Start the request.
+     * If it is completed immediately, release the request and return the status.
+     * Otherwise, return the request.
+     */
+    status = ucp_request_start_send(req);
+    if (req->flags & UCP_REQUEST_FLAG_COMPLETED) {
+        ucs_trace_req("releasing stream send request %p, returning status %s",
+                      req, ucs_status_string(status));
+        ucp_request_put(req);
+        ret = UCS_STATUS_PTR(status);
+        goto out;
+    }
+
+    ucp_request_set_callback(req, send.cb, cb)
+    ucs_trace_req("returning stream send request %p", req);
+    ret = req + 1;
+
+out:
+    UCP_THREAD_CS_EXIT_CONDITIONAL(&ep->worker->mt_lock);
+    return ret;
+}
@@ -17,11 +17,10 @@
 
 
 /*
- * EAGER_ONLY, EAGER_MIDDLE, EAGER_LAST
+ * EAGER_ONLY
  */
 typedef struct {
     ucp_tag_hdr_t             super;
-    /* TODO offset/sequence number */
 } UCS_S_PACKED ucp_eager_hdr_t;
 
 
@@ -31,9 +30,19 @@ typedef struct {
 typedef struct {
     ucp_eager_hdr_t           super;
     size_t                    total_len;
+    ucp_tag_frag_key_t        frag;
 } UCS_S_PACKED ucp_eager_first_hdr_t;
 
 
+/*
+ * EAGER_MIDDLE, EAGER_LAST
+ */
+typedef struct {
+    ucp_eager_hdr_t           super;
+    ucp_tag_frag_key_t        frag;
+} UCS_S_PACKED ucp_eager_middle_hdr_t;
+
+
 /*
  * EAGER_SYNC_ONLY
  */
@@ -82,11 +91,27 @@ ucp_eager_total_len(ucp_eager_hdr_t *hdr, unsigned flags, unsigned payload_lengt
     }
 }
 
+/*
+ * Get the identifier of a multi-fragment message from the header of its
+ * fragment. Not valid for single-fragment messages.
+ */
+static UCS_F_ALWAYS_INLINE ucp_tag_frag_key_t*
+ucp_eager_frag_key(void *data, unsigned flags)
+{
+    ucs_assert(!ucs_test_all_flags(flags, UCP_RECV_DESC_FLAG_FIRST |
+                                          UCP_RECV_DESC_FLAG_LAST));
+    if (flags & UCP_RECV_DESC_FLAG_FIRST) {
+        return &((ucp_eager_first_hdr_t*)data)->frag;
+    } else {
+        return &((ucp_eager_middle_hdr_t*)data)->frag;
+    }
+}
+
 static UCS_F_ALWAYS_INLINE ucs_status_t
 ucp_eager_unexp_match(ucp_worker_h worker, ucp_recv_desc_t *rdesc, ucp_tag_t tag,
                       unsigned flags, void *buffer, size_t count,
                       ucp_datatype_t datatype, ucp_dt_state_t *state,
-                      ucp_tag_recv_info_t *info)
+                      ucp_tag_recv_info_t *info, ucp_tag_frag_key_t *frag)
 {
     size_t recv_len, hdr_len;
     ucs_status_t status;
@@ -119,6 +144,11 @@ ucp_eager_unexp_match(ucp_worker_h worker, ucp_recv_desc_t *rdesc, ucp_tag_t tag
         return status;
     }
 
+    if (flags & UCP_RECV_DESC_FLAG_FIRST) {
+        /* Remember which message the following fragments belong to */
+        *frag = *ucp_eager_frag_key(data, flags);
+    }
+
     return UCS_INPROGRESS;
 }
 
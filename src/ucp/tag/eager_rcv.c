@@ -56,7 +56,14 @@ ucp_eager_handler(void *arg, void *data, size_t length, unsigned am_flags,
     recv_tag = eager_hdr->super.tag;
     recv_len = length - hdr_len;
 
-    req = ucp_tag_exp_search(&context->tm, recv_tag, recv_len, flags);
+    if (flags & UCP_RECV_DESC_FLAG_FIRST) {
+        req = ucp_tag_exp_search(&context->tm, recv_tag, recv_len, flags);
+    } else {
+        /* The rest of the message goes directly to the matched request */
+        req = ucp_tag_frag_search(&context->tm, ucp_eager_frag_key(data, flags),
+                                  flags);
+    }
+
     if (req != NULL) {
         UCS_PROFILE_REQUEST_EVENT(req, "eager_recv", recv_len);
 
@@ -73,6 +80,8 @@ ucp_eager_handler(void *arg, void *data, size_t length, unsigned am_flags,
                 req->recv.info.length = recv_len;
             } else {
                 req->recv.info.length = eager_first_hdr->total_len;
+                req->recv.frag        = eager_first_hdr->frag;
+                ucp_tag_frag_add(&context->tm, req);
             }
         }
 
@@ -125,7 +134,7 @@ static ucs_status_t ucp_eager_middle_handler(void *arg, void *data, size_t lengt
 {
     return ucp_eager_handler(arg, data, length, am_flags,
                              UCP_RECV_DESC_FLAG_EAGER,
-                             sizeof(ucp_eager_hdr_t));
+                             sizeof(ucp_eager_middle_hdr_t));
 }
 
 static ucs_status_t ucp_eager_last_handler(void *arg, void *data, size_t length,
@@ -134,7 +143,7 @@ static ucs_status_t ucp_eager_last_handler(void *arg, void *data, size_t length,
     return ucp_eager_handler(arg, data, length, am_flags,
                              UCP_RECV_DESC_FLAG_EAGER|
                              UCP_RECV_DESC_FLAG_LAST,
-                             sizeof(ucp_eager_hdr_t));
+                             sizeof(ucp_eager_middle_hdr_t));
 }
 
 static ucs_status_t ucp_eager_sync_only_handler(void *arg, void *data,
@@ -175,6 +184,7 @@ static void ucp_eager_dump(ucp_worker_h worker, uct_am_trace_type_t type,
 {
     const ucp_eager_first_hdr_t *eager_first_hdr = data;
     const ucp_eager_hdr_t *eager_hdr             = data;
+    const ucp_eager_middle_hdr_t *eager_mid_hdr  = data;
     const ucp_eager_sync_first_hdr_t *eagers_first_hdr = data;
     const ucp_eager_sync_hdr_t *eagers_hdr       = data;
     const ucp_reply_hdr_t *rep_hdr               = data;
@@ -187,17 +197,24 @@ static void ucp_eager_dump(ucp_worker_h worker, uct_am_trace_type_t type,
         header_len = sizeof(*eager_hdr);
         break;
     case UCP_AM_ID_EAGER_FIRST:
-        snprintf(buffer, max, "EGR_F tag %"PRIx64" len %zu",
-                 eager_first_hdr->super.super.tag, eager_first_hdr->total_len);
+        snprintf(buffer, max, "EGR_F tag %"PRIx64" len %zu uuid %"PRIx64
+                 " msg_id %"PRIu64, eager_first_hdr->super.super.tag,
+                 eager_first_hdr->total_len,
+                 eager_first_hdr->frag.sender_uuid,
+                 eager_first_hdr->frag.msg_id);
         header_len = sizeof(*eager_first_hdr);
         break;
     case UCP_AM_ID_EAGER_MIDDLE:
-        snprintf(buffer, max, "EGR_M tag %"PRIx64, eager_hdr->super.tag);
-        header_len = sizeof(*eager_hdr);
+        snprintf(buffer, max, "EGR_M tag %"PRIx64" uuid %"PRIx64" msg_id %"PRIu64,
+                 eager_mid_hdr->super.super.tag, eager_mid_hdr->frag.sender_uuid,
+                 eager_mid_hdr->frag.msg_id);
+        header_len = sizeof(*eager_mid_hdr);
         break;
     case UCP_AM_ID_EAGER_LAST:
-        snprintf(buffer, max, "EGR_L tag %"PRIx64, eager_hdr->super.tag);
-        header_len = sizeof(*eager_hdr);
+        snprintf(buffer, max, "EGR_L tag %"PRIx64" uuid %"PRIx64" msg_id %"PRIu64,
+                 eager_mid_hdr->super.super.tag, eager_mid_hdr->frag.sender_uuid,
+                 eager_mid_hdr->frag.msg_id);
+        header_len = sizeof(*eager_mid_hdr);
         break;
     case UCP_AM_ID_EAGER_SYNC_ONLY:
         snprintf(buffer, max, "EGRS tag %"PRIx64" uuid %"PRIx64" request 0x%lx",
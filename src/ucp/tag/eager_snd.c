@@ -23,7 +23,7 @@ static size_t ucp_tag_pack_eager_single_dt(void *dest, void *arg)
 
     ucs_assert(req->send.state.offset == 0);
     length = ucp_dt_pack(req->send.datatype, hdr + 1, req->send.buffer,
-                         &req->send.state, req->send.length);
+                         &req->send.state, req->send.length, req->send.length);
     ucs_assert(length == req->send.length);
     return sizeof(*hdr) + length;
 }
@@ -40,7 +40,7 @@ static size_t ucp_tag_pack_eager_sync_single_dt(void *dest, void *arg)
 
     ucs_assert(req->send.state.offset == 0);
     length = ucp_dt_pack(req->send.datatype, hdr + 1, req->send.buffer,
-                         &req->send.state, req->send.length);
+                         &req->send.state, req->send.length, req->send.length);
     ucs_assert(length == req->send.length);
     return sizeof(*hdr) + length;
 }
@@ -51,17 +51,19 @@ static size_t ucp_tag_pack_eager_first_dt(void *dest, void *arg)
     ucp_request_t *req = arg;
     size_t length;
 
-    length               = ucp_ep_config(req->send.ep)->am.max_bcopy -
-                                         sizeof(*hdr);
-    hdr->super.super.tag = req->send.tag;
-    hdr->total_len       = req->send.length;
+    length                 = ucp_ep_config(req->send.ep)->am.max_bcopy -
+                             sizeof(*hdr);
+    hdr->super.super.tag   = req->send.tag;
+    hdr->total_len         = req->send.length;
+    hdr->frag.sender_uuid  = req->send.ep->worker->uuid;
+    hdr->frag.msg_id       = req->send.msg_id;
 
     ucs_debug("pack eager_first paylen %zu", length);
     ucs_assert(req->send.state.offset == 0);
     ucs_assert(req->send.length > length);
     return sizeof(*hdr) + ucp_dt_pack(req->send.datatype, hdr + 1,
                                       req->send.buffer, &req->send.state,
-                                      length);
+                                      length, req->send.length);
 }
 
 static size_t ucp_tag_pack_eager_sync_first_dt(void *dest, void *arg)
@@ -70,46 +72,56 @@ static size_t ucp_tag_pack_eager_sync_first_dt(void *dest, void *arg)
     ucp_request_t *req = arg;
     size_t length;
 
-    length                     = ucp_ep_config(req->send.ep)->am.max_bcopy -
-                                 sizeof(*hdr);
-    hdr->super.super.super.tag = req->send.tag;
-    hdr->super.total_len       = req->send.length;
-    hdr->req.sender_uuid       = req->send.ep->worker->uuid;
-    hdr->req.reqptr            = (uintptr_t)req;
+    length                      = ucp_ep_config(req->send.ep)->am.max_bcopy -
+                                  sizeof(*hdr);
+    hdr->super.super.super.tag  = req->send.tag;
+    hdr->super.total_len        = req->send.length;
+    hdr->super.frag.sender_uuid = req->send.ep->worker->uuid;
+    hdr->super.frag.msg_id      = req->send.msg_id;
+    hdr->req.sender_uuid        = req->send.ep->worker->uuid;
+    hdr->req.reqptr             = (uintptr_t)req;
 
     ucs_debug("pack eager_sync_first paylen %zu", length);
     ucs_assert(req->send.state.offset == 0);
     ucs_assert(req->send.length > length);
     return sizeof(*hdr) + ucp_dt_pack(req->send.datatype, hdr + 1,
                                       req->send.buffer, &req->send.state,
-                                      length);
+                                      length, req->send.length);
+}
+
+static void ucp_tag_eager_middle_hdr_init(ucp_eager_middle_hdr_t *hdr,
+                                          ucp_request_t *req)
+{
+    hdr->super.super.tag  = req->send.tag;
+    hdr->frag.sender_uuid = req->send.ep->worker->uuid;
+    hdr->frag.msg_id      = req->send.msg_id;
 }
 
 static size_t ucp_tag_pack_eager_middle_dt(void *dest, void *arg)
 {
-    ucp_eager_hdr_t *hdr = dest;
+    ucp_eager_middle_hdr_t *hdr = dest;
     ucp_request_t *req = arg;
     size_t length;
 
     length         = ucp_ep_config(req->send.ep)->am.max_bcopy - sizeof(*hdr);
     ucs_debug("pack eager_middle paylen %zu offset %zu", length,
               req->send.state.offset);
-    hdr->super.tag = req->send.tag;
+    ucp_tag_eager_middle_hdr_init(hdr, req);
     return sizeof(*hdr) + ucp_dt_pack(req->send.datatype, hdr + 1,
                                       req->send.buffer, &req->send.state,
-                                      length);
+                                      length, req->send.length);
 }
 
 static size_t ucp_tag_pack_eager_last_dt(void *dest, void *arg)
 {
-    ucp_eager_hdr_t *hdr = dest;
+    ucp_eager_middle_hdr_t *hdr = dest;
     ucp_request_t *req = arg;
     size_t length, ret_length;
 
     length         = req->send.length - req->send.state.offset;
-    hdr->super.tag = req->send.tag;
+    ucp_tag_eager_middle_hdr_init(hdr, req);
     ret_length     = ucp_dt_pack(req->send.datatype, hdr + 1, req->send.buffer,
-                                 &req->send.state, length);
+                                 &req->send.state, length, req->send.length);
     ucs_debug("pack eager_last paylen %zu offset %zu", length,
               req->send.state.offset);
     ucs_assertv(ret_length == length, "length=%zu, max_length=%zu",
@@ -154,7 +166,7 @@ static ucs_status_t ucp_tag_eager_bcopy_multi(uct_pending_req_t *self)
                                                 UCP_AM_ID_EAGER_FIRST,
                                                 UCP_AM_ID_EAGER_MIDDLE,
                                                 UCP_AM_ID_EAGER_LAST,
-                                                sizeof(ucp_eager_hdr_t),
+                                                sizeof(ucp_eager_middle_hdr_t),
                                                 ucp_tag_pack_eager_first_dt,
                                                 ucp_tag_pack_eager_middle_dt,
                                                 ucp_tag_pack_eager_last_dt);
@@ -186,15 +198,19 @@ static ucs_status_t ucp_tag_eager_zcopy_multi(uct_pending_req_t *self)
 {
     ucp_request_t *req = ucs_container_of(self, ucp_request_t, send.uct);
     ucp_eager_first_hdr_t first_hdr;
+    ucp_eager_middle_hdr_t middle_hdr;
 
-    first_hdr.super.super.tag = req->send.tag;
-    first_hdr.total_len       = req->send.length;
+    first_hdr.super.super.tag  = req->send.tag;
+    first_hdr.total_len        = req->send.length;
+    first_hdr.frag.sender_uuid = req->send.ep->worker->uuid;
+    first_hdr.frag.msg_id      = req->send.msg_id;
+    ucp_tag_eager_middle_hdr_init(&middle_hdr, req);
     return ucp_do_am_zcopy_multi(self,
                                  UCP_AM_ID_EAGER_FIRST,
                                  UCP_AM_ID_EAGER_MIDDLE,
                                  UCP_AM_ID_EAGER_LAST,
                                  &first_hdr, sizeof(first_hdr),
-                                 &first_hdr.super, sizeof(first_hdr.super),
+                                 &middle_hdr, sizeof(middle_hdr),
                                  ucp_tag_eager_zcopy_req_complete);
 }
 
@@ -214,7 +230,7 @@ const ucp_proto_t ucp_tag_eager_proto = {
     .zcopy_completion        = ucp_tag_eager_zcopy_completion,
     .only_hdr_size           = sizeof(ucp_eager_hdr_t),
     .first_hdr_size          = sizeof(ucp_eager_first_hdr_t),
-    .mid_hdr_size            = sizeof(ucp_eager_hdr_t)
+    .mid_hdr_size            = sizeof(ucp_eager_middle_hdr_t)
 };
 
 /* eager sync */
@@ -249,7 +265,7 @@ static ucs_status_t ucp_tag_eager_sync_bcopy_multi(uct_pending_req_t *self)
                                                 UCP_AM_ID_EAGER_SYNC_FIRST,
                                                 UCP_AM_ID_EAGER_MIDDLE,
                                                 UCP_AM_ID_EAGER_LAST,
-                                                sizeof(ucp_eager_hdr_t),
+                                                sizeof(ucp_eager_middle_hdr_t),
                                                 ucp_tag_pack_eager_sync_first_dt,
                                                 ucp_tag_pack_eager_middle_dt,
                                                 ucp_tag_pack_eager_last_dt);
@@ -284,17 +300,21 @@ static ucs_status_t ucp_tag_eager_sync_zcopy_multi(uct_pending_req_t *self)
 {
     ucp_request_t *req = ucs_container_of(self, ucp_request_t, send.uct);
     ucp_eager_sync_first_hdr_t first_hdr;
-
-    first_hdr.super.super.super.tag = req->send.tag;
-    first_hdr.super.total_len       = req->send.length;
-    first_hdr.req.sender_uuid       = req->send.ep->worker->uuid;
-    first_hdr.req.reqptr            = (uintptr_t)req;
+    ucp_eager_middle_hdr_t middle_hdr;
+
+    first_hdr.super.super.super.tag  = req->send.tag;
+    first_hdr.super.total_len        = req->send.length;
+    first_hdr.super.frag.sender_uuid = req->send.ep->worker->uuid;
+    first_hdr.super.frag.msg_id      = req->send.msg_id;
+    first_hdr.req.sender_uuid        = req->send.ep->worker->uuid;
+    first_hdr.req.reqptr             = (uintptr_t)req;
+    ucp_tag_eager_middle_hdr_init(&middle_hdr, req);
     return ucp_do_am_zcopy_multi(self,
                                  UCP_AM_ID_EAGER_SYNC_FIRST,
                                  UCP_AM_ID_EAGER_MIDDLE,
                                  UCP_AM_ID_EAGER_LAST,
                                  &first_hdr, sizeof(first_hdr),
-                                 &first_hdr.super.super, sizeof(first_hdr.super.super),
+                                 &middle_hdr, sizeof(middle_hdr),
                                  ucp_tag_eager_sync_zcopy_req_complete);
 }
 
@@ -314,5 +334,5 @@ const ucp_proto_t ucp_tag_eager_sync_proto = {
     .zcopy_completion        = ucp_tag_eager_sync_zcopy_completion,
     .only_hdr_size           = sizeof(ucp_eager_sync_hdr_t),
     .first_hdr_size          = sizeof(ucp_eager_sync_first_hdr_t),
-    .mid_hdr_size            = sizeof(ucp_eager_hdr_t)
+    .mid_hdr_size            = sizeof(ucp_eager_middle_hdr_t)
 };
@@ -10,20 +10,22 @@
 
 #include <ucp/api/ucp.h>
 #include <ucp/core/ucp_worker.h>
-#include <ucs/datastruct/queue.h>
+#include <ucs/datastruct/list.h>
 
 
 static UCS_F_ALWAYS_INLINE ucp_recv_desc_t*
 ucp_tag_probe_search(ucp_context_h context, ucp_tag_t tag, uint64_t tag_mask,
                      ucp_tag_recv_info_t *info, int remove)
 {
-    ucp_recv_desc_t *rdesc;
+    ucp_recv_desc_t *rdesc, *trdesc;
+    ucs_list_link_t *list;
     ucp_tag_hdr_t *hdr;
-    ucs_queue_iter_t iter;
     ucp_tag_t recv_tag;
     unsigned flags;
+    int i_list;
 
-    ucs_queue_for_each_safe(rdesc, iter, &context->tm.unexpected, queue) {
+    list = ucp_tag_unexp_get_list(&context->tm, tag, tag_mask, &i_list);
+    ucp_tag_unexp_list_for_each_safe(rdesc, trdesc, list, i_list) {
         hdr      = (void*)(rdesc + 1);
         recv_tag = hdr->tag;
         flags    = rdesc->flags;
@@ -44,7 +46,7 @@ ucp_tag_probe_search(ucp_context_h context, ucp_tag_t tag, uint64_t tag_mask,
             }
 
             if (remove) {
-                ucs_queue_del_iter(&context->tm.unexpected, iter);
+                ucp_tag_unexp_remove(rdesc);
             }
             return rdesc;
         }
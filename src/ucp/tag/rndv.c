@@ -75,7 +75,8 @@ static size_t ucp_tag_rndv_rts_pack(void *dest, void *arg)
     if (UCP_DT_IS_CONTIG(sreq->send.datatype)) {
         rndv_rts_hdr->address = (uintptr_t) sreq->send.buffer;
         packed_len += ucp_tag_rndv_pack_rkey(sreq, rndv_rts_hdr);
-    } else if (UCP_DT_IS_GENERIC(sreq->send.datatype)) {
+    } else {
+        /* the data is not contiguous, and can be sent only by AM */
         rndv_rts_hdr->address = 0;
     }
 
@@ -151,6 +152,39 @@ static void ucp_rndv_send_ats(ucp_request_t *rndv_req, uintptr_t remote_request)
     ucp_request_start_send(rndv_req);
 }
 
+/* Get the key of the sender's buffer from the worker cache. If it fails, the
+ * key remains invalid, and the data is sent by active messages instead */
+static void ucp_rndv_rkey_unpack(ucp_request_t *rndv_req,
+                                 ucp_rndv_rts_hdr_t *rndv_rts_hdr,
+                                 size_t rkey_size)
+{
+    ucp_ep_h ep = rndv_req->send.ep;
+    ucp_rkey_cache_entry_t *entry;
+    ucs_status_t status;
+
+    status = ucp_rkey_cache_get(&ep->worker->rkey_cache,
+                                rndv_rts_hdr->sreq.sender_uuid,
+                                rndv_rts_hdr + 1, rkey_size, &entry);
+    if (status != UCS_OK) {
+        ucs_debug("failed to unpack rendezvous rkey: %s",
+                  ucs_status_string(status));
+        return;
+    }
+
+    rndv_req->send.rndv_get.rkey       = entry->rkey_bundle.rkey;
+    rndv_req->send.rndv_get.rkey_entry = entry;
+}
+
+static void ucp_rndv_rkey_release(ucp_request_t *rndv_req)
+{
+    if (rndv_req->send.rndv_get.rkey_entry != NULL) {
+        ucp_rkey_cache_put(&rndv_req->send.ep->worker->rkey_cache,
+                           rndv_req->send.rndv_get.rkey_entry);
+        rndv_req->send.rndv_get.rkey       = UCT_INVALID_RKEY;
+        rndv_req->send.rndv_get.rkey_entry = NULL;
+    }
+}
+
 static void ucp_rndv_complete_rndv_get(ucp_request_t *rndv_req)
 {
     ucp_request_t *rreq = rndv_req->send.rndv_get.rreq;
@@ -160,10 +194,7 @@ static void ucp_rndv_complete_rndv_get(ucp_request_t *rndv_req)
     UCS_PROFILE_REQUEST_EVENT(rreq, "complete_rndv_get", 0); // TODO
     ucp_request_complete_recv(rreq, UCS_OK);
 
-    if (rndv_req->send.rndv_get.rkey_bundle.rkey != UCT_INVALID_RKEY) {
-        uct_rkey_release(&rndv_req->send.rndv_get.rkey_bundle);
-    }
-
+    ucp_rndv_rkey_release(rndv_req);
     ucp_rndv_rma_request_send_buffer_dereg(rndv_req);
 
     ucp_rndv_send_ats(rndv_req, rndv_req->send.rndv_get.remote_request);
@@ -205,42 +236,81 @@ static void ucp_rndv_recv_am(ucp_request_t *rndv_req, ucp_request_t *rreq,
     }
 }
 
+/* Length of the next get_zcopy fragment on a rendezvous lane. The message is
+ * split between the lanes in proportion to their bandwidth, in units which
+ * fit into the maximal get_zcopy size of every lane. */
+static size_t ucp_rndv_get_frag_length(const ucp_ep_config_t *config,
+                                       ucp_lane_index_t lane_idx, size_t length)
+{
+    double scale_sum, unit;
+    ucp_lane_index_t i;
+
+    if (config->rndv.num_lanes == 1) {
+        return config->rndv.max_get_zcopy[0];
+    }
+
+    scale_sum = 0;
+    for (i = 0; i < config->rndv.num_lanes; ++i) {
+        scale_sum += config->rndv.bw_scale[i];
+    }
+
+    unit = ucs_max(1.0, length / scale_sum);
+    for (i = 0; i < config->rndv.num_lanes; ++i) {
+        unit = ucs_min(unit, config->rndv.max_get_zcopy[i] /
+                             config->rndv.bw_scale[i]);
+    }
+
+    return ucs_max((size_t)1,
+                   (size_t)(unit * config->rndv.bw_scale[lane_idx] + 0.5));
+}
+
 UCS_PROFILE_FUNC(ucs_status_t, ucp_proto_progress_rndv_get_zcopy, (self),
                  uct_pending_req_t *self)
 {
     ucp_request_t *rndv_req = ucs_container_of(self, ucp_request_t, send.uct);
+    ucp_ep_h ep             = rndv_req->send.ep;
+    ucp_ep_config_t *config;
     ucs_status_t status;
     size_t offset, length, ucp_mtu, align;
     uct_iov_t iov[1];
     ucp_rsc_index_t rsc_index;
+    ucp_lane_index_t lane_idx;
 
-    if (ucp_ep_is_stub(rndv_req->send.ep)) {
+    if (ucp_ep_is_stub(ep)) {
         return UCS_ERR_NO_RESOURCE;
     }
 
-    if (!(ucp_tag_rndv_is_get_op_possible(rndv_req->send.ep,
-                                          rndv_req->send.rndv_get.rkey_bundle.rkey))) {
+    if (!(ucp_tag_rndv_is_get_op_possible(ep,
+                                          rndv_req->send.rndv_get.rkey))) {
         /* can't perform get_zcopy - switch to AM rndv */
         ucp_rndv_recv_am(rndv_req, rndv_req->send.rndv_get.rreq,
                          rndv_req->send.rndv_get.remote_request,
                          rndv_req->send.length);
 
-        if (rndv_req->send.rndv_get.rkey_bundle.rkey != UCT_INVALID_RKEY) {
-            uct_rkey_release(&rndv_req->send.rndv_get.rkey_bundle);
-        }
+        ucp_rndv_rkey_release(rndv_req);
         return UCS_INPROGRESS;
     }
 
-    /* reset the lane to rndv since it might have been set to 0 since it was stub on RTS receive */
-    rndv_req->send.lane = ucp_ep_get_rndv_get_lane(rndv_req->send.ep);
-    rsc_index = ucp_ep_get_rsc_index(rndv_req->send.ep, rndv_req->send.lane);
-    align     = rndv_req->send.ep->worker->iface_attrs[rsc_index].cap.get.opt_zcopy_align;
-    ucp_mtu   = rndv_req->send.ep->worker->iface_attrs[rsc_index].cap.get.align_mtu;
+    /* fragments are posted on the rendezvous lanes in round-robin order. The
+     * lane is reset every time, since it might have been set to 0 since it was
+     * stub on RTS receive, and pending requests are queued on this lane */
+    config   = ucp_ep_config(ep);
+    lane_idx = rndv_req->send.rndv_get.lane_idx;
+    if (lane_idx >= config->rndv.num_lanes) {
+        lane_idx = 0;
+    }
+
+    rndv_req->send.lane = config->key.rndv_lanes[lane_idx];
+    rsc_index = ucp_ep_get_rsc_index(ep, rndv_req->send.lane);
+    align     = ep->worker->iface_attrs[rsc_index].cap.get.opt_zcopy_align;
+    ucp_mtu   = ep->worker->iface_attrs[rsc_index].cap.get.align_mtu;
 
     ucs_trace_data("ep: %p try to progress get_zcopy for rndv get. rndv_req: %p. lane: %d",
-                   rndv_req->send.ep, rndv_req, rndv_req->send.lane);
+                   ep, rndv_req, rndv_req->send.lane);
 
-    /* rndv_req is the internal request to perform the get operation */
+    /* rndv_req is the internal request to perform the get operation.
+     * all rendezvous lanes share the same memory domain, so the registration
+     * is valid for each of them */
     if (rndv_req->send.state.dt.contig.memh == UCT_MEM_HANDLE_NULL) {
         /* TODO Not all UCTs need registration on the recv side */
         UCS_PROFILE_REQUEST_EVENT(rndv_req->send.rndv_get.rreq, "rndv_recv_reg", 0);
@@ -255,7 +325,8 @@ UCS_PROFILE_FUNC(ucs_status_t, ucp_proto_progress_rndv_get_zcopy, (self),
         length = ucp_mtu - ((uintptr_t)rndv_req->send.buffer % align);
     } else {
         length = ucs_min(rndv_req->send.length - offset,
-                         ucp_ep_config(rndv_req->send.ep)->rndv.max_get_zcopy);
+                         ucp_rndv_get_frag_length(config, lane_idx,
+                                                  rndv_req->send.length));
     }
 
     ucs_trace_data("offset %zu remainder %zu. read to %p len %zu",
@@ -268,21 +339,28 @@ UCS_PROFILE_FUNC(ucs_status_t, ucp_proto_progress_rndv_get_zcopy, (self),
     iov[0].count  = 1;
     iov[0].stride = 0;
     rndv_req->send.uct_comp.count++;
-    status = uct_ep_get_zcopy(ucp_ep_get_rndv_data_uct_ep(rndv_req->send.ep),
+    status = uct_ep_get_zcopy(ep->uct_eps[rndv_req->send.lane],
                               iov, 1,
                               rndv_req->send.rndv_get.remote_address + offset,
-                              rndv_req->send.rndv_get.rkey_bundle.rkey,
+                              rndv_req->send.rndv_get.rkey,
                               &rndv_req->send.uct_comp);
 
     if ((status == UCS_OK) || (status == UCS_INPROGRESS)) {
         UCS_PROFILE_REQUEST_EVENT(rndv_req->send.rndv_get.rreq, "rndv_get_zcopy",
                                   iov[0].length);
-        rndv_req->send.state.offset += length;
+        if (status == UCS_OK) {
+            /* the zcopy operation was locally-completed, so the uct_comp
+             * callback won't be called for it */
+            rndv_req->send.uct_comp.count--;
+        }
+
+        rndv_req->send.rndv_get.lane_idx = lane_idx + 1;
+        rndv_req->send.state.offset     += length;
         if (rndv_req->send.state.offset == rndv_req->send.length) {
-            if (status == UCS_OK) {
-                rndv_req->send.uct_comp.count--;
-                /* if the zcopy operation was locally-completed, the uct_comp callback
-                 * won't be called, so do the completion procedure here */
+            /* release the reference which was held while posting fragments.
+             * if all fragments are already completed, the uct_comp callback
+             * won't be called, so do the completion procedure here */
+            if (--rndv_req->send.uct_comp.count == 0) {
                 ucp_rndv_complete_rndv_get(rndv_req);
             }
             return UCS_OK;
@@ -305,7 +383,8 @@ UCS_PROFILE_FUNC_VOID(ucp_rndv_get_completion, (self, status),
 }
 
 static void ucp_rndv_handle_recv_contig(ucp_request_t *rndv_req, ucp_request_t *rreq,
-                                        ucp_rndv_rts_hdr_t *rndv_rts_hdr)
+                                        ucp_rndv_rts_hdr_t *rndv_rts_hdr,
+                                        size_t rndv_rts_length)
 {
     ucs_trace_req("handle contig datatype on rndv receive. local rndv_req: %p, "
                   "recv request: %p", rndv_req, rreq);
@@ -328,14 +407,18 @@ static void ucp_rndv_handle_recv_contig(ucp_request_t *rndv_req, ucp_request_t *
         rndv_req->send.proto.rreq_ptr       = (uintptr_t) rreq;
     } else {
         if (rndv_rts_hdr->flags & UCP_RNDV_RTS_FLAG_PACKED_RKEY) {
-            UCS_PROFILE_CALL(uct_rkey_unpack, rndv_rts_hdr + 1,
-                             &rndv_req->send.rndv_get.rkey_bundle);
+            /* the key was packed by the sender's memory domain, so its size
+             * is known only from the message */
+            ucp_rndv_rkey_unpack(rndv_req, rndv_rts_hdr,
+                                 rndv_rts_length - sizeof(*rndv_rts_hdr));
         }
         rndv_req->send.length         = rndv_rts_hdr->size;
         rndv_req->send.uct_comp.func  = ucp_rndv_get_completion;
-        rndv_req->send.uct_comp.count = 0;
+        /* held until all fragments are posted */
+        rndv_req->send.uct_comp.count = 1;
         rndv_req->send.state.offset   = 0;
         rndv_req->send.lane           = ucp_ep_get_rndv_get_lane(rndv_req->send.ep);
+        rndv_req->send.rndv_get.lane_idx    = 0;
         rndv_req->send.state.dt.contig.memh = UCT_MEM_HANDLE_NULL;
     }
     ucp_request_start_send(rndv_req);
@@ -354,9 +437,10 @@ static void ucp_rndv_handle_recv_am(ucp_request_t *rndv_req, ucp_request_t *rreq
     ucp_request_start_send(rndv_req);
 }
 
-UCS_PROFILE_FUNC_VOID(ucp_rndv_matched, (worker, rreq, rndv_rts_hdr),
+UCS_PROFILE_FUNC_VOID(ucp_rndv_matched,
+                      (worker, rreq, rndv_rts_hdr, rndv_rts_length),
                       ucp_worker_h worker, ucp_request_t *rreq,
-                      ucp_rndv_rts_hdr_t *rndv_rts_hdr)
+                      ucp_rndv_rts_hdr_t *rndv_rts_hdr, size_t rndv_rts_length)
 {
     ucp_request_t *rndv_req;
     ucp_ep_h ep;
@@ -375,7 +459,8 @@ UCS_PROFILE_FUNC_VOID(ucp_rndv_matched, (worker, rreq, rndv_rts_hdr),
      * operation, send "ATS" and "RTR") */
     rndv_req = ucp_worker_allocate_reply(worker, rndv_rts_hdr->sreq.sender_uuid);
     ep = rndv_req->send.ep;
-    rndv_req->send.rndv_get.rkey_bundle.rkey = UCT_INVALID_RKEY;
+    rndv_req->send.rndv_get.rkey       = UCT_INVALID_RKEY;
+    rndv_req->send.rndv_get.rkey_entry = NULL;
     rndv_req->send.datatype = rreq->recv.datatype;
 
     ucs_trace_req("ucp_rndv_matched. remote data address: %zu. remote request: %zu. "
@@ -394,15 +479,17 @@ UCS_PROFILE_FUNC_VOID(ucp_rndv_matched, (worker, rreq, rndv_rts_hdr),
         if ((rndv_rts_hdr->address != 0) && ucp_ep_is_rndv_lane_present(ep)) {
             /* read the data from the sender with a get_zcopy operation on the
              * rndv lane */
-            ucp_rndv_handle_recv_contig(rndv_req, rreq, rndv_rts_hdr);
+            ucp_rndv_handle_recv_contig(rndv_req, rreq, rndv_rts_hdr,
+                                        rndv_rts_length);
         } else {
             /* if the sender didn't specify its address in the RTS, can't do a
              * get operation, so send an RTR and the sender will send the data
              * with AM messages */
             ucp_rndv_handle_recv_am(rndv_req, rreq, rndv_rts_hdr);
         }
-    } else if (UCP_DT_IS_GENERIC(rreq->recv.datatype)) {
-        /* if the recv side has a generic datatype,
+    } else if (UCP_DT_IS_GENERIC(rreq->recv.datatype) ||
+               UCP_DT_IS_STRIDED(rreq->recv.datatype)) {
+        /* if the recv side has a generic or a strided datatype,
          * send an RTR and the sender will send the data with AM messages */
         ucp_rndv_handle_recv_am(rndv_req, rreq, rndv_rts_hdr);
     } else {
@@ -430,7 +517,7 @@ UCS_PROFILE_FUNC(ucs_status_t, ucp_rndv_rts_handler,
     rreq = ucp_tag_exp_search(&context->tm, rndv_rts_hdr->super.tag,
                               rndv_rts_hdr->size, recv_flags);
     if (rreq != NULL) {
-        ucp_rndv_matched(worker, rreq, rndv_rts_hdr);
+        ucp_rndv_matched(worker, rreq, rndv_rts_hdr, length);
         UCP_WORKER_STAT_RNDV(worker, EXP);
         status = UCS_OK;
     } else {
@@ -467,7 +554,8 @@ static size_t ucp_rndv_pack_single_data(void *dest, void *arg)
 
     hdr->rreq_ptr = sreq->send.proto.rreq_ptr;
     length = ucp_dt_pack(sreq->send.datatype, hdr + 1, sreq->send.buffer,
-                         &sreq->send.state, sreq->send.length);
+                         &sreq->send.state, sreq->send.length,
+                         sreq->send.length);
     ucs_assert(length == sreq->send.length);
     return sizeof(*hdr) + length;
 }
@@ -483,7 +571,7 @@ static size_t ucp_rndv_pack_multi_data(void *dest, void *arg)
 
     return sizeof(*hdr) + ucp_dt_pack(sreq->send.datatype, hdr + 1,
                                       sreq->send.buffer, &sreq->send.state,
-                                      length);
+                                      length, sreq->send.length);
 }
 
 static size_t ucp_rndv_pack_multi_data_last(void *dest, void *arg)
@@ -497,7 +585,7 @@ static size_t ucp_rndv_pack_multi_data_last(void *dest, void *arg)
 
     return sizeof(*hdr) + ucp_dt_pack(sreq->send.datatype, hdr + 1,
                                       sreq->send.buffer, &sreq->send.state,
-                                      length);
+                                      length, sreq->send.length);
 }
 
 UCS_PROFILE_FUNC(ucs_status_t, ucp_rndv_progress_bcopy_send, (self),
@@ -538,6 +626,185 @@ UCS_PROFILE_FUNC(ucs_status_t, ucp_rndv_progress_bcopy_send, (self),
     return status;
 }
 
+static void ucp_rndv_pipeline_send_complete(ucp_request_t *sreq)
+{
+    ucp_request_send_generic_dt_finish(sreq);
+    ucp_request_complete_send(sreq, sreq->send.rndv_pipe.status);
+}
+
+/* Stop sending after a failure; the request is completed with the error once
+ * all fragments in flight have released their staging buffers */
+static void ucp_rndv_pipeline_send_abort(ucp_request_t *sreq)
+{
+    if (sreq->send.rndv_pipe.inflight == 0) {
+        ucp_rndv_pipeline_send_complete(sreq);
+    } else {
+        sreq->send.rndv_pipe.stalled = 1;
+    }
+}
+
+static void
+ucp_rndv_pipeline_resume_slow_path_callback(ucs_callbackq_slow_elem_t *self)
+{
+    ucp_request_t *sreq = ucs_container_of(self, ucp_request_t,
+                                           send.rndv_pipe.cbq_elem);
+
+    uct_worker_slowpath_progress_unregister(sreq->send.ep->worker->uct,
+                                            &sreq->send.rndv_pipe.cbq_elem);
+    ucp_request_start_send(sreq);
+}
+
+static void ucp_rndv_pipeline_frag_completion(uct_completion_t *self,
+                                              ucs_status_t status)
+{
+    ucp_rndv_frag_t *frag = ucs_container_of(self, ucp_rndv_frag_t, comp);
+    ucp_request_t *sreq   = frag->sreq;
+
+    ucs_mpool_put_inline(frag);
+    --sreq->send.rndv_pipe.inflight;
+
+    if (ucs_unlikely(status != UCS_OK) &&
+        (sreq->send.rndv_pipe.status == UCS_OK)) {
+        ucs_trace_req("sreq %p: rendezvous fragment failed: %s", sreq,
+                      ucs_status_string(status));
+        sreq->send.rndv_pipe.status = status;
+    }
+
+    if (sreq->send.state.offset == sreq->send.length) {
+        if (sreq->send.rndv_pipe.inflight == 0) {
+            ucp_rndv_pipeline_send_complete(sreq);
+        }
+    } else if (sreq->send.rndv_pipe.stalled) {
+        if (sreq->send.rndv_pipe.status != UCS_OK) {
+            /* the request is not scheduled, so it's completed here */
+            if (sreq->send.rndv_pipe.inflight == 0) {
+                ucp_rndv_pipeline_send_complete(sreq);
+            }
+            return;
+        }
+
+        /* a staging buffer was released, continue packing from the progress
+         * context rather than from inside the transport completion */
+        sreq->send.rndv_pipe.stalled     = 0;
+        sreq->send.rndv_pipe.cbq_elem.cb =
+                        ucp_rndv_pipeline_resume_slow_path_callback;
+        uct_worker_slowpath_progress_register(sreq->send.ep->worker->uct,
+                                              &sreq->send.rndv_pipe.cbq_elem);
+    }
+}
+
+/* Pack the next fragment to a registered staging buffer and send it with
+ * zcopy, while the previous fragments are still in flight */
+UCS_PROFILE_FUNC(ucs_status_t, ucp_rndv_progress_pipeline_send, (self),
+                 uct_pending_req_t *self)
+{
+    ucp_request_t *sreq     = ucs_container_of(self, ucp_request_t, send.uct);
+    ucp_ep_t *ep            = sreq->send.ep;
+    ucp_worker_h worker     = ep->worker;
+    ucp_rndv_data_hdr_t hdr;
+    ucp_rndv_frag_t *frag;
+    ucp_dt_state_t state;
+    ucs_status_t status;
+    uct_iov_t iov;
+    uint8_t am_id;
+
+    if (ucs_unlikely(sreq->send.rndv_pipe.status != UCS_OK)) {
+        ucp_rndv_pipeline_send_abort(sreq);
+        return UCS_OK;
+    }
+
+    if (sreq->send.rndv_pipe.inflight >=
+        worker->context->config.ext.rndv_pipeline_depth) {
+        /* all staging buffers of this request are busy, resume when one of
+         * them completes */
+        sreq->send.rndv_pipe.stalled = 1;
+        return UCS_OK;
+    }
+
+    frag = ucs_mpool_get_inline(&worker->rndv_frag_mp);
+    if (frag == NULL) {
+        if (sreq->send.rndv_pipe.inflight > 0) {
+            /* resume when one of the fragments in flight releases its
+             * staging buffer */
+            sreq->send.rndv_pipe.stalled = 1;
+            return UCS_OK;
+        }
+
+        /* staging buffers could not be allocated or registered, send the rest
+         * of the message with bcopy on the same lane, so the receiver gets
+         * the data in order */
+        ucs_debug("sreq %p: no rendezvous staging buffers, falling back to "
+                  "bcopy at offset %zu", sreq, sreq->send.state.offset);
+        sreq->send.proto.rreq_ptr = sreq->send.rndv_pipe.rreq_ptr;
+        sreq->send.uct.func       = ucp_rndv_progress_bcopy_send;
+        return ucp_rndv_progress_bcopy_send(self);
+    }
+
+    sreq->send.lane = ucp_ep_get_am_lane(ep);
+
+    /* pack to a copy of the state, to pack again if the send is postponed */
+    state      = sreq->send.state;
+    iov.buffer = frag + 1;
+    iov.length = ucp_dt_pack(sreq->send.datatype, iov.buffer, sreq->send.buffer,
+                             &state,
+                             ucs_min(ucp_ep_config(ep)->rndv.frag_size,
+                                     sreq->send.length - sreq->send.state.offset),
+                             sreq->send.length);
+    iov.memh   = ucp_memh2uct(frag->super.memh,
+                              ucp_ep_md_index(ep, sreq->send.lane));
+    iov.count  = 1;
+    iov.stride = 0;
+
+    am_id = (state.offset == sreq->send.length) ? UCP_AM_ID_RNDV_DATA_LAST :
+                                                  UCP_AM_ID_RNDV_DATA;
+    hdr.rreq_ptr    = sreq->send.rndv_pipe.rreq_ptr;
+    frag->sreq      = sreq;
+    frag->comp.func  = ucp_rndv_pipeline_frag_completion;
+    frag->comp.count = 1;
+
+    ucs_trace_data("send on sreq %p, am lane: %d, offset: %zu, fragment: %zu, "
+                   "inflight: %u (pipeline)", sreq, sreq->send.lane,
+                   sreq->send.state.offset, iov.length,
+                   sreq->send.rndv_pipe.inflight);
+
+    status = uct_ep_am_zcopy(ep->uct_eps[sreq->send.lane], am_id, &hdr,
+                             sizeof(hdr), &iov, 1, &frag->comp);
+    if (status == UCS_INPROGRESS) {
+        ++sreq->send.rndv_pipe.inflight;
+    } else {
+        ucs_mpool_put_inline(frag);
+        if (status == UCS_ERR_NO_RESOURCE) {
+            return status;
+        } else if (ucs_unlikely(status != UCS_OK)) {
+            sreq->send.rndv_pipe.status = status;
+            ucp_rndv_pipeline_send_abort(sreq);
+            return UCS_OK;
+        }
+    }
+
+    sreq->send.state = state;
+    if (state.offset < sreq->send.length) {
+        return UCS_INPROGRESS;
+    }
+
+    /* all fragments were sent, if some of them are still in flight, the
+     * request is completed by the last fragment completion */
+    if (sreq->send.rndv_pipe.inflight == 0) {
+        ucp_rndv_pipeline_send_complete(sreq);
+    }
+    return UCS_OK;
+}
+
+static int ucp_rndv_is_pipeline_possible(ucp_request_t *sreq)
+{
+    ucp_ep_config_t *config = ucp_ep_config(sreq->send.ep);
+
+    /* a message which fits a single bcopy fragment has nothing to overlap */
+    return (config->rndv.frag_size > 0) &&
+           (config->key.am_lane != UCP_NULL_LANE) &&
+           (sreq->send.length > config->am.max_bcopy - sizeof(ucp_rndv_data_hdr_t));
+}
+
 static void ucp_rndv_zcopy_req_complete(ucp_request_t *req)
 {
     ucp_request_send_buffer_dereg(req, ucp_ep_get_am_lane(req->send.ep));
@@ -627,20 +894,32 @@ UCS_PROFILE_FUNC(ucs_status_t, ucp_rndv_rtr_handler,
     ucs_assert_always(!ucp_ep_is_stub(ep));
     ucs_trace_req("RTR received. start sending on sreq %p", sreq);
 
+    UCS_PROFILE_REQUEST_EVENT(sreq, "rndv_rtr_recv", 0);
+
     if ((UCP_DT_IS_CONTIG(sreq->send.datatype)) &&
         (sreq->send.length >= ucp_ep_config(ep)->am.zcopy_thresh[0])) {
         /* send with zcopy */
         ucp_rndv_prepare_zcopy(sreq, ep);
+        sreq->send.proto.rreq_ptr = rndv_rtr_hdr->rreq_ptr;
+    } else if (ucp_rndv_is_pipeline_possible(sreq)) {
+        /* send with zcopy from staging buffers */
+        /* deregister the sender's buffer if it was registered */
+        ucp_rndv_rma_request_send_buffer_dereg(sreq);
+
+        sreq->send.uct.func           = ucp_rndv_progress_pipeline_send;
+        sreq->send.rndv_pipe.rreq_ptr = rndv_rtr_hdr->rreq_ptr;
+        sreq->send.rndv_pipe.inflight = 0;
+        sreq->send.rndv_pipe.stalled  = 0;
+        sreq->send.rndv_pipe.status   = UCS_OK;
     } else {
         /* send with bcopy */
         /* deregister the sender's buffer if it was registered */
         ucp_rndv_rma_request_send_buffer_dereg(sreq);
 
-        sreq->send.uct.func = ucp_rndv_progress_bcopy_send;
+        sreq->send.uct.func       = ucp_rndv_progress_bcopy_send;
+        sreq->send.proto.rreq_ptr = rndv_rtr_hdr->rreq_ptr;
     }
 
-    UCS_PROFILE_REQUEST_EVENT(sreq, "rndv_rtr_recv", 0);
-    sreq->send.proto.rreq_ptr = rndv_rtr_hdr->rreq_ptr;
     ucp_request_start_send(sreq);
     return UCS_OK;
 }
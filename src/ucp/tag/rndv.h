@@ -11,12 +11,23 @@
 
 #include <ucp/api/ucp.h>
 #include <ucp/core/ucp_request.h>
+#include <ucp/core/ucp_mm.h>
 #include <ucp/proto/proto.h>
 
 enum {
     UCP_RNDV_RTS_FLAG_PACKED_RKEY  = UCS_BIT(0)
 };
 
+/*
+ * Staging buffer of the pipelined rendezvous protocol. The fragment data
+ * follows the structure.
+ */
+typedef struct {
+    ucp_mem_desc_t            super;
+    uct_completion_t          comp;     /* completion of the fragment send */
+    ucp_request_t             *sreq;    /* send request the fragment belongs to */
+} ucp_rndv_frag_t;
+
 /*
  * Rendezvous RTS
  */
@@ -48,7 +59,7 @@ typedef struct {
 void ucp_tag_send_start_rndv(ucp_request_t *req);
 
 void ucp_rndv_matched(ucp_worker_h worker, ucp_request_t *req,
-                      ucp_rndv_rts_hdr_t *rndv_rts_hdr);
+                      ucp_rndv_rts_hdr_t *rndv_rts_hdr, size_t rndv_rts_length);
 
 ucs_status_t ucp_proto_progress_rndv_get_zcopy(uct_pending_req_t *self);
 
@@ -7,33 +7,69 @@
 #include "tag_match.inl"
 
 
+static ucs_list_link_t *ucp_tag_match_hash_alloc(const char *name)
+{
+    ucs_list_link_t *hash;
+    unsigned i;
+
+    hash = ucs_malloc(sizeof(*hash) * UCP_TAG_MATCH_HASH_SIZE, name);
+    if (hash == NULL) {
+        ucs_error("failed to allocate %s", name);
+        return NULL;
+    }
+
+    for (i = 0; i < UCP_TAG_MATCH_HASH_SIZE; ++i) {
+        ucs_list_head_init(&hash[i]);
+    }
+    return hash;
+}
+
 ucs_status_t ucp_tag_match_init(ucp_tag_match_t *tm)
 {
-    ucs_queue_head_init(&tm->expected);
-    ucs_queue_head_init(&tm->unexpected);
+    tm->expected.hash = ucp_tag_match_hash_alloc("tm_expected_hash");
+    if (tm->expected.hash == NULL) {
+        return UCS_ERR_NO_MEMORY;
+    }
+
+    tm->unexpected.hash = ucp_tag_match_hash_alloc("tm_unexpected_hash");
+    if (tm->unexpected.hash == NULL) {
+        ucs_free(tm->expected.hash);
+        return UCS_ERR_NO_MEMORY;
+    }
+
+    ucs_list_head_init(&tm->expected.wildcard);
+    ucs_list_head_init(&tm->unexpected.all);
+    kh_init_inplace(ucp_tag_frag_hash, &tm->frag_hash);
+    tm->expected.sn = 0;
     return UCS_OK;
 }
 
 void ucp_tag_match_cleanup(ucp_tag_match_t *tm)
 {
+    kh_destroy_inplace(ucp_tag_frag_hash, &tm->frag_hash);
+    ucs_free(tm->unexpected.hash);
+    ucs_free(tm->expected.hash);
 }
 
 int ucp_tag_unexp_is_empty(ucp_tag_match_t *tm)
 {
-    return ucs_queue_is_empty(&tm->unexpected);
+    return ucs_list_is_empty(&tm->unexpected.all);
 }
 
 void ucp_tag_exp_remove(ucp_tag_match_t *tm, ucp_request_t *req)
 {
-    ucs_queue_iter_t iter;
-    ucp_request_t *qreq;
-
-    ucs_queue_for_each_safe(qreq, iter, &tm->expected, recv.queue) {
-        if (qreq == req) {
-            ucs_queue_del_iter(&tm->expected, iter);
-            return;
-        }
+    if (req->recv.state.offset > 0) {
+        /* The request has already started receiving a message */
+        ucp_tag_frag_del(tm, req);
+        return;
+    }
+
+    /* Requests which are not on the expected queue have a self-linked
+     * element, see ucp_tag_exp_delete() */
+    if (ucs_list_is_empty(&req->recv.list)) {
+        ucs_bug("expected request not found");
+        return;
     }
 
-    ucs_bug("expected request not found");
+    ucp_tag_exp_delete(req);
 }
@@ -9,10 +9,29 @@
 
 #include <ucp/api/ucp_def.h>
 #include <ucp/core/ucp_types.h>
-#include <ucs/datastruct/queue_types.h>
+#include <ucs/datastruct/khash.h>
+#include <ucs/datastruct/list_types.h>
 #include <ucs/sys/compiler_def.h>
 
 
+/* Number of hash buckets in tag-matching queues */
+#define UCP_TAG_MATCH_HASH_BITS   10
+#define UCP_TAG_MATCH_HASH_SIZE   (1ul << UCP_TAG_MATCH_HASH_BITS)
+
+/* Tag mask which requires all tag bits to match */
+#define UCP_TAG_MASK_FULL         ((ucp_tag_t)-1)
+
+
+/**
+ * Lists of an unexpected receive descriptor
+ */
+enum {
+    UCP_RDESC_HASH_LIST,  /* List of descriptors in the same hash bucket */
+    UCP_RDESC_ALL_LIST,   /* List of all descriptors, in arrival order */
+    UCP_RDESC_LAST
+};
+
+
 /**
  * Tag-match header
  */
@@ -22,11 +41,53 @@ typedef struct {
 
 
 /**
- * Tag-matching context
+ * Identifies a multi-fragment message in flight: the remote worker which sent
+ * it, and the message sequence number on that worker.
+ */
+typedef struct {
+    uint64_t                  sender_uuid;
+    uint64_t                  msg_id;
+} UCS_S_PACKED ucp_tag_frag_key_t;
+
+
+static inline khint32_t ucp_tag_frag_key_hash(ucp_tag_frag_key_t key)
+{
+    uint64_t h = key.sender_uuid ^ (key.msg_id * 0x9e3779b97f4a7c15ull);
+    return kh_int64_hash_func(h);
+}
+
+#define ucp_tag_frag_key_equal(_key1, _key2) \
+    (((_key1).sender_uuid == (_key2).sender_uuid) && \
+     ((_key1).msg_id == (_key2).msg_id))
+
+KHASH_INIT(ucp_tag_frag_hash, ucp_tag_frag_key_t, ucp_request_t*, 1,
+           ucp_tag_frag_key_hash, ucp_tag_frag_key_equal);
+
+
+/**
+ * Tag-matching context.
+ *
+ * Requests and descriptors with a fully-specified tag are kept in hash buckets,
+ * so matching does not have to scan the requests posted for other tags.
+ * Expected requests with a partial tag mask are kept on a separate wildcard
+ * list, and sequence numbers decide which of the candidates from the bucket
+ * and from the wildcard list was posted first. Unexpected descriptors are also
+ * kept on a list of all descriptors, which is searched by wildcard receives.
  */
 typedef struct ucp_tag_match {
-    ucs_queue_head_t          expected;   /* Expected requests */
-    ucs_queue_head_t          unexpected; /* Unexpected received descriptors */
+    struct {
+        ucs_list_link_t       *hash;      /* Requests with fully-specified tag */
+        ucs_list_link_t       wildcard;   /* Requests with partial tag mask */
+        uint64_t              sn;         /* Next request sequence number */
+    } expected;
+
+    khash_t(ucp_tag_frag_hash) frag_hash; /* Requests in the middle of a
+                                             message, by sender and message id */
+
+    struct {
+        ucs_list_link_t       *hash;      /* Descriptors by their tag */
+        ucs_list_link_t       all;        /* All descriptors, in arrival order */
+    } unexpected;
 } ucp_tag_match_t;
 
 
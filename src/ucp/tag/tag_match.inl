@@ -12,7 +12,7 @@
 #include <ucp/core/ucp_request.h>
 #include <ucp/dt/dt.h>
 #include <ucs/debug/log.h>
-#include <ucs/datastruct/queue.h>
+#include <ucs/datastruct/list.h>
 #include <ucs/datastruct/mpool.inl>
 #include <inttypes.h>
 
@@ -35,44 +35,113 @@ int ucp_tag_is_match(ucp_tag_t tag, ucp_tag_t exp_tag, ucp_tag_t tag_mask)
 
 static UCS_F_ALWAYS_INLINE
 int ucp_tag_recv_is_match(ucp_tag_t recv_tag, unsigned recv_flags,
+                          const ucp_tag_frag_key_t *recv_frag,
                           ucp_tag_t exp_tag, ucp_tag_t tag_mask,
-                          size_t offset, ucp_tag_t curr_tag)
+                          size_t offset, const ucp_tag_frag_key_t *curr_frag)
 {
     /*
      * For first fragment, we search a matching request
-     * For subsequent fragments, we search for a request with exact same tag,
-     * which would also mean it arrives from the same sender.
+     * For subsequent fragments, we search for a request which has received the
+     * beginning of the same message from the same sender.
      */
     return (((offset == 0) && (recv_flags & UCP_RECV_DESC_FLAG_FIRST) &&
               ucp_tag_is_match(recv_tag, exp_tag, tag_mask)) ||
             (!(offset == 0) && !(recv_flags & UCP_RECV_DESC_FLAG_FIRST) &&
-              (recv_tag == curr_tag)));
+              ucp_tag_frag_key_equal(*recv_frag, *curr_frag)));
+}
+
+static UCS_F_ALWAYS_INLINE ucs_list_link_t*
+ucp_tag_match_hash_bucket(ucs_list_link_t *hash, ucp_tag_t tag)
+{
+    /* Fibonacci hashing, the high bits of the product are the best mixed */
+    return &hash[(tag * 0x9e3779b97f4a7c15ull) >> (64 - UCP_TAG_MATCH_HASH_BITS)];
+}
+
+static UCS_F_ALWAYS_INLINE void
+ucp_tag_frag_add(ucp_tag_match_t *tm, ucp_request_t *req)
+{
+    int hash_extra_status;
+    khiter_t hash_it;
+
+    hash_it = kh_put(ucp_tag_frag_hash, &tm->frag_hash, req->recv.frag,
+                     &hash_extra_status);
+    if (ucs_unlikely(hash_it == kh_end(&tm->frag_hash))) {
+        ucs_fatal("failed to add request %p to fragments hash", req);
+    }
+
+    ucs_assertv(hash_extra_status != 0, "uuid %"PRIx64" msg_id %"PRIu64
+                " already has request %p", req->recv.frag.sender_uuid,
+                req->recv.frag.msg_id, kh_value(&tm->frag_hash, hash_it));
+    kh_value(&tm->frag_hash, hash_it) = req;
+}
+
+static UCS_F_ALWAYS_INLINE void
+ucp_tag_frag_del(ucp_tag_match_t *tm, ucp_request_t *req)
+{
+    khiter_t hash_it;
+
+    hash_it = kh_get(ucp_tag_frag_hash, &tm->frag_hash, req->recv.frag);
+    ucs_assert(hash_it != kh_end(&tm->frag_hash));
+    kh_del(ucp_tag_frag_hash, &tm->frag_hash, hash_it);
+}
+
+/*
+ * Find the request which receives a message, by a fragment which follows the
+ * first one. The request is removed from the hash when the last fragment
+ * arrives.
+ */
+static UCS_F_ALWAYS_INLINE ucp_request_t *
+ucp_tag_frag_search(ucp_tag_match_t *tm, const ucp_tag_frag_key_t *frag,
+                    unsigned recv_flags)
+{
+    ucp_request_t *req;
+    khiter_t hash_it;
+
+    hash_it = kh_get(ucp_tag_frag_hash, &tm->frag_hash, *frag);
+    if (hash_it == kh_end(&tm->frag_hash)) {
+        return NULL;
+    }
+
+    req = kh_value(&tm->frag_hash, hash_it);
+    if (recv_flags & UCP_RECV_DESC_FLAG_LAST) {
+        kh_del(ucp_tag_frag_hash, &tm->frag_hash, hash_it);
+    }
+    return req;
 }
 
 static UCS_F_ALWAYS_INLINE
 void ucp_tag_exp_add(ucp_tag_match_t *tm, ucp_request_t *req)
 {
-    ucs_queue_push(&tm->expected, &req->recv.queue);
+    ucs_list_link_t *list;
+
+    if (req->recv.state.offset > 0) {
+        /* The rest of the message is identified by the sender and message id */
+        ucp_tag_frag_add(tm, req);
+        return;
+    } else if (req->recv.tag_mask == UCP_TAG_MASK_FULL) {
+        list = ucp_tag_match_hash_bucket(tm->expected.hash, req->recv.tag);
+    } else {
+        list = &tm->expected.wildcard;
+    }
+
+    req->recv.sn = tm->expected.sn++;
+    ucs_list_add_tail(list, &req->recv.list);
+}
+
+static UCS_F_ALWAYS_INLINE void ucp_tag_exp_delete(ucp_request_t *req)
+{
+    ucs_list_del(&req->recv.list);
+    ucs_list_head_init(&req->recv.list);
 }
 
+/* Find the first request in the list which matches the tag of a message */
 static UCS_F_ALWAYS_INLINE ucp_request_t *
-ucp_tag_exp_search(ucp_tag_match_t *tm, ucp_tag_t recv_tag, size_t recv_len,
-                   unsigned recv_flags)
+ucp_tag_exp_list_search(ucs_list_link_t *list, ucp_tag_t recv_tag)
 {
-    ucs_queue_iter_t iter;
     ucp_request_t *req;
 
-    ucs_queue_for_each_safe(req, iter, &tm->expected, recv.queue) {
-        req = ucs_container_of(*iter, ucp_request_t, recv.queue);
-        if (ucp_tag_recv_is_match(recv_tag, recv_flags, req->recv.tag,
-                                  req->recv.tag_mask, req->recv.state.offset,
-                                  req->recv.info.sender_tag))
-        {
-            ucp_tag_log_match(recv_tag, recv_len, req, req->recv.tag,
-                              req->recv.tag_mask, req->recv.state.offset, "expected");
-            if (recv_flags & UCP_RECV_DESC_FLAG_LAST) {
-                ucs_queue_del_iter(&tm->expected, iter);
-            }
+    ucs_list_for_each(req, list, recv.list) {
+        if (ucp_tag_is_match(recv_tag, req->recv.tag, req->recv.tag_mask)) {
             return req;
         }
     }
@@ -80,6 +149,43 @@ ucp_tag_exp_search(ucp_tag_match_t *tm, ucp_tag_t recv_tag, size_t recv_len,
     return NULL;
 }
 
+/*
+ * Find the expected request for the first fragment of a message, and remove it
+ * from the expected queues. If the message has more fragments, the caller is
+ * responsible to add the request to the fragments hash.
+ */
+static UCS_F_ALWAYS_INLINE ucp_request_t *
+ucp_tag_exp_search(ucp_tag_match_t *tm, ucp_tag_t recv_tag, size_t recv_len,
+                   unsigned recv_flags)
+{
+    ucp_request_t *req, *wild_req;
+
+    ucs_assert(recv_flags & UCP_RECV_DESC_FLAG_FIRST);
+
+    req = ucp_tag_exp_list_search(ucp_tag_match_hash_bucket(tm->expected.hash,
+                                                            recv_tag),
+                                  recv_tag);
+
+    /* Out of two matching requests, the one which was posted first wins */
+    if (!ucs_list_is_empty(&tm->expected.wildcard)) {
+        wild_req = ucp_tag_exp_list_search(&tm->expected.wildcard, recv_tag);
+        if ((wild_req != NULL) && ((req == NULL) ||
+                                   (wild_req->recv.sn < req->recv.sn)))
+        {
+            req = wild_req;
+        }
+    }
+
+    if (req == NULL) {
+        return NULL;
+    }
+
+    ucp_tag_log_match(recv_tag, recv_len, req, req->recv.tag,
+                      req->recv.tag_mask, req->recv.state.offset, "expected");
+    ucp_tag_exp_delete(req);
+    return req;
+}
+
 static UCS_F_ALWAYS_INLINE ucp_tag_t ucp_rdesc_get_tag(ucp_recv_desc_t *rdesc)
 {
     return ((ucp_tag_hdr_t*)(rdesc + 1))->tag;
@@ -119,10 +225,56 @@ ucp_tag_unexp_recv(ucp_tag_match_t *tm, ucp_worker_h worker, void *data,
 
     rdesc->length  = length;
     rdesc->hdr_len = hdr_len;
-    ucs_queue_push(&tm->unexpected, &rdesc->queue);
+    ucs_list_add_tail(ucp_tag_match_hash_bucket(tm->unexpected.hash,
+                                                ucp_rdesc_get_tag(rdesc)),
+                      &rdesc->tag_list[UCP_RDESC_HASH_LIST]);
+    ucs_list_add_tail(&tm->unexpected.all, &rdesc->tag_list[UCP_RDESC_ALL_LIST]);
     return status;
 }
 
+/*
+ * Get the list of unexpected descriptors which should be searched for a tag
+ * and mask, and which of the descriptor list elements to use for iteration.
+ */
+static UCS_F_ALWAYS_INLINE ucs_list_link_t*
+ucp_tag_unexp_get_list(ucp_tag_match_t *tm, ucp_tag_t tag, ucp_tag_t tag_mask,
+                       int *i_list_p)
+{
+    if (tag_mask == UCP_TAG_MASK_FULL) {
+        *i_list_p = UCP_RDESC_HASH_LIST;
+        return ucp_tag_match_hash_bucket(tm->unexpected.hash, tag);
+    } else {
+        *i_list_p = UCP_RDESC_ALL_LIST;
+        return &tm->unexpected.all;
+    }
+}
+
+static UCS_F_ALWAYS_INLINE ucp_recv_desc_t*
+ucp_tag_unexp_list_elem(ucs_list_link_t *link, int i_list)
+{
+    return ucs_container_of(link - i_list, ucp_recv_desc_t, tag_list[0]);
+}
+
+/**
+ * Iterate over unexpected descriptors on a list returned by
+ * ucp_tag_unexp_get_list(). The current descriptor may be removed.
+ */
+#define ucp_tag_unexp_list_for_each_safe(_rdesc, _trdesc, _list, _i_list) \
+    for (_rdesc  = ucp_tag_unexp_list_elem((_list)->next, _i_list), \
+         _trdesc = ucp_tag_unexp_list_elem((_rdesc)->tag_list[_i_list].next, \
+                                           _i_list); \
+         &(_rdesc)->tag_list[_i_list] != (_list); \
+         _rdesc  = _trdesc, \
+         _trdesc = ucp_tag_unexp_list_elem((_rdesc)->tag_list[_i_list].next, \
+                                           _i_list))
+
+static UCS_F_ALWAYS_INLINE void
+ucp_tag_unexp_remove(ucp_recv_desc_t *rdesc)
+{
+    ucs_list_del(&rdesc->tag_list[UCP_RDESC_HASH_LIST]);
+    ucs_list_del(&rdesc->tag_list[UCP_RDESC_ALL_LIST]);
+}
+
 static UCS_F_ALWAYS_INLINE void
 ucp_tag_unexp_desc_release(ucp_recv_desc_t *rdesc)
 {
@@ -11,7 +11,7 @@
 #include <ucp/core/ucp_worker.h>
 #include <ucp/core/ucp_request.inl>
 #include <ucs/datastruct/mpool.inl>
-#include <ucs/datastruct/queue.h>
+#include <ucs/datastruct/list.h>
 
 
 static UCS_F_ALWAYS_INLINE ucs_status_t
@@ -21,13 +21,23 @@ ucp_tag_search_unexp(ucp_worker_h worker, void *buffer, size_t buffer_size,
                      ucp_tag_recv_callback_t cb, unsigned *save_rreq)
 {
     ucp_context_h context = worker->context;
-    ucp_recv_desc_t *rdesc;
-    ucs_queue_iter_t iter;
+    ucp_recv_desc_t *rdesc, *trdesc;
+    ucp_tag_frag_key_t *recv_frag;
+    ucs_list_link_t *list;
     ucs_status_t status;
     ucp_tag_t recv_tag;
     unsigned flags;
+    int i_list;
 
-    ucs_queue_for_each_safe(rdesc, iter, &context->tm.unexpected, queue) {
+    /* Fragments which follow the first one come with the exact sender tag */
+    if (req->recv.state.offset > 0) {
+        list = ucp_tag_unexp_get_list(&context->tm, info->sender_tag,
+                                      UCP_TAG_MASK_FULL, &i_list);
+    } else {
+        list = ucp_tag_unexp_get_list(&context->tm, tag, tag_mask, &i_list);
+    }
+
+    ucp_tag_unexp_list_for_each_safe(rdesc, trdesc, list, i_list) {
         recv_tag = ucp_rdesc_get_tag(rdesc);
         flags    = rdesc->flags;
         ucs_trace_req("searching for %"PRIx64"/%"PRIx64"/%"PRIx64" offset %zu, "
@@ -39,17 +49,20 @@ ucp_tag_search_unexp(ucp_worker_h worker, void *buffer, size_t buffer_size,
                       (flags & UCP_RECV_DESC_FLAG_EAGER) ? 'e' : '-',
                       (flags & UCP_RECV_DESC_FLAG_SYNC)  ? 's' : '-',
                       (flags & UCP_RECV_DESC_FLAG_RNDV)  ? 'r' : '-');
-        if (ucp_tag_recv_is_match(recv_tag, flags, tag, tag_mask,
-                                  req->recv.state.offset, info->sender_tag))
+        recv_frag = (flags & UCP_RECV_DESC_FLAG_FIRST) ? NULL :
+                    ucp_eager_frag_key(rdesc + 1, flags);
+        if (ucp_tag_recv_is_match(recv_tag, flags, recv_frag, tag, tag_mask,
+                                  req->recv.state.offset, &req->recv.frag))
         {
             ucp_tag_log_match(recv_tag, rdesc->length - rdesc->hdr_len, req, tag,
                               tag_mask, req->recv.state.offset, "unexpected");
-            ucs_queue_del_iter(&context->tm.unexpected, iter);
+            ucp_tag_unexp_remove(rdesc);
             if (rdesc->flags & UCP_RECV_DESC_FLAG_EAGER) {
                 UCS_PROFILE_REQUEST_EVENT(req, "eager_match", 0);
                 status = ucp_eager_unexp_match(worker, rdesc, recv_tag, flags,
                                                buffer, buffer_size, datatype,
-                                               &req->recv.state, info);
+                                               &req->recv.state, info,
+                                               &req->recv.frag);
                 ucs_trace_req("release receive descriptor %p", rdesc);
                 ucp_tag_unexp_desc_release(rdesc);
                 if (status != UCS_INPROGRESS) {
@@ -61,7 +74,7 @@ ucp_tag_search_unexp(ucp_worker_h worker, void *buffer, size_t buffer_size,
                 req->recv.length   = buffer_size;
                 req->recv.datatype = datatype;
                 req->recv.cb       = cb;
-                ucp_rndv_matched(worker, req, (void*)(rdesc + 1));
+                ucp_rndv_matched(worker, req, (void*)(rdesc + 1), rdesc->length);
                 ucp_tag_unexp_desc_release(rdesc);
                 UCP_WORKER_STAT_RNDV(worker, UNEXP);
                 return UCS_INPROGRESS;
@@ -78,30 +91,10 @@ ucp_tag_recv_request_init(ucp_request_t *req, ucp_worker_h worker, void* buffer,
                           size_t count, ucp_datatype_t datatype,
                           uint16_t req_flags)
 {
-    ucp_dt_generic_t *dt_gen;
     req->flags = UCP_REQUEST_FLAG_EXPECTED | UCP_REQUEST_FLAG_RECV | req_flags;
-    req->recv.state.offset = 0;
-
-    switch (datatype & UCP_DATATYPE_CLASS_MASK) {
-    case UCP_DATATYPE_IOV:
-        req->recv.state.dt.iov.iov_offset    = 0;
-        req->recv.state.dt.iov.iovcnt_offset = 0;
-        req->recv.state.dt.iov.iovcnt        = count;
-        req->recv.state.dt.iov.memh          = UCT_MEM_HANDLE_NULL;
-        break;
-
-    case UCP_DATATYPE_GENERIC:
-        dt_gen = ucp_dt_generic(datatype);
-        req->recv.state.dt.generic.state =
-                        UCS_PROFILE_NAMED_CALL("dt_start", dt_gen->ops.start_unpack,
-                                               dt_gen->context, buffer, count);
-        ucs_debug("req %p buffer %p count %zu dt_gen state=%p", req, buffer, count,
-                  req->recv.state.dt.generic.state);
-        break;
-
-    default:
-        break;
-    }
+    ucs_list_head_init(&req->recv.list);
+
+    ucp_dt_recv_state_init(&req->recv.state, buffer, count, datatype);
 
     if (ucs_log_enabled(UCS_LOG_LEVEL_TRACE_REQ)) {
         req->recv.info.sender_tag = 0;
@@ -271,7 +264,8 @@ UCS_PROFILE_FUNC(ucs_status_ptr_t, ucp_tag_msg_recv_nb,
         UCS_PROFILE_REQUEST_EVENT(req, "eager_match", 0);
         status = ucp_eager_unexp_match(worker, rdesc, tag, rdesc->flags,
                                        buffer, buffer_size, datatype,
-                                       &req->recv.state, &req->recv.info);
+                                       &req->recv.state, &req->recv.info,
+                                       &req->recv.frag);
         ucs_trace_req("release receive descriptor %p", rdesc);
         ucp_tag_unexp_desc_release(rdesc);
     } else if (rdesc->flags & UCP_RECV_DESC_FLAG_RNDV) {
@@ -279,7 +273,7 @@ UCS_PROFILE_FUNC(ucs_status_ptr_t, ucp_tag_msg_recv_nb,
         req->recv.length   = buffer_size;
         req->recv.datatype = datatype;
         req->recv.cb       = cb;
-        ucp_rndv_matched(worker, req, (void*)(rdesc + 1));
+        ucp_rndv_matched(worker, req, (void*)(rdesc + 1), rdesc->length);
         ucp_tag_unexp_desc_release(rdesc);
         status = UCS_INPROGRESS;
         save_rreq = 0;
@@ -305,8 +299,8 @@ UCS_PROFILE_FUNC(ucs_status_ptr_t, ucp_tag_msg_recv_nb,
     } else if (save_rreq) {
         ucs_trace_req("msg_recv_nb returning inprogress request %p (%p)",
                       req, req + 1);
-        /* For eager - need to put the recv_req in expected since more packets
-         * will follow. For rndv - don't need to keep the recv_req in the expected queue
+        /* For eager - need to put the recv_req in the fragments hash since
+         * more packets will follow. For rndv - don't need to keep the recv_req in the expected queue
          * as the match to the RTS already happened. */
         req->recv.buffer   = buffer;
         req->recv.length   = buffer_size;
@@ -27,14 +27,33 @@ static ucs_status_t ucp_tag_req_start(ucp_request_t *req, size_t count,
     ucp_worker_h worker       = req->send.ep->worker;
     size_t only_hdr_size      = proto->only_hdr_size;
     unsigned flag_iov_single  = 1;
+    unsigned tune_proto       = UCP_EP_TUNE_PROTO_LAST;
+    ucp_dt_strided_t *dt_strided;
     ucp_rsc_index_t rsc_index;
-    unsigned is_iov;
+    unsigned is_contig;
     size_t zcopy_thresh;
     ucs_status_t status;
     size_t length;
 
-    is_iov = UCP_DT_IS_IOV(req->send.datatype);
-    if (ucs_unlikely(is_iov)) {
+    is_contig = UCP_DT_IS_CONTIG(req->send.datatype);
+    if (ucs_likely(is_contig)) {
+        length       = ucp_contig_dt_length(req->send.datatype, count);
+        zcopy_thresh = count ? zcopy_thresh_arr[0] : SIZE_MAX;
+    } else if (UCP_DT_IS_STRIDED(req->send.datatype)) {
+        dt_strided      = ucp_dt_strided(req->send.datatype);
+        length          = ucp_dt_strided_length(req->send.datatype, count);
+        flag_iov_single = (ucp_dt_strided_num_blocks(dt_strided, 0, length) <=
+                           config->am.max_iovcnt);
+        req->send.state.dt.strided.memh = UCT_MEM_HANDLE_NULL;
+        /* zero copy sends a block per IOV entry, so use it only if the blocks
+         * are large enough for a message to be made of them */
+        if ((count > 0) && ((dt_strided->block_size * config->am.max_iovcnt) >=
+                            zcopy_thresh_arr[0])) {
+            zcopy_thresh = zcopy_thresh_arr[0];
+        } else {
+            zcopy_thresh = SIZE_MAX;
+        }
+    } else {
         length = ucp_dt_length(req->send.datatype, count, req->send.buffer,
                                &req->send.state);
         req->send.state.dt.iov.iovcnt_offset = 0;
@@ -58,9 +77,6 @@ static ucs_status_t ucp_tag_req_start(ucp_request_t *req, size_t count,
                                worker->context,
                                worker->iface_attrs[rsc_index].bandwidth);
         }
-    } else {
-        length       = ucp_contig_dt_length(req->send.datatype, count);
-        zcopy_thresh = count ? zcopy_thresh_arr[0] : SIZE_MAX;
     }
     req->send.length = length;
 
@@ -70,18 +86,21 @@ static ucs_status_t ucp_tag_req_start(ucp_request_t *req, size_t count,
                   req, req->send.datatype, req->send.buffer, length, max_short,
                   rndv_rma_thresh, rndv_am_thresh, zcopy_thresh);
 
-    if (((ssize_t)length <= max_short) && !is_iov) {
+    if (((ssize_t)length <= max_short) && is_contig) {
         /* short */
         req->send.uct.func = proto->contig_short;
         UCS_PROFILE_REQUEST_EVENT(req, "start_contig_short", req->send.length);
-    } else if ((((config->key.rndv_lane != UCP_NULL_RESOURCE) &&
-               (length >= rndv_rma_thresh)) ||
-               (length >= rndv_am_thresh)) && !is_iov) {
+    } else if ((((config->key.rndv_lanes[0] != UCP_NULL_RESOURCE) &&
+               (length >= rndv_rma_thresh) && is_contig) ||
+               (length >= rndv_am_thresh)) &&
+               !UCP_DT_IS_IOV(req->send.datatype)) {
         /* RMA/AM rendezvous */
         ucp_tag_send_start_rndv(req);
         UCS_PROFILE_REQUEST_EVENT(req, "start_rndv", req->send.length);
+        tune_proto = UCP_EP_TUNE_PROTO_RNDV;
     } else if (length < zcopy_thresh) {
         /* bcopy */
+        tune_proto = UCP_EP_TUNE_PROTO_BCOPY;
         if (length <= (config->am.max_bcopy - only_hdr_size)) {
             req->send.uct.func   = proto->bcopy_single;
             UCS_PROFILE_REQUEST_EVENT(req, "start_egr_bcopy_single", req->send.length);
@@ -98,6 +117,7 @@ static ucs_status_t ucp_tag_req_start(ucp_request_t *req, size_t count,
 
         req->send.uct_comp.func  = proto->zcopy_completion;
         req->send.uct_comp.count = 1;
+        tune_proto               = UCP_EP_TUNE_PROTO_ZCOPY;
 
         if ((length <= (config->am.max_zcopy - only_hdr_size)) &&
             flag_iov_single) {
@@ -108,6 +128,16 @@ static ucs_status_t ucp_tag_req_start(ucp_request_t *req, size_t count,
             UCS_PROFILE_REQUEST_EVENT(req, "start_egr_zcopy_multi", req->send.length);
         }
     }
+
+    /* Synchronous sends wait for the receiver, so they don't tell the
+     * bandwidth of the protocol */
+    if (ucs_unlikely(config->tune.enabled) &&
+        (tune_proto != UCP_EP_TUNE_PROTO_LAST) &&
+        !(req->flags & UCP_REQUEST_FLAG_SYNC)) {
+        req->flags               |= UCP_REQUEST_FLAG_TUNE;
+        req->send.tune.proto      = tune_proto;
+        req->send.tune.start_time = ucs_get_time();
+    }
     return UCS_OK;
 }
 
@@ -161,6 +191,7 @@ ucp_tag_send_req(ucp_request_t *req, size_t count, ssize_t max_short,
 
     switch (req->send.datatype & UCP_DATATYPE_CLASS_MASK) {
     case UCP_DATATYPE_CONTIG:
+    case UCP_DATATYPE_STRIDED:
     case UCP_DATATYPE_IOV:
         status = ucp_tag_req_start(req, count, max_short, zcopy_thresh,
                                    rndv_rma_thresh, rndv_am_thresh, proto);
@@ -208,6 +239,7 @@ static void ucp_tag_send_req_init(ucp_request_t* req, ucp_ep_h ep,
     req->send.buffer       = buffer;
     req->send.datatype     = datatype;
     req->send.tag          = tag;
+    req->send.msg_id       = ep->worker->msg_id++;
     req->send.state.offset = 0;
 #if ENABLE_ASSERT
     req->send.lane         = UCP_NULL_LANE;
@@ -242,12 +274,16 @@ UCS_PROFILE_FUNC(ucs_status_ptr_t, ucp_tag_send_nb,
         }
     }
 
+    UCP_THREAD_CS_EXIT_CONDITIONAL(&ep->worker->mt_lock);
+
+    /* The request pool is thread-safe, so allocate outside of the lock */
     req = ucp_request_get(ep->worker);
     if (req == NULL) {
-        ret = UCS_STATUS_PTR(UCS_ERR_NO_MEMORY);
-        goto out;
+        return UCS_STATUS_PTR(UCS_ERR_NO_MEMORY);
     }
 
+    UCP_THREAD_CS_ENTER_CONDITIONAL(&ep->worker->mt_lock);
+
     ucp_tag_send_req_init(req, ep, buffer, datatype, tag, 0);
 
     ret = ucp_tag_send_req(req, count,
@@ -269,17 +305,17 @@ UCS_PROFILE_FUNC(ucs_status_ptr_t, ucp_tag_send_sync_nb,
     ucp_request_t *req;
     ucs_status_ptr_t ret;
 
-    UCP_THREAD_CS_ENTER_CONDITIONAL(&ep->worker->mt_lock);
-
     ucs_trace_req("send_sync_nb buffer %p count %zu tag %"PRIx64" to %s cb %p",
                   buffer, count, tag, ucp_ep_peer_name(ep), cb);
 
+    /* The request pool is thread-safe, so allocate outside of the lock */
     req = ucp_request_get(ep->worker);
     if (req == NULL) {
-        ret = UCS_STATUS_PTR(UCS_ERR_NO_MEMORY);
-        goto out;
+        return UCS_STATUS_PTR(UCS_ERR_NO_MEMORY);
     }
 
+    UCP_THREAD_CS_ENTER_CONDITIONAL(&ep->worker->mt_lock);
+
     /* Remote side needs to send reply, so have it connect to us */
     ucp_ep_connect_remote(ep);
 
@@ -291,7 +327,7 @@ UCS_PROFILE_FUNC(ucs_status_ptr_t, ucp_tag_send_sync_nb,
                            ucp_ep_config(ep)->rndv.rma_thresh,
                            ucp_ep_config(ep)->rndv.am_thresh,
                            cb, &ucp_tag_eager_sync_proto);
-out:
+
     UCP_THREAD_CS_EXIT_CONDITIONAL(&ep->worker->mt_lock);
     return ret;
 }
@@ -29,6 +29,7 @@ typedef struct {
     uint32_t          usage;
     double            rma_score;
     double            amo_score;
+    double            rndv_score;
 } ucp_wireup_lane_desc_t;
 
 
@@ -324,6 +325,7 @@ ucp_wireup_add_lane_desc(ucp_wireup_lane_desc_t *lane_descs,
     lane_desc->usage        = usage;
     lane_desc->rma_score    = 0.0;
     lane_desc->amo_score    = 0.0;
+    lane_desc->rndv_score   = 0.0;
 
 out_update_score:
     if (usage & UCP_WIREUP_LANE_USAGE_RMA) {
@@ -332,6 +334,9 @@ out_update_score:
     if (usage & UCP_WIREUP_LANE_USAGE_AMO) {
         lane_desc->amo_score = score;
     }
+    if (usage & UCP_WIREUP_LANE_USAGE_RNDV) {
+        lane_desc->rndv_score = score;
+    }
 }
 
 #define UCP_WIREUP_COMPARE_SCORE(_elem1, _elem2, _arg, _token) \
@@ -359,6 +364,12 @@ static int ucp_wireup_compare_lane_amo_score(const void *elem1, const void *elem
     return UCP_WIREUP_COMPARE_SCORE(elem1, elem2, arg, amo);
 }
 
+static int ucp_wireup_compare_lane_rndv_score(const void *elem1, const void *elem2,
+                                              void *arg)
+{
+    return UCP_WIREUP_COMPARE_SCORE(elem1, elem2, arg, rndv);
+}
+
 static UCS_F_NOINLINE ucs_status_t
 ucp_wireup_add_memaccess_lanes(ucp_ep_h ep, unsigned address_count,
                                const ucp_address_entry_t *address_list,
@@ -569,7 +580,9 @@ static ucs_status_t ucp_wireup_add_am_lane(ucp_ep_h ep, unsigned address_count,
     int need_am;
 
     /* Check if we need active messages, for wireup */
-    if (!(ucp_ep_get_context_features(ep) & UCP_FEATURE_TAG)) {
+    if (!(ucp_ep_get_context_features(ep) & (UCP_FEATURE_TAG |
+                                              UCP_FEATURE_STREAM |
+                                              UCP_FEATURE_AM))) {
         need_am = 0;
         for (lane = 0; lane < *num_lanes_p; ++lane) {
             need_am = need_am || ucp_worker_is_tl_p2p(ep->worker,
@@ -589,8 +602,10 @@ static ucs_status_t ucp_wireup_add_am_lane(ucp_ep_h ep, unsigned address_count,
     criteria.local_iface_flags  = UCT_IFACE_FLAG_AM_BCOPY;
     criteria.calc_score         = ucp_wireup_am_score_func;
 
-    if (ucs_test_all_flags(ucp_ep_get_context_features(ep), UCP_FEATURE_TAG |
-                                                            UCP_FEATURE_WAKEUP)) {
+    if ((ucp_ep_get_context_features(ep) & UCP_FEATURE_WAKEUP) &&
+        (ucp_ep_get_context_features(ep) & (UCP_FEATURE_TAG |
+                                            UCP_FEATURE_STREAM |
+                                            UCP_FEATURE_AM))) {
         criteria.remote_iface_flags |= UCT_IFACE_FLAG_WAKEUP;
     }
 
@@ -606,22 +621,25 @@ static ucs_status_t ucp_wireup_add_am_lane(ucp_ep_h ep, unsigned address_count,
     return UCS_OK;
 }
 
-static ucs_status_t ucp_wireup_add_rndv_lane(ucp_ep_h ep, unsigned address_count,
-                                             const ucp_address_entry_t *address_list,
-                                             ucp_wireup_lane_desc_t *lane_descs,
-                                             ucp_lane_index_t *num_lanes_p)
+static ucs_status_t ucp_wireup_add_rndv_lanes(ucp_ep_h ep, unsigned address_count,
+                                              const ucp_address_entry_t *address_list,
+                                              ucp_wireup_lane_desc_t *lane_descs,
+                                              ucp_lane_index_t *num_lanes_p)
 {
+    ucp_context_h context = ep->worker->context;
     ucp_wireup_criteria_t criteria;
-    ucp_rsc_index_t rsc_index;
+    ucp_rsc_index_t rsc_index, md_rsc_index, dev_rsc_index, md_index;
+    uint64_t tl_bitmap, remote_md_map;
     ucs_status_t status;
     unsigned addr_index;
+    unsigned num_rndv_lanes;
     double score;
 
     if (!(ucp_ep_get_context_features(ep) & UCP_FEATURE_TAG)) {
         return UCS_OK;
     }
 
-    /* Select one lane for the Rendezvous protocol (for the actual data. not for rts/rtr) */
+    /* Select lanes for the Rendezvous protocol (for the actual data. not for rts/rtr) */
     criteria.title              = "rendezvous";
     criteria.local_md_flags     = UCT_MD_FLAG_REG;
     criteria.remote_md_flags    = UCT_MD_FLAG_REG;  /* TODO not all ucts need reg on remote side */
@@ -634,14 +652,48 @@ static ucs_status_t ucp_wireup_add_rndv_lane(ucp_ep_h ep, unsigned address_count
         criteria.remote_iface_flags |= UCT_IFACE_FLAG_WAKEUP;
     }
 
-    status = ucp_wireup_select_transport(ep, address_list, address_count, &criteria,
-                                         -1, -1, 0, &rsc_index, &addr_index, &score);
-    if ((status == UCS_OK) &&
-        /* a temporary workaround to prevent the ugni uct from using rndv */
-        (strstr(ep->worker->context->tl_rscs[rsc_index].tl_rsc.tl_name, "ugni") == NULL)) {
-         ucp_wireup_add_lane_desc(lane_descs, num_lanes_p, rsc_index, addr_index,
+    tl_bitmap     = -1;
+    remote_md_map = -1;
+
+    for (num_rndv_lanes = 0;
+         (num_rndv_lanes < context->config.ext.max_rndv_lanes) &&
+         (*num_lanes_p < UCP_MAX_LANES);
+         ++num_rndv_lanes)
+    {
+        status = ucp_wireup_select_transport(ep, address_list, address_count,
+                                             &criteria, tl_bitmap, remote_md_map,
+                                             0, &rsc_index, &addr_index, &score);
+        if ((status != UCS_OK) ||
+            /* a temporary workaround to prevent the ugni uct from using rndv */
+            (strstr(context->tl_rscs[rsc_index].tl_rsc.tl_name, "ugni") != NULL)) {
+            break;
+        }
+
+        ucp_wireup_add_lane_desc(lane_descs, num_lanes_p, rsc_index, addr_index,
                                  address_list[addr_index].md_index, score,
                                  UCP_WIREUP_LANE_USAGE_RNDV);
+
+        if (num_rndv_lanes == 0) {
+            /* Additional lanes must use the same local and remote memory
+             * domains, so a single registration and remote key would be valid
+             * for all of them */
+            md_index      = context->tl_rscs[rsc_index].md_index;
+            remote_md_map = UCS_BIT(address_list[addr_index].md_index);
+            tl_bitmap     = 0;
+            for (md_rsc_index = 0; md_rsc_index < context->num_tls; ++md_rsc_index) {
+                if (context->tl_rscs[md_rsc_index].md_index == md_index) {
+                    tl_bitmap |= UCS_BIT(md_rsc_index);
+                }
+            }
+        }
+
+        /* Another transport on the same device would not add bandwidth */
+        for (dev_rsc_index = 0; dev_rsc_index < context->num_tls; ++dev_rsc_index) {
+            if (!strcmp(context->tl_rscs[dev_rsc_index].tl_rsc.dev_name,
+                        context->tl_rscs[rsc_index].tl_rsc.dev_name)) {
+                tl_bitmap &= ~UCS_BIT(dev_rsc_index);
+            }
+        }
     }
 
     return UCS_OK;
@@ -738,8 +790,8 @@ ucs_status_t ucp_wireup_select_lanes(ucp_ep_h ep, unsigned address_count,
         return status;
     }
 
-    status = ucp_wireup_add_rndv_lane(ep, address_count, address_list,
-                                      lane_descs, &key->num_lanes);
+    status = ucp_wireup_add_rndv_lanes(ep, address_count, address_list,
+                                       lane_descs, &key->num_lanes);
     if (status != UCS_OK) {
         return status;
     }
@@ -767,8 +819,7 @@ ucs_status_t ucp_wireup_select_lanes(ucp_ep_h ep, unsigned address_count,
             key->am_lane = lane;
         }
         if (lane_descs[lane].usage & UCP_WIREUP_LANE_USAGE_RNDV) {
-            ucs_assert(key->rndv_lane == UCP_NULL_LANE);
-            key->rndv_lane = lane;
+            key->rndv_lanes[lane] = lane;
         }
         if (lane_descs[lane].usage & UCP_WIREUP_LANE_USAGE_RMA) {
             key->rma_lanes[lane] = lane;
@@ -778,11 +829,13 @@ ucs_status_t ucp_wireup_select_lanes(ucp_ep_h ep, unsigned address_count,
         }
     }
 
-    /* Sort RMA and AMO lanes according to score */
+    /* Sort RMA, AMO and Rendezvous lanes according to score */
     ucs_qsort_r(key->rma_lanes, UCP_MAX_LANES, sizeof(ucp_lane_index_t),
                 ucp_wireup_compare_lane_rma_score, lane_descs);
     ucs_qsort_r(key->amo_lanes, UCP_MAX_LANES, sizeof(ucp_lane_index_t),
                 ucp_wireup_compare_lane_amo_score, lane_descs);
+    ucs_qsort_r(key->rndv_lanes, UCP_MAX_LANES, sizeof(ucp_lane_index_t),
+                ucp_wireup_compare_lane_rndv_score, lane_descs);
 
     /* Get all reachable MDs from full remote address list */
     key->reachable_md_map = ucp_wireup_get_reachable_mds(worker, address_count,
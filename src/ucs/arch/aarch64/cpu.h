@@ -29,6 +29,7 @@
 #define ucs_memory_cpu_fence()        asm volatile ("dmb sy" ::: "memory");
 #define ucs_memory_cpu_store_fence()  asm volatile ("dmb st" ::: "memory");
 #define ucs_memory_cpu_load_fence()   asm volatile ("dmb ld" ::: "memory");
+#define ucs_cpu_relax()               asm volatile ("yield" ::: "memory")
 
 
 #if HAVE_HW_TIMER
@@ -0,0 +1,65 @@
+/**
+* Copyright (C) Mellanox Technologies Ltd. 2001-2017.  ALL RIGHTS RESERVED.
+*
+* See file LICENSE for terms.
+*/
+
+#if defined(__aarch64__)
+
+#include <ucs/arch/memcpy.h>
+#include <ucs/arch/cpu.h>
+#include <ucs/sys/math.h>
+
+
+#if __ARM_NEON
+/*
+ * Copy the head with memcpy until the destination is aligned to a cache line,
+ * copy full cache lines with non-temporal store pairs, and copy the remaining
+ * tail with memcpy.
+ */
+static void ucs_aarch64_memcpy_nt_neon(void *dst, const void *src, size_t len)
+{
+    size_t head = ucs_min(ucs_padding((uintptr_t)dst, UCS_ARCH_CACHE_LINE_SIZE),
+                          len);
+    const char *s;
+    char *d;
+
+    memcpy(dst, src, head);
+    d    = (char*)dst + head;
+    s    = (const char*)src + head;
+    len -= head;
+
+    while (len >= UCS_ARCH_CACHE_LINE_SIZE) {
+        asm volatile ("ldp  q0, q1, [%[s]]       \n"
+                      "ldp  q2, q3, [%[s], #32]  \n"
+                      "stnp q0, q1, [%[d]]       \n"
+                      "stnp q2, q3, [%[d], #32]  \n"
+                      :
+                      : [s] "r" (s), [d] "r" (d)
+                      : "v0", "v1", "v2", "v3", "memory");
+        s   += UCS_ARCH_CACHE_LINE_SIZE;
+        d   += UCS_ARCH_CACHE_LINE_SIZE;
+        len -= UCS_ARCH_CACHE_LINE_SIZE;
+    }
+
+    ucs_memory_cpu_store_fence();
+    memcpy(d, s, len);
+}
+#endif
+
+ucs_memcpy_func_t ucs_arch_memcpy_nt_func(ucs_memcpy_engine_t engine)
+{
+    switch (engine) {
+    case UCS_MEMCPY_ENGINE_LIBC:
+        return (ucs_memcpy_func_t)memcpy;
+#if __ARM_NEON
+    case UCS_MEMCPY_ENGINE_NEON:
+        /* Advanced SIMD is mandatory on ARMv8 */
+        return ucs_aarch64_memcpy_nt_neon;
+#endif
+    default:
+        return NULL;
+    }
+}
+
+#endif
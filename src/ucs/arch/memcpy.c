@@ -0,0 +1,96 @@
+/**
+* Copyright (C) Mellanox Technologies Ltd. 2001-2017.  ALL RIGHTS RESERVED.
+*
+* See file LICENSE for terms.
+*/
+
+#include "memcpy.h"
+
+#include <ucs/config/types.h>
+#include <ucs/debug/log.h>
+#include <ucs/sys/math.h>
+#include <unistd.h>
+
+
+/* Used when the cache sizes are not reported by the system */
+#define UCS_MEMCPY_DEFAULT_CACHE_SHARE  (1 * UCS_MBYTE)
+
+
+const char *ucs_memcpy_engine_names[] = {
+    [UCS_MEMCPY_ENGINE_LIBC]   = "libc",
+    [UCS_MEMCPY_ENGINE_SSE2]   = "sse2",
+    [UCS_MEMCPY_ENGINE_AVX2]   = "avx2",
+    [UCS_MEMCPY_ENGINE_AVX512] = "avx512",
+    [UCS_MEMCPY_ENGINE_NEON]   = "neon",
+    [UCS_MEMCPY_ENGINE_LAST]   = NULL
+};
+
+ucs_memcpy_func_t ucs_memcpy_nt_func = (ucs_memcpy_func_t)memcpy;
+
+static ucs_memcpy_engine_t ucs_memcpy_engine = UCS_MEMCPY_ENGINE_LIBC;
+
+
+#if !defined(__x86_64__) && !defined(__aarch64__)
+ucs_memcpy_func_t ucs_arch_memcpy_nt_func(ucs_memcpy_engine_t engine)
+{
+    return (engine == UCS_MEMCPY_ENGINE_LIBC) ? (ucs_memcpy_func_t)memcpy : NULL;
+}
+#endif
+
+static long ucs_memcpy_sysconf(int name)
+{
+    long value = sysconf(name);
+    return (value > 0) ? value : 0;
+}
+
+/* Part of the cache available to a single core, which is the amount of data a
+ * core can copy without evicting data used by others or by itself */
+static size_t ucs_memcpy_get_cache_share()
+{
+    long l2_size = 0, l3_size = 0, num_cpus;
+
+#ifdef _SC_LEVEL2_CACHE_SIZE
+    l2_size = ucs_memcpy_sysconf(_SC_LEVEL2_CACHE_SIZE);
+#endif
+#ifdef _SC_LEVEL3_CACHE_SIZE
+    l3_size = ucs_memcpy_sysconf(_SC_LEVEL3_CACHE_SIZE);
+#endif
+    num_cpus = ucs_max(ucs_memcpy_sysconf(_SC_NPROCESSORS_ONLN), 1);
+
+    if ((l2_size == 0) && (l3_size == 0)) {
+        return UCS_MEMCPY_DEFAULT_CACHE_SHARE;
+    }
+
+    return ucs_max(l2_size, l3_size / num_cpus);
+}
+
+void ucs_memcpy_init()
+{
+    ucs_memcpy_engine_t engine;
+    ucs_memcpy_func_t func;
+
+    /* The last engine in the list which is supported is the fastest */
+    for (engine = UCS_MEMCPY_ENGINE_LIBC; engine < UCS_MEMCPY_ENGINE_LAST;
+         ++engine) {
+        func = ucs_arch_memcpy_nt_func(engine);
+        if (func != NULL) {
+            ucs_memcpy_engine  = engine;
+            ucs_memcpy_nt_func = func;
+        }
+    }
+
+    /* A larger copy would evict data which is likely to be used again, while
+     * the copied data is usually not read by this core */
+    if (ucs_global_opts.memcpy_nt_thresh == UCS_CONFIG_MEMUNITS_AUTO) {
+        ucs_global_opts.memcpy_nt_thresh = ucs_memcpy_get_cache_share();
+    }
+
+    ucs_debug("using %s non-temporal copy for %zu bytes and above",
+              ucs_memcpy_engine_names[ucs_memcpy_engine],
+              ucs_global_opts.memcpy_nt_thresh);
+}
+
+ucs_memcpy_engine_t ucs_memcpy_get_engine()
+{
+    return ucs_memcpy_engine;
+}
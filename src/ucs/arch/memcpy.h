@@ -0,0 +1,138 @@
+/**
+* Copyright (C) Mellanox Technologies Ltd. 2001-2017.  ALL RIGHTS RESERVED.
+*
+* See file LICENSE for terms.
+*/
+
+#ifndef UCS_ARCH_MEMCPY_H_
+#define UCS_ARCH_MEMCPY_H_
+
+#include <ucs/config/global_opts.h>
+#include <ucs/sys/compiler.h>
+#include <stdint.h>
+#include <string.h>
+
+
+/* Copies up to this size are done inline, without calling libc */
+#define UCS_MEMCPY_SMALL_MAX       16
+
+
+/**
+ * Copy engines which can be used for non-temporal copies.
+ */
+typedef enum ucs_memcpy_engine {
+    UCS_MEMCPY_ENGINE_LIBC,     /* plain memcpy, always available */
+    UCS_MEMCPY_ENGINE_SSE2,
+    UCS_MEMCPY_ENGINE_AVX2,
+    UCS_MEMCPY_ENGINE_AVX512,
+    UCS_MEMCPY_ENGINE_NEON,
+    UCS_MEMCPY_ENGINE_LAST
+} ucs_memcpy_engine_t;
+
+
+typedef void (*ucs_memcpy_func_t)(void *dst, const void *src, size_t len);
+
+
+extern const char *ucs_memcpy_engine_names[];
+extern ucs_memcpy_func_t ucs_memcpy_nt_func;
+
+
+/**
+ * @return Non-temporal copy function of the given engine, or NULL if the
+ *         engine is not supported by the CPU or the compiler.
+ */
+ucs_memcpy_func_t ucs_arch_memcpy_nt_func(ucs_memcpy_engine_t engine);
+
+
+/**
+ * Select the fastest copy engine supported by the CPU, and resolve the
+ * non-temporal copy threshold.
+ */
+void ucs_memcpy_init();
+
+
+/**
+ * @return The engine used by @ref ucs_memcpy_nontemporal.
+ */
+ucs_memcpy_engine_t ucs_memcpy_get_engine();
+
+
+/**
+ * Copy a small buffer of up to @ref UCS_MEMCPY_SMALL_MAX bytes with a couple
+ * of possibly overlapping loads and stores.
+ */
+static UCS_F_ALWAYS_INLINE void
+ucs_memcpy_small(void *dst, const void *src, size_t len)
+{
+    uint64_t q0, q1;
+    uint32_t d0, d1;
+
+    if (len >= sizeof(q0)) {
+        memcpy(&q0, src, sizeof(q0));
+        memcpy(&q1, (const char*)src + len - sizeof(q1), sizeof(q1));
+        memcpy(dst, &q0, sizeof(q0));
+        memcpy((char*)dst + len - sizeof(q1), &q1, sizeof(q1));
+    } else if (len >= sizeof(d0)) {
+        memcpy(&d0, src, sizeof(d0));
+        memcpy(&d1, (const char*)src + len - sizeof(d1), sizeof(d1));
+        memcpy(dst, &d0, sizeof(d0));
+        memcpy((char*)dst + len - sizeof(d1), &d1, sizeof(d1));
+    } else if (len > 0) {
+        ((char*)dst)[0]       = ((const char*)src)[0];
+        ((char*)dst)[len / 2] = ((const char*)src)[len / 2];
+        ((char*)dst)[len - 1] = ((const char*)src)[len - 1];
+    }
+}
+
+
+/**
+ * Copy memory using non-temporal stores, which bypass the cache. The copy is
+ * globally visible when the function returns.
+ */
+static UCS_F_ALWAYS_INLINE void
+ucs_memcpy_nontemporal(void *dst, const void *src, size_t len)
+{
+    ucs_memcpy_nt_func(dst, src, len);
+}
+
+
+/**
+ * Copy one fragment of a larger transfer.
+ *
+ * @param nontemporal  Whether the whole transfer is large enough to bypass
+ *                     the cache.
+ */
+static UCS_F_ALWAYS_INLINE void
+ucs_memcpy_fragment(void *dst, const void *src, size_t len, int nontemporal)
+{
+    if (len <= UCS_MEMCPY_SMALL_MAX) {
+        ucs_memcpy_small(dst, src, len);
+    } else if (ucs_unlikely(nontemporal)) {
+        ucs_memcpy_nontemporal(dst, src, len);
+    } else {
+        memcpy(dst, src, len);
+    }
+}
+
+
+/**
+ * @return Whether a transfer of the given size should bypass the cache.
+ */
+static UCS_F_ALWAYS_INLINE int ucs_memcpy_is_nontemporal(size_t len)
+{
+    return len >= ucs_global_opts.memcpy_nt_thresh;
+}
+
+
+/**
+ * Copy memory, choosing the copy method by size: inline for small buffers,
+ * libc for medium ones, and non-temporal stores for buffers which would
+ * evict a large part of the cache.
+ */
+static UCS_F_ALWAYS_INLINE void
+ucs_memcpy_relaxed(void *dst, const void *src, size_t len)
+{
+    ucs_memcpy_fragment(dst, src, len, ucs_memcpy_is_nontemporal(len));
+}
+
+#endif
@@ -26,6 +26,7 @@
 #define ucs_memory_cpu_fence()        ucs_memory_bus_fence()
 #define ucs_memory_cpu_store_fence()  ucs_memory_bus_fence()
 #define ucs_memory_cpu_load_fence()   ucs_memory_bus_fence()
+#define ucs_cpu_relax()               asm volatile ("or 1,1,1; or 2,2,2" ::: "memory")
 
 
 static inline uint64_t ucs_arch_read_hres_clock()
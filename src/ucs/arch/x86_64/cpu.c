@@ -216,6 +216,13 @@ int ucs_arch_get_cpu_flag()
             if ((result & UCS_CPU_FLAG_AVX) && (_ebx & (1 << 5))) {
                 result |= UCS_CPU_FLAG_AVX2;
             }
+            /* the OS must also save the opmask and upper ZMM registers */
+            if ((result & UCS_CPU_FLAG_AVX) && (_ebx & (1 << 16))) {
+                ucs_x86_xgetbv(0, _eax, _edx);
+                if ((_eax & 0xe6) == 0xe6) {
+                    result |= UCS_CPU_FLAG_AVX512F;
+                }
+            }
         }
         cpu_flag = result;
     }
@@ -32,6 +32,7 @@
 #define ucs_memory_cpu_fence()        ucs_compiler_fence()
 #define ucs_memory_cpu_store_fence()  ucs_compiler_fence()
 #define ucs_memory_cpu_load_fence()   ucs_compiler_fence()
+#define ucs_cpu_relax()               asm volatile ("pause" ::: "memory")
 
 
 static inline uint64_t ucs_arch_read_hres_clock()
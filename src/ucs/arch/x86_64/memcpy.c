@@ -0,0 +1,111 @@
+/**
+* Copyright (C) Mellanox Technologies Ltd. 2001-2017.  ALL RIGHTS RESERVED.
+*
+* See file LICENSE for terms.
+*/
+
+#if defined(__x86_64__)
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include <ucs/arch/memcpy.h>
+#include <ucs/arch/cpu.h>
+#include <ucs/sys/math.h>
+#include <emmintrin.h>
+#ifdef UCS_F_TARGET
+#  include <immintrin.h>
+#endif
+
+
+/* Amount of data loaded before it is stored, to keep several loads in flight */
+#define UCS_X86_MEMCPY_NT_BLOCK   (4 * UCS_ARCH_CACHE_LINE_SIZE)
+
+
+/*
+ * Copy the head with memcpy until the destination is aligned to a cache line,
+ * stream full blocks and then single vectors with non-temporal stores, and
+ * copy the remaining tail with memcpy.
+ */
+#define UCS_X86_MEMCPY_NT(_dst, _src, _len, _vec_t, _load, _stream) \
+    { \
+        const size_t nvec = UCS_X86_MEMCPY_NT_BLOCK / sizeof(_vec_t); \
+        size_t head       = ucs_min(ucs_padding((uintptr_t)(_dst), \
+                                                UCS_ARCH_CACHE_LINE_SIZE), \
+                                    _len); \
+        _vec_t v[UCS_X86_MEMCPY_NT_BLOCK / sizeof(_vec_t)]; \
+        const _vec_t *s; \
+        _vec_t *d; \
+        size_t i; \
+        \
+        memcpy(_dst, _src, head); \
+        d     = (_vec_t*)((char*)(_dst) + head); \
+        s     = (const _vec_t*)((const char*)(_src) + head); \
+        _len -= head; \
+        \
+        while (_len >= UCS_X86_MEMCPY_NT_BLOCK) { \
+            for (i = 0; i < nvec; ++i) { \
+                v[i] = _load(s + i); \
+            } \
+            for (i = 0; i < nvec; ++i) { \
+                _stream(d + i, v[i]); \
+            } \
+            s    += nvec; \
+            d    += nvec; \
+            _len -= UCS_X86_MEMCPY_NT_BLOCK; \
+        } \
+        \
+        while (_len >= sizeof(_vec_t)) { \
+            _stream(d++, _load(s++)); \
+            _len -= sizeof(_vec_t); \
+        } \
+        \
+        _mm_sfence(); \
+        memcpy(d, s, _len); \
+    }
+
+
+static void ucs_x86_memcpy_nt_sse2(void *dst, const void *src, size_t len)
+{
+    UCS_X86_MEMCPY_NT(dst, src, len, __m128i, _mm_loadu_si128,
+                      _mm_stream_si128);
+}
+
+#ifdef UCS_F_TARGET
+static UCS_F_TARGET("avx2")
+void ucs_x86_memcpy_nt_avx2(void *dst, const void *src, size_t len)
+{
+    UCS_X86_MEMCPY_NT(dst, src, len, __m256i, _mm256_loadu_si256,
+                      _mm256_stream_si256);
+}
+
+static UCS_F_TARGET("avx512f")
+void ucs_x86_memcpy_nt_avx512(void *dst, const void *src, size_t len)
+{
+    UCS_X86_MEMCPY_NT(dst, src, len, __m512i, _mm512_loadu_si512,
+                      _mm512_stream_si512);
+}
+#endif
+
+ucs_memcpy_func_t ucs_arch_memcpy_nt_func(ucs_memcpy_engine_t engine)
+{
+    switch (engine) {
+    case UCS_MEMCPY_ENGINE_LIBC:
+        return (ucs_memcpy_func_t)memcpy;
+    case UCS_MEMCPY_ENGINE_SSE2:
+        return ucs_x86_memcpy_nt_sse2;
+#ifdef UCS_F_TARGET
+    case UCS_MEMCPY_ENGINE_AVX2:
+        return (ucs_arch_get_cpu_flag() & UCS_CPU_FLAG_AVX2) ?
+               ucs_x86_memcpy_nt_avx2 : NULL;
+    case UCS_MEMCPY_ENGINE_AVX512:
+        return (ucs_arch_get_cpu_flag() & UCS_CPU_FLAG_AVX512F) ?
+               ucs_x86_memcpy_nt_avx512 : NULL;
+#endif
+    default:
+        return NULL;
+    }
+}
+
+#endif
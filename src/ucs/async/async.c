@@ -290,9 +290,10 @@ ucs_status_t ucs_async_context_init(ucs_async_context_t *async, ucs_async_mode_t
         goto err_free_miss_fds;
     }
 
-    async->mode         = mode;
-    async->num_handlers = 0;
-    async->last_wakeup  = ucs_get_time();
+    async->mode           = mode;
+    async->num_handlers   = 0;
+    async->last_wakeup    = ucs_get_time();
+    async->timer_interval = UCS_TIME_INFINITY;
     return UCS_OK;
 
 err_free_miss_fds:
@@ -355,6 +356,7 @@ void ucs_async_context_destroy(ucs_async_context_t *async)
 }
 
 static ucs_status_t ucs_async_alloc_handler(ucs_async_mode_t mode, int id,
+                                            ucs_time_t interval,
                                             ucs_async_event_cb_t cb, void *arg,
                                             ucs_async_context_t *async)
 {
@@ -388,6 +390,7 @@ static ucs_status_t ucs_async_alloc_handler(ucs_async_mode_t mode, int id,
     handler->cb       = cb;
     handler->arg      = arg;
     handler->async    = async;
+    handler->interval = interval;
     handler->missed   = 0;
     handler->refcount = 1;
     ucs_async_method_call(mode, block);
@@ -409,6 +412,27 @@ err:
     return status;
 }
 
+/* Recalculate the shortest timer interval of the async context */
+static void ucs_async_update_timer_interval(ucs_async_context_t *async)
+{
+    ucs_time_t interval = UCS_TIME_INFINITY;
+    ucs_async_handler_t *handler;
+
+    if (async == NULL) {
+        return;
+    }
+
+    pthread_rwlock_rdlock(&ucs_async_global_context.handlers_lock);
+    kh_foreach_value(&ucs_async_global_context.handlers, handler, {
+        if ((handler->async == async) && (handler->interval != 0)) {
+            interval = ucs_min(interval, handler->interval);
+        }
+    });
+    pthread_rwlock_unlock(&ucs_async_global_context.handlers_lock);
+
+    async->timer_interval = interval;
+}
+
 ucs_status_t ucs_async_set_event_handler(ucs_async_mode_t mode, int event_fd,
                                          int events, ucs_async_event_cb_t cb,
                                          void *arg, ucs_async_context_t *async)
@@ -421,7 +445,7 @@ ucs_status_t ucs_async_set_event_handler(ucs_async_mode_t mode, int event_fd,
         goto err;
     }
 
-    status = ucs_async_alloc_handler(mode, event_fd, cb, arg, async);
+    status = ucs_async_alloc_handler(mode, event_fd, 0, cb, arg, async);
     if (status != UCS_OK) {
         goto err;
     }
@@ -455,7 +479,8 @@ ucs_status_t ucs_async_add_timer(ucs_async_mode_t mode, ucs_time_t interval,
             timer_id = UCS_ASYNC_TIMER_ID_MIN;
         }
 
-        status = ucs_async_alloc_handler(mode, timer_id, cb, arg, async);
+        status = ucs_async_alloc_handler(mode, timer_id, interval, cb, arg,
+                                         async);
     } while (status == UCS_ERR_ALREADY_EXISTS);
     if (status != UCS_OK) {
         goto err;
@@ -466,6 +491,7 @@ ucs_status_t ucs_async_add_timer(ucs_async_mode_t mode, ucs_time_t interval,
         goto err_remove_handler;
     }
 
+    ucs_async_update_timer_interval(async);
     *timer_id_p = timer_id;
     return UCS_OK;
 
@@ -504,6 +530,9 @@ ucs_status_t ucs_async_remove_handler(int id, int sync)
 
     if (handler->async != NULL) {
         ucs_atomic_add32(&handler->async->num_handlers, -1);
+        if (handler->interval != 0) {
+            ucs_async_update_timer_interval(handler->async);
+        }
     }
 
     if (sync) {
@@ -30,6 +30,7 @@ struct ucs_async_context {
     volatile uint32_t num_handlers;  /* Number of event and timer handlers */
     ucs_mpmc_queue_t  missed;        /* Miss queue */
     ucs_time_t        last_wakeup;   /* time of the last wakeup */
+    ucs_time_t        timer_interval;/* Shortest interval of the context timers */
 };
 
 
@@ -83,6 +84,17 @@ static inline int ucs_async_check_miss(ucs_async_context_t *async)
 }
 
 
+/**
+ * @return Shortest interval of the timers added to the async context, or
+ *         UCS_TIME_INFINITY if it has no timers. Can be used to bound blocking
+ *         waits, so timer events which were missed are handled in time.
+ */
+static inline ucs_time_t ucs_async_get_timer_interval(ucs_async_context_t *async)
+{
+    return async->timer_interval;
+}
+
+
 /**
  * Block the async handler (if its currently running, wait until it exists and
  * block it then). Used to serialize accesses with the async handler.
@@ -21,6 +21,7 @@ struct ucs_async_handler {
     ucs_async_event_cb_t       cb;      /* Callback function */
     void                       *arg;    /* Callback argument */
     ucs_async_context_t        *async;  /* Async context for the handler. Can be NULL */
+    ucs_time_t                 interval;/* Timer interval, 0 for event handlers */
     volatile uint32_t          missed;  /* Protect against adding to miss queue multiple times */
     volatile uint32_t          refcount;
 };
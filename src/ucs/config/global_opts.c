@@ -33,7 +33,8 @@ ucs_global_opts_t ucs_global_opts = {
     .stats_trigger         = "exit",
     .memtrack_dest         = "",
     .profile_mode          = 0,
-    .profile_file          = ""
+    .profile_file          = "",
+    .memcpy_nt_thresh      = UCS_CONFIG_MEMUNITS_AUTO
 };
 
 static const char *ucs_handle_error_modes[] = {
@@ -159,10 +160,18 @@ static ucs_config_field_t ucs_global_opts_table[] = {
    ucs_offsetof(ucs_global_opts_t, profile_file), UCS_CONFIG_TYPE_STRING},
 
   {"PROFILE_LOG_SIZE", "4m",
-   "Maximal size of profiling log. New records will replace old records.",
+   "Maximal size of the profiling log of each thread. New records will replace\n"
+   "old records.",
    ucs_offsetof(ucs_global_opts_t, profile_log_size), UCS_CONFIG_TYPE_MEMUNITS},
 #endif
 
+ {"MEMCPY_NT_THRESH", "auto",
+  "Data copies of this size and above use non-temporal stores, which bypass the\n"
+  "cache. \"auto\" sets it to the share of a single core in the last-level\n"
+  "cache, but not less than the L2 cache size. \"inf\" disables non-temporal\n"
+  "copies.",
+  ucs_offsetof(ucs_global_opts_t, memcpy_nt_thresh), UCS_CONFIG_TYPE_MEMUNITS},
+
  {NULL}
 };
 
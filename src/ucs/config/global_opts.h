@@ -90,6 +90,9 @@ typedef struct {
     /* Limit for profiling log size */
      size_t                   profile_log_size;
 
+    /* Copies of this size and above use non-temporal stores */
+    size_t                   memcpy_nt_thresh;
+
 } ucs_global_opts_t;
 
 
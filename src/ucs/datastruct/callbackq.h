@@ -25,11 +25,15 @@
 
 /*
  * Forward declarations
+ *
+ * A callback returns the number of events it has processed, so the dispatcher
+ * can tell whether any progress was made. Slow path callbacks do not report
+ * events.
  */
 typedef struct ucs_callbackq            ucs_callbackq_t;
 typedef struct ucs_callbackq_elem       ucs_callbackq_elem_t;
 typedef struct ucs_callbackq_slow_elem  ucs_callbackq_slow_elem_t;
-typedef void                            (*ucs_callback_t)(void *arg);
+typedef unsigned                        (*ucs_callback_t)(void *arg);
 typedef void                            (*ucs_callback_slow_t)(ucs_callbackq_slow_elem_t *self);
 
 
@@ -30,13 +30,17 @@
  * Complexity: O(n)
  *
  * @param  [in] cbq      Callback queue whose elements to dispatch.
+ *
+ * @return Sum of the event counts returned by the callbacks.
  */
-static inline void ucs_callbackq_dispatch(ucs_callbackq_t *cbq)
+static inline unsigned ucs_callbackq_dispatch(ucs_callbackq_t *cbq)
 {
     ucs_callbackq_elem_t *elem;
+    unsigned count = 0;
 
     ucs_callbackq_for_each(elem, cbq) {
-        elem->cb(elem->arg);
+        count += elem->cb(elem->arg);
     }
+    return count;
 }
 #endif
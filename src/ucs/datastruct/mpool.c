@@ -8,10 +8,32 @@
 #include "mpool.inl"
 #include "queue.h"
 
+#include <ucs/arch/atomic.h>
+#include <ucs/arch/bitops.h>
 #include <ucs/debug/log.h>
 #include <ucs/sys/math.h>
 #include <ucs/sys/checker.h>
 #include <ucs/sys/sys.h>
+#include <linux/mempolicy.h>
+
+
+/* Maximal NUMA node number which chunks can be bound to */
+#define UCS_MPOOL_NUMA_MAX_NODES    1024
+
+
+/* The depot of a thread-safe pool keeps the stack head pointer in the lower
+ * bits, and a tag which is incremented by every update in the upper bits */
+#define UCS_MPOOL_DEPOT_PTR_BITS    48
+#define UCS_MPOOL_DEPOT_PTR_MASK    UCS_MASK(UCS_MPOOL_DEPOT_PTR_BITS)
+
+/* Thread index value for threads which have no magazine */
+#define UCS_MPOOL_THREAD_NONE       UCS_MPOOL_MAX_THREADS
+
+
+static pthread_once_t  ucs_mpool_thread_once = PTHREAD_ONCE_INIT;
+static pthread_key_t   ucs_mpool_thread_key;
+static pthread_mutex_t ucs_mpool_thread_lock = PTHREAD_MUTEX_INITIALIZER;
+static uint64_t        ucs_mpool_thread_map  = 0;
 
 
 static inline unsigned ucs_mpool_elem_total_size(ucs_mpool_data_t *data)
@@ -26,6 +48,107 @@ static inline ucs_mpool_elem_t *ucs_mpool_chunk_elem(ucs_mpool_data_t *data,
     return chunk->elems + elem_index * ucs_mpool_elem_total_size(data);
 }
 
+static void ucs_mpool_thread_release(void *arg)
+{
+    unsigned index = (uintptr_t)arg - 1;
+
+    if (index == UCS_MPOOL_THREAD_NONE) {
+        return;
+    }
+
+    /* The magazines of this index keep their elements for the next thread
+     * which gets the same index */
+    pthread_mutex_lock(&ucs_mpool_thread_lock);
+    ucs_mpool_thread_map &= ~UCS_BIT(index);
+    pthread_mutex_unlock(&ucs_mpool_thread_lock);
+}
+
+static void ucs_mpool_thread_key_create()
+{
+    int ret;
+
+    ret = pthread_key_create(&ucs_mpool_thread_key, ucs_mpool_thread_release);
+    if (ret != 0) {
+        ucs_fatal("pthread_key_create() failed: %s", strerror(ret));
+    }
+}
+
+/* Returns the magazine index of the calling thread, shared by all pools */
+static unsigned ucs_mpool_thread_index()
+{
+    uintptr_t value;
+
+    pthread_once(&ucs_mpool_thread_once, ucs_mpool_thread_key_create);
+
+    value = (uintptr_t)pthread_getspecific(ucs_mpool_thread_key);
+    if (ucs_likely(value != 0)) {
+        return value - 1;
+    }
+
+    pthread_mutex_lock(&ucs_mpool_thread_lock);
+    if (ucs_mpool_thread_map == UINT64_MAX) {
+        value = UCS_MPOOL_THREAD_NONE;
+    } else {
+        value = ucs_ffs64(~ucs_mpool_thread_map);
+        ucs_mpool_thread_map |= UCS_BIT(value);
+    }
+    pthread_mutex_unlock(&ucs_mpool_thread_lock);
+
+    ucs_debug("thread %d uses mpool magazine index %lu", ucs_get_tid(), value);
+    pthread_setspecific(ucs_mpool_thread_key, (void*)(value + 1));
+    return value;
+}
+
+static inline ucs_mpool_elem_t *ucs_mpool_depot_head(uint64_t depot)
+{
+    return (ucs_mpool_elem_t*)(uintptr_t)(depot & UCS_MPOOL_DEPOT_PTR_MASK);
+}
+
+static inline uint64_t ucs_mpool_depot_next(uint64_t depot,
+                                            ucs_mpool_elem_t *head)
+{
+    return (((depot >> UCS_MPOOL_DEPOT_PTR_BITS) + 1) << UCS_MPOOL_DEPOT_PTR_BITS) |
+           (uintptr_t)head;
+}
+
+/* Push a chain of elements, linked by their 'next' field, to the depot */
+static void ucs_mpool_depot_push(ucs_mpool_t *mp, ucs_mpool_elem_t *first,
+                                 ucs_mpool_elem_t *last)
+{
+    volatile uint64_t *depot = &mp->data->depot;
+    uint64_t old;
+
+    VALGRIND_MAKE_MEM_DEFINED(last, sizeof *last);
+    do {
+        old        = *depot;
+        last->next = ucs_mpool_depot_head(old);
+    } while (ucs_atomic_cswap64(depot, old,
+                                ucs_mpool_depot_next(old, first)) != old);
+}
+
+static ucs_mpool_elem_t *ucs_mpool_depot_pop(ucs_mpool_t *mp)
+{
+    volatile uint64_t *depot = &mp->data->depot;
+    ucs_mpool_elem_t *elem;
+    uint64_t old;
+
+    /* The element may be popped and reused by another thread after reading the
+     * head, so its 'next' value may be garbage. In this case the tag would be
+     * changed and compare-and-swap would fail. Chunk memory is not released
+     * until the pool is destroyed, so reading it is safe. */
+    do {
+        old  = *depot;
+        elem = ucs_mpool_depot_head(old);
+        if (elem == NULL) {
+            return NULL;
+        }
+        VALGRIND_MAKE_MEM_DEFINED(elem, sizeof *elem);
+    } while (ucs_atomic_cswap64(depot, old,
+                                ucs_mpool_depot_next(old, elem->next)) != old);
+
+    return elem;
+}
+
 static void ucs_mpool_chunk_leak_check(ucs_mpool_t *mp, ucs_mpool_chunk_t *chunk)
 {
     ucs_mpool_elem_t *elem;
@@ -43,8 +166,12 @@ static void ucs_mpool_chunk_leak_check(ucs_mpool_t *mp, ucs_mpool_chunk_t *chunk
 ucs_status_t ucs_mpool_init(ucs_mpool_t *mp, size_t priv_size,
                             size_t elem_size, size_t align_offset, size_t alignment,
                             unsigned elems_per_chunk, unsigned max_elems,
-                            ucs_mpool_ops_t *ops, const char *name)
+                            unsigned flags, ucs_mpool_ops_t *ops,
+                            const char *name)
 {
+    unsigned i;
+    int ret;
+
     /* Check input values */
     if ((elem_size == 0) || (align_offset > elem_size) ||
         (alignment == 0) || !ucs_is_pow2(alignment) ||
@@ -61,6 +188,7 @@ ucs_status_t ucs_mpool_init(ucs_mpool_t *mp, size_t priv_size,
     }
 
     mp->freelist           = NULL;
+    mp->flags              = flags;
     mp->data->elem_size    = sizeof(ucs_mpool_elem_t) + elem_size;
     mp->data->alignment    = alignment;
     mp->data->align_offset = sizeof(ucs_mpool_elem_t) + align_offset;
@@ -71,25 +199,54 @@ ucs_status_t ucs_mpool_init(ucs_mpool_t *mp, size_t priv_size,
     mp->data->chunks       = NULL;
     mp->data->ops          = ops;
     mp->data->name         = strdup(name);
+    mp->data->depot        = 0;
+    mp->data->magazines    = NULL;
+
+    if (flags & UCS_MPOOL_FLAG_THREAD_SAFE) {
+        mp->data->magazines = ucs_memalign(UCS_SYS_CACHE_LINE_SIZE,
+                                           UCS_MPOOL_MAX_THREADS *
+                                           sizeof(*mp->data->magazines),
+                                           "mpool_magazines");
+        if (mp->data->magazines == NULL) {
+            ucs_error("Failed to allocate memory pool magazines");
+            goto err_free_data;
+        }
+
+        for (i = 0; i < UCS_MPOOL_MAX_THREADS; ++i) {
+            mp->data->magazines[i].freelist = NULL;
+            mp->data->magazines[i].count    = 0;
+        }
+
+        ret = pthread_spin_init(&mp->data->grow_lock, 0);
+        if (ret != 0) {
+            ucs_error("pthread_spin_init() failed: %s", strerror(ret));
+            goto err_free_magazines;
+        }
+    }
 
     VALGRIND_CREATE_MEMPOOL(mp, 0, 0);
 
-    ucs_debug("mpool %s: align %u, maxelems %u, elemsize %u",
-              ucs_mpool_name(mp), mp->data->alignment, max_elems, mp->data->elem_size);
+    ucs_debug("mpool %s: align %u, maxelems %u, elemsize %u%s",
+              ucs_mpool_name(mp), mp->data->alignment, max_elems, mp->data->elem_size,
+              (flags & UCS_MPOOL_FLAG_THREAD_SAFE) ? ", thread-safe" : "");
     return UCS_OK;
+
+err_free_magazines:
+    ucs_free(mp->data->magazines);
+err_free_data:
+    free(mp->data->name);
+    ucs_free(mp->data);
+    return UCS_ERR_NO_MEMORY;
 }
 
-void ucs_mpool_cleanup(ucs_mpool_t *mp, int leak_check)
+static void ucs_mpool_freelist_cleanup(ucs_mpool_t *mp,
+                                       ucs_mpool_elem_t *freelist)
 {
-    ucs_mpool_chunk_t *chunk, *next_chunk;
     ucs_mpool_elem_t *elem, *next_elem;
     ucs_mpool_data_t *data = mp->data;
     void *obj;
 
-    /* Cleanup all elements in the freelist and set their header to NULL to mark
-     * them as released for the leak check.
-     */
-    next_elem = mp->freelist;
+    next_elem = freelist;
     while (next_elem != NULL) {
         elem = next_elem;
         VALGRIND_MAKE_MEM_DEFINED(elem, sizeof *elem);
@@ -103,6 +260,24 @@ void ucs_mpool_cleanup(ucs_mpool_t *mp, int leak_check)
         }
         elem->mpool = NULL;
     }
+}
+
+void ucs_mpool_cleanup(ucs_mpool_t *mp, int leak_check)
+{
+    ucs_mpool_chunk_t *chunk, *next_chunk;
+    ucs_mpool_data_t *data = mp->data;
+    unsigned i;
+
+    /* Cleanup all elements in the freelist and set their header to NULL to mark
+     * them as released for the leak check.
+     */
+    ucs_mpool_freelist_cleanup(mp, mp->freelist);
+    if (mp->flags & UCS_MPOOL_FLAG_THREAD_SAFE) {
+        ucs_mpool_freelist_cleanup(mp, ucs_mpool_depot_head(data->depot));
+        for (i = 0; i < UCS_MPOOL_MAX_THREADS; ++i) {
+            ucs_mpool_freelist_cleanup(mp, data->magazines[i].freelist);
+        }
+    }
 
     /* Must be done before chunks are released and other threads could allocated
      * the same memory address
@@ -126,6 +301,11 @@ void ucs_mpool_cleanup(ucs_mpool_t *mp, int leak_check)
 
     ucs_debug("mpool %s destroyed", ucs_mpool_name(mp));
 
+    if (mp->flags & UCS_MPOOL_FLAG_THREAD_SAFE) {
+        pthread_spin_destroy(&data->grow_lock);
+        ucs_free(data->magazines);
+    }
+
     free(data->name);
     ucs_free(data);
 }
@@ -142,6 +322,12 @@ const char *ucs_mpool_name(ucs_mpool_t *mp)
 
 int ucs_mpool_is_empty(ucs_mpool_t *mp)
 {
+    if (mp->flags & UCS_MPOOL_FLAG_THREAD_SAFE) {
+        /* Elements in the magazines of other threads are not accounted */
+        return (ucs_mpool_depot_head(mp->data->depot) == NULL) &&
+               (mp->data->quota == 0);
+    }
+
     return (mp->freelist == NULL) && (mp->data->quota == 0);
 }
 
@@ -155,20 +341,72 @@ void ucs_mpool_put(void *obj)
     ucs_mpool_put_inline(obj);
 }
 
-void *ucs_mpool_get_grow(ucs_mpool_t *mp)
+/* Set the memory policy of the chunk to prefer the NUMA node of the calling
+ * thread. This affects only pages which were not faulted in yet. */
+static void ucs_mpool_chunk_numa_bind(ucs_mpool_t *mp, void *ptr, size_t size)
+{
+#if defined(__NR_mbind) && defined(__NR_getcpu)
+    unsigned long nodemask[UCS_MPOOL_NUMA_MAX_NODES / (8 * sizeof(unsigned long))];
+    size_t page_size = ucs_get_page_size();
+    uintptr_t start, end;
+    unsigned cpu, node;
+    int ret;
+
+    start = ucs_align_up_pow2((uintptr_t)ptr, page_size);
+    end   = ucs_align_down_pow2((uintptr_t)ptr + size, page_size);
+    if (start >= end) {
+        return;
+    }
+
+    ret = syscall(__NR_getcpu, &cpu, &node, NULL);
+    if ((ret < 0) || (node >= UCS_MPOOL_NUMA_MAX_NODES - 1)) {
+        ucs_debug("mpool %s: failed to get NUMA node of cpu: %m",
+                  ucs_mpool_name(mp));
+        return;
+    }
+
+    memset(nodemask, 0, sizeof(nodemask));
+    nodemask[node / (8 * sizeof(unsigned long))] |=
+                    1ul << (node % (8 * sizeof(unsigned long)));
+
+    ret = syscall(__NR_mbind, start, end - start, MPOL_PREFERRED, nodemask,
+                  UCS_MPOOL_NUMA_MAX_NODES, 0);
+    if (ret < 0) {
+        ucs_debug("mpool %s: mbind(addr=0x%lx length=%ld node=%u) failed: %m",
+                  ucs_mpool_name(mp), start, end - start, node);
+    }
+#endif
+}
+
+/* Touch every page of the chunk, so page faults happen when the pool grows
+ * rather than when the objects are first used */
+static void ucs_mpool_chunk_prefault(void *ptr, size_t size)
+{
+    size_t page_size = ucs_get_page_size();
+    volatile char *p;
+
+    for (p = ptr; p < (char*)ptr + size; p += page_size) {
+        *p = *p;
+    }
+    if (size > 0) {
+        p  = (char*)ptr + size - 1;
+        *p = *p;
+    }
+}
+
+/* Allocate a new chunk and link its elements to a list, in address order */
+static ucs_mpool_chunk_t *ucs_mpool_chunk_create(ucs_mpool_t *mp,
+                                                 ucs_mpool_elem_t **first_p,
+                                                 ucs_mpool_elem_t **last_p)
 {
     size_t chunk_size, chunk_padding;
     ucs_mpool_data_t *data = mp->data;
+    ucs_mpool_elem_t *elem, *prev;
     ucs_mpool_chunk_t *chunk;
-    ucs_mpool_elem_t *elem;
     ucs_status_t status;
     unsigned i;
     void *ptr;
 
-    if (data->quota == 0) {
-        return NULL;
-    }
-
     chunk_size = data->chunk_size;
     status = data->ops->chunk_alloc(mp, &chunk_size, &ptr);
     if (status != UCS_OK) {
@@ -176,6 +414,24 @@ void *ucs_mpool_get_grow(ucs_mpool_t *mp)
         return NULL;
     }
 
+    /* The depot of a thread-safe pool can address only the lower part of the
+     * address space, since the upper bits of the stack head hold the tag */
+    if ((mp->flags & UCS_MPOOL_FLAG_THREAD_SAFE) &&
+        ((((uintptr_t)ptr + chunk_size - 1) & ~UCS_MPOOL_DEPOT_PTR_MASK) != 0)) {
+        ucs_error("mpool %s: chunk %p of %zu bytes is out of the range of "
+                  "the depot", ucs_mpool_name(mp), ptr, chunk_size);
+        data->ops->chunk_release(mp, ptr);
+        return NULL;
+    }
+
+    if (mp->flags & UCS_MPOOL_FLAG_NUMA_LOCAL) {
+        ucs_mpool_chunk_numa_bind(mp, ptr, chunk_size);
+    }
+
+    if (mp->flags & UCS_MPOOL_FLAG_PREFAULT) {
+        ucs_mpool_chunk_prefault(ptr, chunk_size);
+    }
+
     /* Calculate padding, and update element count according to allocated size */
     chunk            = ptr;
     chunk_padding    = ucs_padding((uintptr_t)(chunk + 1) + data->align_offset,
@@ -187,18 +443,22 @@ void *ucs_mpool_get_grow(ucs_mpool_t *mp)
     ucs_debug("mpool %s: allocated chunk %p of %lu bytes with %u elements",
               ucs_mpool_name(mp), chunk, chunk_size, chunk->num_elems);
 
+    prev = NULL;
     for (i = 0; i < chunk->num_elems; ++i) {
         elem         = ucs_mpool_chunk_elem(data, chunk, i);
         if (data->ops->obj_init != NULL) {
             data->ops->obj_init(mp, elem + 1, chunk);
         }
 
-        ucs_mpool_add_to_freelist(mp, elem, 0);
-        if (mp->data->tail == NULL) {
-            mp->data->tail = elem;
+        if (prev == NULL) {
+            *first_p   = elem;
+        } else {
+            prev->next = elem;
         }
+        prev = elem;
     }
-
+    prev->next = NULL;
+    *last_p    = prev;
 
     chunk->next  = data->chunks;
     data->chunks = chunk;
@@ -212,6 +472,153 @@ void *ucs_mpool_get_grow(ucs_mpool_t *mp)
     }
 
     VALGRIND_MAKE_MEM_NOACCESS(chunk + 1, chunk_size - sizeof(*chunk));
+    return chunk;
+}
+
+static void *ucs_mpool_elem_get(ucs_mpool_t *mp, ucs_mpool_elem_t *elem)
+{
+    void *obj;
+
+    elem->mpool = mp;
+    VALGRIND_MAKE_MEM_NOACCESS(elem, sizeof *elem);
+
+    obj = elem + 1;
+    VALGRIND_MEMPOOL_ALLOC(mp, obj, mp->data->elem_size - sizeof(ucs_mpool_elem_t));
+    return obj;
+}
+
+/* Refill an empty magazine from the depot, growing the pool if needed.
+ * Returns one element for the caller. */
+static ucs_mpool_elem_t *ucs_mpool_magazine_refill(ucs_mpool_t *mp,
+                                                   ucs_mpool_magazine_t *mag)
+{
+    ucs_mpool_data_t *data = mp->data;
+    ucs_mpool_elem_t *elem, *first, *last;
+
+    elem = ucs_mpool_depot_pop(mp);
+    if (elem == NULL) {
+        pthread_spin_lock(&data->grow_lock);
+
+        /* Another thread could have grown the pool while we were waiting */
+        elem = ucs_mpool_depot_pop(mp);
+        if ((elem == NULL) && (data->quota != 0) &&
+            (ucs_mpool_chunk_create(mp, &first, &last) != NULL))
+        {
+            elem = first;
+            if (first != last) {
+                ucs_mpool_depot_push(mp, first->next, last);
+            }
+        }
+
+        pthread_spin_unlock(&data->grow_lock);
+        if (elem == NULL) {
+            return NULL;
+        }
+    }
+
+    if (mag == NULL) {
+        return elem;
+    }
+
+    /* Take up to half a magazine, to leave the rest to other threads */
+    while (mag->count < UCS_MPOOL_MAGAZINE_SIZE / 2) {
+        first = ucs_mpool_depot_pop(mp);
+        if (first == NULL) {
+            break;
+        }
+        first->next   = mag->freelist;
+        mag->freelist = first;
+        ++mag->count;
+    }
+
+    return elem;
+}
+
+static void *ucs_mpool_get_mt(ucs_mpool_t *mp)
+{
+    ucs_mpool_magazine_t *mag;
+    ucs_mpool_elem_t *elem;
+    unsigned index;
+
+    index = ucs_mpool_thread_index();
+    if (ucs_unlikely(index == UCS_MPOOL_THREAD_NONE)) {
+        mag = NULL;
+    } else {
+        mag = &mp->data->magazines[index];
+        elem = mag->freelist;
+        if (ucs_likely(elem != NULL)) {
+            VALGRIND_MAKE_MEM_DEFINED(elem, sizeof *elem);
+            mag->freelist = elem->next;
+            --mag->count;
+            return ucs_mpool_elem_get(mp, elem);
+        }
+    }
+
+    elem = ucs_mpool_magazine_refill(mp, mag);
+    if (elem == NULL) {
+        return NULL;
+    }
+
+    return ucs_mpool_elem_get(mp, elem);
+}
+
+void ucs_mpool_put_mt(ucs_mpool_t *mp, void *obj)
+{
+    ucs_mpool_elem_t *elem = (ucs_mpool_elem_t*)obj - 1;
+    ucs_mpool_elem_t *first, *last;
+    ucs_mpool_magazine_t *mag;
+    unsigned index, i;
+
+    VALGRIND_MAKE_MEM_DEFINED(elem, sizeof *elem);
+
+    index = ucs_mpool_thread_index();
+    if (ucs_unlikely(index == UCS_MPOOL_THREAD_NONE)) {
+        ucs_mpool_depot_push(mp, elem, elem);
+        goto out;
+    }
+
+    mag = &mp->data->magazines[index];
+    if (ucs_unlikely(mag->count == UCS_MPOOL_MAGAZINE_SIZE)) {
+        /* Flush half of the magazine to the depot in a single operation */
+        first = last = mag->freelist;
+        for (i = 1; i < UCS_MPOOL_MAGAZINE_SIZE / 2; ++i) {
+            last = last->next;
+        }
+        mag->freelist = last->next;
+        mag->count   -= UCS_MPOOL_MAGAZINE_SIZE / 2;
+        ucs_mpool_depot_push(mp, first, last);
+    }
+
+    elem->next    = mag->freelist;
+    mag->freelist = elem;
+    ++mag->count;
+
+out:
+    VALGRIND_MEMPOOL_FREE(mp, obj);
+}
+
+void *ucs_mpool_get_grow(ucs_mpool_t *mp)
+{
+    ucs_mpool_elem_t *first, *last;
+    ucs_mpool_data_t *data = mp->data;
+
+    if (mp->flags & UCS_MPOOL_FLAG_THREAD_SAFE) {
+        return ucs_mpool_get_mt(mp);
+    }
+
+    if (data->quota == 0) {
+        return NULL;
+    }
+
+    if (ucs_mpool_chunk_create(mp, &first, &last) == NULL) {
+        return NULL;
+    }
+
+    last->next   = mp->freelist;
+    mp->freelist = first;
+    if (data->tail == NULL) {
+        data->tail = last;
+    }
 
     ucs_assert(mp->freelist != NULL); /* Should not recurse */
     return ucs_mpool_get(mp);
@@ -238,11 +645,40 @@ ucs_status_t ucs_mpool_chunk_mmap(ucs_mpool_t *mp, size_t *size_p, void **chunk_
     ucs_mmap_mpool_chunk_hdr_t *chunk;
     size_t real_size;
 
-    real_size = ucs_align_up(*size_p + sizeof(*chunk), ucs_get_page_size());
-    chunk = ucs_mmap(NULL, real_size, PROT_READ|PROT_WRITE,
-                     MAP_PRIVATE|MAP_ANONYMOUS, -1, 0, ucs_mpool_name(mp));
+    chunk = MAP_FAILED;
+
+#ifdef MAP_HUGETLB
+    /* First, try huge pages */
+    if (mp->flags & UCS_MPOOL_FLAG_HUGETLB) {
+        real_size = ucs_align_up(*size_p + sizeof(*chunk),
+                                 ucs_get_huge_page_size());
+        chunk = ucs_mmap(NULL, real_size, PROT_READ|PROT_WRITE,
+                         MAP_PRIVATE|MAP_ANONYMOUS|MAP_HUGETLB, -1, 0,
+                         ucs_mpool_name(mp));
+        if (chunk == MAP_FAILED) {
+            ucs_debug("mpool %s: failed to allocate %zu bytes with huge pages: %m",
+                      ucs_mpool_name(mp), real_size);
+        }
+    }
+#endif
+
+    /* Fallback to regular pages */
     if (chunk == MAP_FAILED) {
-        return UCS_ERR_NO_MEMORY;
+        real_size = ucs_align_up(*size_p + sizeof(*chunk), ucs_get_page_size());
+        chunk = ucs_mmap(NULL, real_size, PROT_READ|PROT_WRITE,
+                         MAP_PRIVATE|MAP_ANONYMOUS, -1, 0, ucs_mpool_name(mp));
+        if (chunk == MAP_FAILED) {
+            return UCS_ERR_NO_MEMORY;
+        }
+
+#ifdef MADV_HUGEPAGE
+        /* Let the kernel back the chunk with transparent huge pages */
+        if ((mp->flags & UCS_MPOOL_FLAG_HUGETLB) &&
+            (madvise(chunk, real_size, MADV_HUGEPAGE) != 0)) {
+            ucs_debug("mpool %s: madvise(HUGEPAGE) failed: %m",
+                      ucs_mpool_name(mp));
+        }
+#endif
     }
 
     chunk->size = real_size;
@@ -8,9 +8,11 @@
 #define UCS_MPOOL_H_
 
 
+#include <ucs/arch/cpu.h>
 #include <ucs/debug/log.h>
 #include <ucs/debug/memtrack.h>
 #include <ucs/type/status.h>
+#include <pthread.h>
 
 
 typedef struct ucs_mpool_chunk   ucs_mpool_chunk_t;
@@ -18,6 +20,32 @@ typedef union  ucs_mpool_elem    ucs_mpool_elem_t;
 typedef struct ucs_mpool         ucs_mpool_t;
 typedef struct ucs_mpool_data    ucs_mpool_data_t;
 typedef struct ucs_mpool_ops     ucs_mpool_ops_t;
+typedef struct ucs_mpool_magazine ucs_mpool_magazine_t;
+
+
+/* Maximal number of threads which can have a magazine in a thread-safe memory
+ * pool. Additional threads use the shared depot directly. */
+#define UCS_MPOOL_MAX_THREADS       64
+
+/* Number of objects a per-thread magazine can hold */
+#define UCS_MPOOL_MAGAZINE_SIZE     64
+
+
+/**
+ * Memory pool flags.
+ */
+enum {
+    UCS_MPOOL_FLAG_THREAD_SAFE = UCS_BIT(0), /**< Objects may be allocated and
+                                                  released concurrently by
+                                                  multiple threads */
+    UCS_MPOOL_FLAG_HUGETLB     = UCS_BIT(1), /**< Generic chunk allocators use
+                                                  huge pages if possible */
+    UCS_MPOOL_FLAG_NUMA_LOCAL  = UCS_BIT(2), /**< Chunk memory is placed on the
+                                                  NUMA node of the thread which
+                                                  grows the pool */
+    UCS_MPOOL_FLAG_PREFAULT    = UCS_BIT(3)  /**< Chunk memory is faulted in
+                                                  when the pool grows */
+};
 
 
 /**
@@ -34,6 +62,11 @@ typedef struct ucs_mpool_ops     ucs_mpool_ops_t;
  * +------------+--------+------+
  *                       |
  *                       This location is aligned.
+ *
+ * A thread-safe memory pool keeps the free elements in per-thread magazines,
+ * so most allocations and releases do not access shared state. When a
+ * magazine is empty or full, elements are moved in bulk from or to a shared
+ * depot, which is a lock-free stack whose head is tagged against ABA.
  */
 
 
@@ -60,11 +93,22 @@ struct ucs_mpool_chunk {
  * Memory pool structure.
  */
 struct ucs_mpool {
-    ucs_mpool_elem_t       *freelist;  /* List of available elements */
+    ucs_mpool_elem_t       *freelist;  /* List of available elements, always
+                                          NULL for a thread-safe pool */
     ucs_mpool_data_t       *data;      /* Slow-path data */
+    unsigned               flags;      /* Memory pool flags */
 };
 
 
+/**
+ * Per-thread cache of free elements of a thread-safe memory pool.
+ */
+struct ucs_mpool_magazine {
+    ucs_mpool_elem_t       *freelist;  /* List of available elements */
+    unsigned               count;      /* Number of elements on the list */
+} UCS_V_ALIGNED(UCS_SYS_CACHE_LINE_SIZE);
+
+
 /**
  * Memory pool slow-path data.
  */
@@ -78,6 +122,12 @@ struct ucs_mpool_data {
     ucs_mpool_chunk_t      *chunks;      /* List of allocated chunks */
     ucs_mpool_ops_t        *ops;         /* Memory pool operations */
     char                   *name;        /* Name - used for debugging */
+
+    /* Thread-safe pool only */
+    volatile uint64_t      depot;        /* Shared stack of free elements, the
+                                            upper bits hold the ABA tag */
+    ucs_mpool_magazine_t   *magazines;   /* Per-thread magazines */
+    pthread_spinlock_t     grow_lock;    /* Serializes growing the pool */
 };
 
 
@@ -139,6 +189,7 @@ struct ucs_mpool_ops {
  * @param elems_per_chunk  Number of elements in a single chunk.
  * @param max_elems        Maximal number of elements which can be allocated by the pool.
  *                         -1 or UINT_MAX means no limit.
+ * @param flags            Memory pool flags, UCS_MPOOL_FLAG_xx.
  * @param ops              Memory pool operations.
  * @param name             Memory pool name.
  *
@@ -147,7 +198,8 @@ struct ucs_mpool_ops {
 ucs_status_t ucs_mpool_init(ucs_mpool_t *mp, size_t priv_size,
                             size_t elem_size, size_t align_offset, size_t alignment,
                             unsigned elems_per_chunk, unsigned max_elems,
-                            ucs_mpool_ops_t *ops, const char *name);
+                            unsigned flags, ucs_mpool_ops_t *ops,
+                            const char *name);
 
 
 /**
@@ -206,7 +258,8 @@ void ucs_mpool_put(void *obj);
 
 /**
  * Allocate and object and grow the memory pool if necessary.
- * Used internally by ucs_mpool_get().
+ * Used internally by ucs_mpool_get(). This is also the allocation path of
+ * thread-safe memory pools.
  *
  * @param mp               Memory pool structure.
  *
@@ -215,6 +268,16 @@ void ucs_mpool_put(void *obj);
 void *ucs_mpool_get_grow(ucs_mpool_t *mp);
 
 
+/**
+ * Return an object to a thread-safe memory pool.
+ * Used internally by ucs_mpool_put().
+ *
+ * @param mp               Memory pool structure.
+ * @param obj              Object to return.
+ */
+void ucs_mpool_put_mt(ucs_mpool_t *mp, void *obj);
+
+
 /**
  * heap-based chunk allocator.
  */
@@ -34,10 +34,13 @@
                     "ptr=%p", (_ptr)); \
     } while (0)
 
+/* The store fence makes the region or directory contents visible before the
+ * pointer to it, for the sake of concurrent lookups */
 #define ucs_pgt_entry_set_region(_pte, _region) \
     do { \
         ucs_pgt_region_t *tmp = (_region); \
         ucs_pgt_check_ptr(tmp); \
+        ucs_memory_cpu_store_fence(); \
         (_pte)->value = ((uintptr_t)tmp) | UCS_PGT_ENTRY_FLAG_REGION; \
     } while (0)
 
@@ -45,9 +48,13 @@
     do { \
         ucs_pgt_dir_t *tmp = (_dir); \
         ucs_pgt_check_ptr(tmp); \
+        ucs_memory_cpu_store_fence(); \
         (_pte)->value = ((uintptr_t)tmp) | UCS_PGT_ENTRY_FLAG_DIR; \
     } while (0)
 
+#define ucs_pgt_entry_load(_pte) \
+    (*(const volatile ucs_pgt_addr_t*)&(_pte)->value)
+
 #define ucs_pgt_entry_get_region(_pte) \
     ({ \
         ucs_assert(ucs_pgt_entry_test(_pte, UCS_PGT_ENTRY_FLAG_REGION)); \
@@ -454,7 +461,7 @@ ucs_status_t ucs_pgtable_remove(ucs_pgtable_t *pgtable, ucs_pgt_region_t *region
 ucs_pgt_region_t *ucs_pgtable_lookup(const ucs_pgtable_t *pgtable,
                                      ucs_pgt_addr_t address)
 {
-    const ucs_pgt_entry_t *pte;
+    ucs_pgt_entry_t pte;
     ucs_pgt_region_t *region;
     ucs_pgt_dir_t *dir;
     unsigned shift;
@@ -466,18 +473,26 @@ ucs_pgt_region_t *ucs_pgtable_lookup(const ucs_pgtable_t *pgtable,
         return NULL;
     }
 
-    /* Descend into the page table */
-    pte   = &pgtable->root;
-    shift = pgtable->shift;
+    /* Descend into the page table. Every entry is read exactly once, so the
+     * lookup would not crash if the page table is modified concurrently, as
+     * long as released directories and regions are not freed until the lookup
+     * is done. In this case the result may be stale, or NULL.
+     */
+    pte.value = ucs_pgt_entry_load(&pgtable->root);
+    shift     = pgtable->shift;
     for (;;) {
-        if (ucs_pgt_entry_test(pte, UCS_PGT_ENTRY_FLAG_REGION)) {
-            region = ucs_pgt_entry_get_region(pte);
-            ucs_assert((address >= region->start) && (address < region->end));
+        if (ucs_pgt_entry_test(&pte, UCS_PGT_ENTRY_FLAG_REGION)) {
+            region = ucs_pgt_entry_get_region(&pte);
+            if ((address < region->start) || (address >= region->end)) {
+                return NULL; /* Concurrent modification */
+            }
             return region;
-        } else if (ucs_pgt_entry_test(pte, UCS_PGT_ENTRY_FLAG_DIR)) {
-            dir = ucs_pgt_entry_get_dir(pte);
-            shift -= UCS_PGT_ENTRY_SHIFT;
-            pte = &dir->entries[(address >> shift) & UCS_PGT_ENTRY_MASK];
+        } else if (ucs_pgt_entry_test(&pte, UCS_PGT_ENTRY_FLAG_DIR) &&
+                   (shift >= UCS_PGT_ADDR_SHIFT + UCS_PGT_ENTRY_SHIFT)) {
+            dir       = ucs_pgt_entry_get_dir(&pte);
+            shift    -= UCS_PGT_ENTRY_SHIFT;
+            pte.value = ucs_pgt_entry_load(
+                            &dir->entries[(address >> shift) & UCS_PGT_ENTRY_MASK]);
         } else {
             return NULL;
         }
@@ -199,6 +199,12 @@ ucs_status_t ucs_pgtable_remove(ucs_pgtable_t *pgtable, ucs_pgt_region_t *region
 /*
  * Find a region which contains the given address.
  *
+ * This function may be called concurrently with page table modifications,
+ * provided that directories and regions removed from the page table are not
+ * released until all such lookups which could have observed them are done.
+ * In this case the returned region may be one which was just removed, or NULL
+ * could be returned for an address which is mapped.
+ *
  * @param [in]  pgtable     Page table to search the address in.
  * @param [in]  address     Address to search.
  *
@@ -19,15 +19,20 @@ const char *ucs_profile_mode_names[] = {
 
 ucs_profile_global_context_t ucs_profile_ctx = {
     .locations       = NULL,
-    .log.start       = NULL,
-    .log.end         = NULL,
-    .log.current     = NULL,
-    .log.wraparound  = 0,
-    .accum.stack_top = -1,
     .num_locations   = 0,
     .max_locations   = 0,
+    .lock            = PTHREAD_MUTEX_INITIALIZER,
+    .thread_list     = UCS_LIST_INITIALIZER(&ucs_profile_ctx.thread_list,
+                                            &ucs_profile_ctx.thread_list),
+    .generation      = 0
 };
 
+__thread ucs_profile_thread_context_t *ucs_profile_thread_ctx = NULL;
+
+static pthread_once_t ucs_profile_thread_once = PTHREAD_ONCE_INIT;
+static pthread_key_t  ucs_profile_thread_key;
+
+
 static void ucs_profile_file_write_data(int fd, void *data, size_t size)
 {
     ssize_t written = write(fd, data, size);
@@ -45,11 +50,57 @@ static void ucs_profile_file_write_records(int fd, ucs_profile_record_t *begin,
     ucs_profile_file_write_data(fd, begin, (void*)end - (void*)begin);
 }
 
+/* Assume locked */
+static void ucs_profile_write_thread(int fd, ucs_profile_thread_context_t *ctx,
+                                     unsigned num_locations)
+{
+    ucs_profile_thread_location_t empty_location = {0, 0};
+    ucs_profile_thread_header_t thread_header;
+    unsigned i, num_thread_locations;
+
+    thread_header.tid         = ctx->tid;
+    thread_header.start_time  = ctx->start_time;
+    thread_header.end_time    = ctx->is_completed ? ctx->end_time : ucs_get_time();
+
+    if (ctx->generation != ucs_profile_ctx.generation) {
+        /* the thread did not record anything since the last reset */
+        thread_header.num_records = 0;
+        num_thread_locations      = 0;
+    } else {
+        thread_header.num_records = ctx->log.wraparound ?
+                                    (ctx->log.end     - ctx->log.start) :
+                                    (ctx->log.current - ctx->log.start);
+        num_thread_locations      = ctx->accum.num_locations;
+    }
+    ucs_profile_file_write_data(fd, &thread_header, sizeof(thread_header));
+
+    /* write accumulated data, also for locations the thread did not reach */
+    ucs_profile_file_write_data(fd, ctx->accum.locations,
+                                sizeof(*ctx->accum.locations) *
+                                num_thread_locations);
+    for (i = num_thread_locations; i < num_locations; ++i) {
+        ucs_profile_file_write_data(fd, &empty_location, sizeof(empty_location));
+    }
+
+    /* write records */
+    if (thread_header.num_records == 0) {
+        return;
+    }
+
+    if (ctx->log.wraparound > 0) {
+        ucs_profile_file_write_records(fd, ctx->log.current, ctx->log.end);
+    }
+    ucs_profile_file_write_records(fd, ctx->log.start, ctx->log.current);
+}
+
+/* Assume locked */
 static void ucs_profile_write()
 {
+    ucs_profile_thread_context_t *ctx;
     ucs_profile_header_t header;
     char fullpath[1024] = {0};
     char filename[1024] = {0};
+    unsigned i;
     int fd;
 
     if (!ucs_global_opts.profile_mode) {
@@ -73,33 +124,165 @@ static void ucs_profile_write()
     header.pid = getpid();
     header.mode = ucs_global_opts.profile_mode;
     header.num_locations = ucs_profile_ctx.num_locations;
-    header.num_records   = ucs_profile_ctx.log.wraparound ?
-                    (ucs_profile_ctx.log.end     - ucs_profile_ctx.log.start) :
-                    (ucs_profile_ctx.log.current - ucs_profile_ctx.log.start);
+    header.num_threads   = ucs_list_length(&ucs_profile_ctx.thread_list);
     header.one_second    = ucs_time_from_sec(1.0);
     ucs_profile_file_write_data(fd, &header, sizeof(header));
 
     /* write locations */
-    ucs_profile_file_write_data(fd, ucs_profile_ctx.locations,
-                                sizeof(*ucs_profile_ctx.locations) *
-                                ucs_profile_ctx.num_locations);
+    for (i = 0; i < ucs_profile_ctx.num_locations; ++i) {
+        ucs_profile_file_write_data(fd, &ucs_profile_ctx.locations[i].super,
+                                    sizeof(ucs_profile_ctx.locations[i].super));
+    }
 
-    /* write records */
-    if (ucs_profile_ctx.log.wraparound > 0) {
-        ucs_profile_file_write_records(fd, ucs_profile_ctx.log.current,
-                                       ucs_profile_ctx.log.end);
+    /* write threads */
+    ucs_list_for_each(ctx, &ucs_profile_ctx.thread_list, list) {
+        ucs_profile_write_thread(fd, ctx, ucs_profile_ctx.num_locations);
     }
-    ucs_profile_file_write_records(fd, ucs_profile_ctx.log.start,
-                                   ucs_profile_ctx.log.current);
 
     close(fd);
 }
 
+static void ucs_profile_thread_release(void *arg)
+{
+    ucs_profile_thread_context_t *ctx = arg;
+
+    /* Keep the context until its data is dumped */
+    pthread_mutex_lock(&ucs_profile_ctx.lock);
+    ctx->end_time     = ucs_get_time();
+    ctx->is_completed = 1;
+    pthread_mutex_unlock(&ucs_profile_ctx.lock);
+}
+
+static void ucs_profile_thread_key_create()
+{
+    int ret;
+
+    ret = pthread_key_create(&ucs_profile_thread_key, ucs_profile_thread_release);
+    if (ret != 0) {
+        ucs_fatal("pthread_key_create() failed: %s", strerror(ret));
+    }
+}
+
+ucs_profile_thread_context_t *ucs_profile_thread_init()
+{
+    ucs_profile_thread_context_t *ctx;
+
+    pthread_once(&ucs_profile_thread_once, ucs_profile_thread_key_create);
+
+    /* The log and the accumulated locations are allocated on first use */
+    ctx = ucs_calloc(1, sizeof(*ctx), "profile_thread_context");
+    if (ctx == NULL) {
+        ucs_error("failed to allocate profiling thread context");
+        return NULL;
+    }
+
+    ctx->tid             = ucs_get_tid();
+    ctx->start_time      = ucs_get_time();
+    ctx->accum.stack_top = -1;
+
+    pthread_mutex_lock(&ucs_profile_ctx.lock);
+    ctx->generation      = ucs_profile_ctx.generation;
+    ucs_list_add_tail(&ucs_profile_ctx.thread_list, &ctx->list);
+    pthread_mutex_unlock(&ucs_profile_ctx.lock);
+
+    pthread_setspecific(ucs_profile_thread_key, ctx);
+    ucs_profile_thread_ctx = ctx;
+    return ctx;
+}
+
+static void ucs_profile_thread_free_data(ucs_profile_thread_context_t *ctx)
+{
+    ucs_free(ctx->log.start);
+    ctx->log.start           = NULL;
+    ctx->log.end             = NULL;
+    ctx->log.current         = NULL;
+    ctx->log.wraparound      = 0;
+    ucs_free(ctx->accum.locations);
+    ctx->accum.locations     = NULL;
+    ctx->accum.num_locations = 0;
+}
+
+void ucs_profile_thread_reset(ucs_profile_thread_context_t *ctx)
+{
+    pthread_mutex_lock(&ucs_profile_ctx.lock);
+
+    /* The locations could be registered again since the reset, so the array
+     * is allocated again on the next use. The log buffer is reused. */
+    ucs_free(ctx->accum.locations);
+    ctx->accum.locations     = NULL;
+    ctx->accum.num_locations = 0;
+    ctx->log.current         = ctx->log.start;
+    ctx->log.wraparound      = 0;
+    ctx->generation          = ucs_profile_ctx.generation;
+
+    pthread_mutex_unlock(&ucs_profile_ctx.lock);
+}
+
+ucs_status_t ucs_profile_thread_expand_locations(ucs_profile_thread_context_t *ctx)
+{
+    ucs_profile_thread_location_t *locations;
+    ucs_status_t status;
+    unsigned num_locations;
+
+    pthread_mutex_lock(&ucs_profile_ctx.lock);
+
+    num_locations = ucs_profile_ctx.num_locations;
+    locations     = ucs_realloc(ctx->accum.locations,
+                                sizeof(*locations) * num_locations,
+                                "profile_thread_locations");
+    if (locations == NULL) {
+        ucs_warn("failed to expand thread locations array");
+        status = UCS_ERR_NO_MEMORY;
+        goto out;
+    }
+
+    memset(locations + ctx->accum.num_locations, 0,
+           sizeof(*locations) * (num_locations - ctx->accum.num_locations));
+    ctx->accum.locations     = locations;
+    ctx->accum.num_locations = num_locations;
+    status                   = UCS_OK;
+
+out:
+    pthread_mutex_unlock(&ucs_profile_ctx.lock);
+    return status;
+}
+
+ucs_status_t ucs_profile_thread_log_rewind(ucs_profile_thread_context_t *ctx)
+{
+    size_t num_records;
+
+    if (ctx->log.start != NULL) {
+        ctx->log.current    = ctx->log.start;
+        ctx->log.wraparound = 1;
+        return UCS_OK;
+    }
+
+    num_records = ucs_global_opts.profile_log_size / sizeof(ucs_profile_record_t);
+    if (num_records == 0) {
+        return UCS_ERR_INVALID_PARAM;
+    }
+
+    pthread_mutex_lock(&ucs_profile_ctx.lock);
+    ctx->log.start = ucs_calloc(num_records, sizeof(ucs_profile_record_t),
+                                "profile_log");
+    if (ctx->log.start == NULL) {
+        pthread_mutex_unlock(&ucs_profile_ctx.lock);
+        ucs_warn("failed to allocate profiling log");
+        return UCS_ERR_NO_MEMORY;
+    }
+
+    ctx->log.end        = ctx->log.start + num_records;
+    ctx->log.current    = ctx->log.start;
+    ctx->log.wraparound = 0;
+    pthread_mutex_unlock(&ucs_profile_ctx.lock);
+    return UCS_OK;
+}
+
 void ucs_profile_get_location(ucs_profile_type_t type, const char *name,
                               const char *file, int line, const char *function,
                               int *loc_id_p)
 {
-    ucs_profile_location_t *loc;
+    ucs_profile_global_location_t *loc;
     int location;
 
     /* Check if profiling is disabled */
@@ -108,8 +291,12 @@ void ucs_profile_get_location(ucs_profile_type_t type, const char *name,
         return;
     }
 
-    /* Location ID must be uninitialized */
-    ucs_assert(*loc_id_p == -1);
+    pthread_mutex_lock(&ucs_profile_ctx.lock);
+
+    /* Another thread could register the location meanwhile */
+    if (*loc_id_p != -1) {
+        goto out;
+    }
 
     location = ucs_profile_ctx.num_locations++;
 
@@ -123,27 +310,26 @@ void ucs_profile_get_location(ucs_profile_type_t type, const char *name,
         if (ucs_profile_ctx.locations == NULL) {
             ucs_warn("failed to expand locations array");
             *loc_id_p = 0;
-            return;
+            goto out;
         }
     }
 
     /* Initialize new location */
     loc             = &ucs_profile_ctx.locations[location];
-    ucs_strncpy_zero(loc->file, basename(file), sizeof(loc->file));
-    ucs_strncpy_zero(loc->function, function, sizeof(loc->function));
-    ucs_strncpy_zero(loc->name, name, sizeof(loc->name));
-    loc->line       = line;
-    loc->type       = type;
-    loc->total_time = 0;
-    loc->count      = 0;
+    ucs_strncpy_zero(loc->super.file, basename(file), sizeof(loc->super.file));
+    ucs_strncpy_zero(loc->super.function, function, sizeof(loc->super.function));
+    ucs_strncpy_zero(loc->super.name, name, sizeof(loc->super.name));
+    loc->super.line = line;
+    loc->super.type = type;
     loc->loc_id_p   = loc_id_p;
     *loc_id_p       = location + 1;
+
+out:
+    pthread_mutex_unlock(&ucs_profile_ctx.lock);
 }
 
 void ucs_profile_global_init()
 {
-    size_t num_records;
-
     if (!ucs_global_opts.profile_mode) {
         goto off;
     }
@@ -153,24 +339,6 @@ void ucs_profile_global_init()
         goto disable;
     }
 
-    if (ucs_global_opts.profile_mode & UCS_BIT(UCS_PROFILE_MODE_LOG)) {
-        num_records = ucs_global_opts.profile_log_size / sizeof(ucs_profile_record_t);
-        ucs_profile_ctx.log.start = ucs_calloc(num_records,
-                                               sizeof(ucs_profile_record_t),
-                                               "profile_log");
-        if (ucs_profile_ctx.log.start == NULL) {
-            ucs_warn("failed to allocate profiling log");
-            goto disable;
-        }
-
-        ucs_profile_ctx.log.end     = ucs_profile_ctx.log.start + num_records;
-        ucs_profile_ctx.log.current = ucs_profile_ctx.log.start;
-    }
-
-    if (ucs_global_opts.profile_mode & UCS_BIT(UCS_PROFILE_MODE_ACCUM)) {
-        ucs_profile_ctx.accum.stack_top = -1;
-    }
-
     ucs_info("profiling is enabled");
     return;
 
@@ -182,7 +350,7 @@ off:
 
 static void ucs_profile_reset_locations()
 {
-    ucs_profile_location_t *loc;
+    ucs_profile_global_location_t *loc;
 
     for (loc = ucs_profile_ctx.locations;
          loc < ucs_profile_ctx.locations + ucs_profile_ctx.num_locations;
@@ -197,35 +365,41 @@ static void ucs_profile_reset_locations()
     ucs_profile_ctx.locations = NULL;
 }
 
+/*
+ * Release the contexts of threads which exited. Live threads may be recording
+ * without the lock, so their contexts are only marked as outdated, and each
+ * thread resets its own data before the next record.
+ */
+static void ucs_profile_threads_reset()
+{
+    ucs_profile_thread_context_t *ctx, *tmp;
+
+    ucs_list_for_each_safe(ctx, tmp, &ucs_profile_ctx.thread_list, list) {
+        if (ctx->is_completed) {
+            ucs_list_del(&ctx->list);
+            ucs_profile_thread_free_data(ctx);
+            ucs_free(ctx);
+        }
+    }
+
+    ++ucs_profile_ctx.generation;
+}
+
 void ucs_profile_global_cleanup()
 {
+    pthread_mutex_lock(&ucs_profile_ctx.lock);
     ucs_profile_write();
-    ucs_free(ucs_profile_ctx.log.start);
-    ucs_profile_ctx.log.start      = NULL;
-    ucs_profile_ctx.log.end        = NULL;
-    ucs_profile_ctx.log.current    = NULL;
-    ucs_profile_ctx.log.wraparound = 0;
+    ucs_profile_threads_reset();
     ucs_profile_reset_locations();
+    pthread_mutex_unlock(&ucs_profile_ctx.lock);
 }
 
 void ucs_profile_dump()
 {
-    ucs_profile_location_t *loc;
-
+    pthread_mutex_lock(&ucs_profile_ctx.lock);
     ucs_profile_write();
-
-    for (loc = ucs_profile_ctx.locations;
-         loc < ucs_profile_ctx.locations + ucs_profile_ctx.num_locations;
-         ++loc)
-    {
-        loc->count      = 0;
-        loc->total_time = 0;
-    }
-
-    if (ucs_global_opts.profile_mode & UCS_BIT(UCS_PROFILE_MODE_LOG)) {
-        ucs_profile_ctx.log.wraparound = 0;
-        ucs_profile_ctx.log.current    = ucs_profile_ctx.log.start;
-    }
+    ucs_profile_threads_reset();
+    pthread_mutex_unlock(&ucs_profile_ctx.lock);
 }
 
 #else
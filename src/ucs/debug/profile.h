@@ -11,9 +11,12 @@
 #  include "config.h"
 #endif
 
+#include <ucs/datastruct/list.h>
 #include <ucs/sys/preprocessor.h>
 #include <ucs/time/time.h>
 #include <ucs/debug/log.h>
+#include <pthread.h>
+#include <sys/types.h>
 
 
 #define UCS_PROFILE_STACK_MAX 64
@@ -52,11 +55,33 @@ typedef struct ucs_profile_header {
     uint32_t                 pid;           /**< Process ID */
     uint32_t                 mode;          /**< Profiling mode */
     uint32_t                 num_locations; /**< Number of locations in the file */
-    uint64_t                 num_records;   /**< Number of records in the file */
+    uint32_t                 num_threads;   /**< Number of threads in the file */
     uint64_t                 one_second;    /**< How much time is one second on the sampled machine */
 } UCS_S_PACKED ucs_profile_header_t;
 
 
+/**
+ * Profile output file thread header. Each thread header is followed by
+ * num_locations entries of @ref ucs_profile_thread_location_t and by
+ * num_records entries of @ref ucs_profile_record_t.
+ */
+typedef struct ucs_profile_thread_header {
+    uint32_t                 tid;           /**< System thread ID */
+    uint64_t                 start_time;    /**< Time of the first record */
+    uint64_t                 end_time;      /**< Time of thread exit, or of the dump */
+    uint64_t                 num_records;   /**< Number of records of the thread */
+} UCS_S_PACKED ucs_profile_thread_header_t;
+
+
+/**
+ * Profile output file per-thread location data
+ */
+typedef struct ucs_profile_thread_location {
+    uint64_t                 total_time;    /**< Total interval from previous location */
+    uint64_t                 count;         /**< Number of times we've hit this location */
+} UCS_S_PACKED ucs_profile_thread_location_t;
+
+
 /**
  * Profile output file sample record
  */
@@ -75,22 +100,22 @@ typedef struct ucs_profile_location {
     char                     file[64];      /**< Source file name */
     char                     function[64];  /**< Function name */
     char                     name[32];      /**< User-provided name */
-    int                      *loc_id_p;     /**< Back-pointer for location ID */
     int                      line;          /**< Source line number */
     uint8_t                  type;          /**< From ucs_profile_type_t */
-    uint64_t                 total_time;    /**< Total interval from previous location */
-    size_t                   count;         /**< Number of times we've hit this location */
 } UCS_S_PACKED ucs_profile_location_t;
 
 
 /**
- * Profiling global context
+ * Profiling context of a single thread
  */
-typedef struct ucs_profile_global_context {
-
-    ucs_profile_location_t   *locations;    /**< Array of all locations */
-    unsigned                 num_locations; /**< Number of valid locations */
-    unsigned                 max_locations; /**< Size of locations array */
+typedef struct ucs_profile_thread_context {
+    pid_t                    tid;           /**< System thread ID */
+    ucs_time_t               start_time;    /**< Time the context was created */
+    ucs_time_t               end_time;      /**< Time the thread exited */
+    int                      is_completed;  /**< Whether the thread exited */
+    unsigned                 generation;    /**< Global generation the data
+                                                 belongs to */
+    ucs_list_link_t          list;          /**< Entry in the global threads list */
 
     struct {
         ucs_profile_record_t *start, *end;  /**< Circular log buffer */
@@ -99,10 +124,40 @@ typedef struct ucs_profile_global_context {
     } log;
 
     struct {
+        ucs_profile_thread_location_t *locations; /**< Accumulated data per location */
+        unsigned             num_locations; /**< Size of locations array */
         int                  stack_top;     /**< Index of stack top */
         ucs_time_t           stack[UCS_PROFILE_STACK_MAX]; /**< Timestamps for each nested scope */
     } accum;
 
+} ucs_profile_thread_context_t;
+
+
+/**
+ * Profile location registered in the global context
+ */
+typedef struct ucs_profile_global_location {
+    ucs_profile_location_t   super;         /**< Location info, as in the file */
+    int                      *loc_id_p;     /**< Back-pointer for location ID */
+} ucs_profile_global_location_t;
+
+
+/**
+ * Profiling global context
+ */
+typedef struct ucs_profile_global_context {
+
+    ucs_profile_global_location_t *locations; /**< Array of all locations */
+    unsigned                 num_locations; /**< Number of valid locations */
+    unsigned                 max_locations; /**< Size of locations array */
+
+    pthread_mutex_t          lock;          /**< Protects the locations and the
+                                                 threads list */
+    ucs_list_link_t          thread_list;   /**< Contexts of all threads */
+    volatile unsigned        generation;    /**< Incremented when the data is
+                                                 reset, live threads then reset
+                                                 their own contexts */
+
 } ucs_profile_global_context_t;
 
 
@@ -127,6 +182,7 @@ void ucs_profile_dump();
 #if HAVE_PROFILING
 
 extern const char *ucs_profile_mode_names[];
+extern ucs_profile_global_context_t ucs_profile_ctx;
 
 /*
  * Register a profiling location - should be called once per location in the
@@ -147,6 +203,49 @@ void ucs_profile_get_location(ucs_profile_type_t type, const char *name,
                               int *loc_id_p);
 
 
+/* Profiling context of the calling thread, or NULL if it was not created yet */
+extern __thread ucs_profile_thread_context_t *ucs_profile_thread_ctx
+                __attribute__((tls_model("initial-exec")));
+
+
+/*
+ * Create the profiling context of the calling thread.
+ * Should not be used directly - use UCS_PROFILE macros instead.
+ *
+ * @return The new context, or NULL if failed to allocate it.
+ */
+ucs_profile_thread_context_t *ucs_profile_thread_init();
+
+
+/*
+ * Reset the data of the calling thread after the profiling data was dumped or
+ * cleaned up.
+ * Should not be used directly - use UCS_PROFILE macros instead.
+ *
+ * @param [in]  ctx       Context of the calling thread.
+ */
+void ucs_profile_thread_reset(ucs_profile_thread_context_t *ctx);
+
+
+/*
+ * Expand the accumulated locations array of a thread to include all locations
+ * registered so far.
+ * Should not be used directly - use UCS_PROFILE macros instead.
+ *
+ * @param [in]  ctx       Thread context to expand.
+ */
+ucs_status_t ucs_profile_thread_expand_locations(ucs_profile_thread_context_t *ctx);
+
+
+/*
+ * Called when the log of a thread is full, or was not allocated yet.
+ * Should not be used directly - use UCS_PROFILE macros instead.
+ *
+ * @param [in]  ctx       Thread context whose log to rewind.
+ */
+ucs_status_t ucs_profile_thread_log_rewind(ucs_profile_thread_context_t *ctx);
+
+
 /*
  * Store a new record with the given data.
  * Should not be used directly - use UCS_PROFILE macros instead.
@@ -165,10 +264,9 @@ static inline void ucs_profile_record(ucs_profile_type_t type, const char *name,
                                       const char *file, int line,
                                       const char *function, int *loc_id_p)
 {
-    extern ucs_profile_global_context_t ucs_profile_ctx;
-    ucs_profile_global_context_t *ctx = &ucs_profile_ctx;
-    ucs_profile_record_t   *rec;
-    ucs_profile_location_t *loc;
+    ucs_profile_thread_context_t  *ctx;
+    ucs_profile_thread_location_t *loc;
+    ucs_profile_record_t          *rec;
     ucs_time_t current_time;
     int loc_id;
 
@@ -183,9 +281,28 @@ retry:
         goto retry;
     }
 
+    ctx = ucs_profile_thread_ctx;
+    if (ucs_unlikely(ctx == NULL)) {
+        ctx = ucs_profile_thread_init();
+        if (ctx == NULL) {
+            return;
+        }
+    }
+
+    if (ucs_unlikely(ctx->generation != ucs_profile_ctx.generation)) {
+        /* the location could be registered again by the reset */
+        ucs_profile_thread_reset(ctx);
+        goto retry;
+    }
+
     current_time = ucs_get_time();
     if (ucs_global_opts.profile_mode & UCS_BIT(UCS_PROFILE_MODE_ACCUM)) {
-        loc              = &ctx->locations[loc_id - 1];
+        if (ucs_unlikely((unsigned)loc_id > ctx->accum.num_locations) &&
+            (ucs_profile_thread_expand_locations(ctx) != UCS_OK)) {
+            return;
+        }
+
+        loc              = &ctx->accum.locations[loc_id - 1];
         switch (type) {
         case UCS_PROFILE_TYPE_SCOPE_BEGIN:
             ctx->accum.stack[++ctx->accum.stack_top] = current_time;
@@ -202,15 +319,16 @@ retry:
         ++loc->count;
     }
     if (ucs_global_opts.profile_mode & UCS_BIT(UCS_PROFILE_MODE_LOG)) {
-        rec              = ctx->log.current;
+        if (ucs_unlikely(ctx->log.current >= ctx->log.end) &&
+            (ucs_profile_thread_log_rewind(ctx) != UCS_OK)) {
+            return;
+        }
+
+        rec              = ctx->log.current++;
         rec->timestamp   = current_time;
         rec->param64     = param64;
         rec->param32     = param32;
         rec->location    = loc_id - 1;
-        if (++ctx->log.current >= ctx->log.end) {
-            ctx->log.current    = ctx->log.start;
-            ctx->log.wraparound = 1;
-        }
     }
 }
 
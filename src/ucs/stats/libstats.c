@@ -59,7 +59,33 @@ ucs_status_t ucs_stats_node_initv(ucs_stats_node_t *node, ucs_stats_class_t *cls
     ucs_list_head_init(&node->children[UCS_STATS_INACTIVE_CHILDREN]);
     ucs_list_head_init(&node->children[UCS_STATS_ACTIVE_CHILDREN]);
     memset(node->counters, 0, cls->num_counters * sizeof(ucs_stats_counter_t));
+    if (node->shards != NULL) {
+        memset(node->shards, 0, UCS_STATS_NUM_SHARDS * node->shard_stride *
+                                sizeof(ucs_stats_counter_t));
+    }
 
     return UCS_OK;
 }
 
+void ucs_stats_node_aggregate(ucs_stats_node_t *node)
+{
+    ucs_stats_node_t *child;
+    unsigned i, shard;
+    int sel;
+
+    if (node->shards != NULL) {
+        for (i = 0; i < node->cls->num_counters; ++i) {
+            node->counters[i] = 0;
+            for (shard = 0; shard < UCS_STATS_NUM_SHARDS; ++shard) {
+                node->counters[i] += node->shards[shard * node->shard_stride + i];
+            }
+        }
+    }
+
+    for (sel = 0; sel < UCS_STATS_CHILDREN_LAST; ++sel) {
+        ucs_list_for_each(child, &node->children[sel], list) {
+            ucs_stats_node_aggregate(child);
+        }
+    }
+}
+
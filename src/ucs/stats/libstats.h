@@ -11,6 +11,7 @@
 #include <ucs/datastruct/list.h>
 #include <ucs/type/status.h>
 #include <ucs/sys/math.h>
+#include <ucs/arch/cpu.h>
 
 #include <stdint.h>
 #include <stdio.h>
@@ -30,6 +31,16 @@ enum {
 
 #define UCS_STAT_NAME_MAX          31
 
+/* Number of per-thread counter shards in a live statistics node, when UCX is
+ * built with thread support. The last shard is shared by all threads which
+ * did not get a shard of their own. */
+#define UCS_STATS_NUM_SHARDS       8
+
+/* Number of counters in a shard, padded to a whole number of cache lines */
+#define UCS_STATS_SHARD_STRIDE(_num_counters) \
+    ucs_align_up_pow2(_num_counters, \
+                      UCS_SYS_CACHE_LINE_SIZE / sizeof(ucs_stats_counter_t))
+
 #define UCS_STATS_NODE_FMT \
     "%s%s"
 #define UCS_STATS_NODE_ARG(_node) \
@@ -61,7 +72,11 @@ struct ucs_stats_node {
     char                 name[UCS_STAT_NAME_MAX + 1];
     ucs_list_link_t      list;
     ucs_list_link_t      children[UCS_STATS_CHILDREN_LAST];
-    ucs_stats_counter_t  counters[];
+    ucs_stats_counter_t  *shards;       /* Per-thread counters, NULL if the node
+                                           was de-serialized */
+    unsigned             shard_stride;  /* Distance between shards, in counters */
+    ucs_stats_counter_t  counters[];    /* Sum of all shards, updated by
+                                           ucs_stats_node_aggregate() */
 };
 
 
@@ -77,6 +92,15 @@ ucs_status_t ucs_stats_node_initv(ucs_stats_node_t *node, ucs_stats_class_t *cls
                                  const char *name, va_list ap);
 
 
+/**
+ * Sum up the per-thread shards of a node and its children into their
+ * "counters" arrays. Nodes without shards are left unchanged.
+ *
+ * @param node  Root of the sub-tree to aggregate.
+ */
+void ucs_stats_node_aggregate(ucs_stats_node_t *node);
+
+
 /**
  * Serialize statistics.
  *
@@ -331,6 +331,10 @@ ucs_status_t ucs_stats_serialize(FILE *stream, ucs_stats_node_t *root, int optio
                                     UCS_STATS_INACTIVE_CHILDREN :
                                     UCS_STATS_ACTIVE_CHILDREN;
 
+    /* Collect the per-thread counters of live nodes, both for stream dumps and
+     * for the UDP client */
+    ucs_stats_node_aggregate(root);
+
     if (options & UCS_STATS_SERIALIZE_BINARY) {
         return ucs_stats_serialize_binary(stream, root, sel);
     } else {
@@ -384,7 +388,9 @@ ucs_stats_deserialize_recurs(FILE *stream, ucs_stats_class_t **classes,
 
     node = ptr + headroom;
 
-    node->cls = cls;
+    node->cls          = cls;
+    node->shards       = NULL;
+    node->shard_stride = 0;
     FREAD(node->name, namelen, stream);
     node->name[namelen] = '\0';
     ucs_list_head_init(&node->children[UCS_STATS_INACTIVE_CHILDREN]);
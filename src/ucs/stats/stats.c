@@ -10,6 +10,7 @@
 
 #include "stats.h"
 
+#include <ucs/arch/bitops.h>
 #include <ucs/debug/log.h>
 #include <ucs/time/time.h>
 #include <ucs/config/global_opts.h>
@@ -45,6 +46,11 @@ typedef struct {
     ucs_time_t           start_time;
     ucs_stats_node_t     root_node;
     ucs_stats_counter_t  root_counters[UCS_ROOT_STATS_LAST];
+#if ENABLE_MT
+    ucs_stats_counter_t  root_shards[UCS_STATS_NUM_SHARDS *
+                                     UCS_STATS_SHARD_STRIDE(UCS_ROOT_STATS_LAST)]
+                         UCS_V_ALIGNED(UCS_SYS_CACHE_LINE_SIZE);
+#endif
 
     union {
         FILE             *stream;         /* Output stream */
@@ -67,6 +73,20 @@ static ucs_stats_context_t ucs_stats_context = {
     .thread           = 0xfffffffful
 };
 
+#if ENABLE_MT
+
+/* Thread shard value for threads which have no shard of their own */
+#define UCS_STATS_THREAD_SHARED    UCS_STATS_NUM_SHARDS
+
+static pthread_once_t  ucs_stats_thread_once = PTHREAD_ONCE_INIT;
+static pthread_key_t   ucs_stats_thread_key;
+static pthread_mutex_t ucs_stats_thread_lock = PTHREAD_MUTEX_INITIALIZER;
+static uint64_t        ucs_stats_thread_map  = 0;
+
+__thread unsigned ucs_stats_thread_shard = 0;
+
+#endif
+
 static ucs_stats_class_t ucs_stats_root_node_class = {
     .name          = "",
     .num_counters  = UCS_ROOT_STATS_LAST,
@@ -83,6 +103,56 @@ ucs_sys_futex(volatile void *addr1, int op, int val1, struct timespec *timeout,
     return syscall(SYS_futex, addr1, op, val1, timeout, uaddr2, val3);
 }
 
+#if ENABLE_MT
+
+static void ucs_stats_thread_release(void *arg)
+{
+    unsigned shard = (uintptr_t)arg;
+
+    if (shard == UCS_STATS_THREAD_SHARED) {
+        return;
+    }
+
+    /* The counters of this shard are kept, and the next thread which gets it
+     * adds on top of them */
+    pthread_mutex_lock(&ucs_stats_thread_lock);
+    ucs_stats_thread_map &= ~UCS_BIT(shard - 1);
+    pthread_mutex_unlock(&ucs_stats_thread_lock);
+}
+
+static void ucs_stats_thread_key_create()
+{
+    int ret;
+
+    ret = pthread_key_create(&ucs_stats_thread_key, ucs_stats_thread_release);
+    if (ret != 0) {
+        ucs_fatal("pthread_key_create() failed: %s", strerror(ret));
+    }
+}
+
+unsigned ucs_stats_thread_shard_init()
+{
+    uintptr_t shard;
+
+    pthread_once(&ucs_stats_thread_once, ucs_stats_thread_key_create);
+
+    pthread_mutex_lock(&ucs_stats_thread_lock);
+    if (ucs_stats_thread_map == UCS_MASK(UCS_STATS_NUM_SHARDS - 1)) {
+        shard = UCS_STATS_THREAD_SHARED;
+    } else {
+        shard = ucs_ffs64(~ucs_stats_thread_map) + 1;
+        ucs_stats_thread_map |= UCS_BIT(shard - 1);
+    }
+    pthread_mutex_unlock(&ucs_stats_thread_lock);
+
+    ucs_debug("thread %d uses stats shard %lu", ucs_get_tid(), shard);
+    pthread_setspecific(ucs_stats_thread_key, (void*)shard);
+    ucs_stats_thread_shard = shard;
+    return shard;
+}
+
+#endif
+
 static void ucs_stats_node_add(ucs_stats_node_t *node, ucs_stats_node_t *parent)
 {
     ucs_assert(node != &ucs_stats_context.root_node);
@@ -124,6 +194,12 @@ static void ucs_stats_node_init_root(const char *name, ...)
         return;
     }
 
+#if ENABLE_MT
+    ucs_stats_context.root_node.shards       = ucs_stats_context.root_shards;
+    ucs_stats_context.root_node.shard_stride =
+                    UCS_STATS_SHARD_STRIDE(UCS_ROOT_STATS_LAST);
+#endif
+
     va_start(ap, name);
     status = ucs_stats_node_initv(&ucs_stats_context.root_node,
                                  &ucs_stats_root_node_class, name, ap);
@@ -135,16 +211,31 @@ static void ucs_stats_node_init_root(const char *name, ...)
 
 static ucs_status_t ucs_stats_node_new(ucs_stats_class_t *cls, ucs_stats_node_t **p_node)
 {
+    size_t size = sizeof(ucs_stats_node_t) +
+                  sizeof(ucs_stats_counter_t) * cls->num_counters;
     ucs_stats_node_t *node;
 
-    node = ucs_malloc(sizeof(ucs_stats_node_t) +
-                      sizeof(ucs_stats_counter_t) * cls->num_counters,
-                      "stats node");
+#if ENABLE_MT
+    /* The shards are placed after the counters, on a cache line boundary */
+    size += UCS_SYS_CACHE_LINE_SIZE - 1 +
+            sizeof(ucs_stats_counter_t) * UCS_STATS_NUM_SHARDS *
+            UCS_STATS_SHARD_STRIDE(cls->num_counters);
+#endif
+
+    node = ucs_malloc(size, "stats node");
     if (node == NULL) {
         ucs_error("Failed to allocate stats node for %s", cls->name);
         return UCS_ERR_NO_MEMORY;
     }
 
+#if ENABLE_MT
+    node->shards       = ucs_align_up_pow2_ptr(&node->counters[cls->num_counters],
+                                               UCS_SYS_CACHE_LINE_SIZE);
+    node->shard_stride = UCS_STATS_SHARD_STRIDE(cls->num_counters);
+#else
+    node->shards       = NULL;
+    node->shard_stride = 0;
+#endif
     *p_node = node;
     return UCS_OK;
 }
@@ -21,6 +21,99 @@ int ucs_stats_is_active();
 
 #include "libstats.h"
 
+#include <ucs/arch/atomic.h>
+#include <ucs/sys/compiler_def.h>
+
+
+#if ENABLE_MT
+
+/* Shard of the calling thread plus 1, or 0 if it was not assigned yet.
+ * Initial-exec model avoids a __tls_get_addr() call on every update from
+ * the other UCX libraries. */
+extern __thread unsigned ucs_stats_thread_shard
+                __attribute__((tls_model("initial-exec")));
+
+
+/**
+ * Assign a counters shard to the calling thread.
+ *
+ * @return The shard number plus 1.
+ */
+unsigned ucs_stats_thread_shard_init();
+
+
+static UCS_F_ALWAYS_INLINE void
+ucs_stats_update_counter(ucs_stats_node_t *node, unsigned index,
+                         ucs_stats_counter_t delta)
+{
+    unsigned shard = ucs_stats_thread_shard;
+    ucs_stats_counter_t *counter;
+
+    if (ucs_unlikely(shard == 0)) {
+        shard = ucs_stats_thread_shard_init();
+    }
+
+    counter = &node->shards[(shard - 1) * node->shard_stride + index];
+    if (ucs_likely(shard < UCS_STATS_NUM_SHARDS)) {
+        /* The shard is owned by this thread */
+        *counter += delta;
+    } else {
+        ucs_atomic_add64(counter, delta);
+    }
+}
+
+static inline ucs_stats_counter_t
+ucs_stats_get_counter(ucs_stats_node_t *node, unsigned index)
+{
+    ucs_stats_counter_t value;
+    unsigned shard;
+
+    if (node->shards == NULL) {
+        return node->counters[index];
+    }
+
+    value = 0;
+    for (shard = 0; shard < UCS_STATS_NUM_SHARDS; ++shard) {
+        value += node->shards[shard * node->shard_stride + index];
+    }
+    return value;
+}
+
+/* Only the shard of the calling thread is changed, by the difference from the
+ * current sum, so updates which other threads make to their shards are kept */
+static inline void
+ucs_stats_set_counter(ucs_stats_node_t *node, unsigned index,
+                      ucs_stats_counter_t value)
+{
+    ucs_stats_update_counter(node, index,
+                             value - ucs_stats_get_counter(node, index));
+}
+
+#else
+
+/* Without thread support, the node is updated by a single thread at a time */
+static UCS_F_ALWAYS_INLINE void
+ucs_stats_update_counter(ucs_stats_node_t *node, unsigned index,
+                         ucs_stats_counter_t delta)
+{
+    node->counters[index] += delta;
+}
+
+static UCS_F_ALWAYS_INLINE ucs_stats_counter_t
+ucs_stats_get_counter(ucs_stats_node_t *node, unsigned index)
+{
+    return node->counters[index];
+}
+
+static UCS_F_ALWAYS_INLINE void
+ucs_stats_set_counter(ucs_stats_node_t *node, unsigned index,
+                      ucs_stats_counter_t value)
+{
+    node->counters[index] = value;
+}
+
+#endif
+
 /**
  * Allocate statistics node.
  *
@@ -49,22 +142,22 @@ void ucs_stats_node_free(ucs_stats_node_t *node);
 
 #define UCS_STATS_UPDATE_COUNTER(_node, _index, _delta) \
     if (((_delta) != 0) && ((_node) != NULL)) { \
-        (_node)->counters[(_index)] += (_delta); \
+        ucs_stats_update_counter(_node, _index, _delta); \
     }
 
 #define UCS_STATS_SET_COUNTER(_node, _index, _value) \
     if ((_node) != NULL) { \
-        (_node)->counters[(_index)] = (_value); \
+        ucs_stats_set_counter(_node, _index, _value); \
     }
 
 #define UCS_STATS_GET_COUNTER(_node, _index) \
     (((_node) != NULL) ?  \
-    (_node)->counters[(_index)] : 0)
+    ucs_stats_get_counter(_node, _index) : 0)
 
 #define UCS_STATS_UPDATE_MAX(_node, _index, _value) \
     if ((_node) != NULL) { \
-        if ((_node)->counters[(_index)] < (_value)) { \
-            (_node)->counters[(_index)] = (_value); \
+        if (ucs_stats_get_counter(_node, _index) < (_value)) { \
+            ucs_stats_set_counter(_node, _index, _value); \
         } \
     }
 
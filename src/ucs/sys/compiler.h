@@ -46,6 +46,12 @@
 #define UCS_F_NOOPTIMIZE
 #endif
 
+/* A function which is compiled for a specific instruction set, and is called
+ * only after checking the CPU supports it */
+#if defined(HAVE_ATTRIBUTE_TARGET) && (HAVE_ATTRIBUTE_TARGET == 1)
+#define UCS_F_TARGET(_isa) __attribute__((target(_isa)))
+#endif
+
 /* Avoid inlining the function */
 #define UCS_F_NOINLINE __attribute__ ((noinline))
 
@@ -6,6 +6,7 @@
 
 #include <ucs/sys/compiler.h>
 #include <ucs/arch/cpu.h>
+#include <ucs/arch/memcpy.h>
 #include <ucs/debug/debug.h>
 #include <ucs/debug/log.h>
 #include <ucs/debug/memtrack.h>
@@ -77,6 +78,7 @@ static void UCS_F_CTOR ucs_init()
     ucs_log_early_init(); /* Must be called before all others */
     ucs_global_opts_init();
     ucs_log_init();
+    ucs_memcpy_init();
 #if ENABLE_STATS
     ucs_stats_init();
 #endif
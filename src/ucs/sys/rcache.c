@@ -13,6 +13,7 @@
 #include <ucs/debug/memtrack.h>
 #include <ucs/sys/sys.h>
 #include <ucm/api/ucm.h>
+#include <sched.h>
 
 
 #define ucs_rcache_region_log(_level, _message, ...) \
@@ -32,12 +33,28 @@
 #define ucs_rcache_region_trace(_message, ...) \
     ucs_rcache_region_log(UCS_LOG_LEVEL_TRACE, _message, ## __VA_ARGS__)
 
+/* Reference count value of a region which is being destroyed, and cannot be
+ * taken by lookups anymore */
+#define UCS_RCACHE_REGION_DEAD  UCS_BIT(31)
+
 #define UCS_RCACHE_PROT_FMT "%c%c"
 #define UCS_RCACHE_PROT_ARG(_prot) \
     ((_prot) & PROT_READ)  ? 'r' : '-', \
     ((_prot) & PROT_WRITE) ? 'w' : '-'
 
 
+/*
+ * Registration cache statistics counters
+ */
+enum {
+    UCS_RCACHE_STAT_HITS,
+    UCS_RCACHE_STAT_MISSES,
+    UCS_RCACHE_STAT_EVICTIONS,
+    UCS_RCACHE_STAT_MERGES,
+    UCS_RCACHE_STAT_LAST
+};
+
+
 typedef struct ucs_rcache_inv_entry {
     ucs_queue_elem_t         queue;
     ucs_pgt_addr_t           start;
@@ -45,6 +62,12 @@ typedef struct ucs_rcache_inv_entry {
 } ucs_rcache_inv_entry_t;
 
 
+typedef struct ucs_rcache_pgt_dir {
+    ucs_pgt_dir_t            super;
+    ucs_queue_elem_t         queue;  /* Element in the retired directories queue */
+} ucs_rcache_pgt_dir_t;
+
+
 static void __ucs_rcache_region_log(const char *file, int line, const char *function,
                                     ucs_log_level_t level, ucs_rcache_t *rcache,
                                     ucs_rcache_region_t *region, const char *fmt,
@@ -77,16 +100,40 @@ static void __ucs_rcache_region_log(const char *file, int line, const char *func
               region_desc);
 }
 
+#if ENABLE_STATS
+static ucs_stats_class_t ucs_rcache_stats_class = {
+    .name           = "rcache",
+    .num_counters   = UCS_RCACHE_STAT_LAST,
+    .counter_names = {
+        [UCS_RCACHE_STAT_HITS]      = "hits",
+        [UCS_RCACHE_STAT_MISSES]    = "misses",
+        [UCS_RCACHE_STAT_EVICTIONS] = "evictions",
+        [UCS_RCACHE_STAT_MERGES]    = "merges"
+    }
+};
+#endif
+
 static ucs_pgt_dir_t *ucs_rcache_pgt_dir_alloc(const ucs_pgtable_t *pgtable)
 {
-    return ucs_memalign(UCS_PGT_ENTRY_MIN_ALIGN, sizeof(ucs_pgt_dir_t),
-                        "rcache_pgdir");
+    ucs_rcache_pgt_dir_t *dir;
+
+    dir = ucs_memalign(UCS_PGT_ENTRY_MIN_ALIGN, sizeof(*dir), "rcache_pgdir");
+    if (dir == NULL) {
+        return NULL;
+    }
+
+    return &dir->super;
 }
 
+/* Lock must be held in write mode */
 static void ucs_rcache_pgt_dir_release(const ucs_pgtable_t *pgtable,
-                                       ucs_pgt_dir_t *dir)
+                                       ucs_pgt_dir_t *pgd)
 {
-    ucs_free(dir);
+    ucs_rcache_t *rcache      = ucs_container_of(pgtable, ucs_rcache_t, pgtable);
+    ucs_rcache_pgt_dir_t *dir = ucs_derived_of(pgd, ucs_rcache_pgt_dir_t);
+
+    /* A concurrent lookup may be still reading the directory */
+    ucs_queue_push(&rcache->retired_dirs, &dir->queue);
 }
 
 static ucs_status_t ucs_rcache_mp_chunk_alloc(ucs_mpool_t *mp, size_t *size_p,
@@ -155,21 +202,243 @@ static void ucs_mem_region_destroy_internal(ucs_rcache_t *rcache,
                                             ucs_rcache_region_t *region)
 {
     ucs_rcache_region_trace(rcache, region, "destroy");
+    ucs_assert(ucs_list_is_empty(&region->lru_list));
     if (region->flags & UCS_RCACHE_REGION_FLAG_REGISTERED) {
         UCS_PROFILE_CODE("mem_dereg") {
             rcache->params.ops->mem_dereg(rcache->params.context, rcache, region);
         }
+        ucs_assert(rcache->num_regions > 0);
+        --rcache->num_regions;
+        rcache->total_size -= region->super.end - region->super.start;
+    }
+
+    /* A concurrent lookup may be still reading the region, so it's released
+     * later by ucs_rcache_reclaim() */
+    ucs_list_add_tail(&rcache->retired_regions, &region->lru_list);
+}
+
+/*
+ * Per-thread readers of all registration caches are chained from a single
+ * thread-specific key, since the number of keys is limited.
+ */
+static pthread_once_t ucs_rcache_reader_key_once = PTHREAD_ONCE_INIT;
+static pthread_key_t ucs_rcache_reader_key;
+static int ucs_rcache_reader_key_ret;
+
+/* Serializes releasing the readers of an exiting thread with destroying the
+ * registration caches they belong to */
+static pthread_mutex_t ucs_rcache_readers_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+/*
+ * Detach retired regions and page table directories, and advance the epoch.
+ * Lookups starting after that cannot find the retired objects.
+ * Lock must be held in write mode.
+ *
+ * @return Epoch the readers must reach before the objects are released, or 0
+ *         if there is nothing to release.
+ */
+static uint64_t ucs_rcache_retire(ucs_rcache_t *rcache,
+                                  ucs_list_link_t *retired_regions,
+                                  ucs_queue_head_t *retired_dirs)
+{
+    ucs_list_head_init(retired_regions);
+    ucs_queue_head_init(retired_dirs);
+
+    if (ucs_list_is_empty(&rcache->retired_regions) &&
+        ucs_queue_is_empty(&rcache->retired_dirs)) {
+        return 0;
+    }
+
+    ucs_list_splice_tail(retired_regions, &rcache->retired_regions);
+    ucs_list_head_init(&rcache->retired_regions);
+    ucs_queue_splice(retired_dirs, &rcache->retired_dirs);
+
+    return ucs_atomic_fadd64(&rcache->epoch, 1) + 1;
+}
+
+/* Check if some lookup which started before the given epoch is still running */
+static int ucs_rcache_readers_behind(ucs_rcache_t *rcache, uint64_t epoch)
+{
+    ucs_rcache_reader_t *reader;
+    int behind = 0;
+
+    pthread_spin_lock(&rcache->readers_lock);
+    ucs_list_for_each(reader, &rcache->readers, list) {
+        if ((reader->epoch != 0) && (reader->epoch < epoch)) {
+            behind = 1;
+            break;
+        }
+    }
+    pthread_spin_unlock(&rcache->readers_lock);
+    return behind;
+}
+
+/*
+ * Release retired regions and page table directories, after waiting for all
+ * lookups which could have observed them to complete. Does not need the lock,
+ * so other threads can modify the page table meanwhile.
+ */
+static void ucs_rcache_reclaim(ucs_rcache_t *rcache, uint64_t epoch,
+                               ucs_list_link_t *retired_regions,
+                               ucs_queue_head_t *retired_dirs)
+{
+    ucs_rcache_region_t *region, *tmp;
+    ucs_rcache_pgt_dir_t *dir;
+
+    if (epoch == 0) {
+        return;
+    }
+
+    while (ucs_rcache_readers_behind(rcache, epoch)) {
+        sched_yield();
+    }
+
+    ucs_list_for_each_safe(region, tmp, retired_regions, lru_list) {
+        ucs_free(region);
+    }
+
+    while (!ucs_queue_is_empty(retired_dirs)) {
+        dir = ucs_queue_pull_elem_non_empty(retired_dirs, ucs_rcache_pgt_dir_t,
+                                            queue);
+        ucs_free(dir);
+    }
+}
+
+static void ucs_rcache_write_lock(ucs_rcache_t *rcache)
+{
+    pthread_rwlock_wrlock(&rcache->lock);
+}
+
+static void ucs_rcache_write_unlock(ucs_rcache_t *rcache)
+{
+    ucs_list_link_t retired_regions;
+    ucs_queue_head_t retired_dirs;
+    uint64_t epoch;
+
+    epoch = ucs_rcache_retire(rcache, &retired_regions, &retired_dirs);
+    pthread_rwlock_unlock(&rcache->lock);
+    ucs_rcache_reclaim(rcache, epoch, &retired_regions, &retired_dirs);
+}
+
+/* Called when a thread exits, to release its readers of all caches */
+static void ucs_rcache_readers_release(void *arg)
+{
+    ucs_rcache_reader_t *reader = arg;
+    ucs_rcache_reader_t *next;
+
+    pthread_mutex_lock(&ucs_rcache_readers_mutex);
+    for (; reader != NULL; reader = next) {
+        next = reader->next;
+        if (reader->rcache != NULL) {
+            pthread_spin_lock(&reader->rcache->readers_lock);
+            ucs_list_del(&reader->list);
+            pthread_spin_unlock(&reader->rcache->readers_lock);
+        }
+        ucs_free(reader);
+    }
+    pthread_mutex_unlock(&ucs_rcache_readers_mutex);
+}
+
+static void ucs_rcache_reader_key_create()
+{
+    ucs_rcache_reader_key_ret = pthread_key_create(&ucs_rcache_reader_key,
+                                                   ucs_rcache_readers_release);
+}
+
+static ucs_rcache_reader_t *ucs_rcache_reader_create(ucs_rcache_t *rcache)
+{
+    ucs_rcache_reader_t *head, *reader;
+    int ret;
+
+    head = pthread_getspecific(ucs_rcache_reader_key);
+
+    /* Reuse a reader of a registration cache which was destroyed */
+    pthread_mutex_lock(&ucs_rcache_readers_mutex);
+    for (reader = head; reader != NULL; reader = reader->next) {
+        if (reader->rcache == NULL) {
+            break;
+        }
+    }
+
+    if (reader == NULL) {
+        reader = ucs_memalign(UCS_SYS_CACHE_LINE_SIZE, sizeof(*reader),
+                              "rcache_reader");
+        if (reader == NULL) {
+            goto out_unlock;
+        }
+
+        reader->next = head;
+        ret = pthread_setspecific(ucs_rcache_reader_key, reader);
+        if (ret) {
+            ucs_free(reader);
+            reader = NULL;
+            goto out_unlock;
+        }
+    }
+
+    reader->epoch  = 0;
+    reader->rcache = rcache;
+
+    pthread_spin_lock(&rcache->readers_lock);
+    ucs_list_add_tail(&rcache->readers, &reader->list);
+    pthread_spin_unlock(&rcache->readers_lock);
+
+out_unlock:
+    pthread_mutex_unlock(&ucs_rcache_readers_mutex);
+    return reader;
+}
+
+/*
+ * Start a lock-free lookup. Objects which are observed in the page table until
+ * ucs_rcache_reader_exit() is called would not be released.
+ *
+ * @return Current thread's reader, or NULL if could not be allocated.
+ */
+static UCS_F_ALWAYS_INLINE ucs_rcache_reader_t *
+ucs_rcache_reader_enter(ucs_rcache_t *rcache)
+{
+    ucs_rcache_reader_t *reader;
+
+    reader = pthread_getspecific(ucs_rcache_reader_key);
+    while (ucs_unlikely((reader != NULL) && (reader->rcache != rcache))) {
+        reader = reader->next;
+    }
+
+    if (ucs_unlikely(reader == NULL)) {
+        reader = ucs_rcache_reader_create(rcache);
+        if (reader == NULL) {
+            return NULL;
+        }
+    }
+
+    /* Atomic swap is also a full memory barrier, so the epoch is published
+     * before the page table is read */
+    ucs_atomic_swap64(&reader->epoch, rcache->epoch);
+    return reader;
+}
+
+static UCS_F_ALWAYS_INLINE void ucs_rcache_reader_exit(ucs_rcache_reader_t *reader)
+{
+    ucs_memory_cpu_fence();
+    reader->epoch = 0;
+}
+
+/* LRU lock must be held */
+static void ucs_rcache_region_lru_remove(ucs_rcache_region_t *region)
+{
+    if (!ucs_list_is_empty(&region->lru_list)) {
+        ucs_list_del(&region->lru_list);
+        ucs_list_head_init(&region->lru_list);
     }
-    ucs_free(region);
 }
 
 /* Lock must be held in write mode */
 static void ucs_rcache_region_invalidate(ucs_rcache_t *rcache,
                                          ucs_rcache_region_t *region,
-                                         int must_be_in_pgt,
-                                         int must_be_destroyed)
+                                         int must_be_in_pgt)
 {
     ucs_status_t status;
+    int destroy;
 
     ucs_rcache_region_trace(rcache, region, "invalidate");
 
@@ -187,14 +456,68 @@ static void ucs_rcache_region_invalidate(ucs_rcache_t *rcache,
 
     /* If no one is using the region, we can completely destroy it.
      * Otherwise, just mark it as invalid, and it would be destroyed when the
-     * reference count drops to 0.
+     * reference count drops to 0. The reference count is atomically marked as
+     * dead, so a concurrent lookup which still sees the region could not take
+     * it. The check is done with the LRU lock held, so it would not race with
+     * a concurrent ucs_rcache_region_put().
      */
-    if (region->refcount == 0) {
-        ucs_mem_region_destroy_internal(rcache, region);
-    } else {
-        ucs_assert(!must_be_destroyed);
+    pthread_spin_lock(&rcache->lru_lock);
+    destroy = (ucs_atomic_cswap32(&region->refcount, 0,
+                                  UCS_RCACHE_REGION_DEAD) == 0);
+    if (!destroy) {
         region->flags |= UCS_RCACHE_REGION_FLAG_INVALID;
     }
+    ucs_rcache_region_lru_remove(region);
+    pthread_spin_unlock(&rcache->lru_lock);
+
+    if (destroy) {
+        ucs_mem_region_destroy_internal(rcache, region);
+    }
+}
+
+/*
+ * Evict the least recently used region which is not in use.
+ * Lock must be held in write mode.
+ *
+ * @return Size of the evicted region, or 0 if there are no unused regions.
+ */
+static size_t ucs_rcache_evict_lru(ucs_rcache_t *rcache)
+{
+    ucs_rcache_region_t *region;
+    size_t size;
+
+    pthread_spin_lock(&rcache->lru_lock);
+    if (ucs_list_is_empty(&rcache->lru)) {
+        pthread_spin_unlock(&rcache->lru_lock);
+        return 0;
+    }
+
+    region = ucs_list_head(&rcache->lru, ucs_rcache_region_t, lru_list);
+    pthread_spin_unlock(&rcache->lru_lock);
+
+    /* A concurrent lookup may take the region before it's invalidated, in
+     * which case it would be destroyed when released */
+    ucs_rcache_region_trace(rcache, region, "evict");
+    size = region->super.end - region->super.start;
+    ucs_rcache_region_invalidate(rcache, region, 1);
+    UCS_STATS_UPDATE_COUNTER(rcache->stats, UCS_RCACHE_STAT_EVICTIONS, 1);
+    return size;
+}
+
+/* Lock must be held in write mode */
+static void ucs_rcache_check_limits(ucs_rcache_t *rcache, size_t size)
+{
+    /* Make room for a new region of the given size. If all regions are in
+     * use, the limits are exceeded rather than failing the registration. */
+    while ((rcache->num_regions >= rcache->params.max_regions) ||
+           (rcache->total_size + size > rcache->params.max_size))
+    {
+        if (ucs_rcache_evict_lru(rcache) == 0) {
+            ucs_debug("%s: all %u regions of %zu bytes are in use", rcache->name,
+                      rcache->num_regions, rcache->total_size);
+            break;
+        }
+    }
 }
 
 /* Lock must be held in write mode */
@@ -208,7 +531,7 @@ static void ucs_rcache_invalidate_range(ucs_rcache_t *rcache, ucs_pgt_addr_t sta
 
     ucs_rcache_find_regions(rcache, start, end - 1, &region_list);
     ucs_list_for_each_safe(region, tmp, &region_list, list) {
-        ucs_rcache_region_invalidate(rcache, region, 0, 0);
+        ucs_rcache_region_invalidate(rcache, region, 0);
     }
 }
 
@@ -284,6 +607,7 @@ static void ucs_rcache_purge(ucs_rcache_t *rcache)
             ucs_rcache_region_warn(rcache, region, "destroying inuse");
         }
         region->flags &= ~UCS_RCACHE_REGION_FLAG_PGTABLE;
+        ucs_rcache_region_lru_remove(region);
         ucs_mem_region_destroy_internal(rcache, region);
     }
 }
@@ -336,7 +660,7 @@ ucs_rcache_check_overlap(ucs_rcache_t *rcache, ucs_pgt_addr_t *start,
                                     " with mem "UCS_RCACHE_PROT_FMT,
                                     UCS_RCACHE_PROT_ARG(*prot),
                                     UCS_RCACHE_PROT_ARG(mem_prot));
-            ucs_rcache_region_invalidate(rcache, region, 1, 0);
+            ucs_rcache_region_invalidate(rcache, region, 1);
             continue;
         }
 
@@ -362,7 +686,7 @@ ucs_rcache_check_overlap(ucs_rcache_t *rcache, ucs_pgt_addr_t *start,
                 ucs_rcache_region_trace(rcache, region,
                                         "do not merge mem "UCS_RCACHE_PROT_FMT" with",
                                         UCS_RCACHE_PROT_ARG(mem_prot));
-                ucs_rcache_region_invalidate(rcache, region, 1, 0);
+                ucs_rcache_region_invalidate(rcache, region, 1);
                 continue;
             }
         }
@@ -372,11 +696,51 @@ ucs_rcache_check_overlap(ucs_rcache_t *rcache, ucs_pgt_addr_t *start,
                                 *start, *end, UCS_RCACHE_PROT_ARG(*prot));
         *start = ucs_min(*start, region->super.start);
         *end   = ucs_max(*end,   region->super.end);
-        ucs_rcache_region_invalidate(rcache, region, 1, 0);
+        ucs_rcache_region_invalidate(rcache, region, 1);
+        UCS_STATS_UPDATE_COUNTER(rcache->stats, UCS_RCACHE_STAT_MERGES, 1);
     }
     return UCS_OK;
 }
 
+/* Lock must be held in write mode */
+static ucs_status_t ucs_rcache_region_register(ucs_rcache_t *rcache,
+                                               ucs_rcache_region_t *region,
+                                               void *arg)
+{
+    size_t size = region->super.end - region->super.start;
+    size_t evicted, evicted_size;
+    ucs_status_t status;
+
+    for (;;) {
+        status = UCS_PROFILE_NAMED_CALL("mem_reg", rcache->params.ops->mem_reg,
+                                        rcache->params.context, rcache, arg,
+                                        region);
+        if (status != UCS_ERR_NO_MEMORY) {
+            return status;
+        }
+
+        /* Release unused registrations to make room for the new one, and
+         * try again */
+        evicted_size = 0;
+        do {
+            evicted = ucs_rcache_evict_lru(rcache);
+            evicted_size += evicted;
+        } while ((evicted > 0) && (evicted_size < size));
+
+        if (evicted_size == 0) {
+            /* The memory domain does not report out of memory as an error,
+             * since it is usually resolved by eviction */
+            ucs_error("%s: failed to register %zu bytes at %p: %s",
+                      rcache->name, size, (void*)region->super.start,
+                      ucs_status_string(status));
+            return status;
+        }
+
+        ucs_rcache_region_debug(rcache, region, "retry after evicting %zu bytes",
+                                evicted_size);
+    }
+}
+
 static ucs_status_t
 ucs_rcache_create_region(ucs_rcache_t *rcache, void *address, size_t length,
                          int prot, void *arg, ucs_rcache_region_t **region_p)
@@ -388,7 +752,7 @@ ucs_rcache_create_region(ucs_rcache_t *rcache, void *address, size_t length,
     ucs_trace_func("rcache=%s, address=%p, length=%zu", rcache->name, address,
                    length);
 
-    pthread_rwlock_wrlock(&rcache->lock);
+    ucs_rcache_write_lock(rcache);
 
     /* Align to page size */
     start = ucs_align_down_pow2((uintptr_t)address,
@@ -403,6 +767,7 @@ ucs_rcache_create_region(ucs_rcache_t *rcache, void *address, size_t length,
         /* Found a matching region (it could have been added after we released
          * the lock)
          */
+        UCS_STATS_UPDATE_COUNTER(rcache->stats, UCS_RCACHE_STAT_HITS, 1);
         status = region->status;
         goto out_set_region;
     } else if (status != UCS_OK) {
@@ -412,6 +777,9 @@ ucs_rcache_create_region(ucs_rcache_t *rcache, void *address, size_t length,
         goto out_unlock;
     }
 
+    UCS_STATS_UPDATE_COUNTER(rcache->stats, UCS_RCACHE_STAT_MISSES, 1);
+    ucs_rcache_check_limits(rcache, end - start);
+
     /* Allocate structure for new region */
     region = ucs_memalign(UCS_PGT_ENTRY_MIN_ALIGN, rcache->params.region_struct_size,
                           "rcache_region");
@@ -421,6 +789,7 @@ ucs_rcache_create_region(ucs_rcache_t *rcache, void *address, size_t length,
     }
 
     memset(region, 0, rcache->params.region_struct_size);
+    ucs_list_head_init(&region->lru_list);
 
     region->super.start = start;
     region->super.end   = end;
@@ -438,9 +807,7 @@ ucs_rcache_create_region(ucs_rcache_t *rcache, void *address, size_t length,
     region->prot     = prot;
     region->flags    = UCS_RCACHE_REGION_FLAG_PGTABLE;
     region->refcount = 0;
-    region->status = status =
-        UCS_PROFILE_NAMED_CALL("mem_reg", rcache->params.ops->mem_reg,
-                               rcache->params.context, rcache, arg, region);
+    region->status = status = ucs_rcache_region_register(rcache, region, arg);
     if (status != UCS_OK) {
         /* In case region is not registered, we don't return it to the user,
          * so no need to increment reference count.
@@ -450,21 +817,58 @@ ucs_rcache_create_region(ucs_rcache_t *rcache, void *address, size_t length,
         goto out_unlock;
     }
 
-    region->flags   |= UCS_RCACHE_REGION_FLAG_REGISTERED;
+    /* Lookups may find the region as soon as it's marked as registered, so
+     * the reference count must be set before */
     region->refcount = 1;
+    ucs_memory_cpu_store_fence();
+    region->flags   |= UCS_RCACHE_REGION_FLAG_REGISTERED;
+    ++rcache->num_regions;
+    rcache->total_size += end - start;
 
     ucs_rcache_region_trace(rcache, region, "created");
 
 out_set_region:
     *region_p = region;
 out_unlock:
-    pthread_rwlock_unlock(&rcache->lock);
+    ucs_rcache_write_unlock(rcache);
     return status;
 }
 
+/*
+ * Increment the reference count, unless the region is being destroyed.
+ *
+ * @return Whether the reference count was incremented.
+ */
+static int ucs_rcache_region_try_hold(ucs_rcache_t *rcache,
+                                      ucs_rcache_region_t *region)
+{
+    uint32_t refcount;
+
+    do {
+        refcount = region->refcount;
+        if (ucs_unlikely(refcount & UCS_RCACHE_REGION_DEAD)) {
+            return 0;
+        }
+    } while (ucs_atomic_cswap32(&region->refcount, refcount,
+                                refcount + 1) != refcount);
+
+    if (refcount == 0) {
+        /* The region is used again, so it should not be evicted */
+        pthread_spin_lock(&rcache->lru_lock);
+        if (region->refcount > 0) {
+            ucs_rcache_region_lru_remove(region);
+        }
+        pthread_spin_unlock(&rcache->lru_lock);
+    }
+    return 1;
+}
+
 void ucs_rcache_region_hold(ucs_rcache_t *rcache, ucs_rcache_region_t *region)
 {
-    ucs_atomic_add32(&region->refcount, +1);
+    int UCS_V_UNUSED held;
+
+    held = ucs_rcache_region_try_hold(rcache, region);
+    ucs_assert(held);
     ucs_rcache_region_trace(rcache, region, "hold");
 }
 
@@ -474,31 +878,46 @@ ucs_status_t ucs_rcache_get(ucs_rcache_t *rcache, void *address, size_t length,
     ucs_pgt_addr_t start = (uintptr_t)address;
     ucs_pgt_region_t *pgt_region;
     ucs_rcache_region_t *region;
+    ucs_rcache_reader_t *reader;
+    int held;
 
     ucs_trace_func("rcache=%s, address=%p, length=%zu", rcache->name, address,
                    length);
 
-    pthread_rwlock_rdlock(&rcache->lock);
-    if (ucs_queue_is_empty(&rcache->inv_q)) {
+    reader = ucs_rcache_reader_enter(rcache);
+    if (ucs_likely(reader != NULL) && ucs_queue_is_empty(&rcache->inv_q)) {
         pgt_region = ucs_pgtable_lookup(&rcache->pgtable, start);
         if (ucs_likely(pgt_region != NULL)) {
             region = ucs_derived_of(pgt_region, ucs_rcache_region_t);
-            if (((start + length) <= region->super.end) &&
-                ucs_rcache_region_test(region, prot))
-            {
-                ucs_rcache_region_hold(rcache, region);
-                *region_p = region;
-                pthread_rwlock_unlock(&rcache->lock);
-                return UCS_OK;
+            held   = ((start + length) <= region->super.end) &&
+                     ucs_rcache_region_test(region, prot) &&
+                     ucs_rcache_region_try_hold(rcache, region);
+            ucs_rcache_reader_exit(reader);
+
+            if (held) {
+                /* The region could be invalidated after it was found */
+                if (ucs_likely(!(region->flags & UCS_RCACHE_REGION_FLAG_INVALID))) {
+                    ucs_rcache_region_trace(rcache, region, "hold");
+                    UCS_STATS_UPDATE_COUNTER(rcache->stats,
+                                             UCS_RCACHE_STAT_HITS, 1);
+                    *region_p = region;
+                    return UCS_OK;
+                }
+                ucs_rcache_region_put(rcache, region);
             }
+            goto out_slow;
         }
     }
-    pthread_rwlock_unlock(&rcache->lock);
 
-    /* Fall back to slow version (with rw lock) in following cases:
+    if (reader != NULL) {
+        ucs_rcache_reader_exit(reader);
+    }
+
+out_slow:
+    /* Fall back to slow version (with write lock) in following cases:
      * - invalidation list not empty
      * - could not find cached region
-     * - found unregistered region
+     * - found unregistered or invalidated region
      */
     return UCS_PROFILE_CALL(ucs_rcache_create_region, rcache, address, length,
                             prot, arg, region_p);
@@ -506,17 +925,53 @@ ucs_status_t ucs_rcache_get(ucs_rcache_t *rcache, void *address, size_t length,
 
 void ucs_rcache_region_put(ucs_rcache_t *rcache, ucs_rcache_region_t *region)
 {
+    uint32_t refcount, new_refcount;
+
     ucs_rcache_region_trace(rcache, region, "put");
 
-    ucs_assert(region->refcount > 0);
-    ucs_atomic_add32(&region->refcount, -1);
+    /* Releasing a reference which is not the last one does not need a lock */
+    do {
+        refcount = region->refcount;
+        ucs_assert((refcount > 0) && !(refcount & UCS_RCACHE_REGION_DEAD));
+        if (refcount == 1) {
+            break;
+        }
+    } while (ucs_atomic_cswap32(&region->refcount, refcount,
+                                refcount - 1) != refcount);
+    if (refcount > 1) {
+        return;
+    }
 
-    if (ucs_unlikely(region->flags & UCS_RCACHE_REGION_FLAG_INVALID) &&
-        (region->refcount == 0))
-    {
-        pthread_rwlock_wrlock(&rcache->lock);
-        ucs_rcache_region_invalidate(rcache, region, 0, 1);
-        pthread_rwlock_unlock(&rcache->lock);
+    /* Release the last reference with the LRU lock held, so the region could
+     * not be destroyed by another thread before it's added to the LRU list.
+     * Lookups may still take new references concurrently. An invalid region
+     * is marked as dead atomically, so lookups could not take it anymore.
+     */
+    pthread_spin_lock(&rcache->lru_lock);
+    do {
+        refcount = region->refcount;
+        ucs_assert(refcount > 0);
+        if ((refcount == 1) &&
+            ucs_unlikely(region->flags & UCS_RCACHE_REGION_FLAG_INVALID)) {
+            new_refcount = UCS_RCACHE_REGION_DEAD;
+        } else {
+            new_refcount = refcount - 1;
+        }
+    } while (ucs_atomic_cswap32(&region->refcount, refcount,
+                                new_refcount) != refcount);
+
+    if (new_refcount == UCS_RCACHE_REGION_DEAD) {
+        ucs_rcache_region_lru_remove(region);
+    } else if ((new_refcount == 0) && ucs_list_is_empty(&region->lru_list)) {
+        ucs_list_add_tail(&rcache->lru, &region->lru_list);
+    }
+    pthread_spin_unlock(&rcache->lru_lock);
+
+    if (new_refcount == UCS_RCACHE_REGION_DEAD) {
+        ucs_rcache_write_lock(rcache);
+        ucs_assert(!(region->flags & UCS_RCACHE_REGION_FLAG_PGTABLE));
+        ucs_mem_region_destroy_internal(rcache, region);
+        ucs_rcache_write_unlock(rcache);
     }
 }
 
@@ -565,14 +1020,42 @@ static UCS_CLASS_INIT_FUNC(ucs_rcache_t, const ucs_rcache_params_t *params,
         goto err_destroy_rwlock;
     }
 
+    ret = pthread_spin_init(&self->lru_lock, 0);
+    if (ret) {
+        ucs_error("pthread_spin_init() failed: %m");
+        status = UCS_ERR_INVALID_PARAM;
+        goto err_destroy_inv_q_lock;
+    }
+
+    ret = pthread_spin_init(&self->readers_lock, 0);
+    if (ret) {
+        ucs_error("pthread_spin_init() failed: %m");
+        status = UCS_ERR_INVALID_PARAM;
+        goto err_destroy_lru_lock;
+    }
+
+    pthread_once(&ucs_rcache_reader_key_once, ucs_rcache_reader_key_create);
+    if (ucs_rcache_reader_key_ret) {
+        ucs_error("pthread_key_create() failed: %s",
+                  strerror(ucs_rcache_reader_key_ret));
+        status = UCS_ERR_NO_RESOURCE;
+        goto err_destroy_readers_lock;
+    }
+
+    status = UCS_STATS_NODE_ALLOC(&self->stats, &ucs_rcache_stats_class,
+                                  stats_parent, "%s", name);
+    if (status != UCS_OK) {
+        goto err_destroy_readers_lock;
+    }
+
     status = ucs_pgtable_init(&self->pgtable, ucs_rcache_pgt_dir_alloc,
                               ucs_rcache_pgt_dir_release);
     if (status != UCS_OK) {
-        goto err_destroy_inv_q_lock;
+        goto err_free_stats;
     }
 
     status = ucs_mpool_init(&self->inv_mp, 0, sizeof(ucs_rcache_inv_entry_t), 0,
-                            1, 1024, -1, &ucs_rcache_mp_ops, "rcache_inv_mp");
+                            1, 1024, -1, 0, &ucs_rcache_mp_ops, "rcache_inv_mp");
     if (status != UCS_OK) {
         goto err_cleanup_pgtable;
     }
@@ -584,12 +1067,25 @@ static UCS_CLASS_INIT_FUNC(ucs_rcache_t, const ucs_rcache_params_t *params,
     }
 
     ucs_queue_head_init(&self->inv_q);
+    ucs_list_head_init(&self->lru);
+    ucs_list_head_init(&self->readers);
+    ucs_list_head_init(&self->retired_regions);
+    ucs_queue_head_init(&self->retired_dirs);
+    self->num_regions = 0;
+    self->total_size  = 0;
+    self->epoch       = 1;
     return UCS_OK;
 
 err_destroy_mp:
     ucs_mpool_cleanup(&self->inv_mp, 1);
 err_cleanup_pgtable:
     ucs_pgtable_cleanup(&self->pgtable);
+err_free_stats:
+    UCS_STATS_NODE_FREE(self->stats);
+err_destroy_readers_lock:
+    pthread_spin_destroy(&self->readers_lock);
+err_destroy_lru_lock:
+    pthread_spin_destroy(&self->lru_lock);
 err_destroy_inv_q_lock:
     pthread_spin_destroy(&self->inv_lock);
 err_destroy_rwlock:
@@ -602,13 +1098,31 @@ err:
 
 static UCS_CLASS_CLEANUP_FUNC(ucs_rcache_t)
 {
+    ucs_list_link_t retired_regions;
+    ucs_queue_head_t retired_dirs;
+    ucs_rcache_reader_t *reader;
+    uint64_t epoch;
+
     ucm_unset_event_handler(UCM_EVENT_VM_UNMAPPED, ucs_rcache_unmapped_callback,
                             self);
     ucs_rcache_check_inv_queue(self);
     ucs_rcache_purge(self);
+    epoch = ucs_rcache_retire(self, &retired_regions, &retired_dirs);
+    ucs_rcache_reclaim(self, epoch, &retired_regions, &retired_dirs);
+
+    /* The readers are released when their threads exit, or reused by other
+     * registration caches */
+    pthread_mutex_lock(&ucs_rcache_readers_mutex);
+    ucs_list_for_each(reader, &self->readers, list) {
+        reader->rcache = NULL;
+    }
+    pthread_mutex_unlock(&ucs_rcache_readers_mutex);
 
     ucs_mpool_cleanup(&self->inv_mp, 1);
     ucs_pgtable_cleanup(&self->pgtable);
+    UCS_STATS_NODE_FREE(self->stats);
+    pthread_spin_destroy(&self->readers_lock);
+    pthread_spin_destroy(&self->lru_lock);
     pthread_spin_destroy(&self->inv_lock);
     pthread_rwlock_destroy(&self->lock);
     free(self->name);
@@ -10,7 +10,12 @@
 /*
  * Memory registration cache - holds registered memory regions, takes care of
  * memory invalidation (if it's unmapped), merging of regions, protection flags.
- * This data structure is thread safe.
+ * The number and total size of registered regions can be limited, in which
+ * case unused regions are evicted in least-recently-used order.
+ * This data structure is thread safe. Looking up a cached region does not take
+ * any lock: readers announce themselves in a per-thread epoch slot, and page
+ * table directories and regions which are removed are freed only after all
+ * readers which could have seen them are done.
  */
 #include <ucs/datastruct/pgtable.h>
 #include <ucs/datastruct/list.h>
@@ -23,6 +28,7 @@ typedef struct ucs_rcache         ucs_rcache_t;
 typedef struct ucs_rcache_ops     ucs_rcache_ops_t;
 typedef struct ucs_rcache_params  ucs_rcache_params_t;
 typedef struct ucs_rcache_region  ucs_rcache_region_t;
+typedef struct ucs_rcache_reader  ucs_rcache_reader_t;
 
 /*
  * Memory region flags.
@@ -90,23 +96,44 @@ struct ucs_rcache_params {
     const ucs_rcache_ops_t *ops;                /**< Memory operations functions */
     void                   *context;            /**< User-defined context that will
                                                      be passed to mem_reg/mem_dereg */
+    unsigned               max_regions;         /**< Maximal number of registered
+                                                     regions, UINT_MAX for no limit */
+    size_t                 max_size;            /**< Maximal total size of registered
+                                                     regions, SIZE_MAX for no limit */
 };
 
 
 struct ucs_rcache_region {
     ucs_pgt_region_t       super;    /**< Base class - page table region */
     ucs_list_link_t        list;     /**< List element */
-    volatile uint32_t      refcount; /**< Usage count */
+    ucs_list_link_t        lru_list; /**< Element in the LRU list, self-linked
+                                          if not on the list */
+    volatile uint32_t      refcount; /**< Usage count. Updated atomically, since
+                                          lookups do not take the page table lock */
     ucs_status_t           status;   /**< Current status code */
     uint8_t                prot;     /**< Protection bits */
     uint16_t               flags;    /**< Status flags. Protected by page table lock. */
 };
 
 
+/*
+ * Per-thread state of lock-free region lookup.
+ */
+struct ucs_rcache_reader {
+    volatile uint64_t      epoch;    /**< Global epoch when the thread started a
+                                          lookup, or 0 if not inside a lookup */
+    ucs_rcache_t           *rcache;  /**< Registration cache of the reader, or
+                                          NULL if it was destroyed */
+    ucs_list_link_t        list;     /**< Element in the list of readers */
+    ucs_rcache_reader_t    *next;    /**< Next reader of the same thread */
+} UCS_V_ALIGNED(UCS_SYS_CACHE_LINE_SIZE);
+
+
 struct ucs_rcache {
     ucs_rcache_params_t    params;   /**< rcache parameters (immutable) */
-    pthread_rwlock_t       lock;     /**< Protects the page table and all regions
-                                          whose refcount is 0 */
+    pthread_rwlock_t       lock;     /**< Serializes page table modifications and
+                                          all regions whose refcount is 0. Lookups
+                                          of existing regions do not take it. */
     ucs_pgtable_t          pgtable;  /**< page table to hold the regions */
 
     pthread_spinlock_t     inv_lock; /**< Lock for inv_q and inv_mp. This is a
@@ -119,7 +146,26 @@ struct ucs_rcache {
                                           since we cannot use regulat malloc().
                                           The backing storage is original mmap()
                                           which does not generate memory events */
+
+    pthread_spinlock_t     lru_lock; /**< Protects the LRU list, and moving regions
+                                          to and from it when their refcount
+                                          drops to 0 or increases from 0 */
+    ucs_list_link_t        lru;      /**< Registered regions whose refcount is 0,
+                                          least recently used first */
+    unsigned               num_regions; /**< Number of registered regions */
+    size_t                 total_size;  /**< Total size of registered regions */
+    volatile uint64_t      epoch;    /**< Global epoch, advanced before waiting for
+                                          the readers to release retired objects */
+    pthread_spinlock_t     readers_lock; /**< Protects the list of readers */
+    ucs_list_link_t        readers;  /**< List of all threads' readers */
+    ucs_list_link_t        retired_regions; /**< Destroyed regions, which may be
+                                                 still observed by readers */
+    ucs_queue_head_t       retired_dirs;    /**< Released page table directories,
+                                                 which may be still observed by
+                                                 readers */
+
     char                   *name;
+    UCS_STATS_NODE_DECLARE(stats);
 };
 
 
@@ -710,8 +710,10 @@ void uct_worker_destroy(uct_worker_h worker);
  * to receive the active message requests.
  *
  * @param [in]  worker        Handle to worker.
+ *
+ * @return Non-zero if any communication was progressed, zero otherwise.
  */
-void uct_worker_progress(uct_worker_h worker);
+unsigned uct_worker_progress(uct_worker_h worker);
 
 
 /**
@@ -719,6 +721,8 @@ void uct_worker_progress(uct_worker_h worker);
  * @brief Add a callback function to a worker progress.
  *
  * Add a function which will be called every time a progress is made on the worker.
+ * The function should return the number of events it has processed, which is
+ * accumulated into the return value of @ref uct_worker_progress.
  *
  * @param [in]  worker        Handle to worker.
  * @param [in]  func          Pointer to callback function.
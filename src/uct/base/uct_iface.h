@@ -264,6 +264,8 @@ struct uct_iface_config {
 typedef struct uct_iface_mpool_config {
     unsigned          max_bufs;  /* Upper limit to number of buffers */
     unsigned          bufs_grow; /* How many buffers (approx.) are allocated every time */
+    int               numa_local;/* Bind buffers to the local NUMA node */
+    int               prefault;  /* Fault in buffers memory when the pool grows */
 } uct_iface_mpool_config_t;
 
 
@@ -279,7 +281,18 @@ typedef struct uct_iface_mpool_config {
     {_prefix "BUFS_GROW", UCS_PP_QUOTE(_dfl_grow), \
      "How much buffers are added every time the " _mp_name " memory pool grows.\n" \
      "0 means the value is chosen by the transport.", \
-     (_offset) + ucs_offsetof(uct_iface_mpool_config_t, bufs_grow), UCS_CONFIG_TYPE_UINT}
+     (_offset) + ucs_offsetof(uct_iface_mpool_config_t, bufs_grow), UCS_CONFIG_TYPE_UINT}, \
+    \
+    {_prefix "NUMA_LOCAL", "n", \
+     "Place " _mp_name " buffers on the NUMA node of the thread which grows the\n" \
+     "memory pool. Has no effect on memory which is already resident, such as\n" \
+     "memory registered by the allocation.", \
+     (_offset) + ucs_offsetof(uct_iface_mpool_config_t, numa_local), UCS_CONFIG_TYPE_BOOL}, \
+    \
+    {_prefix "PREFAULT", "n", \
+     "Fault in the memory of " _mp_name " buffers when the memory pool grows,\n" \
+     "rather than on first use.", \
+     (_offset) + ucs_offsetof(uct_iface_mpool_config_t, prefault), UCS_CONFIG_TYPE_BOOL}
 
 
 /**
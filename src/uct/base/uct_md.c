@@ -228,9 +228,9 @@ static UCS_CLASS_CLEANUP_FUNC(uct_worker_t)
     ucs_callbackq_cleanup(&self->progress_q);
 }
 
-void uct_worker_progress(uct_worker_h worker)
+unsigned uct_worker_progress(uct_worker_h worker)
 {
-    ucs_callbackq_dispatch(&worker->progress_q);
+    return ucs_callbackq_dispatch(&worker->progress_q);
 }
 
 void uct_worker_progress_register(uct_worker_h worker,
@@ -353,13 +353,21 @@ ucs_status_t uct_iface_mpool_init(uct_base_iface_t *iface, ucs_mpool_t *mp,
                                   uct_iface_mpool_init_obj_cb_t init_obj_cb,
                                   const char *name)
 {
-    unsigned elems_per_chunk;
+    unsigned elems_per_chunk, flags;
     ucs_status_t status;
 
+    flags = 0;
+    if (config->numa_local) {
+        flags |= UCS_MPOOL_FLAG_NUMA_LOCAL;
+    }
+    if (config->prefault) {
+        flags |= UCS_MPOOL_FLAG_PREFAULT;
+    }
+
     elems_per_chunk = (config->bufs_grow != 0) ? config->bufs_grow : grow;
     status = ucs_mpool_init(mp, sizeof(uct_iface_mp_priv_t),
                             elem_size, align_offset, alignment,
-                            elems_per_chunk, config->max_bufs,
+                            elems_per_chunk, config->max_bufs, flags,
                             &uct_iface_mpool_ops, name);
     if (status != UCS_OK) {
         return status;
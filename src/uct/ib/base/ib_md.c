@@ -77,6 +77,17 @@ static ucs_config_field_t uct_ib_md_config_table[] = {
   {"RCACHE_OVERHEAD", "90ns", "Registration cache lookup overhead",
    ucs_offsetof(uct_ib_md_config_t, rcache.overhead), UCS_CONFIG_TYPE_TIME},
 
+  {"RCACHE_MAX_REGIONS", "-1",
+   "Maximal number of regions in the registration cache. When the limit is\n"
+   "reached, unused regions are released in least recently used order.\n"
+   "-1 means no limit.",
+   ucs_offsetof(uct_ib_md_config_t, rcache.max_regions), UCS_CONFIG_TYPE_UINT},
+
+  {"RCACHE_MAX_SIZE", "inf",
+   "Maximal total size of the regions in the registration cache. When the\n"
+   "limit is reached, unused regions are released in least recently used order.",
+   ucs_offsetof(uct_ib_md_config_t, rcache.max_size), UCS_CONFIG_TYPE_MEMUNITS},
+
   {"MEM_REG_OVERHEAD", "16us", "Memory registration overhead", /* TODO take default from device */
    ucs_offsetof(uct_ib_md_config_t, uc_reg_cost.overhead), UCS_CONFIG_TYPE_TIME},
 
@@ -320,6 +331,8 @@ static ucs_status_t uct_ib_md_reg_mr(uct_ib_md_t *md, void *address,
                                      size_t length, uint64_t exp_access,
                                      struct ibv_mr **mr_p)
 {
+    ucs_log_level_t level;
+    ucs_status_t status;
     struct ibv_mr *mr;
 
     if (exp_access) {
@@ -334,9 +347,12 @@ static ucs_status_t uct_ib_md_reg_mr(uct_ib_md_t *md, void *address,
 
         mr = UCS_PROFILE_CALL(ibv_exp_reg_mr, &in);
         if (mr == NULL) {
-            ucs_error("ibv_exp_reg_mr(address=%p, length=%Zu, exp_access=0x%lx) failed: %m",
-                      in.addr, in.length, in.exp_access);
-            return UCS_ERR_IO_ERROR;
+            status = (errno == ENOMEM) ? UCS_ERR_NO_MEMORY : UCS_ERR_IO_ERROR;
+            level  = (status == UCS_ERR_NO_MEMORY) ? UCS_LOG_LEVEL_DEBUG :
+                                                     UCS_LOG_LEVEL_ERROR;
+            ucs_log(level, "ibv_exp_reg_mr(address=%p, length=%Zu, exp_access=0x%lx) failed: %m",
+                    in.addr, in.length, in.exp_access);
+            return status;
         }
 #else
         return UCS_ERR_UNSUPPORTED;
@@ -345,9 +361,14 @@ static ucs_status_t uct_ib_md_reg_mr(uct_ib_md_t *md, void *address,
         mr = UCS_PROFILE_CALL(ibv_reg_mr, md->pd, address, length,
                               UCT_IB_MEM_ACCESS_FLAGS);
         if (mr == NULL) {
-            ucs_error("ibv_reg_mr(address=%p, length=%Zu, access=0x%x) failed: %m",
-                      address, length, UCT_IB_MEM_ACCESS_FLAGS);
-            return UCS_ERR_IO_ERROR;
+            /* Out of memory can be resolved by releasing cached regions, so
+             * it is not an error yet */
+            status = (errno == ENOMEM) ? UCS_ERR_NO_MEMORY : UCS_ERR_IO_ERROR;
+            level  = (status == UCS_ERR_NO_MEMORY) ? UCS_LOG_LEVEL_DEBUG :
+                                                     UCS_LOG_LEVEL_ERROR;
+            ucs_log(level, "ibv_reg_mr(address=%p, length=%Zu, access=0x%x) failed: %m",
+                    address, length, UCT_IB_MEM_ACCESS_FLAGS);
+            return status;
         }
     }
 
@@ -1180,6 +1201,8 @@ uct_ib_md_open(const char *md_name, const uct_md_config_t *uct_md_config, uct_md
         rcache_params.region_struct_size = sizeof(uct_ib_rcache_region_t);
         rcache_params.alignment          = md_config->rcache.alignment;
         rcache_params.ucm_event_priority = md_config->rcache.event_prio;
+        rcache_params.max_regions        = md_config->rcache.max_regions;
+        rcache_params.max_size           = md_config->rcache.max_size;
         rcache_params.context            = md;
         rcache_params.ops                = &uct_ib_rcache_ops;
         status = ucs_rcache_create(&rcache_params, uct_ib_device_name(&md->dev)
@@ -94,6 +94,8 @@ typedef struct uct_ib_md_config {
         size_t               alignment;    /**< Force address alignment */
         unsigned             event_prio;   /**< Memory events priority */
         double               overhead;     /**< Lookup overhead estimation */
+        unsigned             max_regions;  /**< Maximal number of regions */
+        size_t               max_size;     /**< Maximal total size of regions */
     } rcache;
 
     uct_linear_growth_t      uc_reg_cost;  /**< Memory registration cost estimation
@@ -683,7 +683,7 @@ ucs_status_t uct_dc_verbs_ep_fc_ctrl(uct_ep_h tl_ep, unsigned op,
     return UCS_OK;
 }
 
-static UCS_F_ALWAYS_INLINE void
+static UCS_F_ALWAYS_INLINE unsigned
 uct_dc_verbs_poll_tx(uct_dc_verbs_iface_t *iface)
 {
     int i;
@@ -715,18 +715,20 @@ uct_dc_verbs_poll_tx(uct_dc_verbs_iface_t *iface)
     }
     ucs_arbiter_dispatch(uct_dc_iface_tx_waitq(&iface->super), 1, 
                          uct_dc_iface_dci_do_pending_tx, NULL);
+    return num_wcs;
 }
 
 /* TODO: make a macro that defines progress func */
-static void uct_dc_verbs_iface_progress(void *arg)
+static unsigned uct_dc_verbs_iface_progress(void *arg)
 {
     uct_dc_verbs_iface_t *iface = arg;
     ucs_status_t status;
 
     status = uct_rc_verbs_iface_poll_rx_common(&iface->super.super);
     if (status == UCS_ERR_NO_PROGRESS) {
-        uct_dc_verbs_poll_tx(iface);
+        return uct_dc_verbs_poll_tx(iface);
     }
+    return (status == UCS_OK) ? 1 : 0;
 }
 
 static void UCS_CLASS_DELETE_FUNC_NAME(uct_dc_verbs_iface_t)(uct_iface_t*);
@@ -71,7 +71,7 @@ typedef struct uct_rc_verbs_iface {
         unsigned                tx_max_wr;
     } config;
 
-    void (*progress)(void*); /* Progress function (either regular or TM aware) */
+    ucs_callback_t progress; /* Progress function (either regular or TM aware) */
 } uct_rc_verbs_iface_t;
 
 
@@ -242,7 +242,7 @@ ucs_status_t uct_rc_verbs_ep_connect_to_ep(uct_ep_h tl_ep,
 
 ucs_status_t uct_rc_verbs_ep_get_address(uct_ep_h tl_ep, uct_ep_addr_t *addr);
 
-void uct_rc_verbs_iface_progress(void *arg);
+unsigned uct_rc_verbs_iface_progress(void *arg);
 
 ucs_status_t uct_rc_verbs_ep_fc_ctrl(uct_ep_t *tl_ep, unsigned op,
                                      uct_rc_fc_request_t *req);
@@ -103,7 +103,7 @@ static inline unsigned uct_rc_verbs_iface_post_recv_common(uct_rc_iface_t *iface
 #define UCT_RC_VERBS_IFACE_FOREACH_TXWQE(_iface, _i, _wc, _num_wcs) \
       status = uct_ib_poll_cq((_iface)->super.send_cq, &_num_wcs, _wc); \
       if (status != UCS_OK) { \
-          return; \
+          return 0; \
       } \
       UCS_STATS_UPDATE_COUNTER((_iface)->stats, UCT_RC_IFACE_STAT_TX_COMPLETION, _num_wcs); \
       for (_i = 0; _i < _num_wcs; ++_i)
@@ -88,7 +88,7 @@ void uct_rc_verbs_ep_am_packet_dump(uct_base_iface_t *base_iface,
                              valid_length, buffer, max);
 }
 
-static UCS_F_ALWAYS_INLINE void
+static UCS_F_ALWAYS_INLINE unsigned
 uct_rc_verbs_iface_poll_tx(uct_rc_verbs_iface_t *iface)
 {
     uct_rc_verbs_ep_t *ep;
@@ -114,17 +114,19 @@ uct_rc_verbs_iface_poll_tx(uct_rc_verbs_iface_t *iface)
     }
     iface->super.tx.cq_available += num_wcs;
     ucs_arbiter_dispatch(&iface->super.tx.arbiter, 1, uct_rc_ep_process_pending, NULL);
+    return num_wcs;
 }
 
-void uct_rc_verbs_iface_progress(void *arg)
+unsigned uct_rc_verbs_iface_progress(void *arg)
 {
     uct_rc_verbs_iface_t *iface = arg;
     ucs_status_t status;
 
     status = uct_rc_verbs_iface_poll_rx_common(&iface->super);
     if (status == UCS_ERR_NO_PROGRESS) {
-        uct_rc_verbs_iface_poll_tx(iface);
+        return uct_rc_verbs_iface_poll_tx(iface);
     }
+    return (status == UCS_OK) ? 1 : 0;
 }
 
 #if HAVE_IBV_EX_HW_TM
@@ -203,15 +205,16 @@ out:
     return status;
 }
 
-void uct_rc_verbs_iface_progress_tm(void *arg)
+unsigned uct_rc_verbs_iface_progress_tm(void *arg)
 {
     uct_rc_verbs_iface_t *iface = arg;
     ucs_status_t status;
 
     status = uct_rc_verbs_iface_poll_rx_tm(iface);
     if (status == UCS_ERR_NO_PROGRESS) {
-        uct_rc_verbs_iface_poll_tx(iface);
+        return uct_rc_verbs_iface_poll_tx(iface);
     }
+    return (status == UCS_OK) ? 1 : 0;
 }
 #endif /* HAVE_IBV_EX_HW_TM */
 
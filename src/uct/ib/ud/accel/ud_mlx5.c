@@ -431,25 +431,26 @@ uct_ud_mlx5_iface_poll_tx(uct_ud_mlx5_iface_t *iface)
     iface->super.tx.available = uct_ib_mlx5_txwq_update_bb(&iface->tx.wq, ntohs(cqe->wqe_counter));
 }
 
-static void uct_ud_mlx5_iface_progress(void *arg)
+static unsigned uct_ud_mlx5_iface_progress(void *arg)
 {
     uct_ud_mlx5_iface_t *iface = arg;
     ucs_status_t status;
-    int count;
+    unsigned count;
 
     uct_ud_enter(&iface->super);
     uct_ud_iface_dispatch_zcopy_comps(&iface->super);
     status = uct_ud_iface_dispatch_pending_rx(&iface->super);
+    count  = 0;
     if (ucs_likely(status == UCS_OK)) {
-        count = 0;
-        do {
-            status = uct_ud_mlx5_iface_poll_rx(iface, 0);
-            count++;
-        } while ((status == UCS_OK) && (count < iface->super.super.config.rx_max_poll));
+        while ((count < iface->super.super.config.rx_max_poll) &&
+               (uct_ud_mlx5_iface_poll_rx(iface, 0) == UCS_OK)) {
+            ++count;
+        }
     }
     uct_ud_mlx5_iface_poll_tx(iface);
     uct_ud_iface_progress_pending(&iface->super, 0);
     uct_ud_leave(&iface->super);
+    return count;
 }
 
 static void uct_ud_mlx5_iface_async_progress(uct_ud_iface_t *ud_iface)
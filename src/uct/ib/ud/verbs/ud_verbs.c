@@ -300,7 +300,8 @@ uct_ud_verbs_iface_poll_tx(uct_ud_verbs_iface_t *iface)
     iface->super.tx.available += UCT_UD_TX_MODERATION + 1;
 }
 
-static UCS_F_ALWAYS_INLINE ucs_status_t
+/* Returns the number of received packets */
+static UCS_F_ALWAYS_INLINE unsigned
 uct_ud_verbs_iface_poll_rx(uct_ud_verbs_iface_t *iface, int is_async)
 {
     unsigned num_wcs = iface->super.super.config.rx_max_poll;
@@ -311,6 +312,7 @@ uct_ud_verbs_iface_poll_rx(uct_ud_verbs_iface_t *iface, int is_async)
 
     status = uct_ib_poll_cq(iface->super.super.recv_cq, &num_wcs, wc);
     if (status != UCS_OK) {
+        num_wcs = 0;
         goto out;
     }
 
@@ -327,37 +329,40 @@ uct_ud_verbs_iface_poll_rx(uct_ud_verbs_iface_t *iface, int is_async)
     iface->super.rx.available += num_wcs;
 out:
     uct_ud_verbs_iface_post_recv(iface);
-    return status;
+    return num_wcs;
 }
 
 static void uct_ud_verbs_iface_async_progress(uct_ud_iface_t *ud_iface)
 {
     uct_ud_verbs_iface_t *iface = ucs_derived_of(ud_iface, uct_ud_verbs_iface_t);
-    ucs_status_t status;
+    unsigned count;
 
     do {
-        status = uct_ud_verbs_iface_poll_rx(iface, 1);
-    } while (status == UCS_OK);
+        count = uct_ud_verbs_iface_poll_rx(iface, 1);
+    } while (count > 0);
     uct_ud_verbs_iface_poll_tx(iface);
     uct_ud_iface_progress_pending(&iface->super, 1);
 }
 
-static void uct_ud_verbs_iface_progress(void *arg)
+static unsigned uct_ud_verbs_iface_progress(void *arg)
 {
     uct_ud_verbs_iface_t *iface = arg;
     ucs_status_t status;
+    unsigned count;
 
     uct_ud_enter(&iface->super);
     uct_ud_iface_dispatch_zcopy_comps(&iface->super);
     status = uct_ud_iface_dispatch_pending_rx(&iface->super);
+    count  = 0;
     if (status == UCS_OK) {
-        status = uct_ud_verbs_iface_poll_rx(iface, 0);
-        if (status == UCS_ERR_NO_PROGRESS) {
+        count = uct_ud_verbs_iface_poll_rx(iface, 0);
+        if (count == 0) {
             uct_ud_verbs_iface_poll_tx(iface);
         }
     }
     uct_ud_iface_progress_pending(&iface->super, 0);
     uct_ud_leave(&iface->super);
+    return count;
 }
 
 static ucs_status_t
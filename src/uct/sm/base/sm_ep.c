@@ -4,6 +4,7 @@
 */
 
 #include "sm_ep.h"
+#include "sm_iface.h"
 
 #include <ucs/arch/atomic.h>
 
@@ -54,6 +55,61 @@ ucs_status_t uct_sm_ep_get_bcopy(uct_ep_h tl_ep, uct_unpack_callback_t unpack_cb
     return UCS_OK;
 }
 
+/* Copy the iov elements to/from a contiguous region of the attached remote
+ * memory, return the total length. Every iov entry holds 'count' elements of
+ * 'length' bytes, which are 'stride' bytes apart in the local buffer. */
+static UCS_F_ALWAYS_INLINE size_t
+uct_sm_ep_iov_copy(const uct_iov_t *iov, size_t iovcnt, void *remote_ptr,
+                   int is_put)
+{
+    size_t iov_it, count_it, length, offset;
+    void *buffer;
+
+    offset = 0;
+    for (iov_it = 0; iov_it < iovcnt; ++iov_it) {
+        buffer = iov[iov_it].buffer;
+        length = iov[iov_it].length;
+        for (count_it = 0; count_it < iov[iov_it].count; ++count_it) {
+            if (is_put) {
+                memcpy(remote_ptr + offset, buffer, length);
+            } else {
+                memcpy(buffer, remote_ptr + offset, length);
+            }
+            buffer += iov[iov_it].stride;
+            offset += length;
+        }
+    }
+    return offset;
+}
+
+ucs_status_t uct_sm_ep_put_zcopy(uct_ep_h tl_ep, const uct_iov_t *iov,
+                                 size_t iovcnt, uint64_t remote_addr,
+                                 uct_rkey_t rkey, uct_completion_t *comp)
+{
+    size_t length;
+
+    UCT_CHECK_IOV_SIZE(iovcnt, uct_sm_get_max_iov(), "uct_sm_ep_put_zcopy");
+
+    length = uct_sm_ep_iov_copy(iov, iovcnt, (void *)(rkey + remote_addr), 1);
+    uct_sm_ep_trace_data(remote_addr, rkey, "PUT_ZCOPY [length %zu]", length);
+    UCT_TL_EP_STAT_OP(ucs_derived_of(tl_ep, uct_base_ep_t), PUT, ZCOPY, length);
+    return UCS_OK;
+}
+
+ucs_status_t uct_sm_ep_get_zcopy(uct_ep_h tl_ep, const uct_iov_t *iov,
+                                 size_t iovcnt, uint64_t remote_addr,
+                                 uct_rkey_t rkey, uct_completion_t *comp)
+{
+    size_t length;
+
+    UCT_CHECK_IOV_SIZE(iovcnt, uct_sm_get_max_iov(), "uct_sm_ep_get_zcopy");
+
+    length = uct_sm_ep_iov_copy(iov, iovcnt, (void *)(rkey + remote_addr), 0);
+    uct_sm_ep_trace_data(remote_addr, rkey, "GET_ZCOPY [length %zu]", length);
+    UCT_TL_EP_STAT_OP(ucs_derived_of(tl_ep, uct_base_ep_t), GET, ZCOPY, length);
+    return UCS_OK;
+}
+
 ucs_status_t uct_sm_ep_atomic_add64(uct_ep_h tl_ep, uint64_t add,
                                     uint64_t remote_addr, uct_rkey_t rkey)
 {
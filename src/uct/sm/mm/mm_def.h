@@ -54,9 +54,19 @@ typedef struct uct_mm_md_config {
 } uct_mm_md_config_t;
 
 
+/*
+ * The FIFO geometry is published with the address, so a sender attaches as
+ * much memory as the receiver's FIFO and rings take. A sender writes elements
+ * with its own FIFO size and element size, so a peer which uses different ones
+ * is reported as unreachable.
+ */
 typedef struct uct_mm_iface_addr {
     uint64_t   id;
     uintptr_t  vaddr;
+    uint32_t   fifo_size;       /* Number of elements in the FIFO and in every
+                                   sender ring */
+    uint32_t   fifo_elem_size;  /* Size of a FIFO element */
+    uint8_t    num_rings;       /* Number of sender rings after the FIFO */
 } UCS_S_PACKED uct_mm_iface_addr_t;
 
 
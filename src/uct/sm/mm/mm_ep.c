@@ -8,6 +8,7 @@
 #include "mm_ep.h"
 
 #include <ucs/arch/atomic.h>
+#include <signal.h>
 
 SGLIB_DEFINE_LIST_FUNCTIONS(uct_mm_remote_seg_t, uct_mm_remote_seg_compare, next)
 SGLIB_DEFINE_HASHED_CONTAINER_FUNCTIONS(uct_mm_remote_seg_t,
@@ -19,12 +20,94 @@ static ucs_status_t uct_mm_ep_signal_remote(uct_mm_ep_t *ep,
 
 void uct_mm_ep_connected(uct_mm_ep_t *ep)
 {
+    uct_mm_iface_t *iface = ucs_derived_of(ep->super.super.iface, uct_mm_iface_t);
+
     /* point the ep->fifo_ctl to the remote fifo.
      * it's an aligned pointer to the beginning of the ctl struct in the remote FIFO */
     ep->fifo_ctl    = uct_mm_set_fifo_ctl(ep->mapped_desc.address);
+    if (ep->ring_index >= 0) {
+        ep->fifo_ctl = uct_mm_get_ring_ctl(iface, ep->fifo_ctl, ep->ring_index);
+    }
     ep->cached_tail = ep->fifo_ctl->tail;
 }
 
+/* Check whether the sender which owns a ring has exited without releasing it.
+ * As with cma, the peers are assumed to share the process id namespace. */
+static int uct_mm_ep_is_ring_orphaned(uint32_t owner)
+{
+    return (owner != 0) && (kill(owner, 0) < 0) && (errno == ESRCH);
+}
+
+/* A sender which died in the middle of a send has already advanced the ring
+ * head, but did not mark the element as written. The receiver would wait for
+ * this element forever, so the new owner writes it again. */
+static void uct_mm_ep_ring_rewind(uct_mm_iface_t *iface,
+                                  uct_mm_fifo_ctl_t *ring_ctl)
+{
+    uint64_t head = ring_ctl->head;
+    uct_mm_fifo_element_t *elem;
+    void *ring_elems;
+
+    if (head == ring_ctl->tail) {
+        return;
+    }
+
+    uct_mm_set_fifo_elems_ptr(ring_ctl, &ring_elems);
+    elem = UCT_MM_IFACE_GET_FIFO_ELEM(iface, ring_elems,
+                                      (head - 1) & iface->fifo_mask);
+    if ((((head - 1) >> iface->fifo_shift) & 1) !=
+        (elem->flags & UCT_MM_FIFO_ELEM_FLAG_OWNER)) {
+        ucs_debug("mm: rewinding orphaned ring head from %"PRIu64, head);
+        ring_ctl->head = head - 1;
+    }
+}
+
+/* Try to take ownership of one of the remote peer's sender rings, and mark it
+ * on the ring map so the receiver would start polling it. A ring whose owner
+ * process is gone is taken over, otherwise its ring map bit would stay set and
+ * the ring would never be used again. */
+static void uct_mm_ep_claim_ring(uct_mm_ep_t *ep, uct_mm_iface_t *iface,
+                                 uct_mm_fifo_ctl_t *remote_fifo_ctl,
+                                 unsigned remote_num_rings)
+{
+    uint32_t pid = getpid();
+    uct_mm_fifo_ctl_t *ring_ctl;
+    uint64_t ring_map;
+    uint32_t owner;
+    unsigned i;
+
+    ep->ring_index = -1;
+
+    for (i = 0; i < remote_num_rings; ++i) {
+        ring_ctl = uct_mm_get_ring_ctl(iface, remote_fifo_ctl, i);
+        owner    = ring_ctl->ring_owner;
+        if ((owner == 0) || uct_mm_ep_is_ring_orphaned(owner)) {
+            if (ucs_atomic_cswap32(&ring_ctl->ring_owner, owner, pid) == owner) {
+                ep->ring_index = i;
+                break;
+            }
+        }
+    }
+
+    if (ep->ring_index < 0) {
+        ucs_debug("mm ep %p: no free sender ring, using the shared FIFO", ep);
+        return;
+    }
+
+    if (owner != 0) {
+        ucs_debug("mm ep %p: taking over sender ring %d of exited process %u",
+                  ep, ep->ring_index, owner);
+        uct_mm_ep_ring_rewind(iface, ring_ctl);
+    }
+
+    do {
+        ring_map = remote_fifo_ctl->ring_map;
+    } while (ucs_atomic_cswap64(&remote_fifo_ctl->ring_map, ring_map,
+                                ring_map | UCS_BIT(i)) != ring_map);
+
+    ucs_debug("mm ep %p: claimed sender ring %d", ep, ep->ring_index);
+}
+
 static void
 uct_mm_ep_signal_remote_slow_path_callback(ucs_callbackq_slow_elem_t *self)
 {
@@ -98,6 +181,24 @@ uct_mm_ep_signal_remote(uct_mm_ep_t *ep, uct_mm_iface_conn_signal_t sig)
     }
 }
 
+static void uct_mm_ep_release_ring(uct_mm_ep_t *ep, uct_mm_iface_t *iface)
+{
+    uct_mm_fifo_ctl_t *ring_ctl;
+
+    if (ep->ring_index < 0) {
+        return;
+    }
+
+    /* the receiver keeps polling the ring, so messages which were already
+     * written to it would be delivered; the next owner continues from the
+     * current head */
+    ring_ctl = uct_mm_get_ring_ctl(iface,
+                                   uct_mm_set_fifo_ctl(ep->mapped_desc.address),
+                                   ep->ring_index);
+    ucs_memory_cpu_store_fence();
+    ring_ctl->ring_owner = 0;
+}
+
 static UCS_CLASS_INIT_FUNC(uct_mm_ep_t, uct_iface_t *tl_iface,
                            const uct_device_addr_t *dev_addr,
                            const uct_iface_addr_t *iface_addr)
@@ -110,9 +211,19 @@ static UCS_CLASS_INIT_FUNC(uct_mm_ep_t, uct_iface_t *tl_iface,
 
     UCS_CLASS_CALL_SUPER_INIT(uct_base_ep_t, &iface->super);
 
+    if (!uct_mm_iface_is_geometry_compatible(iface, addr)) {
+        ucs_error("mm: remote FIFO of %u elements of %u bytes with %u rings "
+                  "does not match the local FIFO of %u elements of %u bytes",
+                  addr->fifo_size, addr->fifo_elem_size, addr->num_rings,
+                  iface->config.fifo_size, iface->config.fifo_elem_size);
+        return UCS_ERR_UNREACHABLE;
+    }
+
     /* Connect to the remote address (remote FIFO) */
-    /* Attach the address's memory */
-    size_to_attach = UCT_MM_GET_FIFO_SIZE(iface);
+    /* Attach the address's memory, which holds as many sender rings as the
+     * remote peer has */
+    size_to_attach = UCT_MM_FIFO_SEG_SIZE(addr->fifo_size, addr->fifo_elem_size,
+                                          addr->num_rings);
     status =
         uct_mm_md_mapper_ops(iface->super.md)->attach(addr->id,
                                                       size_to_attach,
@@ -136,19 +247,27 @@ static UCS_CLASS_INIT_FUNC(uct_mm_ep_t, uct_iface_t *tl_iface,
 
     self->cached_tail = self->fifo_ctl->tail;
 
-    /* set the ep->fifo ptr to point to the beginning of the fifo elements at
-     * the remote peer */
-    uct_mm_set_fifo_elems_ptr(self->mapped_desc.address, &self->fifo);
-
     remote_fifo_ctl   = uct_mm_set_fifo_ctl(self->mapped_desc.address);
     self->cached_signal_addrlen  = remote_fifo_ctl->signal_addrlen;
     self->cached_signal_sockaddr = remote_fifo_ctl->signal_sockaddr;
 
+    /* set the ep->fifo ptr to point to the beginning of the fifo elements at
+     * the remote peer, either of the shared FIFO or of a sender ring */
+    uct_mm_ep_claim_ring(self, iface, remote_fifo_ctl, addr->num_rings);
+    if (self->ring_index >= 0) {
+        uct_mm_set_fifo_elems_ptr(uct_mm_get_ring_ctl(iface, remote_fifo_ctl,
+                                                      self->ring_index),
+                                  &self->fifo);
+    } else {
+        uct_mm_set_fifo_elems_ptr(self->mapped_desc.address, &self->fifo);
+    }
+
     self->cbq_elem_on = 0;
 
     /* Send connect message to remote side so it will start polling */
     status = uct_mm_ep_signal_remote(self, UCT_MM_IFACE_SIGNAL_CONNECT);
     if (status != UCS_OK) {
+        uct_mm_ep_release_ring(self, iface);
         uct_mm_md_mapper_ops(iface->super.md)->detach(&self->mapped_desc);
         return status;
     }
@@ -199,6 +318,8 @@ static UCS_CLASS_CLEANUP_FUNC(uct_mm_ep_t)
             ucs_free(remote_seg);
     }
 
+    uct_mm_ep_release_ring(self, iface);
+
     /* detach the remote proceess's shared memory segment (remote recv FIFO) */
     status = uct_mm_md_mapper_ops(iface->super.md)->detach(&self->mapped_desc);
     if (status != UCS_OK) {
@@ -265,6 +386,13 @@ static inline ucs_status_t uct_mm_ep_get_remote_elem(uct_mm_ep_t *ep, uint64_t h
     elem_index = ep->fifo_ctl->head & iface->fifo_mask;
     *elem = UCT_MM_IFACE_GET_FIFO_ELEM(iface, ep->fifo, elem_index);
 
+    if (ep->ring_index >= 0) {
+        /* the sender ring has a single producer, so no other sender may take
+         * the head element */
+        ep->fifo_ctl->head = head + 1;
+        return UCS_OK;
+    }
+
     /* try to get ownership of the head element */
     returned_val = ucs_atomic_cswap64(&ep->fifo_ctl->head, head, head+1);
     if (returned_val != head) {
@@ -280,6 +408,27 @@ static inline void uct_mm_ep_update_cached_tail(uct_mm_ep_t *ep)
     ep->cached_tail = ep->fifo_ctl->tail;
 }
 
+/* Notify the remote peer about a new message if it's armed, and make sure only
+ * one sender does it */
+static UCS_F_ALWAYS_INLINE void uct_mm_ep_notify_remote(uct_mm_ep_t *ep,
+                                                        uct_mm_iface_t *iface)
+{
+    uct_mm_fifo_ctl_t *ctl = uct_mm_set_fifo_ctl(ep->mapped_desc.address);
+
+    if (ucs_likely(ctl->arm_state == UCT_MM_ARM_STATE_DISABLED)) {
+        return;
+    }
+
+    /* the message must be visible before checking the state, since the
+     * receiver checks the FIFO after arming */
+    ucs_memory_bus_fence();
+    if ((ctl->arm_state == UCT_MM_ARM_STATE_ARMED) &&
+        (ucs_atomic_cswap32(&ctl->arm_state, UCT_MM_ARM_STATE_ARMED,
+                            UCT_MM_ARM_STATE_IDLE) == UCT_MM_ARM_STATE_ARMED)) {
+        uct_mm_iface_send_wakeup(iface, ctl);
+    }
+}
+
 /* A common mm active message sending function.
  * The first parameter indicates the origin of the call.
  * is_short = 1 - perform AM short sending
@@ -364,6 +513,8 @@ uct_mm_ep_am_common_send(const unsigned is_short, uct_mm_ep_t *ep, uct_mm_iface_
         elem->flags &= ~UCT_MM_FIFO_ELEM_FLAG_OWNER;
     }
 
+    uct_mm_ep_notify_remote(ep, iface);
+
     if (is_short) {
         return UCS_OK;
     } else {
@@ -24,6 +24,10 @@ struct uct_mm_ep {
     uint64_t             cached_tail; /* the sender's own copy of the remote FIFO's tail.
                                          it is not always updated with the actual remote tail value */
 
+    int                  ring_index;  /* index of the sender ring owned by this ep
+                                         on the remote peer, or -1 if the ep sends
+                                         to the shared FIFO */
+
     /* mapped remote memory chunks to which remote descriptors belong to.
      * (after attaching to them) */
     uct_mm_remote_seg_t  *remote_segments_hash[UCT_MM_BASE_ADDRESS_HASH_SIZE];
@@ -22,9 +22,22 @@ static ucs_config_field_t uct_mm_iface_config_table[] = {
      UCS_CONFIG_TYPE_TABLE(uct_iface_config_table)},
 
     {"FIFO_SIZE", "64",
-     "Size of the receive FIFO in the memory-map UCTs.",
+     "Size of the receive FIFO in the memory-map UCTs. The FIFO layout is a part\n"
+     "of the interface address, and peers must use the same FIFO size to reach\n"
+     "each other.",
      ucs_offsetof(uct_mm_iface_config_t, fifo_size), UCS_CONFIG_TYPE_UINT},
 
+    {"RX_MAX_POLL", "16",
+     "Maximal number of receive FIFO elements to process in one progress call.",
+     ucs_offsetof(uct_mm_iface_config_t, rx_max_poll), UCS_CONFIG_TYPE_UINT},
+
+    {"SENDER_RINGS", "0",
+     "Number of single-producer receive rings, in addition to the shared receive\n"
+     "FIFO. Every connected sender claims a ring of its own, if available, and\n"
+     "writes to it without atomic operations. Senders which could not claim a\n"
+     "ring use the shared FIFO. The rings use the same size as the FIFO.",
+     ucs_offsetof(uct_mm_iface_config_t, num_rings), UCS_CONFIG_TYPE_UINT},
+
     {"FIFO_RELEASE_FACTOR", "0.5",
      "Frequency of resource releasing on the receiver's side in the MM UCT.\n"
      "This value refers to the percentage of the FIFO size. (must be >= 0 and < 1)",
@@ -44,14 +57,70 @@ static ucs_config_field_t uct_mm_iface_config_table[] = {
     {NULL}
 };
 
+#if ENABLE_STATS
+static ucs_stats_class_t uct_mm_iface_stats_class = {
+    .name = "mm_iface",
+    .num_counters = UCT_MM_IFACE_STAT_LAST,
+    .counter_names = {
+        [UCT_MM_IFACE_STAT_RX_POLL]       = "rx_poll",
+        [UCT_MM_IFACE_STAT_RX_ELEM]       = "rx_elem",
+        [UCT_MM_IFACE_STAT_RX_FULL_BATCH] = "rx_full_batch",
+    }
+};
+#endif
+
 static ucs_status_t uct_mm_iface_get_address(uct_iface_t *tl_iface,
                                              uct_iface_addr_t *addr)
 {
     uct_mm_iface_t *iface = ucs_derived_of(tl_iface, uct_mm_iface_t);
     uct_mm_iface_addr_t *iface_addr = (void*)addr;
 
-    iface_addr->id    = iface->fifo_mm_id;
-    iface_addr->vaddr = (uintptr_t)iface->shared_mem;
+    iface_addr->id             = iface->fifo_mm_id;
+    iface_addr->vaddr          = (uintptr_t)iface->shared_mem;
+    iface_addr->fifo_size      = iface->config.fifo_size;
+    iface_addr->fifo_elem_size = iface->config.fifo_elem_size;
+    iface_addr->num_rings      = iface->config.num_rings;
+    return UCS_OK;
+}
+
+/* The sender writes to the peer's FIFO and rings using its own geometry, so
+ * it can connect only to a peer which uses the same FIFO layout */
+int uct_mm_iface_is_geometry_compatible(uct_mm_iface_t *iface,
+                                        const uct_mm_iface_addr_t *addr)
+{
+    return (addr->fifo_size == iface->config.fifo_size) &&
+           (addr->fifo_elem_size == iface->config.fifo_elem_size) &&
+           (addr->num_rings <= UCT_MM_MAX_RINGS);
+}
+
+static int uct_mm_iface_is_reachable(const uct_iface_h tl_iface,
+                                     const uct_device_addr_t *dev_addr,
+                                     const uct_iface_addr_t *iface_addr)
+{
+    uct_mm_iface_t *iface = ucs_derived_of(tl_iface, uct_mm_iface_t);
+
+    return uct_sm_iface_is_reachable(tl_iface, dev_addr, iface_addr) &&
+           uct_mm_iface_is_geometry_compatible(iface, (const void*)iface_addr);
+}
+
+ucs_status_t uct_mm_iface_send_wakeup(uct_mm_iface_t *iface,
+                                      uct_mm_fifo_ctl_t *fifo_ctl)
+{
+    uct_mm_iface_conn_signal_t sig = UCT_MM_IFACE_SIGNAL_WAKEUP;
+    int ret;
+
+    ret = sendto(iface->signal_fd, &sig, sizeof(sig), 0,
+                 (const struct sockaddr*)&fifo_ctl->wakeup_sockaddr,
+                 fifo_ctl->wakeup_addrlen);
+    if (ret >= 0) {
+        ucs_assert(ret == sizeof(sig));
+    } else if (errno != EAGAIN) {
+        /* EAGAIN means the receiver has unread notifications, so it is awake
+         * anyway */
+        ucs_debug("failed to send mm wakeup signal: %m");
+        return UCS_ERR_IO_ERROR;
+    }
+
     return UCS_OK;
 }
 
@@ -88,14 +157,14 @@ static ucs_status_t uct_mm_iface_query(uct_iface_h tl_iface,
     iface_attr->cap.put.max_zcopy       = SIZE_MAX;
     iface_attr->cap.put.opt_zcopy_align = UCS_SYS_CACHE_LINE_SIZE;
     iface_attr->cap.put.align_mtu       = iface_attr->cap.put.opt_zcopy_align;
-    iface_attr->cap.put.max_iov         = 1;
+    iface_attr->cap.put.max_iov         = uct_sm_get_max_iov();
 
     iface_attr->cap.get.max_bcopy       = SIZE_MAX;
     iface_attr->cap.get.min_zcopy       = 0;
     iface_attr->cap.get.max_zcopy       = SIZE_MAX;
     iface_attr->cap.get.opt_zcopy_align = UCS_SYS_CACHE_LINE_SIZE;
     iface_attr->cap.get.align_mtu       = iface_attr->cap.get.opt_zcopy_align;
-    iface_attr->cap.get.max_iov         = 1;
+    iface_attr->cap.get.max_iov         = uct_sm_get_max_iov();
 
     iface_attr->cap.am.max_short        = iface->config.fifo_elem_size -
                                           sizeof(uct_mm_fifo_element_t);
@@ -111,6 +180,7 @@ static ucs_status_t uct_mm_iface_query(uct_iface_h tl_iface,
     iface_attr->ep_addr_len             = 0;
     iface_attr->cap.flags               = UCT_IFACE_FLAG_PUT_SHORT        |
                                           UCT_IFACE_FLAG_PUT_BCOPY        |
+                                          UCT_IFACE_FLAG_PUT_ZCOPY        |
                                           UCT_IFACE_FLAG_ATOMIC_ADD32     |
                                           UCT_IFACE_FLAG_ATOMIC_ADD64     |
                                           UCT_IFACE_FLAG_ATOMIC_FADD64    |
@@ -121,10 +191,12 @@ static ucs_status_t uct_mm_iface_query(uct_iface_h tl_iface,
                                           UCT_IFACE_FLAG_ATOMIC_CSWAP32   |
                                           UCT_IFACE_FLAG_ATOMIC_CPU       |
                                           UCT_IFACE_FLAG_GET_BCOPY        |
+                                          UCT_IFACE_FLAG_GET_ZCOPY        |
                                           UCT_IFACE_FLAG_AM_SHORT         |
                                           UCT_IFACE_FLAG_AM_BCOPY         |
                                           UCT_IFACE_FLAG_PENDING          |
                                           UCT_IFACE_FLAG_AM_CB_SYNC       |
+                                          UCT_IFACE_FLAG_WAKEUP           |
                                           UCT_IFACE_FLAG_CONNECT_TO_IFACE;
 
     iface_attr->latency.overhead        = 80e-9; /* 80 ns */
@@ -137,17 +209,226 @@ static ucs_status_t uct_mm_iface_query(uct_iface_h tl_iface,
 
 static UCS_CLASS_DECLARE_DELETE_FUNC(uct_mm_iface_t, uct_iface_t);
 
+/* Create a non-blocking UNIX datagram socket bound to an automatic address,
+ * and store the address in the given location, which is usually on the FIFO
+ * control area so we would not have to enlarge the interface address size */
+static ucs_status_t uct_mm_iface_create_socket(int *fd_p,
+                                               struct sockaddr_un *sockaddr,
+                                               socklen_t *addrlen_p)
+{
+    ucs_status_t status;
+    socklen_t addrlen;
+    struct sockaddr_un bind_addr;
+    int ret, fd;
+
+    fd = socket(AF_UNIX, SOCK_DGRAM, 0);
+    if (fd < 0) {
+        ucs_error("Failed to create unix domain socket for signal: %m");
+        status = UCS_ERR_IO_ERROR;
+        goto err;
+    }
+
+    /* Set the signal socket to non-blocking mode */
+    status = ucs_sys_fcntl_modfl(fd, O_NONBLOCK, 0);
+    if (status != UCS_OK) {
+        goto err_close;
+    }
+
+    /* Bind the signal socket to automatic address */
+    bind_addr.sun_family = AF_UNIX;
+    memset(bind_addr.sun_path, 0, sizeof(bind_addr.sun_path));
+    ret = bind(fd, (struct sockaddr*)&bind_addr, sizeof(sa_family_t));
+    if (ret < 0) {
+        ucs_error("Failed to auto-bind unix domain socket: %m");
+        status = UCS_ERR_IO_ERROR;
+        goto err_close;
+    }
+
+    addrlen = sizeof(struct sockaddr_un);
+    memset(sockaddr, 0, addrlen);
+    ret = getsockname(fd, (struct sockaddr *)sockaddr, &addrlen);
+    if (ret < 0) {
+        ucs_error("Failed to retrieve unix domain socket address: %m");
+        status = UCS_ERR_IO_ERROR;
+        goto err_close;
+    }
+
+    *addrlen_p = addrlen;
+    *fd_p      = fd;
+    return UCS_OK;
+
+err_close:
+    close(fd);
+err:
+    return status;
+}
+
+/* Check whether the element at the read position was written by the sender */
+static int uct_mm_iface_fifo_is_ready(uct_mm_iface_t *iface, void *fifo_elems,
+                                      uint64_t read_index)
+{
+    uct_mm_fifo_element_t *elem;
+
+    elem = UCT_MM_IFACE_GET_FIFO_ELEM(iface, fifo_elems,
+                                      read_index & iface->fifo_mask);
+    return ((read_index >> iface->fifo_shift) & 1) == (elem->flags & 1);
+}
+
+/* Check whether the shared FIFO or any of the attached rings holds a message
+ * which was not processed yet */
+static int uct_mm_iface_has_ready_elem(uct_mm_iface_t *iface)
+{
+    uint64_t ring_map = iface->recv_fifo_ctl->ring_map;
+    uct_mm_rx_ring_t *ring;
+    unsigned i;
+
+    if (uct_mm_iface_fifo_is_ready(iface, iface->recv_fifo_elements,
+                                   iface->read_index)) {
+        return 1;
+    }
+
+    for (i = 0; i < iface->config.num_rings; ++i) {
+        if (ring_map & UCS_BIT(i)) {
+            ring = &iface->rx_rings[i];
+            if (uct_mm_iface_fifo_is_ready(iface, ring->elems,
+                                           ring->read_index)) {
+                return 1;
+            }
+        }
+    }
+
+    return 0;
+}
+
+static ucs_status_t uct_mm_iface_wakeup_open(uct_iface_h tl_iface,
+                                             unsigned events,
+                                             uct_wakeup_h wakeup)
+{
+    uct_mm_iface_t *iface = ucs_derived_of(tl_iface, uct_mm_iface_t);
+    uct_mm_fifo_ctl_t *ctl = iface->recv_fifo_ctl;
+    ucs_status_t status;
+    socklen_t addrlen;
+
+    if (ctl->arm_state != UCT_MM_ARM_STATE_DISABLED) {
+        ucs_error("mm_iface %p already has a wakeup handle", iface);
+        return UCS_ERR_ALREADY_EXISTS;
+    }
+
+    status = uct_mm_iface_create_socket(&wakeup->fd, &ctl->wakeup_sockaddr,
+                                        &addrlen);
+    if (status != UCS_OK) {
+        return status;
+    }
+
+    ctl->wakeup_addrlen = addrlen;
+
+    /* from now on, senders check the arm state after every message */
+    ucs_memory_bus_fence();
+    ctl->arm_state = UCT_MM_ARM_STATE_IDLE;
+    return UCS_OK;
+}
+
+static ucs_status_t uct_mm_iface_wakeup_get_fd(uct_wakeup_h wakeup, int *fd_p)
+{
+    *fd_p = wakeup->fd;
+    return UCS_OK;
+}
+
+static ucs_status_t uct_mm_iface_wakeup_arm(uct_wakeup_h wakeup)
+{
+    uct_mm_iface_t *iface = ucs_derived_of(wakeup->iface, uct_mm_iface_t);
+    uct_mm_fifo_ctl_t *ctl = iface->recv_fifo_ctl;
+    uct_mm_iface_conn_signal_t sig;
+    int ret, count;
+
+    /* consume the notifications which were already sent */
+    count = 0;
+    while ((ret = recv(wakeup->fd, &sig, sizeof(sig), 0)) == sizeof(sig)) {
+        ++count;
+    }
+
+    if ((ret < 0) && (errno != EAGAIN)) {
+        ucs_error("failed to receive mm wakeup signal: %m");
+        return UCS_ERR_IO_ERROR;
+    }
+
+    if (count > 0) {
+        return UCS_ERR_BUSY;
+    }
+
+    /* publish the armed state before checking the FIFOs, so a message which is
+     * not seen here would be notified by its sender */
+    ctl->arm_state = UCT_MM_ARM_STATE_ARMED;
+    ucs_memory_bus_fence();
+
+    if (uct_mm_iface_has_ready_elem(iface)) {
+        /* messages are waiting which progress did not consume yet */
+        ucs_atomic_cswap32(&ctl->arm_state, UCT_MM_ARM_STATE_ARMED,
+                           UCT_MM_ARM_STATE_IDLE);
+        return UCS_ERR_BUSY;
+    }
+
+    return UCS_OK;
+}
+
+static ucs_status_t uct_mm_iface_wakeup_wait(uct_wakeup_h wakeup)
+{
+    struct pollfd polled = { .fd = wakeup->fd, .events = POLLIN };
+    ucs_status_t status;
+    int res;
+
+    status = uct_mm_iface_wakeup_arm(wakeup);
+    if (status == UCS_ERR_BUSY) { /* if UCS_ERR_BUSY returned - no poll() must called */
+        return UCS_OK;
+    } else if (status != UCS_OK) {
+        return status;
+    }
+
+    do {
+        res = poll(&polled, 1, -1);
+    } while ((res == -1) && (errno == EINTR));
+
+    if ((res != 1) || (polled.revents != POLLIN)) {
+        return UCS_ERR_IO_ERROR;
+    }
+
+    return UCS_OK;
+}
+
+static ucs_status_t uct_mm_iface_wakeup_signal(uct_wakeup_h wakeup)
+{
+    uct_mm_iface_t *iface = ucs_derived_of(wakeup->iface, uct_mm_iface_t);
+
+    return uct_mm_iface_send_wakeup(iface, iface->recv_fifo_ctl);
+}
+
+static void uct_mm_iface_wakeup_close(uct_wakeup_h wakeup)
+{
+    uct_mm_iface_t *iface = ucs_derived_of(wakeup->iface, uct_mm_iface_t);
+
+    iface->recv_fifo_ctl->arm_state = UCT_MM_ARM_STATE_DISABLED;
+    close(wakeup->fd);
+}
+
 static uct_iface_ops_t uct_mm_iface_ops = {
     .iface_close         = UCS_CLASS_DELETE_FUNC_NAME(uct_mm_iface_t),
     .iface_query         = uct_mm_iface_query,
     .iface_get_address   = uct_mm_iface_get_address,
     .iface_get_device_address = uct_sm_iface_get_device_address,
-    .iface_is_reachable  = uct_sm_iface_is_reachable,
+    .iface_is_reachable  = uct_mm_iface_is_reachable,
     .iface_flush         = uct_mm_iface_flush,
     .iface_fence         = uct_sm_iface_fence,
+    .iface_wakeup_open   = uct_mm_iface_wakeup_open,
+    .iface_wakeup_get_fd = uct_mm_iface_wakeup_get_fd,
+    .iface_wakeup_arm    = uct_mm_iface_wakeup_arm,
+    .iface_wakeup_wait   = uct_mm_iface_wakeup_wait,
+    .iface_wakeup_signal = uct_mm_iface_wakeup_signal,
+    .iface_wakeup_close  = uct_mm_iface_wakeup_close,
     .ep_put_short        = uct_sm_ep_put_short,
     .ep_put_bcopy        = uct_sm_ep_put_bcopy,
+    .ep_put_zcopy        = uct_sm_ep_put_zcopy,
     .ep_get_bcopy        = uct_sm_ep_get_bcopy,
+    .ep_get_zcopy        = uct_sm_ep_get_zcopy,
     .ep_am_short         = uct_mm_ep_am_short,
     .ep_am_bcopy         = uct_mm_ep_am_bcopy,
     .ep_atomic_add64     = uct_sm_ep_atomic_add64,
@@ -166,14 +447,19 @@ static uct_iface_ops_t uct_mm_iface_ops = {
     .ep_destroy          = UCS_CLASS_DELETE_FUNC_NAME(uct_mm_ep_t),
 };
 
-static inline void uct_mm_progress_fifo_tail(uct_mm_iface_t *iface)
+static inline void uct_mm_progress_fifo_tail(uct_mm_iface_t *iface,
+                                             uct_mm_fifo_ctl_t *fifo_ctl,
+                                             uint64_t prev_read_index,
+                                             uint64_t read_index)
 {
-    /* don't progress the tail every time - release in batches. improves performance */
-    if (iface->read_index & iface->fifo_release_factor_mask) {
+    /* don't progress the tail every time - release in batches. improves
+     * performance. the tail is updated once per poll, if the read index has
+     * crossed a release boundary since the previous poll */
+    if (!((prev_read_index ^ read_index) & ~iface->fifo_release_factor_mask)) {
         return;
     }
 
-    iface->recv_fifo_ctl->tail = iface->read_index;
+    fifo_ctl->tail = read_index;
 }
 
 ucs_status_t uct_mm_assign_desc_to_fifo_elem(uct_mm_iface_t *iface,
@@ -230,53 +516,153 @@ static inline ucs_status_t uct_mm_iface_process_recv(uct_mm_iface_t *iface,
     return status;
 }
 
-static inline void uct_mm_iface_poll_fifo(uct_mm_iface_t *iface)
+/* Read up to max_poll elements from the shared FIFO or from a sender ring */
+static inline unsigned uct_mm_iface_poll_fifo(uct_mm_iface_t *iface,
+                                              uct_mm_fifo_ctl_t *fifo_ctl,
+                                              void *fifo_elems,
+                                              uint64_t *read_index_p,
+                                              unsigned max_poll)
 {
-    uint64_t read_index_loc, read_index;
+    uint64_t read_index_loc, read_index, prev_read_index;
     uct_mm_fifo_element_t* read_index_elem;
     ucs_status_t status;
+    unsigned count;
 
-    /* check the memory pool to make sure that there is a new descriptor available */
-    if (ucs_unlikely(iface->last_recv_desc == NULL)) {
-        UCT_TL_IFACE_GET_RX_DESC(&iface->super, &iface->recv_desc_mp,
-                                 iface->last_recv_desc, return);
-    }
+    read_index      = *read_index_p;
+    prev_read_index = read_index;
 
-    read_index = iface->read_index;
-    read_index_loc = (read_index & iface->fifo_mask);
-    /* the fifo_element which the read_index points to */
-    read_index_elem = UCT_MM_IFACE_GET_FIFO_ELEM(iface, iface->recv_fifo_elements ,read_index_loc);
+    for (count = 0; count < max_poll; ++count) {
+        read_index_loc = (read_index & iface->fifo_mask);
+        /* the fifo_element which the read_index points to */
+        read_index_elem = UCT_MM_IFACE_GET_FIFO_ELEM(iface, fifo_elems, read_index_loc);
 
-    /* check the read_index to see if there is a new item to read (checking the owner bit) */
-    if (((read_index >> iface->fifo_shift) & 1) == ((read_index_elem->flags) & 1)) {
+        /* check the read_index to see if there is a new item to read (checking the owner bit) */
+        if (((read_index >> iface->fifo_shift) & 1) != ((read_index_elem->flags) & 1)) {
+            break;
+        }
 
         /* read from read_index_elem */
         ucs_memory_cpu_load_fence();
-        ucs_assert(iface->read_index <= iface->recv_fifo_ctl->head);
+        ucs_assert(read_index <= fifo_ctl->head);
 
         status = uct_mm_iface_process_recv(iface, read_index_elem);
+
+        /* raise the read_index. */
+        read_index++;
+
         if (status != UCS_OK) {
             /* the last_recv_desc is in use. get a new descriptor for it */
             UCT_TL_IFACE_GET_RX_DESC(&iface->super, &iface->recv_desc_mp,
-                                     iface->last_recv_desc, ucs_debug("recv mpool is empty"));
+                                     iface->last_recv_desc,
+                                     ucs_debug("recv mpool is empty"));
+            if (ucs_unlikely(iface->last_recv_desc == NULL)) {
+                /* can't replace the descriptor of the next bcopy element */
+                ++count;
+                break;
+            }
         }
+    }
 
-        /* raise the read_index. */
-        iface->read_index++;
+    if (count > 0) {
+        *read_index_p = read_index;
+        uct_mm_progress_fifo_tail(iface, fifo_ctl, prev_read_index, read_index);
+    }
+
+    return count;
+}
+
+/* Poll the sender rings which were attached, and the shared FIFO, in a
+ * round-robin order. The shared FIFO takes the position after the last ring. */
+static unsigned uct_mm_iface_poll_rings(uct_mm_iface_t *iface)
+{
+    unsigned num_rings = iface->config.num_rings;
+    uint64_t ready_map, map;
+    uct_mm_rx_ring_t *ring;
+    unsigned count, index;
+
+    ready_map = iface->recv_fifo_ctl->ring_map | UCS_BIT(num_rings);
+    map       = ready_map & ~UCS_MASK(iface->rx_ring_next);
+    count     = 0;
+
+    for (;;) {
+        if (map == 0) {
+            /* wrap around to the rings before the starting position */
+            map       = ready_map & UCS_MASK(iface->rx_ring_next);
+            ready_map = 0;
+            if (map == 0) {
+                break;
+            }
+        }
+
+        index = ucs_ilog2(map & -map);
+        map  &= map - 1;
+
+        if (index == num_rings) {
+            count += uct_mm_iface_poll_fifo(iface, iface->recv_fifo_ctl,
+                                            iface->recv_fifo_elements,
+                                            &iface->read_index,
+                                            iface->config.rx_max_poll - count);
+        } else {
+            ring   = &iface->rx_rings[index];
+            count += uct_mm_iface_poll_fifo(iface, ring->ctl, ring->elems,
+                                            &ring->read_index,
+                                            iface->config.rx_max_poll - count);
+        }
+
+        if ((count >= iface->config.rx_max_poll) ||
+            ucs_unlikely(iface->last_recv_desc == NULL)) {
+            break;
+        }
+    }
+
+    /* start from the next position in the following call */
+    iface->rx_ring_next = (iface->rx_ring_next + 1) % (num_rings + 1);
+    return count;
+}
+
+static inline unsigned uct_mm_iface_poll(uct_mm_iface_t *iface)
+{
+    unsigned count;
+
+    /* check the memory pool to make sure that there is a new descriptor available */
+    if (ucs_unlikely(iface->last_recv_desc == NULL)) {
+        UCT_TL_IFACE_GET_RX_DESC(&iface->super, &iface->recv_desc_mp,
+                                 iface->last_recv_desc, return 0);
     }
 
-    uct_mm_progress_fifo_tail(iface);
+    if (iface->config.num_rings == 0) {
+        count = uct_mm_iface_poll_fifo(iface, iface->recv_fifo_ctl,
+                                       iface->recv_fifo_elements,
+                                       &iface->read_index,
+                                       iface->config.rx_max_poll);
+    } else {
+        count = uct_mm_iface_poll_rings(iface);
+    }
+
+    if (count > 0) {
+        UCS_STATS_UPDATE_COUNTER(iface->stats, UCT_MM_IFACE_STAT_RX_POLL, 1);
+        UCS_STATS_UPDATE_COUNTER(iface->stats, UCT_MM_IFACE_STAT_RX_ELEM, count);
+        if (count == iface->config.rx_max_poll) {
+            UCS_STATS_UPDATE_COUNTER(iface->stats,
+                                     UCT_MM_IFACE_STAT_RX_FULL_BATCH, 1);
+        }
+    }
+
+    return count;
 }
 
-void uct_mm_iface_progress(void *arg)
+unsigned uct_mm_iface_progress(void *arg)
 {
     uct_mm_iface_t *iface = arg;
+    unsigned count;
 
     /* progress receive */
-    uct_mm_iface_poll_fifo(iface);
+    count = uct_mm_iface_poll(iface);
 
     /* progress the pending sends (if there are any) */
     ucs_arbiter_dispatch(&iface->arbiter, 1, uct_mm_ep_process_pending, NULL);
+
+    return count;
 }
 
 void uct_mm_iface_recv_desc_init(uct_iface_h tl_iface, void *obj, uct_mem_h memh)
@@ -291,19 +677,102 @@ void uct_mm_iface_recv_desc_init(uct_iface_h tl_iface, void *obj, uct_mem_h memh
     desc->mpool_length = seg->length;
 }
 
-static void uct_mm_iface_free_rx_descs(uct_mm_iface_t *iface, unsigned num_elems)
+static void uct_mm_iface_free_rx_descs(uct_mm_iface_t *iface, void *fifo_elems,
+                                       unsigned num_elems)
 {
     uct_mm_fifo_element_t* fifo_elem_p;
     uct_mm_recv_desc_t *desc;
     unsigned i;
 
     for (i = 0; i < num_elems; i++) {
-        fifo_elem_p = UCT_MM_IFACE_GET_FIFO_ELEM(iface, iface->recv_fifo_elements, i);
+        fifo_elem_p = UCT_MM_IFACE_GET_FIFO_ELEM(iface, fifo_elems, i);
         desc = UCT_MM_IFACE_GET_DESC_START(iface, fifo_elem_p);
         ucs_mpool_put(desc);
     }
 }
 
+/* Initiate the owner bit in all the FIFO elements and assign a receive
+ * descriptor per every FIFO element */
+static ucs_status_t uct_mm_iface_init_fifo_elems(uct_mm_iface_t *iface,
+                                                 void *fifo_elems)
+{
+    uct_mm_fifo_element_t* fifo_elem_p;
+    ucs_status_t status;
+    unsigned i;
+
+    for (i = 0; i < iface->config.fifo_size; i++) {
+        fifo_elem_p = UCT_MM_IFACE_GET_FIFO_ELEM(iface, fifo_elems, i);
+        fifo_elem_p->flags = UCT_MM_FIFO_ELEM_FLAG_OWNER;
+
+        status = uct_mm_assign_desc_to_fifo_elem(iface, fifo_elem_p, 1);
+        if (status != UCS_OK) {
+            ucs_error("Failed to allocate a descriptor for MM");
+            uct_mm_iface_free_rx_descs(iface, fifo_elems, i);
+            return status;
+        }
+    }
+
+    return UCS_OK;
+}
+
+static ucs_status_t uct_mm_iface_init_rx_rings(uct_mm_iface_t *iface)
+{
+    uct_mm_rx_ring_t *ring;
+    ucs_status_t status;
+    unsigned i;
+
+    iface->rx_ring_next = 0;
+    iface->recv_fifo_ctl->ring_map = 0;
+    if (iface->config.num_rings == 0) {
+        iface->rx_rings = NULL;
+        return UCS_OK;
+    }
+
+    iface->rx_rings = ucs_calloc(iface->config.num_rings,
+                                 sizeof(*iface->rx_rings), "mm_rx_rings");
+    if (iface->rx_rings == NULL) {
+        ucs_error("Failed to allocate MM sender rings");
+        return UCS_ERR_NO_MEMORY;
+    }
+
+    for (i = 0; i < iface->config.num_rings; ++i) {
+        ring             = &iface->rx_rings[i];
+        ring->ctl        = uct_mm_get_ring_ctl(iface, iface->recv_fifo_ctl, i);
+        ring->read_index = 0;
+        uct_mm_set_fifo_elems_ptr(ring->ctl, &ring->elems);
+
+        ring->ctl->head       = 0;
+        ring->ctl->tail       = 0;
+        ring->ctl->ring_owner = 0;
+
+        status = uct_mm_iface_init_fifo_elems(iface, ring->elems);
+        if (status != UCS_OK) {
+            goto err;
+        }
+    }
+
+    return UCS_OK;
+
+err:
+    while (i-- > 0) {
+        uct_mm_iface_free_rx_descs(iface, iface->rx_rings[i].elems,
+                                   iface->config.fifo_size);
+    }
+    ucs_free(iface->rx_rings);
+    return status;
+}
+
+static void uct_mm_iface_cleanup_rx_rings(uct_mm_iface_t *iface)
+{
+    unsigned i;
+
+    for (i = 0; i < iface->config.num_rings; ++i) {
+        uct_mm_iface_free_rx_descs(iface, iface->rx_rings[i].elems,
+                                   iface->config.fifo_size);
+    }
+    ucs_free(iface->rx_rings);
+}
+
 ucs_status_t uct_mm_allocate_fifo_mem(uct_mm_iface_t *iface,
                                       uct_mm_iface_config_t *config, uct_md_h md)
 {
@@ -343,54 +812,18 @@ static ucs_status_t uct_mm_iface_create_signal_fd(uct_mm_iface_t *iface)
 {
     ucs_status_t status;
     socklen_t addrlen;
-    struct sockaddr_un bind_addr;
-    int ret;
-
-    /* Create a UNIX domain socket to send and receive wakeup signal from remote processes */
-    iface->signal_fd = socket(AF_UNIX, SOCK_DGRAM, 0);
-    if (iface->signal_fd < 0) {
-        ucs_error("Failed to create unix domain socket for signal: %m");
-        status = UCS_ERR_IO_ERROR;
-        goto err;
-    }
 
-    /* Set the signal socket to non-blocking mode */
-    status = ucs_sys_fcntl_modfl(iface->signal_fd, O_NONBLOCK, 0);
+    /* Create a UNIX domain socket to send and receive connection signals from
+     * remote processes */
+    status = uct_mm_iface_create_socket(&iface->signal_fd,
+                                        &iface->recv_fifo_ctl->signal_sockaddr,
+                                        &addrlen);
     if (status != UCS_OK) {
-        goto err_close;
-    }
-
-    /* Bind the signal socket to automatic address */
-    bind_addr.sun_family = AF_UNIX;
-    memset(bind_addr.sun_path, 0, sizeof(bind_addr.sun_path));
-    ret = bind(iface->signal_fd, (struct sockaddr*)&bind_addr, sizeof(sa_family_t));
-    if (ret < 0) {
-        ucs_error("Failed to auto-bind unix domain socket: %m");
-        status = UCS_ERR_IO_ERROR;
-        goto err_close;
-    }
-
-    /* Share the socket address on the FIFO control area, so we would not have
-     * to enlarge the interface address size.
-     */
-    addrlen = sizeof(struct sockaddr_un);
-    memset(&iface->recv_fifo_ctl->signal_sockaddr, 0, addrlen);
-    ret = getsockname(iface->signal_fd,
-                      (struct sockaddr *)&iface->recv_fifo_ctl->signal_sockaddr,
-                      &addrlen);
-    if (ret < 0) {
-        ucs_error("Failed to retrieve unix domain socket address: %m");
-        status = UCS_ERR_IO_ERROR;
-        goto err_close;
+        return status;
     }
 
     iface->recv_fifo_ctl->signal_addrlen = addrlen;
     return UCS_OK;
-
-err_close:
-    close(iface->signal_fd);
-err:
-    return status;
 }
 
 static void uct_mm_iface_recv_messages(uct_mm_iface_t *iface)
@@ -434,9 +867,7 @@ static UCS_CLASS_INIT_FUNC(uct_mm_iface_t, uct_md_h md, uct_worker_h worker,
                            const uct_iface_config_t *tl_config)
 {
     uct_mm_iface_config_t *mm_config = ucs_derived_of(tl_config, uct_mm_iface_config_t);
-    uct_mm_fifo_element_t* fifo_elem_p;
     ucs_status_t status;
-    unsigned i;
 
     UCS_CLASS_CALL_SUPER_INIT(uct_base_iface_t, &uct_mm_iface_ops, md, worker,
                               tl_config UCS_STATS_ARG(params->stats_root)
@@ -467,9 +898,18 @@ static UCS_CLASS_INIT_FUNC(uct_mm_iface_t, uct_md_h md, uct_worker_h worker,
         goto err;
     }
 
+    if (mm_config->num_rings > UCT_MM_MAX_RINGS) {
+        ucs_error("The number of MM sender rings must not exceed %d.",
+                  UCT_MM_MAX_RINGS);
+        status = UCS_ERR_INVALID_PARAM;
+        goto err;
+    }
+
     self->config.fifo_size         = mm_config->fifo_size;
     self->config.fifo_elem_size    = mm_config->super.max_short;
     self->config.seg_size          = mm_config->super.max_bcopy;
+    self->config.rx_max_poll       = ucs_max(mm_config->rx_max_poll, 1);
+    self->config.num_rings         = mm_config->num_rings;
     self->fifo_release_factor_mask = UCS_MASK(ucs_ilog2(ucs_max((int)
                                      (mm_config->fifo_size * mm_config->release_fifo_factor),
                                      1)));
@@ -481,13 +921,20 @@ static UCS_CLASS_INIT_FUNC(uct_mm_iface_t, uct_md_h md, uct_worker_h worker,
     /* create the receive FIFO */
     /* use specific allocator to allocate and attach memory and check the
      * requested hugetlb allocation mode */
-    status = uct_mm_allocate_fifo_mem(self, mm_config, md);
+    status = UCS_STATS_NODE_ALLOC(&self->stats, &uct_mm_iface_stats_class,
+                                  self->super.stats);
     if (status != UCS_OK) {
         goto err;
     }
 
+    status = uct_mm_allocate_fifo_mem(self, mm_config, md);
+    if (status != UCS_OK) {
+        goto err_free_stats;
+    }
+
     self->recv_fifo_ctl->head   = 0;
     self->recv_fifo_ctl->tail   = 0;
+    self->recv_fifo_ctl->arm_state = UCT_MM_ARM_STATE_DISABLED;
     self->read_index            = 0;
 
     status = uct_mm_iface_create_signal_fd(self);
@@ -520,17 +967,14 @@ static UCS_CLASS_INIT_FUNC(uct_mm_iface_t, uct_md_h md, uct_worker_h worker,
         goto destroy_recv_mpool;
     }
 
-    /* initiate the owner bit in all the FIFO elements and assign a receive descriptor
-     * per every FIFO element */
-    for (i = 0; i < mm_config->fifo_size; i++) {
-        fifo_elem_p = UCT_MM_IFACE_GET_FIFO_ELEM(self, self->recv_fifo_elements, i);
-        fifo_elem_p->flags = UCT_MM_FIFO_ELEM_FLAG_OWNER;
+    status = uct_mm_iface_init_fifo_elems(self, self->recv_fifo_elements);
+    if (status != UCS_OK) {
+        goto put_last_desc;
+    }
 
-        status = uct_mm_assign_desc_to_fifo_elem(self, fifo_elem_p, 1);
-        if (status != UCS_OK) {
-            ucs_error("Failed to allocate a descriptor for MM");
-            goto destroy_descs;
-        }
+    status = uct_mm_iface_init_rx_rings(self);
+    if (status != UCS_OK) {
+        goto destroy_descs;
     }
 
     uct_mm_iface_init_dummy_fifo_ctl(self);
@@ -545,7 +989,9 @@ static UCS_CLASS_INIT_FUNC(uct_mm_iface_t, uct_md_h md, uct_worker_h worker,
     return UCS_OK;
 
 destroy_descs:
-    uct_mm_iface_free_rx_descs(self, i);
+    uct_mm_iface_free_rx_descs(self, self->recv_fifo_elements,
+                               self->config.fifo_size);
+put_last_desc:
     ucs_mpool_put(self->last_recv_desc);
 destroy_recv_mpool:
     ucs_mpool_cleanup(&self->recv_desc_mp, 1);
@@ -554,6 +1000,8 @@ err_close_signal_fd:
 err_free_fifo:
     uct_mm_md_mapper_ops(md)->free(self->shared_mem, self->fifo_mm_id,
                                    UCT_MM_GET_FIFO_SIZE(self), self->path);
+err_free_stats:
+    UCS_STATS_NODE_FREE(self->stats);
 err:
     return status;
 }
@@ -570,7 +1018,9 @@ static UCS_CLASS_CLEANUP_FUNC(uct_mm_iface_t)
 
     /* return all the descriptors that are now 'assigned' to the FIFO,
      * to their mpool */
-    uct_mm_iface_free_rx_descs(self, self->config.fifo_size);
+    uct_mm_iface_free_rx_descs(self, self->recv_fifo_elements,
+                               self->config.fifo_size);
+    uct_mm_iface_cleanup_rx_rings(self);
 
     ucs_mpool_put(self->last_recv_desc);
     ucs_mpool_cleanup(&self->recv_desc_mp, 1);
@@ -587,6 +1037,7 @@ static UCS_CLASS_CLEANUP_FUNC(uct_mm_iface_t)
     }
 
     ucs_arbiter_cleanup(&self->arbiter);
+    UCS_STATS_NODE_FREE(self->stats);
 }
 
 UCS_CLASS_DEFINE(uct_mm_iface_t, uct_base_iface_t);
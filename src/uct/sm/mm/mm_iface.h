@@ -24,20 +24,54 @@
 #define UCT_MM_TL_NAME "mm"
 #define UCT_MM_FIFO_CTL_SIZE_ALIGNED  ucs_align_up(sizeof(uct_mm_fifo_ctl_t),UCS_SYS_CACHE_LINE_SIZE)
 
-#define UCT_MM_GET_FIFO_SIZE(iface)  (UCS_SYS_CACHE_LINE_SIZE - 1 +  \
-                                      UCT_MM_FIFO_CTL_SIZE_ALIGNED + \
-                                     ((iface)->config.fifo_size *    \
-                                     (iface)->config.fifo_elem_size))
+#define UCT_MM_MAX_RINGS             63
+
+/* Size of a FIFO (or a sender ring) in the shared segment: control struct
+ * followed by the elements, aligned to a cache line */
+#define UCT_MM_FIFO_STRIDE(_fifo_size, _elem_size) \
+    (UCT_MM_FIFO_CTL_SIZE_ALIGNED + \
+     ucs_align_up((_fifo_size) * (_elem_size), UCS_SYS_CACHE_LINE_SIZE))
+
+/* The shared FIFO is followed by the single-producer sender rings */
+#define UCT_MM_FIFO_SEG_SIZE(_fifo_size, _elem_size, _num_rings) \
+    (UCS_SYS_CACHE_LINE_SIZE - 1 + \
+     (1 + (_num_rings)) * UCT_MM_FIFO_STRIDE(_fifo_size, _elem_size))
+
+#define UCT_MM_GET_FIFO_SIZE(iface) \
+    UCT_MM_FIFO_SEG_SIZE((iface)->config.fifo_size, \
+                         (iface)->config.fifo_elem_size, \
+                         (iface)->config.num_rings)
 
 
 typedef enum {
     UCT_MM_IFACE_SIGNAL_CONNECT    = 0,
+    UCT_MM_IFACE_SIGNAL_WAKEUP     = 1,
 } uct_mm_iface_conn_signal_t;
 
 
+/* Receive notification state of the shared FIFO */
+enum {
+    UCT_MM_ARM_STATE_DISABLED = 0,   /* no wakeup handle is open, senders do
+                                        not need to check the state */
+    UCT_MM_ARM_STATE_IDLE,           /* the receiver is polling */
+    UCT_MM_ARM_STATE_ARMED           /* the receiver is going to sleep, the
+                                        next sender has to notify it */
+};
+
+
+enum {
+    UCT_MM_IFACE_STAT_RX_POLL,       /* polls which received messages */
+    UCT_MM_IFACE_STAT_RX_ELEM,       /* received FIFO elements */
+    UCT_MM_IFACE_STAT_RX_FULL_BATCH, /* polls which stopped at RX_MAX_POLL */
+    UCT_MM_IFACE_STAT_LAST
+};
+
+
 typedef struct uct_mm_iface_config {
     uct_iface_config_t       super;
     unsigned                 fifo_size;            /* Size of the receive FIFO */
+    unsigned                 rx_max_poll;          /* Max FIFO elements per progress */
+    unsigned                 num_rings;            /* Number of single-producer rings */
     double                   release_fifo_factor;
     ucs_ternary_value_t      hugetlb_mode;         /* Enable using huge pages for */
                                                    /* shared memory buffers */
@@ -54,9 +88,28 @@ struct uct_mm_fifo_ctl {
 
     /* 2nd cacheline */
     volatile uint64_t  tail;       /* how much was read */
+    volatile uint64_t  ring_map;   /* bitmap of sender rings which were ever
+                                      attached (used only in the shared FIFO) */
+    volatile uint32_t  ring_owner; /* process id of the sender which owns
+                                      the ring, or 0 if it's free (used
+                                      only in sender rings) */
+    UCS_CACHELINE_PADDING(uint64_t, uint64_t, uint32_t);
+
+    /* 3rd cacheline, used only in the shared FIFO */
+    volatile uint32_t  arm_state;        /* receive notification state */
+    socklen_t          wakeup_addrlen;   /* address length of wakeup socket */
+    struct sockaddr_un wakeup_sockaddr;  /* address of wakeup socket */
 } UCS_S_PACKED;
 
 
+/* Receiver's view of a single-producer sender ring */
+typedef struct uct_mm_rx_ring {
+    uct_mm_fifo_ctl_t       *ctl;        /* ring head and tail */
+    void                    *elems;      /* first ring element */
+    uint64_t                read_index;  /* actual reading location */
+} uct_mm_rx_ring_t;
+
+
 struct uct_mm_iface {
     uct_base_iface_t        super;
 
@@ -82,6 +135,9 @@ struct uct_mm_iface {
     ucs_mpool_t             recv_desc_mp;
     uct_mm_recv_desc_t      *last_recv_desc;    /* next receive descriptor to use */
 
+    uct_mm_rx_ring_t        *rx_rings;          /* single-producer sender rings */
+    unsigned                rx_ring_next;       /* round-robin polling position */
+
     int                     signal_fd;        /* Unix socket for receiving remote signal */
 
     size_t                  rx_headroom;
@@ -96,7 +152,11 @@ struct uct_mm_iface {
         unsigned fifo_size;
         unsigned fifo_elem_size;
         unsigned seg_size;                    /* size of the receive descriptor (for payload)*/
+        unsigned rx_max_poll;                 /* max FIFO elements to read per progress */
+        unsigned num_rings;                   /* number of sender rings */
     } config;
+
+    UCS_STATS_NODE_DECLARE(stats);
 };
 
 
@@ -168,10 +228,28 @@ static inline void uct_mm_set_fifo_elems_ptr(void *mem_region, void **fifo_elems
    *fifo_elems = (void*) fifo_ctl + UCT_MM_FIFO_CTL_SIZE_ALIGNED;
 }
 
+/**
+ * Get the control struct of a sender ring, according to the control struct of
+ * the shared FIFO it follows.
+ */
+static inline uct_mm_fifo_ctl_t*
+uct_mm_get_ring_ctl(uct_mm_iface_t *iface, uct_mm_fifo_ctl_t *fifo_ctl,
+                    unsigned ring_index)
+{
+    return (uct_mm_fifo_ctl_t*)((char*)fifo_ctl +
+                                ((ring_index + 1) *
+                                 UCT_MM_FIFO_STRIDE(iface->config.fifo_size,
+                                                    iface->config.fifo_elem_size)));
+}
+
 void uct_mm_iface_release_desc(uct_recv_desc_t *self, void *desc);
+int uct_mm_iface_is_geometry_compatible(uct_mm_iface_t *iface,
+                                        const uct_mm_iface_addr_t *addr);
+ucs_status_t uct_mm_iface_send_wakeup(uct_mm_iface_t *iface,
+                                      uct_mm_fifo_ctl_t *fifo_ctl);
 ucs_status_t uct_mm_flush();
 
-void uct_mm_iface_progress(void *arg);
+unsigned uct_mm_iface_progress(void *arg);
 
 extern uct_tl_component_t uct_mm_tl;
 
@@ -6,24 +6,64 @@
 #ifndef UCT_TCP_MD_H
 #define UCT_TCP_MD_H
 
+#include <uct/base/uct_iface.h>
 #include <uct/base/uct_md.h>
 #include <ucs/datastruct/khash.h>
+#include <ucs/datastruct/list.h>
+#include <ucs/datastruct/queue.h>
 #include <net/if.h>
+#include <sys/uio.h>
 
 #define UCT_TCP_NAME "tcp"
 
+/* Maximal number of events to read from epoll in a single progress call */
+#define UCT_TCP_MAX_EVENTS        32
+
+/* Maximal number of user buffers in a zero-copy operation */
+#define UCT_TCP_MAX_IOV           16
+
+/* Maximal number of buffers gathered by a single sendmsg() call */
+#define UCT_TCP_MAX_SEND_IOV      64
+
 
 /** Hash of fd->rsock */
 typedef struct uct_tcp_recv_sock uct_tcp_recv_sock_t;
 KHASH_MAP_INIT_INT64(uct_tcp_fd_hash, uct_tcp_recv_sock_t*);
 
 
+/**
+ * TCP active message header, precedes every message on the stream
+ */
+typedef struct uct_tcp_am_hdr {
+    uint8_t                       am_id;          /* Active message ID */
+    uint32_t                      length;         /* Payload length */
+} UCS_S_PACKED uct_tcp_am_hdr_t;
+
+
+/**
+ * TCP send descriptor, followed by AM header and payload. Zero-copy sends keep
+ * only the headers in the descriptor, and refer to user buffers in the iov.
+ */
+typedef struct uct_tcp_tx_desc {
+    ucs_queue_elem_t              queue;          /* Element in endpoint TX queue */
+    uct_completion_t              *comp;          /* User completion, or NULL */
+    size_t                        length;         /* Total length to send */
+    size_t                        offset;         /* How much was already sent */
+    size_t                        iovcnt;         /* Number of buffers to send */
+    struct iovec                  iov[UCT_TCP_MAX_IOV + 1]; /* Buffers to send */
+} uct_tcp_tx_desc_t;
+
+
 /**
  * TCP endpoint
  */
 typedef struct uct_tcp_ep {
     uct_base_ep_t                 super;
     int                           fd;             /* Socket file descriptor */
+    ucs_queue_head_t              tx_queue;       /* Descriptors waiting to be sent */
+    unsigned                      tx_queue_len;   /* Number of descriptors in tx_queue */
+    ucs_queue_head_t              pending_q;      /* Pending operations */
+    ucs_list_link_t               list;           /* Element in iface TX list */
 } uct_tcp_ep_t;
 
 
@@ -32,15 +72,24 @@ typedef struct uct_tcp_ep {
  */
 typedef struct uct_tcp_iface {
     uct_base_iface_t              super;          /* Parent class */
-    ucs_mpool_t                   mp;             /* Memory pool for TX/RX buffers */
+    ucs_mpool_t                   mp;             /* Memory pool for TX buffers */
+    ucs_mpool_t                   rx_mp;          /* Memory pool for RX buffers */
     int                           listen_fd;      /* Server socket */
+    int                           epfd;           /* epoll fd for receive sockets */
     khash_t(uct_tcp_fd_hash)      fd_hash;        /* Hash table of all FDs */
+    ucs_list_link_t               tx_ep_list;     /* Endpoints with queued sends */
+    ucs_list_link_t               rx_ready_list;  /* Sockets with buffered messages */
     char                          if_name[IFNAMSIZ];/* Network interface name */
 
     struct {
         struct sockaddr_in        ifaddr;         /* Network address */
         struct sockaddr_in        netmask;        /* Network address mask */
+        size_t                    short_size;     /* Maximal short message size */
         size_t                    max_bcopy;      /* Maximal bcopy size */
+        size_t                    max_zcopy;      /* Maximal zcopy size */
+        size_t                    rx_buf_size;    /* Size of RX buffer */
+        unsigned                  tx_queue_len;   /* Max queued sends per endpoint */
+        unsigned                  rx_max_poll;    /* Max messages per progress */
         int                       prefer_default; /* prefer default gateway */
         ptrdiff_t                 am_hdr_offset;  /* offset to receive header */
         ptrdiff_t                 headroom_offset;/* offset to receive headroom */
@@ -60,13 +109,20 @@ typedef struct uct_tcp_iface_config {
     int                           prefer_default;
     unsigned                      backlog;
     int                           sockopt_nodelay;
+    size_t                        max_zcopy;
+    unsigned                      tx_queue_len;
+    unsigned                      rx_max_poll;
 } uct_tcp_iface_config_t;
 
 
 /**
- * TCP receive socket wrapper/
+ * TCP receive socket wrapper
  */
 struct uct_tcp_recv_sock {
+    int                           fd;             /* Socket file descriptor */
+    void                          *buf;           /* Partially received data */
+    size_t                        length;         /* How much data in the buffer */
+    ucs_list_link_t               list;           /* Element in iface RX ready list */
 };
 
 
@@ -77,6 +133,13 @@ ucs_status_t uct_tcp_socket_create(int *fd_p);
 
 ucs_status_t uct_tcp_socket_connect(int fd, const struct sockaddr_in *dest_addr);
 
+ucs_status_t uct_tcp_send(int fd, const void *data, size_t *length_p);
+
+ucs_status_t uct_tcp_recv(int fd, void *data, size_t *length_p);
+
+ucs_status_t uct_tcp_sendv(int fd, const struct iovec *iov, size_t iovcnt,
+                           size_t *length_p);
+
 int uct_tcp_netif_check(const char *if_name);
 
 ucs_status_t uct_tcp_netif_caps(const char *if_name, double *latency_p,
@@ -93,6 +156,31 @@ ucs_status_t uct_tcp_iface_connection_accepted(uct_tcp_iface_t *iface, int fd);
 
 void uct_tcp_iface_recv_cleanup(uct_tcp_iface_t *iface);
 
+unsigned uct_tcp_iface_recv_progress(uct_tcp_iface_t *iface);
+
+unsigned uct_tcp_iface_progress(void *arg);
+
+ucs_status_t uct_tcp_ep_am_short(uct_ep_h uct_ep, uint8_t am_id, uint64_t header,
+                                 const void *payload, unsigned length);
+
+ssize_t uct_tcp_ep_am_bcopy(uct_ep_h uct_ep, uint8_t am_id,
+                            uct_pack_callback_t pack_cb, void *arg);
+
+ucs_status_t uct_tcp_ep_am_zcopy(uct_ep_h uct_ep, uint8_t am_id,
+                                 const void *header, unsigned header_length,
+                                 const uct_iov_t *iov, size_t iovcnt,
+                                 uct_completion_t *comp);
+
+ucs_status_t uct_tcp_ep_pending_add(uct_ep_h tl_ep, uct_pending_req_t *req);
+
+void uct_tcp_ep_pending_purge(uct_ep_h tl_ep, uct_pending_purge_callback_t cb,
+                              void *arg);
+
+ucs_status_t uct_tcp_ep_flush(uct_ep_h tl_ep, unsigned flags,
+                              uct_completion_t *comp);
+
+void uct_tcp_ep_progress_tx(uct_tcp_ep_t *ep);
+
 UCS_CLASS_DECLARE_NEW_FUNC(uct_tcp_ep_t, uct_ep_t, uct_iface_t *,
                            const uct_device_addr_t *, const uct_iface_addr_t *);
 UCS_CLASS_DECLARE_DELETE_FUNC(uct_tcp_ep_t, uct_ep_t);
@@ -38,6 +38,21 @@ static UCS_CLASS_INIT_FUNC(uct_tcp_ep_t, uct_iface_t *tl_iface,
         goto err_close;
     }
 
+    /* Sends are never allowed to block the caller */
+    status = ucs_sys_fcntl_modfl(self->fd, O_NONBLOCK, 0);
+    if (status != UCS_OK) {
+        goto err_close;
+    }
+
+    ucs_queue_head_init(&self->tx_queue);
+    ucs_queue_head_init(&self->pending_q);
+    self->tx_queue_len = 0;
+    ucs_list_head_init(&self->list);
+
+    /* Register for send side progress */
+    uct_worker_progress_register(iface->super.worker, uct_tcp_iface_progress,
+                                 iface);
+
     ucs_debug("connected to %s:%d", inet_ntoa(dest_addr.sin_addr),
               ntohs(dest_addr.sin_port));
     return UCS_OK;
@@ -50,7 +65,23 @@ err:
 
 static UCS_CLASS_CLEANUP_FUNC(uct_tcp_ep_t)
 {
+    uct_tcp_iface_t *iface = ucs_derived_of(self->super.super.iface,
+                                            uct_tcp_iface_t);
+    uct_tcp_tx_desc_t *desc;
+
     ucs_trace_func("self=%p", self);
+
+    uct_tcp_ep_pending_purge(&self->super.super, NULL, NULL);
+
+    ucs_queue_for_each_extract(desc, &self->tx_queue, queue, 1) {
+        ucs_debug("ep %p: dropping %zu unsent bytes", self,
+                  desc->length - desc->offset);
+        ucs_mpool_put(desc);
+    }
+
+    ucs_list_del(&self->list);
+    uct_worker_progress_unregister(iface->super.worker, uct_tcp_iface_progress,
+                                   iface);
     close(self->fd);
 }
 
@@ -58,3 +89,396 @@ UCS_CLASS_DEFINE(uct_tcp_ep_t, uct_base_ep_t);
 UCS_CLASS_DEFINE_NEW_FUNC(uct_tcp_ep_t, uct_ep_t, uct_iface_t *,
                           const uct_device_addr_t *, const uct_iface_addr_t *);
 UCS_CLASS_DEFINE_DELETE_FUNC(uct_tcp_ep_t, uct_ep_t);
+
+static inline int uct_tcp_ep_is_tx_busy(uct_tcp_ep_t *ep)
+{
+    return !ucs_queue_is_empty(&ep->tx_queue);
+}
+
+/* Add the endpoint to the interface list of endpoints which need TX progress */
+static inline void uct_tcp_ep_tx_schedule(uct_tcp_iface_t *iface,
+                                          uct_tcp_ep_t *ep)
+{
+    if (ucs_list_is_empty(&ep->list)) {
+        ucs_list_add_tail(&iface->tx_ep_list, &ep->list);
+    }
+}
+
+static inline void uct_tcp_tx_desc_release(uct_tcp_tx_desc_t *desc,
+                                           ucs_status_t status)
+{
+    if (desc->comp != NULL) {
+        uct_invoke_completion(desc->comp, status);
+    }
+    ucs_mpool_put(desc);
+}
+
+/* Add the unsent buffers of a descriptor to an iov array */
+static size_t uct_tcp_tx_desc_fill_iov(uct_tcp_tx_desc_t *desc,
+                                       struct iovec *iov)
+{
+    size_t offset = desc->offset;
+    size_t i, iovcnt;
+
+    iovcnt = 0;
+    for (i = 0; i < desc->iovcnt; ++i) {
+        if (offset >= desc->iov[i].iov_len) {
+            offset -= desc->iov[i].iov_len;
+            continue;
+        }
+
+        iov[iovcnt].iov_base = desc->iov[i].iov_base + offset;
+        iov[iovcnt].iov_len  = desc->iov[i].iov_len  - offset;
+        offset               = 0;
+        ++iovcnt;
+    }
+
+    return iovcnt;
+}
+
+/* Release the descriptors whose data was sent */
+static void uct_tcp_ep_tx_complete(uct_tcp_ep_t *ep, size_t length)
+{
+    uct_tcp_tx_desc_t *desc;
+    size_t remainder;
+
+    while (length > 0) {
+        desc      = ucs_queue_head_elem_non_empty(&ep->tx_queue,
+                                                  uct_tcp_tx_desc_t, queue);
+        remainder = desc->length - desc->offset;
+        if (length < remainder) {
+            desc->offset += length;
+            break;
+        }
+
+        length -= remainder;
+        ucs_queue_pull_non_empty(&ep->tx_queue);
+        --ep->tx_queue_len;
+        uct_tcp_tx_desc_release(desc, UCS_OK);
+    }
+}
+
+/* Push as much queued data as the socket accepts, gathering all queued
+ * descriptors to a single system call. Return nonzero if the TX queue was
+ * drained. */
+static int uct_tcp_ep_flush_tx_queue(uct_tcp_ep_t *ep)
+{
+    struct iovec iov[UCT_TCP_MAX_SEND_IOV];
+    size_t iovcnt, length, send_length;
+    uct_tcp_tx_desc_t *desc;
+    ucs_status_t status;
+
+    while (!ucs_queue_is_empty(&ep->tx_queue)) {
+        iovcnt = 0;
+        length = 0;
+        ucs_queue_for_each(desc, &ep->tx_queue, queue) {
+            if (iovcnt + desc->iovcnt > UCT_TCP_MAX_SEND_IOV) {
+                break;
+            }
+            iovcnt += uct_tcp_tx_desc_fill_iov(desc, iov + iovcnt);
+            length += desc->length - desc->offset;
+        }
+
+        status = uct_tcp_sendv(ep->fd, iov, iovcnt, &send_length);
+        if (status != UCS_OK) {
+            /* The connection is broken, nothing more could be sent */
+            ucs_queue_for_each_extract(desc, &ep->tx_queue, queue, 1) {
+                uct_tcp_tx_desc_release(desc, status);
+            }
+            ep->tx_queue_len = 0;
+            return 1;
+        }
+
+        ucs_trace_data("ep %p: sent %zu out of %zu queued bytes", ep,
+                       send_length, length);
+        uct_tcp_ep_tx_complete(ep, send_length);
+        if (send_length < length) {
+            return 0; /* Socket buffer is full */
+        }
+    }
+
+    return 1;
+}
+
+/* Pending requests must not be overtaken by new sends */
+static inline int uct_tcp_ep_can_send(uct_tcp_iface_t *iface, uct_tcp_ep_t *ep)
+{
+    if (!ucs_queue_is_empty(&ep->pending_q)) {
+        return 0;
+    }
+
+    if (ep->tx_queue_len < iface->config.tx_queue_len) {
+        return 1;
+    }
+
+    uct_tcp_ep_flush_tx_queue(ep);
+    return ep->tx_queue_len < iface->config.tx_queue_len;
+}
+
+void uct_tcp_ep_progress_tx(uct_tcp_ep_t *ep)
+{
+    uct_tcp_iface_t *iface = ucs_derived_of(ep->super.super.iface,
+                                            uct_tcp_iface_t);
+    ucs_queue_head_t dispatch_q;
+    uct_pending_req_t *req;
+    ucs_status_t status;
+
+    if (!uct_tcp_ep_flush_tx_queue(ep)) {
+        return;
+    }
+
+    /* Dispatch pending requests as long as the socket accepts all data. The
+     * queue is detached during dispatch, so the requests would be able to
+     * send, while new operations still see a non-empty pending queue. */
+    ucs_queue_head_init(&dispatch_q);
+    ucs_queue_splice(&dispatch_q, &ep->pending_q);
+    while (!ucs_queue_is_empty(&dispatch_q) && !uct_tcp_ep_is_tx_busy(ep)) {
+        req    = ucs_queue_pull_elem_non_empty(&dispatch_q, uct_pending_req_t,
+                                               priv);
+        status = req->func(req);
+        if (status != UCS_OK) {
+            ucs_queue_push_head(&dispatch_q, &uct_pending_req_priv(req)->queue);
+            break;
+        }
+    }
+    ucs_queue_splice(&dispatch_q, &ep->pending_q);
+    ucs_queue_splice(&ep->pending_q, &dispatch_q);
+
+    if (!uct_tcp_ep_is_tx_busy(ep) && ucs_queue_is_empty(&ep->pending_q)) {
+        ucs_list_del(&ep->list);
+        ucs_list_head_init(&ep->list);
+    } else {
+        uct_tcp_ep_tx_schedule(iface, ep);
+    }
+}
+
+/* Get a TX descriptor, if the endpoint can send right now */
+static inline ucs_status_t uct_tcp_ep_get_tx_desc(uct_tcp_iface_t *iface,
+                                                  uct_tcp_ep_t *ep,
+                                                  uct_tcp_tx_desc_t **desc_p)
+{
+    uct_tcp_tx_desc_t *desc;
+
+    if (ucs_unlikely(!uct_tcp_ep_can_send(iface, ep))) {
+        UCS_STATS_UPDATE_COUNTER(ep->super.stats, UCT_EP_STAT_NO_RES, 1);
+        return UCS_ERR_NO_RESOURCE;
+    }
+
+    UCT_TL_IFACE_GET_TX_DESC(&iface->super, &iface->mp, desc,
+                             return UCS_ERR_NO_RESOURCE);
+    desc->comp            = NULL;
+    desc->offset          = 0;
+    desc->iovcnt          = 1;
+    desc->iov[0].iov_base = desc + 1;
+    *desc_p               = desc;
+    return UCS_OK;
+}
+
+/* Send a descriptor, or queue it if there is unsent data already. Returns
+ * UCS_INPROGRESS if the user completion would be invoked later. */
+static ucs_status_t uct_tcp_ep_send_desc(uct_tcp_iface_t *iface,
+                                         uct_tcp_ep_t *ep,
+                                         uct_tcp_tx_desc_t *desc)
+{
+    ucs_status_t status;
+    size_t send_length;
+
+    if (ucs_likely(!uct_tcp_ep_is_tx_busy(ep))) {
+        if (desc->iovcnt == 1) {
+            send_length = desc->length;
+            status      = uct_tcp_send(ep->fd, desc->iov[0].iov_base,
+                                       &send_length);
+        } else {
+            status      = uct_tcp_sendv(ep->fd, desc->iov, desc->iovcnt,
+                                        &send_length);
+        }
+        if (ucs_unlikely(status != UCS_OK)) {
+            ucs_mpool_put(desc);
+            return status;
+        }
+
+        if (ucs_likely(send_length == desc->length)) {
+            ucs_mpool_put(desc);
+            return UCS_OK;
+        }
+
+        desc->offset = send_length;
+    }
+
+    /* The rest would be sent from progress */
+    ucs_queue_push(&ep->tx_queue, &desc->queue);
+    ++ep->tx_queue_len;
+    uct_tcp_ep_tx_schedule(iface, ep);
+    return (desc->comp == NULL) ? UCS_OK : UCS_INPROGRESS;
+}
+
+ucs_status_t uct_tcp_ep_am_short(uct_ep_h uct_ep, uint8_t am_id, uint64_t header,
+                                 const void *payload, unsigned length)
+{
+    uct_tcp_ep_t *ep = ucs_derived_of(uct_ep, uct_tcp_ep_t);
+    uct_tcp_iface_t *iface = ucs_derived_of(uct_ep->iface, uct_tcp_iface_t);
+    uct_tcp_tx_desc_t *desc;
+    uct_tcp_am_hdr_t *hdr;
+    ucs_status_t status;
+
+    UCT_CHECK_LENGTH(length + sizeof(header), 0, iface->config.short_size,
+                     "am_short");
+    UCT_CHECK_AM_ID(am_id);
+
+    status = uct_tcp_ep_get_tx_desc(iface, ep, &desc);
+    if (status != UCS_OK) {
+        return status;
+    }
+
+    hdr         = (uct_tcp_am_hdr_t*)(desc + 1);
+    hdr->am_id  = am_id;
+    hdr->length = sizeof(header) + length;
+    memcpy(hdr + 1, &header, sizeof(header));
+    memcpy((void*)(hdr + 1) + sizeof(header), payload, length);
+
+    uct_iface_trace_am(&iface->super, UCT_AM_TRACE_TYPE_SEND, am_id, hdr + 1,
+                       hdr->length, "TX: AM_SHORT");
+    UCT_TL_EP_STAT_OP(&ep->super, AM, SHORT, hdr->length);
+
+    desc->length         = sizeof(*hdr) + hdr->length;
+    desc->iov[0].iov_len = desc->length;
+    return uct_tcp_ep_send_desc(iface, ep, desc);
+}
+
+ssize_t uct_tcp_ep_am_bcopy(uct_ep_h uct_ep, uint8_t am_id,
+                            uct_pack_callback_t pack_cb, void *arg)
+{
+    uct_tcp_ep_t *ep = ucs_derived_of(uct_ep, uct_tcp_ep_t);
+    uct_tcp_iface_t *iface = ucs_derived_of(uct_ep->iface, uct_tcp_iface_t);
+    uct_tcp_tx_desc_t *desc;
+    uct_tcp_am_hdr_t *hdr;
+    ucs_status_t status;
+    size_t length;
+
+    UCT_CHECK_AM_ID(am_id);
+
+    status = uct_tcp_ep_get_tx_desc(iface, ep, &desc);
+    if (status != UCS_OK) {
+        return status;
+    }
+
+    hdr         = (uct_tcp_am_hdr_t*)(desc + 1);
+    hdr->am_id  = am_id;
+    length      = pack_cb(hdr + 1, arg);
+    hdr->length = length;
+    ucs_assert(length <= iface->config.max_bcopy);
+
+    uct_iface_trace_am(&iface->super, UCT_AM_TRACE_TYPE_SEND, am_id, hdr + 1,
+                       length, "TX: AM_BCOPY");
+    UCT_TL_EP_STAT_OP(&ep->super, AM, BCOPY, length);
+
+    desc->length         = sizeof(*hdr) + length;
+    desc->iov[0].iov_len = desc->length;
+    status = uct_tcp_ep_send_desc(iface, ep, desc);
+    if (status != UCS_OK) {
+        return status;
+    }
+
+    return length;
+}
+
+ucs_status_t uct_tcp_ep_am_zcopy(uct_ep_h uct_ep, uint8_t am_id,
+                                 const void *header, unsigned header_length,
+                                 const uct_iov_t *iov, size_t iovcnt,
+                                 uct_completion_t *comp)
+{
+    uct_tcp_ep_t *ep = ucs_derived_of(uct_ep, uct_tcp_ep_t);
+    uct_tcp_iface_t *iface = ucs_derived_of(uct_ep->iface, uct_tcp_iface_t);
+    uct_tcp_tx_desc_t *desc;
+    uct_tcp_am_hdr_t *hdr;
+    ucs_status_t status;
+    size_t i, length;
+
+    UCT_CHECK_IOV_SIZE(iovcnt, (size_t)UCT_TCP_MAX_IOV, "uct_tcp_ep_am_zcopy");
+    UCT_CHECK_LENGTH(header_length, 0, iface->config.max_bcopy,
+                     "am_zcopy header");
+    UCT_CHECK_LENGTH(uct_iov_total_length(iov, iovcnt), 0,
+                     iface->config.max_zcopy, "am_zcopy");
+    UCT_CHECK_AM_ID(am_id);
+
+    status = uct_tcp_ep_get_tx_desc(iface, ep, &desc);
+    if (status != UCS_OK) {
+        return status;
+    }
+
+    /* Only the headers are copied, the payload is sent from user buffers */
+    hdr = (uct_tcp_am_hdr_t*)(desc + 1);
+    hdr->am_id = am_id;
+    memcpy(hdr + 1, header, header_length);
+    desc->iov[0].iov_len = sizeof(*hdr) + header_length;
+    length               = header_length;
+    for (i = 0; i < iovcnt; ++i) {
+        desc->iov[desc->iovcnt].iov_len = uct_iov_get_length(&iov[i]);
+        if (desc->iov[desc->iovcnt].iov_len == 0) {
+            continue;
+        }
+        desc->iov[desc->iovcnt].iov_base = iov[i].buffer;
+        length += desc->iov[desc->iovcnt].iov_len;
+        ++desc->iovcnt;
+    }
+    hdr->length  = length;
+    desc->length = sizeof(*hdr) + length;
+    desc->comp   = comp;
+
+    uct_iface_trace_am(&iface->super, UCT_AM_TRACE_TYPE_SEND, am_id, hdr + 1,
+                       header_length, "TX: AM_ZCOPY");
+    UCT_TL_EP_STAT_OP(&ep->super, AM, ZCOPY, length);
+
+    return uct_tcp_ep_send_desc(iface, ep, desc);
+}
+
+ucs_status_t uct_tcp_ep_pending_add(uct_ep_h tl_ep, uct_pending_req_t *req)
+{
+    uct_tcp_ep_t *ep = ucs_derived_of(tl_ep, uct_tcp_ep_t);
+    uct_tcp_iface_t *iface = ucs_derived_of(tl_ep->iface, uct_tcp_iface_t);
+
+    /* check if resources became available */
+    if (uct_tcp_ep_can_send(iface, ep)) {
+        return UCS_ERR_BUSY;
+    }
+
+    uct_pending_req_push(&ep->pending_q, req);
+    uct_tcp_ep_tx_schedule(iface, ep);
+    return UCS_OK;
+}
+
+void uct_tcp_ep_pending_purge(uct_ep_h tl_ep, uct_pending_purge_callback_t cb,
+                              void *arg)
+{
+    uct_tcp_ep_t *ep = ucs_derived_of(tl_ep, uct_tcp_ep_t);
+    uct_pending_req_t *req;
+
+    ucs_queue_for_each_extract(req, &ep->pending_q, priv, 1) {
+        if (cb != NULL) {
+            cb(req, arg);
+        } else {
+            ucs_warn("ep=%p canceling user pending request %p", ep, req);
+        }
+    }
+}
+
+ucs_status_t uct_tcp_ep_flush(uct_ep_h tl_ep, unsigned flags,
+                              uct_completion_t *comp)
+{
+    uct_tcp_ep_t *ep = ucs_derived_of(tl_ep, uct_tcp_ep_t);
+
+    /* Pending sends were issued before the flush, so it can't complete until
+     * they were sent */
+    if (!ucs_queue_is_empty(&ep->pending_q)) {
+        UCT_TL_EP_STAT_FLUSH_WAIT(&ep->super);
+        return UCS_ERR_NO_RESOURCE;
+    }
+
+    if (uct_tcp_ep_is_tx_busy(ep) && !uct_tcp_ep_flush_tx_queue(ep)) {
+        UCT_TL_EP_STAT_FLUSH_WAIT(&ep->super);
+        return UCS_ERR_NO_RESOURCE;
+    }
+
+    UCT_TL_EP_STAT_FLUSH(&ep->super);
+    return UCS_OK;
+}
@@ -8,6 +8,7 @@
 #include <ucs/async/async.h>
 #include <ucs/sys/string.h>
 #include <sys/socket.h>
+#include <sys/epoll.h>
 #include <sys/poll.h>
 #include <netinet/tcp.h>
 #include <dirent.h>
@@ -31,6 +32,19 @@ static ucs_config_field_t uct_tcp_iface_config_table[] = {
    "option usually provides better performance",
    ucs_offsetof(uct_tcp_iface_config_t, sockopt_nodelay), UCS_CONFIG_TYPE_BOOL},
 
+  {"MAX_ZCOPY", "64k",
+   "Maximal size of zero-copy active message payload",
+   ucs_offsetof(uct_tcp_iface_config_t, max_zcopy), UCS_CONFIG_TYPE_MEMUNITS},
+
+  {"TX_QUEUE_LEN", "64",
+   "Maximal number of sends which may be queued on an endpoint while the socket\n"
+   "buffer is full. Queued sends are gathered to a single system call.",
+   ucs_offsetof(uct_tcp_iface_config_t, tx_queue_len), UCS_CONFIG_TYPE_UINT},
+
+  {"RX_MAX_POLL", "16",
+   "Max number of active messages to dispatch during RX poll",
+   ucs_offsetof(uct_tcp_iface_config_t, rx_max_poll), UCS_CONFIG_TYPE_UINT},
+
   {NULL}
 };
 
@@ -75,9 +89,17 @@ static ucs_status_t uct_tcp_iface_query(uct_iface_h tl_iface, uct_iface_attr_t *
     attr->iface_addr_len   = sizeof(in_port_t);
     attr->device_addr_len  = sizeof(struct in_addr);
     attr->cap.flags        = UCT_IFACE_FLAG_CONNECT_TO_IFACE |
+                             UCT_IFACE_FLAG_AM_SHORT |
+                             UCT_IFACE_FLAG_AM_BCOPY |
+                             UCT_IFACE_FLAG_AM_ZCOPY |
+                             UCT_IFACE_FLAG_AM_CB_SYNC |
                              UCT_IFACE_FLAG_PENDING;
 
+    attr->cap.am.max_short = iface->config.short_size;
     attr->cap.am.max_bcopy = iface->config.max_bcopy;
+    attr->cap.am.max_zcopy = iface->config.max_zcopy;
+    attr->cap.am.max_hdr   = iface->config.max_bcopy;
+    attr->cap.am.max_iov   = UCT_TCP_MAX_IOV;
 
     status = uct_tcp_netif_caps(iface->if_name, &attr->latency.overhead,
                                 &attr->bandwidth);
@@ -127,6 +149,39 @@ static void uct_tcp_iface_connect_handler(int fd, void *arg)
     uct_tcp_iface_connection_accepted(iface, sockfd);
 }
 
+unsigned uct_tcp_iface_progress(void *arg)
+{
+    uct_tcp_iface_t *iface = arg;
+    uct_tcp_ep_t *ep, *tmp;
+    unsigned count;
+
+    count = uct_tcp_iface_recv_progress(iface);
+
+    ucs_list_for_each_safe(ep, tmp, &iface->tx_ep_list, list) {
+        uct_tcp_ep_progress_tx(ep);
+    }
+
+    return count;
+}
+
+static ucs_status_t uct_tcp_iface_flush(uct_iface_h tl_iface, unsigned flags,
+                                        uct_completion_t *comp)
+{
+    uct_tcp_iface_t *iface = ucs_derived_of(tl_iface, uct_tcp_iface_t);
+
+    if (comp != NULL) {
+        return UCS_ERR_UNSUPPORTED;
+    }
+
+    if (!ucs_list_is_empty(&iface->tx_ep_list)) {
+        UCT_TL_IFACE_STAT_FLUSH_WAIT(&iface->super);
+        return UCS_INPROGRESS;
+    }
+
+    UCT_TL_IFACE_STAT_FLUSH(&iface->super);
+    return UCS_OK;
+}
+
 ucs_status_t uct_tcp_iface_set_sockopt(uct_tcp_iface_t *iface, int fd)
 {
     int ret;
@@ -147,10 +202,15 @@ static uct_iface_ops_t uct_tcp_iface_ops = {
     .iface_get_address        = uct_tcp_iface_get_address,
     .iface_query              = uct_tcp_iface_query,
     .iface_is_reachable       = uct_tcp_iface_is_reachable,
+    .iface_flush              = uct_tcp_iface_flush,
     .ep_create_connected      = UCS_CLASS_NEW_FUNC_NAME(uct_tcp_ep_t),
     .ep_destroy               = UCS_CLASS_DELETE_FUNC_NAME(uct_tcp_ep_t),
-    .ep_pending_add           = ucs_empty_function_return_busy,
-    .ep_pending_purge         = ucs_empty_function,
+    .ep_am_short              = uct_tcp_ep_am_short,
+    .ep_am_bcopy              = uct_tcp_ep_am_bcopy,
+    .ep_am_zcopy              = uct_tcp_ep_am_zcopy,
+    .ep_pending_add           = uct_tcp_ep_pending_add,
+    .ep_pending_purge         = uct_tcp_ep_pending_purge,
+    .ep_flush                 = uct_tcp_ep_flush,
 };
 
 static ucs_mpool_ops_t uct_tcp_mpool_ops = {
@@ -176,10 +236,20 @@ static UCS_CLASS_INIT_FUNC(uct_tcp_iface_t, uct_md_h md, uct_worker_h worker,
 
     ucs_strncpy_zero(self->if_name, params->dev_name, sizeof(self->if_name));
     self->config.max_bcopy       = config->super.max_bcopy;
+    self->config.short_size      = ucs_min(config->super.max_short,
+                                           config->super.max_bcopy);
+    self->config.max_zcopy       = config->max_zcopy;
+    self->config.rx_buf_size     = sizeof(uct_tcp_am_hdr_t) +
+                                   self->config.max_bcopy +
+                                   self->config.max_zcopy;
+    self->config.tx_queue_len    = ucs_max(config->tx_queue_len, 1);
     self->config.prefer_default  = config->prefer_default;
+    self->config.rx_max_poll     = ucs_max(config->rx_max_poll, 1);
     self->sockopt.nodelay        = config->sockopt_nodelay;
 
     kh_init_inplace(uct_tcp_fd_hash, &self->fd_hash);
+    ucs_list_head_init(&self->tx_ep_list);
+    ucs_list_head_init(&self->rx_ready_list);
 
     status = uct_tcp_netif_inaddr(self->if_name, &self->config.ifaddr,
                                   &self->config.netmask);
@@ -188,21 +258,44 @@ static UCS_CLASS_INIT_FUNC(uct_tcp_iface_t, uct_md_h md, uct_worker_h worker,
     }
 
     status = ucs_mpool_init(&self->mp, 0,
-                            self->config.max_bcopy,
+                            sizeof(uct_tcp_tx_desc_t) +
+                            sizeof(uct_tcp_am_hdr_t) + self->config.max_bcopy,
                             0,                        /* alignment offset */
                             UCS_SYS_CACHE_LINE_SIZE,  /* alignment */
                             32,                       /* grow */
                             -1,                       /* max buffers */
+                            0,                        /* flags */
                             &uct_tcp_mpool_ops,
                             "tcp_desc");
     if (status != UCS_OK) {
         goto err;
     }
 
+    status = ucs_mpool_init(&self->rx_mp, 0,
+                            self->config.rx_buf_size,
+                            0,                        /* alignment offset */
+                            UCS_SYS_CACHE_LINE_SIZE,  /* alignment */
+                            8,                        /* grow */
+                            -1,                       /* max buffers */
+                            0,                        /* flags */
+                            &uct_tcp_mpool_ops,
+                            "tcp_recv_buf");
+    if (status != UCS_OK) {
+        goto err_mpool_cleanup;
+    }
+
+    /* Create the epoll set for polling receive sockets */
+    self->epfd = epoll_create(1);
+    if (self->epfd < 0) {
+        ucs_error("epoll_create() failed: %m");
+        status = UCS_ERR_IO_ERROR;
+        goto err_rx_mpool_cleanup;
+    }
+
     /* Create the server socket for accepting incoming connections */
     status = uct_tcp_socket_create(&self->listen_fd);
     if (status != UCS_OK) {
-        goto err_mpool_cleanup;
+        goto err_close_epfd;
     }
 
     /* Set the server socket to non-blocking mode */
@@ -253,6 +346,10 @@ static UCS_CLASS_INIT_FUNC(uct_tcp_iface_t, uct_md_h md, uct_worker_h worker,
 
 err_close_sock:
     close(self->listen_fd);
+err_close_epfd:
+    close(self->epfd);
+err_rx_mpool_cleanup:
+    ucs_mpool_cleanup(&self->rx_mp, 0);
 err_mpool_cleanup:
     ucs_mpool_cleanup(&self->mp, 0);
 err:
@@ -268,8 +365,13 @@ static UCS_CLASS_CLEANUP_FUNC(uct_tcp_iface_t)
         ucs_warn("failed to remove handler for server socket fd=%d", self->listen_fd);
     }
 
+    ucs_callbackq_remove_all(&self->super.worker->progress_q,
+                             uct_tcp_iface_progress, self);
+
     uct_tcp_iface_recv_cleanup(self);
     close(self->listen_fd);
+    close(self->epfd);
+    ucs_mpool_cleanup(&self->rx_mp, 1);
     ucs_mpool_cleanup(&self->mp, 1);
     kh_destroy_inplace(uct_tcp_fd_hash, &self->fd_hash);
 }
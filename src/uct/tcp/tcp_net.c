@@ -46,6 +46,67 @@ ucs_status_t uct_tcp_socket_connect(int fd, const struct sockaddr_in *dest_addr)
     return UCS_OK;
 }
 
+static ucs_status_t uct_tcp_do_io(int fd, void *data, size_t *length_p,
+                                  uct_tcp_io_func_t io_func, const char *name)
+{
+    ssize_t ret;
+
+    ucs_assert(*length_p > 0);
+    ret = io_func(fd, data, *length_p, MSG_NOSIGNAL);
+    if (ret == 0) {
+        ucs_trace("fd %d is closed", fd);
+        return UCS_ERR_CANCELED; /* Connection closed */
+    } else if (ret < 0) {
+        if ((errno == EINTR) || (errno == EAGAIN)) {
+            *length_p = 0;
+            return UCS_OK;
+        }
+
+        ucs_error("%s(fd=%d data=%p length=%zu) failed: %m", name, fd, data,
+                  *length_p);
+        return UCS_ERR_IO_ERROR;
+    }
+
+    *length_p = ret;
+    return UCS_OK;
+}
+
+ucs_status_t uct_tcp_send(int fd, const void *data, size_t *length_p)
+{
+    return uct_tcp_do_io(fd, (void*)data, length_p, (uct_tcp_io_func_t)send,
+                         "send");
+}
+
+ucs_status_t uct_tcp_recv(int fd, void *data, size_t *length_p)
+{
+    return uct_tcp_do_io(fd, data, length_p, recv, "recv");
+}
+
+ucs_status_t uct_tcp_sendv(int fd, const struct iovec *iov, size_t iovcnt,
+                           size_t *length_p)
+{
+    struct msghdr msg;
+    ssize_t ret;
+
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov    = (struct iovec*)iov;
+    msg.msg_iovlen = iovcnt;
+
+    ret = sendmsg(fd, &msg, MSG_NOSIGNAL);
+    if (ret < 0) {
+        if ((errno == EINTR) || (errno == EAGAIN)) {
+            *length_p = 0;
+            return UCS_OK;
+        }
+
+        ucs_error("sendmsg(fd=%d iovcnt=%zu) failed: %m", fd, iovcnt);
+        return UCS_ERR_IO_ERROR;
+    }
+
+    *length_p = ret;
+    return UCS_OK;
+}
+
 static ucs_status_t uct_tcp_netif_ioctl(const char *if_name, unsigned long request,
                                         struct ifreq *if_req)
 {
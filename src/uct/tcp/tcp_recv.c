@@ -7,6 +7,7 @@
 #include "tcp.h"
 
 #include <ucs/async/async.h>
+#include <sys/epoll.h>
 #include <sys/poll.h>
 
 
@@ -36,8 +37,11 @@ static ucs_status_t uct_tcp_iface_recv_sock_add(uct_tcp_iface_t *iface, int fd,
 
 ucs_status_t uct_tcp_iface_connection_accepted(uct_tcp_iface_t *iface, int fd)
 {
+    struct epoll_event event;
     uct_tcp_recv_sock_t *rsock;
     ucs_status_t status;
+    khiter_t hash_it;
+    int ret;
 
     status = ucs_sys_fcntl_modfl(fd, O_NONBLOCK, 0);
     if (status != UCS_OK) {
@@ -56,13 +60,34 @@ ucs_status_t uct_tcp_iface_connection_accepted(uct_tcp_iface_t *iface, int fd)
         goto err_close;
     }
 
+    rsock->fd     = fd;
+    rsock->buf    = NULL;
+    rsock->length = 0;
+    ucs_list_head_init(&rsock->list);
+
     status = uct_tcp_iface_recv_sock_add(iface, fd, rsock);
     if (status != UCS_OK) {
         goto err_free;
     }
 
+    memset(&event, 0, sizeof(event));
+    event.events   = EPOLLIN;
+    event.data.ptr = rsock;
+    ret = epoll_ctl(iface->epfd, EPOLL_CTL_ADD, fd, &event);
+    if (ret < 0) {
+        ucs_error("epoll_ctl(epfd=%d, ADD, fd=%d) failed: %m", iface->epfd, fd);
+        status = UCS_ERR_IO_ERROR;
+        goto err_hash_del;
+    }
+
+    /* Start polling the new connection */
+    ucs_callbackq_add_safe(&iface->super.worker->progress_q,
+                           uct_tcp_iface_progress, iface);
     return UCS_OK;
 
+err_hash_del:
+    hash_it = kh_get(uct_tcp_fd_hash, &iface->fd_hash, fd);
+    kh_del(uct_tcp_fd_hash, &iface->fd_hash, hash_it);
 err_free:
     ucs_free(rsock);
 err_close:
@@ -74,10 +99,163 @@ static void uct_tcp_iface_recv_sock_destroy(uct_tcp_iface_t *iface,
                                             uct_tcp_recv_sock_t *rsock, int fd,
                                             int sync)
 {
+    int ret;
+
+    ret = epoll_ctl(iface->epfd, EPOLL_CTL_DEL, fd, NULL);
+    if (ret < 0) {
+        ucs_warn("epoll_ctl(epfd=%d, DEL, fd=%d) failed: %m", iface->epfd, fd);
+    }
+
+    if (rsock->buf != NULL) {
+        ucs_mpool_put(rsock->buf);
+    }
+
+    ucs_list_del(&rsock->list);
     ucs_free(rsock);
     close(fd);
 }
 
+/* Remote side has closed the connection, or it is broken */
+static void uct_tcp_iface_recv_sock_close(uct_tcp_iface_t *iface,
+                                          uct_tcp_recv_sock_t *rsock)
+{
+    khiter_t hash_it;
+    int fd = rsock->fd;
+
+    ucs_debug("tcp_iface %p: closing rsock %d", iface, fd);
+
+    UCS_ASYNC_BLOCK(iface->super.worker->async);
+    hash_it = kh_get(uct_tcp_fd_hash, &iface->fd_hash, fd);
+    ucs_assert_always(hash_it != kh_end(&iface->fd_hash));
+    kh_del(uct_tcp_fd_hash, &iface->fd_hash, hash_it);
+    UCS_ASYNC_UNBLOCK(iface->super.worker->async);
+
+    uct_tcp_iface_recv_sock_destroy(iface, rsock, fd, 0);
+    uct_worker_progress_unregister(iface->super.worker, uct_tcp_iface_progress,
+                                   iface);
+}
+
+static inline int uct_tcp_recv_sock_has_msg(uct_tcp_recv_sock_t *rsock,
+                                            size_t offset)
+{
+    uct_tcp_am_hdr_t *hdr = rsock->buf + offset;
+    size_t remainder      = rsock->length - offset;
+
+    return (remainder >= sizeof(*hdr)) &&
+           (remainder >= sizeof(*hdr) + hdr->length);
+}
+
+/* Dispatch complete messages from the receive buffer, up to the RX poll limit,
+ * and move the remaining data to the beginning of the buffer */
+static void uct_tcp_recv_sock_dispatch(uct_tcp_iface_t *iface,
+                                       uct_tcp_recv_sock_t *rsock,
+                                       unsigned *count_p)
+{
+    uct_tcp_am_hdr_t *hdr;
+    size_t offset;
+
+    offset = 0;
+    while ((*count_p < iface->config.rx_max_poll) &&
+           uct_tcp_recv_sock_has_msg(rsock, offset)) {
+        hdr = rsock->buf + offset;
+        ucs_assert(sizeof(*hdr) + hdr->length <= iface->config.rx_buf_size);
+
+        uct_iface_trace_am(&iface->super, UCT_AM_TRACE_TYPE_RECV, hdr->am_id,
+                           hdr + 1, hdr->length, "RX: AM");
+        uct_iface_invoke_am(&iface->super, hdr->am_id, hdr + 1, hdr->length, 0);
+        offset += sizeof(*hdr) + hdr->length;
+        ++(*count_p);
+    }
+
+    if (offset == rsock->length) {
+        /* Don't hold a buffer for idle connections */
+        ucs_mpool_put(rsock->buf);
+        rsock->buf    = NULL;
+        rsock->length = 0;
+        return;
+    }
+
+    if (offset > 0) {
+        rsock->length -= offset;
+        memmove(rsock->buf, rsock->buf + offset, rsock->length);
+    }
+
+    /* The socket may have no more data to wake up epoll, so remember to
+     * dispatch the rest of buffered messages in the next progress call */
+    if (uct_tcp_recv_sock_has_msg(rsock, 0)) {
+        ucs_list_add_tail(&iface->rx_ready_list, &rsock->list);
+    }
+}
+
+static void uct_tcp_recv_sock_progress(uct_tcp_iface_t *iface,
+                                       uct_tcp_recv_sock_t *rsock,
+                                       unsigned *count_p)
+{
+    ucs_status_t status;
+    size_t recv_length;
+
+    if (rsock->buf == NULL) {
+        UCT_TL_IFACE_GET_RX_DESC(&iface->super, &iface->rx_mp, rsock->buf,
+                                 return);
+        rsock->length = 0;
+    }
+
+    recv_length = iface->config.rx_buf_size - rsock->length;
+    status      = uct_tcp_recv(rsock->fd, rsock->buf + rsock->length,
+                               &recv_length);
+    if (status != UCS_OK) {
+        uct_tcp_iface_recv_sock_close(iface, rsock);
+        return;
+    }
+
+    ucs_trace_data("rsock %d: received %zu bytes", rsock->fd, recv_length);
+    rsock->length += recv_length;
+    uct_tcp_recv_sock_dispatch(iface, rsock, count_p);
+}
+
+unsigned uct_tcp_iface_recv_progress(uct_tcp_iface_t *iface)
+{
+    struct epoll_event events[UCT_TCP_MAX_EVENTS];
+    uct_tcp_recv_sock_t *rsock, *tmp;
+    int i, nevents;
+    unsigned count;
+
+    count = 0;
+
+    /* Messages which were left in the buffers by previous calls go first */
+    ucs_list_for_each_safe(rsock, tmp, &iface->rx_ready_list, list) {
+        if (count >= iface->config.rx_max_poll) {
+            return count;
+        }
+
+        ucs_list_del(&rsock->list);
+        ucs_list_head_init(&rsock->list);
+        uct_tcp_recv_sock_dispatch(iface, rsock, &count);
+    }
+
+    if (count >= iface->config.rx_max_poll) {
+        return count;
+    }
+
+    nevents = epoll_wait(iface->epfd, events, UCT_TCP_MAX_EVENTS, 0);
+    if (ucs_unlikely(nevents < 0)) {
+        if (errno != EINTR) {
+            ucs_error("epoll_wait(epfd=%d) failed: %m", iface->epfd);
+        }
+        return count;
+    }
+
+    /* Sockets which are not read now would be reported again by epoll */
+    for (i = 0; (i < nevents) && (count < iface->config.rx_max_poll); ++i) {
+        rsock = events[i].data.ptr;
+        if (ucs_list_is_empty(&rsock->list)) {
+            uct_tcp_recv_sock_progress(iface, rsock, &count);
+        }
+    }
+
+    return count;
+}
+
 void uct_tcp_iface_recv_cleanup(uct_tcp_iface_t *iface)
 {
     uct_tcp_recv_sock_t *rsock;
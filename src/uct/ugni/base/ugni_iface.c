@@ -28,13 +28,14 @@ void uct_ugni_base_desc_key_init(uct_iface_h iface, void *obj, uct_mem_h memh)
   base->desc.local_mem_hndl = *(gni_mem_handle_t *)memh;
 }
 
-void uct_ugni_progress(void *arg)
+unsigned uct_ugni_progress(void *arg)
 {
     gni_cq_entry_t  event_data = 0;
     gni_post_descriptor_t *event_post_desc_ptr;
     uct_ugni_base_desc_t *desc;
     uct_ugni_iface_t * iface = (uct_ugni_iface_t *)arg;
     gni_return_t ugni_rc;
+    unsigned count = 0;
 
     ugni_rc = GNI_CqGetEvent(iface->local_cq, &event_data);
     if (GNI_RC_NOT_DONE == ugni_rc) {
@@ -44,14 +45,14 @@ void uct_ugni_progress(void *arg)
     if ((GNI_RC_SUCCESS != ugni_rc && !event_data) || GNI_CQ_OVERRUN(event_data)) {
         ucs_error("GNI_CqGetEvent falied. Error status %s %d ",
                   gni_err_str[ugni_rc], ugni_rc);
-        return;
+        return 0;
     }
 
     ugni_rc = GNI_GetCompleted(iface->local_cq, event_data, &event_post_desc_ptr);
     if (GNI_RC_SUCCESS != ugni_rc && GNI_RC_TRANSACTION_ERROR != ugni_rc) {
         ucs_error("GNI_GetCompleted falied. Error status %s %d %d",
                   gni_err_str[ugni_rc], ugni_rc, GNI_RC_TRANSACTION_ERROR);
-        return;
+        return 0;
     }
 
     desc = (uct_ugni_base_desc_t *)event_post_desc_ptr;
@@ -68,11 +69,12 @@ void uct_ugni_progress(void *arg)
     }
 
     uct_ugni_ep_check_flush(desc->ep);
+    count = 1;
 
 out:
     /* have a go a processing the pending queue */
     ucs_arbiter_dispatch(&iface->arbiter, 1, uct_ugni_ep_process_pending, NULL);
-    return;
+    return count;
 }
 
 ucs_status_t uct_ugni_iface_flush(uct_iface_h tl_iface, unsigned flags,
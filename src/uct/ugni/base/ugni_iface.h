@@ -22,7 +22,7 @@ ucs_status_t uct_ugni_ep_flush(uct_ep_h tl_ep, unsigned flags,
 ucs_status_t uct_ugni_iface_get_address(uct_iface_h tl_iface, uct_iface_addr_t *addr);
 int uct_ugni_iface_is_reachable(uct_iface_h tl_iface, const uct_device_addr_t *dev_addr, 
 				const uct_iface_addr_t *iface_addr);
-void uct_ugni_progress(void *arg);
+unsigned uct_ugni_progress(void *arg);
 ucs_status_t ugni_activate_iface(uct_ugni_iface_t *iface);
 ucs_status_t ugni_deactivate_iface(uct_ugni_iface_t *iface);
 ucs_status_t uct_ugni_init_nic(int device_index,
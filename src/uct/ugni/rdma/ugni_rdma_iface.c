@@ -207,6 +207,7 @@ static UCS_CLASS_INIT_FUNC(uct_ugni_rdma_iface_t, uct_md_h md, uct_worker_h work
                             UCS_SYS_CACHE_LINE_SIZE,      /* alignment */
                             128,                          /* grow */
                             config->mpool.max_bufs,       /* max buffers */
+                            0,                            /* flags */
                             &uct_ugni_rdma_desc_mpool_ops,
                             "UGNI-DESC-ONLY");
     if (UCS_OK != status) {
@@ -221,6 +222,7 @@ static UCS_CLASS_INIT_FUNC(uct_ugni_rdma_iface_t, uct_md_h md, uct_worker_h work
                             UCS_SYS_CACHE_LINE_SIZE,      /* alignment */
                             128 ,                         /* grow */
                             config->mpool.max_bufs,       /* max buffers */
+                            0,                            /* flags */
                             &uct_ugni_rdma_desc_mpool_ops,
                             "UGNI-GET-DESC-ONLY");
     if (UCS_OK != status) {
@@ -235,6 +237,7 @@ static UCS_CLASS_INIT_FUNC(uct_ugni_rdma_iface_t, uct_md_h md, uct_worker_h work
                             UCS_SYS_CACHE_LINE_SIZE,      /* alignment */
                             128 ,                         /* grow */
                             config->mpool.max_bufs,       /* max buffers */
+                            0,                            /* flags */
                             &uct_ugni_rdma_desc_mpool_ops,
                             "UGNI-DESC-BUFFER");
     if (UCS_OK != status) {
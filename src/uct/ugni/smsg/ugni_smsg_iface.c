@@ -161,22 +161,23 @@ ucs_status_t progress_remote_cq(uct_ugni_smsg_iface_t *iface)
 
 UCS_CLASS_DEFINE_DELETE_FUNC(uct_ugni_smsg_iface_t, uct_iface_t);
 
-static void uct_ugni_smsg_progress(void *arg)
+static unsigned uct_ugni_smsg_progress(void *arg)
 {
     uct_ugni_smsg_iface_t *iface = (uct_ugni_smsg_iface_t *)arg;
-    ucs_status_t status;
+    unsigned count = 0;
 
-    do {
-        status = progress_local_cq(iface);
-    } while(status == UCS_INPROGRESS);
-    do {
-         status = progress_remote_cq(iface);
-    } while(status == UCS_INPROGRESS);
+    while (progress_local_cq(iface) == UCS_INPROGRESS) {
+        ++count;
+    }
+    while (progress_remote_cq(iface) == UCS_INPROGRESS) {
+        ++count;
+    }
 
     /* have a go a processing the pending queue */
 
     ucs_arbiter_dispatch(&iface->super.arbiter, iface->config.smsg_max_credit,
                          uct_ugni_ep_process_pending, NULL);
+    return count;
 }
 
 static ucs_status_t uct_ugni_smsg_query_tl_resources(uct_md_h md,
@@ -424,6 +425,7 @@ static UCS_CLASS_INIT_FUNC(uct_ugni_smsg_iface_t, uct_md_h md, uct_worker_h work
                             UCS_SYS_CACHE_LINE_SIZE,      /* alignment */
                             128           ,               /* grow */
                             config->mpool.max_bufs,       /* max buffers */
+                            0,                            /* flags */
                             &uct_ugni_smsg_desc_mpool_ops,
                             "UGNI-SMSG-DESC");
 
@@ -439,6 +441,7 @@ static UCS_CLASS_INIT_FUNC(uct_ugni_smsg_iface_t, uct_md_h md, uct_worker_h work
                             UCS_SYS_CACHE_LINE_SIZE,      /* alignment */
                             128,                          /* grow */
                             config->mpool.max_bufs,       /* max buffers */
+                            0,                            /* flags */
                             &uct_ugni_smsg_mbox_mpool_ops,
                             "UGNI-SMSG-MBOX");
 
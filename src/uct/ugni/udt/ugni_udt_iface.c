@@ -133,13 +133,16 @@ static void *uct_ugni_udt_device_thread(void *arg)
     return NULL;
 }
 
-void uct_ugni_udt_progress(void *arg)
+/* Receives are handled by the async thread, so only pending sends are
+ * progressed here, and no events are reported */
+unsigned uct_ugni_udt_progress(void *arg)
 {
     uct_ugni_udt_iface_t * iface = (uct_ugni_udt_iface_t *)arg;
 
     uct_ugni_enter_async(&iface->super);
     ucs_arbiter_dispatch(&iface->super.arbiter, 1, uct_ugni_udt_ep_process_pending, NULL);
     uct_ugni_leave_async(&iface->super);
+    return 0;
 }
 
 static void uct_ugni_udt_iface_release_desc(uct_recv_desc_t *self, void *desc)
@@ -405,6 +408,7 @@ static UCS_CLASS_INIT_FUNC(uct_ugni_udt_iface_t, uct_md_h md, uct_worker_h worke
                             UCS_SYS_CACHE_LINE_SIZE,      /* alignment */
                             128,                          /* grow */
                             config->mpool.max_bufs,       /* max buffers */
+                            0,                            /* flags */
                             &uct_ugni_udt_desc_mpool_ops,
                             "UGNI-UDT-DESC");
 
@@ -0,0 +1,191 @@
+/**
+* Copyright (C) Mellanox Technologies Ltd. 2001-2017.  ALL RIGHTS RESERVED.
+*
+* See file LICENSE for terms.
+*/
+
+#include "ucp_test.h"
+
+#include <common/test_helpers.h>
+
+
+class test_ucp_am : public ucp_test {
+public:
+    static const uint16_t AM_ID       = 7;
+    static const uint16_t AM_REPLY_ID = 8;
+
+    static ucp_params_t get_ctx_params() {
+        ucp_params_t params = ucp_test::get_ctx_params();
+        params.field_mask  |= UCP_PARAM_FIELD_FEATURES;
+        params.features     = UCP_FEATURE_AM;
+        return params;
+    }
+
+    virtual void init() {
+        ucp_test::init();
+        sender().connect(&receiver());
+        m_keep_data = false;
+        m_kept_data = NULL;
+        m_reply_ep  = NULL;
+        m_replies   = 0;
+        set_handler(receiver(), AM_ID, am_handler);
+        set_handler(sender(), AM_REPLY_ID, reply_handler);
+    }
+
+    virtual void cleanup() {
+        if (m_kept_data != NULL) {
+            ucp_am_data_release(receiver().worker(), m_kept_data);
+        }
+        ucp_test::cleanup();
+    }
+
+protected:
+    void set_handler(entity &e, uint16_t id, ucp_am_callback_t cb) {
+        ucs_status_t status = ucp_worker_set_am_handler(e.worker(), id, cb,
+                                                        this);
+        ASSERT_UCS_OK(status);
+    }
+
+    static ucs_status_t am_handler(void *arg, void *data, size_t length,
+                                   ucp_ep_h reply_ep, unsigned flags) {
+        test_ucp_am *self = reinterpret_cast<test_ucp_am*>(arg);
+
+        self->m_recv_data.push_back(std::string((char*)data, length));
+        self->m_reply_ep = reply_ep;
+        if (self->m_keep_data && (flags & UCP_CB_PARAM_FLAG_DATA)) {
+            self->m_kept_data = data;
+            return UCS_INPROGRESS;
+        }
+        return UCS_OK;
+    }
+
+    static ucs_status_t reply_handler(void *arg, void *data, size_t length,
+                                      ucp_ep_h reply_ep, unsigned flags) {
+        test_ucp_am *self = reinterpret_cast<test_ucp_am*>(arg);
+        ++self->m_replies;
+        return UCS_OK;
+    }
+
+    void send_am(const std::string& data, unsigned flags) {
+        void *req = ucp_am_send_nb(sender().ep(), AM_ID, data.data(),
+                                   data.size(), ucp_dt_make_contig(1),
+                                   send_callback, flags);
+        if (UCS_PTR_IS_ERR(req)) {
+            ASSERT_UCS_OK(UCS_PTR_STATUS(req));
+        }
+        wait(req);
+    }
+
+    void wait_recv(size_t count) {
+        ucs_time_t deadline = ucs_get_time() + ucs_time_from_sec(10.0);
+        while ((m_recv_data.size() < count) && (ucs_get_time() < deadline)) {
+            progress();
+        }
+        ASSERT_EQ(count, m_recv_data.size());
+    }
+
+    void test_xfer(size_t size, unsigned flags) {
+        std::string data(size, 0);
+
+        ucs::fill_random(data.begin(), data.end());
+        send_am(data, flags);
+        wait_recv(1);
+        EXPECT_EQ(data, m_recv_data.front());
+        m_recv_data.clear();
+    }
+
+    static void send_callback(void *request, ucs_status_t status) {
+    }
+
+    std::vector<std::string> m_recv_data;
+    bool                     m_keep_data;
+    void                     *m_kept_data;
+    ucp_ep_h                 m_reply_ep;
+    unsigned                 m_replies;
+};
+
+UCS_TEST_P(test_ucp_am, send_recv) {
+    static const size_t sizes[] = { 0, 1, 8, 100, 2000, 10000, 100000,
+                                    1024 * 1024 };
+
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i) {
+        test_xfer(sizes[i], 0);
+        EXPECT_TRUE(m_reply_ep == NULL);
+    }
+}
+
+UCS_TEST_P(test_ucp_am, send_recv_many) {
+    static const size_t count = 16;
+    std::vector<std::string> data(count);
+    std::vector<void*> reqs;
+
+    /* several multi-fragment messages are reassembled at the same time */
+    for (size_t i = 0; i < count; ++i) {
+        data[i].assign(20000 + i, 0);
+        ucs::fill_random(data[i].begin(), data[i].end());
+
+        void *req = ucp_am_send_nb(sender().ep(), AM_ID, data[i].data(),
+                                   data[i].size(), ucp_dt_make_contig(1),
+                                   send_callback, 0);
+        if (UCS_PTR_IS_ERR(req)) {
+            ASSERT_UCS_OK(UCS_PTR_STATUS(req));
+        }
+        reqs.push_back(req);
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        wait(reqs[i]);
+    }
+
+    wait_recv(count);
+    for (size_t i = 0; i < count; ++i) {
+        EXPECT_EQ(data[i], m_recv_data[i]) << "message " << i;
+    }
+    m_recv_data.clear();
+}
+
+UCS_TEST_P(test_ucp_am, reply) {
+    static const size_t sizes[] = { 8, 100000 };
+
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i) {
+        test_xfer(sizes[i], UCP_AM_SEND_REPLY);
+        ASSERT_TRUE(m_reply_ep != NULL);
+
+        void *req = ucp_am_send_nb(m_reply_ep, AM_REPLY_ID, NULL, 0,
+                                   ucp_dt_make_contig(1), send_callback, 0);
+        if (UCS_PTR_IS_ERR(req)) {
+            ASSERT_UCS_OK(UCS_PTR_STATUS(req));
+        }
+        wait(req);
+
+        ucs_time_t deadline = ucs_get_time() + ucs_time_from_sec(10.0);
+        while ((m_replies <= i) && (ucs_get_time() < deadline)) {
+            progress();
+        }
+        EXPECT_EQ(i + 1, m_replies);
+    }
+}
+
+UCS_TEST_P(test_ucp_am, keep_data) {
+    static const size_t sizes[] = { 100, 100000 };
+    std::string data;
+
+    m_keep_data = true;
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i) {
+        data.assign(sizes[i], 0);
+        ucs::fill_random(data.begin(), data.end());
+        send_am(data, 0);
+        wait_recv(1);
+        m_recv_data.clear();
+
+        /* The data is valid until it is released */
+        if (m_kept_data != NULL) {
+            short_progress_loop();
+            EXPECT_EQ(data, std::string((char*)m_kept_data, data.size()));
+            ucp_am_data_release(receiver().worker(), m_kept_data);
+            m_kept_data = NULL;
+        }
+    }
+}
+
+UCP_INSTANTIATE_TEST_CASE(test_ucp_am)
@@ -5,7 +5,10 @@
 */
 
 #include "test_ucp_memheap.h"
+extern "C" {
 #include "ucp/core/ucp_mm.h"
+#include "ucp/core/ucp_context.h"
+}
 
 
 class test_ucp_mmap : public test_ucp_memheap {
@@ -284,4 +287,95 @@ UCS_TEST_P(test_ucp_mmap, fixed) {
     }
 }
 
+UCS_TEST_P(test_ucp_mmap, rkey_cache) {
+    ucp_context_h context = sender().ucph();
+    ucp_rkey_cache_entry_t *entry1, *entry2, *entry3;
+    ucp_mem_map_params_t params;
+    ucp_rkey_cache_t rkey_cache;
+    ucp_rsc_index_t md_index;
+    ucs_status_t status;
+    ucp_mem_h memh;
+
+    params.field_mask = UCP_MEM_MAP_PARAM_FIELD_ADDRESS |
+                        UCP_MEM_MAP_PARAM_FIELD_LENGTH |
+                        UCP_MEM_MAP_PARAM_FIELD_FLAGS;
+    params.address    = NULL;
+    params.length     = 4096;
+    params.flags      = UCP_MEM_MAP_ALLOCATE;
+
+    status = ucp_mem_map(context, &params, &memh);
+    ASSERT_UCS_OK(status);
+
+    for (md_index = 0; md_index < context->num_mds; ++md_index) {
+        if ((memh->md_map & UCS_BIT(md_index)) &&
+            (context->tl_mds[md_index].attr.cap.flags & UCT_MD_FLAG_NEED_RKEY)) {
+            break;
+        }
+    }
+    if (md_index == context->num_mds) {
+        ucp_mem_unmap(context, memh);
+        UCS_TEST_SKIP_R("no memory domain with remote keys");
+    }
+
+    std::vector<char> rkey_buffer(context->tl_mds[md_index].attr.rkey_packed_size);
+    status = uct_md_mkey_pack(context->tl_mds[md_index].md,
+                              ucp_memh2uct(memh, md_index), &rkey_buffer[0]);
+    ASSERT_UCS_OK(status);
+
+    ucp_rkey_cache_init(&rkey_cache, 1);
+
+    /* same key from the same sender is unpacked once */
+    status = ucp_rkey_cache_get(&rkey_cache, 1, &rkey_buffer[0],
+                                rkey_buffer.size(), &entry1);
+    ASSERT_UCS_OK(status);
+    status = ucp_rkey_cache_get(&rkey_cache, 1, &rkey_buffer[0],
+                                rkey_buffer.size(), &entry2);
+    ASSERT_UCS_OK(status);
+    EXPECT_EQ(entry1, entry2);
+    EXPECT_EQ(1u, rkey_cache.count);
+
+    /* keys in use are not released, even if the cache is full */
+    status = ucp_rkey_cache_get(&rkey_cache, 2, &rkey_buffer[0],
+                                rkey_buffer.size(), &entry3);
+    ASSERT_UCS_OK(status);
+    EXPECT_NE(entry1, entry3);
+    EXPECT_EQ(2u, rkey_cache.count);
+
+    ucp_rkey_cache_put(&rkey_cache, entry1);
+    ucp_rkey_cache_put(&rkey_cache, entry2);
+    EXPECT_EQ(1u, rkey_cache.count);
+
+    /* an unused key stays cached */
+    ucp_rkey_cache_put(&rkey_cache, entry3);
+    EXPECT_EQ(1u, rkey_cache.count);
+    status = ucp_rkey_cache_get(&rkey_cache, 2, &rkey_buffer[0],
+                                rkey_buffer.size(), &entry1);
+    ASSERT_UCS_OK(status);
+    EXPECT_EQ(entry3, entry1);
+    ucp_rkey_cache_put(&rkey_cache, entry1);
+
+    ucp_rkey_cache_cleanup(&rkey_cache);
+
+    /* the keys of a disconnected sender are released, unless they are used */
+    ucp_rkey_cache_init(&rkey_cache, 2);
+    status = ucp_rkey_cache_get(&rkey_cache, 1, &rkey_buffer[0],
+                                rkey_buffer.size(), &entry1);
+    ASSERT_UCS_OK(status);
+    status = ucp_rkey_cache_get(&rkey_cache, 2, &rkey_buffer[0],
+                                rkey_buffer.size(), &entry2);
+    ASSERT_UCS_OK(status);
+    ucp_rkey_cache_put(&rkey_cache, entry2);
+    EXPECT_EQ(2u, rkey_cache.count);
+
+    ucp_rkey_cache_purge_sender(&rkey_cache, 1);
+    ucp_rkey_cache_purge_sender(&rkey_cache, 2);
+    EXPECT_EQ(1u, rkey_cache.count);
+    ucp_rkey_cache_put(&rkey_cache, entry1);
+
+    ucp_rkey_cache_cleanup(&rkey_cache);
+
+    status = ucp_mem_unmap(context, memh);
+    ASSERT_UCS_OK(status);
+}
+
 UCP_INSTANTIATE_TEST_CASE(test_ucp_mmap)
@@ -35,6 +35,26 @@ test_perf::test_spec test_ucp_perf::tests[] =
     UCT_PERF_DATA_LAYOUT_ZCOPY, 8192, 3, { 1024, 1024, 1024 }, 1, 100000l,
     ucs_offsetof(ucx_perf_result_t, latency.total_average), 1e6, 0.001, 30.0 },
 
+  { "stream latency", "usec",
+    UCX_PERF_API_UCP, UCX_PERF_CMD_STREAM, UCX_PERF_TEST_TYPE_PINGPONG,
+    UCT_PERF_DATA_LAYOUT_LAST, 0, 1, { 8 }, 1, 100000l,
+    ucs_offsetof(ucx_perf_result_t, latency.total_average), 1e6, 0.001, 30.0 },
+
+  { "stream bw", "MB/sec",
+    UCX_PERF_API_UCP, UCX_PERF_CMD_STREAM, UCX_PERF_TEST_TYPE_STREAM_UNI,
+    UCT_PERF_DATA_LAYOUT_LAST, 0, 1, { 2048 }, 1, 100000l,
+    ucs_offsetof(ucx_perf_result_t, bandwidth.total_average), MB, 200.0, 100000.0 },
+
+  { "am latency", "usec",
+    UCX_PERF_API_UCP, UCX_PERF_CMD_AM, UCX_PERF_TEST_TYPE_PINGPONG,
+    UCT_PERF_DATA_LAYOUT_LAST, 0, 1, { 8 }, 1, 100000l,
+    ucs_offsetof(ucx_perf_result_t, latency.total_average), 1e6, 0.001, 30.0 },
+
+  { "am bw", "MB/sec",
+    UCX_PERF_API_UCP, UCX_PERF_CMD_AM, UCX_PERF_TEST_TYPE_STREAM_UNI,
+    UCT_PERF_DATA_LAYOUT_LAST, 0, 1, { 2048 }, 1, 100000l,
+    ucs_offsetof(ucx_perf_result_t, bandwidth.total_average), MB, 200.0, 100000.0 },
+
   { "put latency", "usec",
     UCX_PERF_API_UCP, UCX_PERF_CMD_PUT, UCX_PERF_TEST_TYPE_PINGPONG,
     UCT_PERF_DATA_LAYOUT_LAST, 0, 1, { 8 }, 1, 100000l,
@@ -91,8 +111,10 @@ UCS_TEST_P(test_ucp_perf, envelope) {
     /* coverity[tainted_string_argument] */
     ucs::scoped_setenv tls("UCX_TLS", ss.str().c_str());
     for (test_spec *test = tests; test->title != NULL; ++test) {
-        unsigned flags = (test->command == UCX_PERF_CMD_TAG) ? 0 :
-                                 UCX_PERF_TEST_FLAG_ONE_SIDED;
+        unsigned flags = ((test->command == UCX_PERF_CMD_TAG) ||
+                          (test->command == UCX_PERF_CMD_STREAM) ||
+                          (test->command == UCX_PERF_CMD_AM)) ? 0 :
+                         UCX_PERF_TEST_FLAG_ONE_SIDED;
         if (ucs_arch_get_cpu_model() == UCS_CPU_MODEL_ARM_AARCH64) {
             test->max *= UCP_ARM_PERF_TEST_MULTIPLIER;
             test->min /= UCP_ARM_PERF_TEST_MULTIPLIER;
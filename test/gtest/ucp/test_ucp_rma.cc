@@ -7,6 +7,11 @@
 
 #include "test_ucp_memheap.h"
 #include <ucs/sys/sys.h>
+extern "C" {
+#include <ucp/core/ucp_ep.inl>
+#include <ucp/core/ucp_mm.h>
+#include <uct/base/uct_iface.h>
+}
 
 
 class test_ucp_rma : public test_ucp_memheap {
@@ -82,9 +87,118 @@ public:
         ASSERT_UCS_OK(status);
     }
 
+    void nonblocking_put_nb(entity *e, size_t max_size,
+                            void *memheap_addr,
+                            ucp_rkey_h rkey,
+                            std::string& expected_data)
+    {
+        void *req;
+
+        req = ucp_put_nb(e->ep(), &expected_data[0], expected_data.length(),
+                         (uintptr_t)memheap_addr, rkey, send_completion);
+        add_request(req);
+    }
+
+    void nonblocking_get_nb(entity *e, size_t max_size,
+                            void *memheap_addr,
+                            ucp_rkey_h rkey,
+                            std::string& expected_data)
+    {
+        void *req;
+
+        ucs::fill_random((char*)memheap_addr, (char*)memheap_addr + ucs_min(max_size, 16384U));
+        req = ucp_get_nb(e->ep(), (void *)&expected_data[0], expected_data.length(),
+                         (uintptr_t)memheap_addr, rkey, send_completion);
+        add_request(req);
+    }
+
+    /* the same as nonblocking_{put,get}_nb, but wait for the request */
+    void blocking_put_nb(entity *e, size_t max_size, void *memheap_addr,
+                         ucp_rkey_h rkey, std::string& expected_data)
+    {
+        nonblocking_put_nb(e, max_size, memheap_addr, rkey, expected_data);
+        wait_requests();
+    }
+
+    void blocking_get_nb(entity *e, size_t max_size, void *memheap_addr,
+                         ucp_rkey_h rkey, std::string& expected_data)
+    {
+        nonblocking_get_nb(e, max_size, memheap_addr, rkey, expected_data);
+        wait_requests();
+    }
+
+    /* wait for the outstanding requests, and check every request invoked its
+     * completion callback */
+    void wait_requests()
+    {
+        size_t num_reqs = m_reqs.size();
+
+        while (!m_reqs.empty()) {
+            wait(m_reqs.back());
+            m_reqs.pop_back();
+        }
+        EXPECT_EQ(num_reqs, m_completed);
+        m_completed = 0;
+    }
+
     void test_message_sizes(blocking_send_func_t func, size_t *msizes, int iters, int is_nbi);
+
+protected:
+    virtual void init() {
+        test_ucp_memheap::init();
+        m_completed = 0;
+    }
+
+private:
+    void add_request(void *req) {
+        ASSERT_FALSE(UCS_PTR_IS_ERR(req)) << ucs_status_string(UCS_PTR_STATUS(req));
+        if (req != NULL) {
+            m_reqs.push_back(req);
+        }
+    }
+
+    static void send_completion(void *request, ucs_status_t status) {
+        EXPECT_UCS_OK(status);
+        ++m_completed;
+    }
+
+protected:
+    typedef ucs_status_t (*put_zcopy_func_t)(uct_ep_h ep, const uct_iov_t *iov,
+                                             size_t iovcnt, uint64_t remote_addr,
+                                             uct_rkey_t rkey,
+                                             uct_completion_t *comp);
+
+    static void err_completion(void *request, ucs_status_t status) {
+        m_err_status = status;
+        ++m_completed;
+    }
+
+    /* Leave the first fragment in flight, and fail the second one. The data
+     * is not transferred, only the completion of the request is checked. */
+    static ucs_status_t
+    put_zcopy_fail_second(uct_ep_h ep, const uct_iov_t *iov, size_t iovcnt,
+                          uint64_t remote_addr, uct_rkey_t rkey,
+                          uct_completion_t *comp) {
+        if (m_inflight_comp != NULL) {
+            return UCS_ERR_IO_ERROR;
+        }
+
+        m_inflight_comp = comp;
+        return UCS_INPROGRESS;
+    }
+
+    std::vector<void*>      m_reqs;
+    static size_t           m_completed;
+    static ucs_status_t     m_err_status;
+    static uct_completion_t *m_inflight_comp;
+    static put_zcopy_func_t m_orig_put_zcopy;
 };
 
+size_t test_ucp_rma::m_completed                           = 0;
+ucs_status_t test_ucp_rma::m_err_status                    = UCS_OK;
+uct_completion_t *test_ucp_rma::m_inflight_comp            = NULL;
+test_ucp_rma::put_zcopy_func_t test_ucp_rma::m_orig_put_zcopy = NULL;
+
 void test_ucp_rma::test_message_sizes(blocking_send_func_t func, size_t *msizes, int iters, int is_nbi)
 {
    int i;
@@ -162,6 +276,56 @@ UCS_TEST_P(test_ucp_rma, nbi_large) {
                        sizes, 3, 1);
 }
 
+UCS_TEST_P(test_ucp_rma, nb_small) {
+    size_t sizes[] = { 8, 24, 96, 120, 250, 0};
+
+    test_message_sizes(static_cast<blocking_send_func_t>(&test_ucp_rma::blocking_put_nb),
+                       sizes, 1000, 0);
+    test_message_sizes(static_cast<blocking_send_func_t>(&test_ucp_rma::blocking_get_nb),
+                       sizes, 1000, 0);
+}
+
+UCS_TEST_P(test_ucp_rma, nb_med) {
+    size_t sizes[] = { 1000, 3000, 9000, 17300, 31000, 99000, 130000, 0};
+
+    test_message_sizes(static_cast<blocking_send_func_t>(&test_ucp_rma::blocking_put_nb),
+                       sizes, 100, 0);
+    test_message_sizes(static_cast<blocking_send_func_t>(&test_ucp_rma::blocking_get_nb),
+                       sizes, 100, 0);
+}
+
+UCS_TEST_P(test_ucp_rma, nb_large) {
+    size_t sizes[] = { 1 * MEG, 3 * MEG, 9 * MEG, 17 * MEG, 32 * MEG, 0};
+
+    if (RUNNING_ON_VALGRIND) {
+        UCS_TEST_SKIP_R("skipping on valgrind");
+    }
+
+    test_message_sizes(static_cast<blocking_send_func_t>(&test_ucp_rma::blocking_put_nb),
+                       sizes, 3, 0);
+    test_message_sizes(static_cast<blocking_send_func_t>(&test_ucp_rma::blocking_get_nb),
+                       sizes, 3, 0);
+}
+
+UCS_TEST_P(test_ucp_rma, nonblocking_stream_put_nb) {
+    test_nonblocking_implicit_stream_xfer(static_cast<nonblocking_send_func_t>(&test_ucp_rma::nonblocking_put_nb),
+                       DEFAULT_SIZE, DEFAULT_ITERS,
+                       1, false, false);
+    wait_requests();
+}
+
+UCS_TEST_P(test_ucp_rma, nonblocking_stream_get_nb) {
+    /* many gets in flight, which complete individually */
+    test_nonblocking_implicit_stream_xfer(static_cast<nonblocking_send_func_t>(&test_ucp_rma::nonblocking_get_nb),
+                       DEFAULT_SIZE, DEFAULT_ITERS,
+                       1, false, false);
+    wait_requests();
+    test_nonblocking_implicit_stream_xfer(static_cast<nonblocking_send_func_t>(&test_ucp_rma::nonblocking_get_nb),
+                       DEFAULT_SIZE, DEFAULT_ITERS,
+                       1, true, true);
+    wait_requests();
+}
+
 UCS_TEST_P(test_ucp_rma, blocking_put_allocated) {
     test_blocking_xfer(static_cast<blocking_send_func_t>(&test_ucp_rma::blocking_put),
                        DEFAULT_SIZE, DEFAULT_ITERS,
@@ -255,5 +419,89 @@ UCS_TEST_P(test_ucp_rma, nonblocking_stream_get_nbi_flush_ep) {
                        1, true, true);
 }
 
+UCS_TEST_P(test_ucp_rma, put_nb_error_with_fragment_in_flight) {
+    static const size_t size = 64 * UCS_KBYTE;
+    ucp_mem_map_params_t params;
+    ucp_mem_attr_t mem_attr;
+    ucs_status_t status;
+    ucp_mem_h memh;
+    void *rkey_buffer;
+    size_t rkey_buffer_size;
+    ucp_rkey_h rkey;
+
+    sender().connect(&receiver());
+
+    params.field_mask = UCP_MEM_MAP_PARAM_FIELD_ADDRESS |
+                        UCP_MEM_MAP_PARAM_FIELD_LENGTH |
+                        UCP_MEM_MAP_PARAM_FIELD_FLAGS;
+    params.address    = NULL;
+    params.length     = size;
+    params.flags      = GetParam().variant | UCP_MEM_MAP_ALLOCATE;
+    status = ucp_mem_map(receiver().ucph(), &params, &memh);
+    ASSERT_UCS_OK(status);
+
+    mem_attr.field_mask = UCP_MEM_ATTR_FIELD_ADDRESS;
+    status = ucp_mem_query(memh, &mem_attr);
+    ASSERT_UCS_OK(status);
+
+    status = ucp_rkey_pack(receiver().ucph(), memh, &rkey_buffer,
+                           &rkey_buffer_size);
+    ASSERT_UCS_OK(status);
+    status = ucp_ep_rkey_unpack(sender().ep(), rkey_buffer, &rkey);
+    ASSERT_UCS_OK(status);
+
+    std::string data(size, 0);
+    ucs::fill_random(data);
+
+    /* resolve the RMA lane of the remote key */
+    status = ucp_put(sender().ep(), &data[0], 1, (uintptr_t)mem_attr.address,
+                     rkey);
+    ASSERT_UCS_OK(status);
+
+    ucp_lane_index_t lane           = rkey->cache.rma_lane;
+    ucp_ep_rma_config_t *rma_config = &ucp_ep_config(sender().ep())->rma[lane];
+    uct_iface_h iface               = sender().ep()->uct_eps[lane]->iface;
+    size_t orig_max_put_short       = rkey->cache.max_put_short;
+    size_t orig_put_zcopy_thresh    = rma_config->put_zcopy_thresh;
+    size_t orig_max_put_zcopy       = rma_config->max_put_zcopy;
+    void *req;
+
+    /* send the message in two zcopy fragments */
+    m_inflight_comp              = NULL;
+    m_err_status                 = UCS_OK;
+    m_orig_put_zcopy             = iface->ops.ep_put_zcopy;
+    iface->ops.ep_put_zcopy      = put_zcopy_fail_second;
+    rkey->cache.max_put_short    = 0;
+    rma_config->put_zcopy_thresh = 0;
+    rma_config->max_put_zcopy    = size / 2;
+
+    req = ucp_put_nb(sender().ep(), &data[0], size, (uintptr_t)mem_attr.address,
+                     rkey, err_completion);
+
+    rkey->cache.max_put_short    = orig_max_put_short;
+    rma_config->put_zcopy_thresh = orig_put_zcopy_thresh;
+    rma_config->max_put_zcopy    = orig_max_put_zcopy;
+    iface->ops.ep_put_zcopy      = m_orig_put_zcopy;
+
+    /* the request must stay alive until the first fragment is completed */
+    ASSERT_FALSE(UCS_PTR_IS_ERR(req));
+    ASSERT_TRUE(req != NULL);
+    ASSERT_TRUE(m_inflight_comp != NULL);
+    EXPECT_EQ(UCS_INPROGRESS, ucp_request_test(req, NULL));
+
+    uct_invoke_completion(m_inflight_comp, UCS_OK);
+    EXPECT_EQ(UCS_ERR_IO_ERROR, ucp_request_test(req, NULL));
+    EXPECT_EQ(UCS_ERR_IO_ERROR, m_err_status);
+    EXPECT_EQ(1ul, m_completed);
+    ucp_request_release(req);
+    m_completed = 0;
+
+    ucp_rkey_destroy(rkey);
+    ucp_rkey_buffer_release(rkey_buffer);
+    disconnect(sender());
+    status = ucp_mem_unmap(receiver().ucph(), memh);
+    ASSERT_UCS_OK(status);
+}
+
 UCP_INSTANTIATE_TEST_CASE(test_ucp_rma)
 
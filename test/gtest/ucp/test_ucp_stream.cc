@@ -0,0 +1,228 @@
+/**
+* Copyright (C) Mellanox Technologies Ltd. 2001-2017.  ALL RIGHTS RESERVED.
+*
+* See file LICENSE for terms.
+*/
+
+#include "ucp_test.h"
+
+#include <common/test_helpers.h>
+
+
+class test_ucp_stream : public ucp_test {
+public:
+    static ucp_params_t get_ctx_params() {
+        ucp_params_t params = ucp_test::get_ctx_params();
+        params.field_mask  |= UCP_PARAM_FIELD_FEATURES;
+        params.features     = UCP_FEATURE_STREAM;
+        return params;
+    }
+
+    virtual void init() {
+        ucp_test::init();
+        sender().connect(&receiver());
+        if (!is_loopback()) {
+            receiver().connect(&sender());
+        }
+    }
+
+protected:
+    static void send_callback(void *request, ucs_status_t status) {
+    }
+
+    static void recv_callback(void *request, ucs_status_t status,
+                              size_t length) {
+    }
+
+    void send_data(const void *buffer, size_t length) {
+        void *req = ucp_stream_send_nb(sender().ep(), buffer, length,
+                                       ucp_dt_make_contig(1), send_callback);
+        m_send_reqs.push_back(req);
+    }
+
+    void wait_send() {
+        for (std::vector<void*>::iterator iter = m_send_reqs.begin();
+             iter != m_send_reqs.end(); ++iter) {
+            if (UCS_PTR_IS_ERR(*iter)) {
+                ASSERT_UCS_OK(UCS_PTR_STATUS(*iter));
+            }
+            wait(*iter);
+        }
+        m_send_reqs.clear();
+    }
+
+    /* Returns the received length */
+    size_t recv_data(void *buffer, size_t length, unsigned flags) {
+        size_t recv_length = 0;
+        void *req;
+
+        req = ucp_stream_recv_nb(receiver().ep(), buffer, length,
+                                 ucp_dt_make_contig(1), recv_callback,
+                                 &recv_length, flags);
+        if (UCS_PTR_IS_ERR(req)) {
+            ADD_FAILURE() << "stream_recv_nb failed: "
+                          << ucs_status_string(UCS_PTR_STATUS(req));
+            return 0;
+        } else if (req == NULL) {
+            return recv_length;
+        }
+
+        return wait_recv(req);
+    }
+
+    size_t wait_recv(void *req) {
+        size_t length = 0;
+        ucs_status_t status;
+
+        do {
+            progress();
+            status = ucp_stream_recv_request_test(req, &length);
+        } while (status == UCS_INPROGRESS);
+        EXPECT_UCS_OK(status);
+        ucp_request_release(req);
+        return length;
+    }
+
+    std::vector<void*> m_send_reqs;
+};
+
+UCS_TEST_P(test_ucp_stream, send_recv_waitall) {
+    static const size_t num_msgs = 10;
+    static const size_t msg_size = 1000;
+    std::vector<char> sbuf(num_msgs * msg_size), rbuf(num_msgs * msg_size, 0);
+
+    ucs::fill_random(sbuf);
+    for (size_t i = 0; i < num_msgs; ++i) {
+        send_data(&sbuf[i * msg_size], msg_size);
+    }
+    wait_send();
+
+    size_t length = recv_data(&rbuf[0], rbuf.size(),
+                              UCP_STREAM_RECV_FLAG_WAITALL);
+    EXPECT_EQ(rbuf.size(), length);
+    EXPECT_EQ(sbuf, rbuf);
+}
+
+UCS_TEST_P(test_ucp_stream, partial_recv) {
+    static const size_t msg_size = 100;
+    std::vector<char> sbuf(msg_size), rbuf(msg_size * 2, 0);
+    size_t offset;
+
+    ucs::fill_random(sbuf);
+    send_data(&sbuf[0], sbuf.size());
+    wait_send();
+
+    /* Receive the data with small buffers, a partial receive completes as soon
+     * as it gets any data */
+    for (offset = 0; offset < msg_size; ) {
+        offset += recv_data(&rbuf[offset], ucs_min(msg_size - offset, 30ul), 0);
+    }
+    EXPECT_EQ(msg_size, offset);
+
+    /* A partial receive which is larger than the data */
+    send_data(&sbuf[0], sbuf.size());
+    wait_send();
+    offset += recv_data(&rbuf[offset], msg_size * 2 - offset, 0);
+    EXPECT_GT(offset, msg_size);
+    while (offset < msg_size * 2) {
+        offset += recv_data(&rbuf[offset], msg_size * 2 - offset, 0);
+    }
+
+    EXPECT_EQ(sbuf, std::vector<char>(rbuf.begin(), rbuf.begin() + msg_size));
+    EXPECT_EQ(sbuf, std::vector<char>(rbuf.begin() + msg_size, rbuf.end()));
+}
+
+UCS_TEST_P(test_ucp_stream, recv_posted) {
+    static const size_t msg_size = 3000;
+    std::vector<char> sbuf(msg_size), rbuf(msg_size, 0);
+    size_t length;
+    void *req;
+
+    /* The receive is posted before the data arrives, so the data is placed
+     * directly in the user buffer */
+    ucs::fill_random(sbuf);
+    req = ucp_stream_recv_nb(receiver().ep(), &rbuf[0], rbuf.size(),
+                             ucp_dt_make_contig(1), recv_callback, &length,
+                             UCP_STREAM_RECV_FLAG_WAITALL);
+    ASSERT_FALSE(UCS_PTR_IS_ERR(req));
+
+    send_data(&sbuf[0], msg_size / 2);
+    send_data(&sbuf[msg_size / 2], msg_size - (msg_size / 2));
+    wait_send();
+
+    EXPECT_EQ(msg_size, wait_recv(req));
+    EXPECT_EQ(sbuf, rbuf);
+}
+
+UCS_TEST_P(test_ucp_stream, large) {
+    static const size_t msg_size = 1 * 1024 * 1024;
+    std::vector<char> sbuf(msg_size), rbuf(msg_size, 0);
+    void *req;
+    size_t length;
+
+    ucs::fill_random(sbuf);
+    req = ucp_stream_recv_nb(receiver().ep(), &rbuf[0], rbuf.size(),
+                             ucp_dt_make_contig(1), recv_callback, &length,
+                             UCP_STREAM_RECV_FLAG_WAITALL);
+    ASSERT_FALSE(UCS_PTR_IS_ERR(req));
+
+    send_data(&sbuf[0], sbuf.size());
+    wait_send();
+
+    if (req != NULL) {
+        length = wait_recv(req);
+    }
+    EXPECT_EQ(msg_size, length);
+    EXPECT_EQ(sbuf, rbuf);
+}
+
+UCS_TEST_P(test_ucp_stream, iov_recv) {
+    static const size_t msg_size = 4000;
+    std::vector<char> sbuf(msg_size), rbuf(msg_size, 0);
+    ucp_dt_iov_t iov[3];
+    size_t length;
+    void *req;
+
+    ucs::fill_random(sbuf);
+    iov[0].buffer = &rbuf[0];
+    iov[0].length = 10;
+    iov[1].buffer = &rbuf[10];
+    iov[1].length = 1990;
+    iov[2].buffer = &rbuf[2000];
+    iov[2].length = msg_size - 2000;
+
+    send_data(&sbuf[0], sbuf.size());
+    wait_send();
+
+    req = ucp_stream_recv_nb(receiver().ep(), iov, 3, ucp_dt_make_iov(),
+                             recv_callback, &length,
+                             UCP_STREAM_RECV_FLAG_WAITALL);
+    ASSERT_FALSE(UCS_PTR_IS_ERR(req));
+    if (req != NULL) {
+        length = wait_recv(req);
+    }
+    EXPECT_EQ(msg_size, length);
+    EXPECT_EQ(sbuf, rbuf);
+}
+
+UCS_TEST_P(test_ucp_stream, cancel) {
+    std::vector<char> rbuf(100);
+    size_t length = 0;
+    ucs_status_t status;
+    void *req;
+
+    req = ucp_stream_recv_nb(receiver().ep(), &rbuf[0], rbuf.size(),
+                             ucp_dt_make_contig(1), recv_callback, &length, 0);
+    ASSERT_TRUE(UCS_PTR_IS_PTR(req));
+
+    ucp_request_cancel(receiver().worker(), req);
+    do {
+        progress();
+        status = ucp_stream_recv_request_test(req, &length);
+    } while (status == UCS_INPROGRESS);
+    EXPECT_EQ(UCS_ERR_CANCELED, status);
+    EXPECT_EQ(0ul, length);
+    ucp_request_release(req);
+}
+
+UCP_INSTANTIATE_TEST_CASE(test_ucp_stream)
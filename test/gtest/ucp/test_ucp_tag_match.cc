@@ -8,6 +8,10 @@
 #include "test_ucp_tag.h"
 
 #include <common/test_helpers.h>
+extern "C" {
+#include <ucp/core/ucp_worker.h>
+#include <ucs/arch/memcpy.h>
+}
 
 using namespace ucs; /* For vector<char> serialization */
 
@@ -35,8 +39,27 @@ public:
                                      RECV_REQ_EXTERNAL, result);
         return result;
     }
+
+protected:
+    static bool thresh_in_range(size_t thresh, size_t calc_thresh) {
+        if (calc_thresh == SIZE_MAX) {
+            return thresh == SIZE_MAX;
+        }
+        return (thresh >= (calc_thresh / 2)) && (thresh <= (calc_thresh * 2));
+    }
+
+    static void counting_memcpy_nt(void *dst, const void *src, size_t len) {
+        ++m_nt_count;
+        m_orig_memcpy_nt(dst, src, len);
+    }
+
+    static size_t            m_nt_count;
+    static ucs_memcpy_func_t m_orig_memcpy_nt;
 };
 
+size_t            test_ucp_tag_match::m_nt_count       = 0;
+ucs_memcpy_func_t test_ucp_tag_match::m_orig_memcpy_nt = NULL;
+
 UCS_TEST_P(test_ucp_tag_match, send_recv_unexp) {
     ucp_tag_recv_info_t info;
     ucs_status_t status;
@@ -99,6 +122,39 @@ UCS_TEST_P(test_ucp_tag_match, send_recv_exp_medium) {
     request_release(my_recv_req);
 }
 
+UCS_TEST_P(test_ucp_tag_match, send_recv_exp_nontemporal,
+           "RNDV_THRESH=inf", "ZCOPY_THRESH=inf") {
+    static const size_t size = 256 * UCS_KBYTE;
+    size_t orig_thresh       = ucs_global_opts.memcpy_nt_thresh;
+    request *my_recv_req;
+
+    std::vector<char> sendbuf(size, 0);
+    std::vector<char> recvbuf(size, 0);
+
+    ucs::fill_random(sendbuf);
+
+    /* The message is sent in bcopy fragments which are all smaller than the
+     * threshold, so the copy bypasses the cache only if the decision is made
+     * by the total message length */
+    m_nt_count                       = 0;
+    m_orig_memcpy_nt                 = ucs_memcpy_nt_func;
+    ucs_memcpy_nt_func               = counting_memcpy_nt;
+    ucs_global_opts.memcpy_nt_thresh = size / 4;
+
+    my_recv_req = recv_nb(&recvbuf[0], recvbuf.size(), DATATYPE, 0x1337, 0xffff);
+    ASSERT_TRUE(!UCS_PTR_IS_ERR(my_recv_req));
+    send_b(&sendbuf[0], sendbuf.size(), DATATYPE, 0x111337);
+    wait(my_recv_req);
+
+    ucs_global_opts.memcpy_nt_thresh = orig_thresh;
+    ucs_memcpy_nt_func               = m_orig_memcpy_nt;
+
+    EXPECT_EQ(sendbuf.size(), my_recv_req->info.length);
+    EXPECT_EQ(sendbuf, recvbuf);
+    EXPECT_GT(m_nt_count, 0ul);
+    request_release(my_recv_req);
+}
+
 UCS_TEST_P(test_ucp_tag_match, send2_nb_recv_exp_medium) {
     static const size_t size = 50000;
     request *my_recv_req;
@@ -234,6 +290,81 @@ UCS_TEST_P(test_ucp_tag_match, send2_nb_recv_medium_wildcard, "RNDV_THRESH=-1")
     }
 }
 
+UCS_TEST_P(test_ucp_tag_match, send2_nb_recv_medium_same_tag, "RNDV_THRESH=-1") {
+    static const size_t size  = 3000000;
+    static const ucp_tag_t tag = 0x1337;
+
+    entity &sender2 = sender();
+    create_entity(true);
+    sender().connect(&receiver());
+
+    for (int is_exp = 0; is_exp <= 1; ++is_exp) {
+
+        UCS_TEST_MESSAGE << "Testing " << (is_exp ? "" : "un") << "expected mode, size " << size;
+
+        std::vector<char> sendbuf1(size, 0);
+        std::vector<char> sendbuf2(size, 0);
+        std::vector<char> recvbuf1(size, 0);
+        std::vector<char> recvbuf2(size, 0);
+
+        ucs::fill_random(sendbuf1);
+        ucs::fill_random(sendbuf2);
+
+        /* Fragments of both messages arrive interleaved with the same tag */
+        request *sreq1, *sreq2;
+        sreq1 = (request*)ucp_tag_send_nb(sender().ep(), &sendbuf1[0], sendbuf1.size(),
+                                          DATATYPE, tag, send_callback);
+        ASSERT_TRUE(!UCS_PTR_IS_ERR(sreq1));
+
+        sreq2 = (request*)ucp_tag_send_nb(sender2.ep(), &sendbuf2[0], sendbuf2.size(),
+                                          DATATYPE, tag, send_callback);
+        ASSERT_TRUE(!UCS_PTR_IS_ERR(sreq2));
+
+        if (!is_exp) {
+            short_progress_loop();
+        }
+
+        request *rreq1, *rreq2;
+
+        rreq1 = recv_nb(&recvbuf1[0], recvbuf1.size(), DATATYPE, tag, (ucp_tag_t)-1);
+        ASSERT_TRUE(!UCS_PTR_IS_ERR(rreq1));
+
+        rreq2 = recv_nb(&recvbuf2[0], recvbuf2.size(), DATATYPE, tag, (ucp_tag_t)-1);
+        ASSERT_TRUE(!UCS_PTR_IS_ERR(rreq2));
+
+        wait(rreq1);
+        wait(rreq2);
+
+        short_progress_loop();
+
+        if (sreq1 != NULL) {
+            EXPECT_TRUE(sreq1->completed);
+            request_release(sreq1);
+        }
+        if (sreq2 != NULL) {
+            EXPECT_TRUE(sreq2->completed);
+            request_release(sreq2);
+        }
+
+        ASSERT_TRUE(rreq1->completed);
+        ASSERT_TRUE(rreq2->completed);
+
+        EXPECT_EQ(size, rreq1->info.length);
+        EXPECT_EQ(size, rreq2->info.length);
+
+        /* Each receive must get a whole message from a single sender */
+        if (recvbuf1 == sendbuf1) {
+            EXPECT_EQ(sendbuf2, recvbuf2);
+        } else {
+            EXPECT_EQ(sendbuf2, recvbuf1);
+            EXPECT_EQ(sendbuf1, recvbuf2);
+        }
+
+        request_release(rreq1);
+        request_release(rreq2);
+    }
+}
+
 UCS_TEST_P(test_ucp_tag_match, send_recv_nb_partial_exp_medium) {
     static const size_t size = 50000;
 
@@ -557,4 +688,185 @@ UCS_TEST_P(test_ucp_tag_match, rndv_req_exp_auto_thresh, "RNDV_THRESH=auto") {
     request_release(my_recv_req);
 }
 
+UCS_TEST_P(test_ucp_tag_match, rndv_rkey_cache, "RNDV_THRESH=1000",
+           "RNDV_RKEY_CACHE_SIZE=1") {
+    static const size_t size = 100000;
+    ucp_rkey_cache_t *rkey_cache = &receiver().worker()->rkey_cache;
+    request *my_recv_req;
+
+    std::vector<char> sendbuf(size, 0);
+    std::vector<char> recvbuf(size, 0);
+
+    /* repeated transfers from the same buffer reuse the cached rkey, and
+     * unused rkeys above the cache size are released */
+    for (int i = 0; i < 5; ++i) {
+        ucs::fill_random(sendbuf);
+
+        my_recv_req = recv_nb(&recvbuf[0], recvbuf.size(), DATATYPE, 0x1337,
+                              0xffff);
+        ASSERT_TRUE(!UCS_PTR_IS_ERR(my_recv_req));
+
+        send_b(&sendbuf[0], sendbuf.size(), DATATYPE, 0x111337);
+        wait(my_recv_req);
+
+        EXPECT_EQ(sendbuf.size(), my_recv_req->info.length);
+        EXPECT_EQ(sendbuf, recvbuf);
+        request_release(my_recv_req);
+
+        EXPECT_LE(rkey_cache->count, 1u);
+    }
+}
+
+UCS_TEST_P(test_ucp_tag_match, tune_thresh_fit) {
+    static const double latency   = 1e-6;
+    static const double bandwidth = 1e9;
+    ucp_ep_tune_stats_t stats;
+    double size, time;
+
+    /* the fixed cost of every send does not count as transfer time */
+    memset(&stats, 0, sizeof(stats));
+    for (size = 1024; size <= 65536; size *= 2) {
+        time                 = latency + (size / bandwidth);
+        stats.count         += 1;
+        stats.sum_size      += size;
+        stats.sum_time      += time;
+        stats.sum_size2     += size * size;
+        stats.sum_size_time += size * time;
+    }
+    EXPECT_NEAR(bandwidth, ucp_ep_tune_stats_bw(&stats), bandwidth * 0.01);
+
+    /* messages of a single size can only be averaged */
+    stats.count         = 2;
+    stats.sum_size      = 2 * size;
+    stats.sum_time      = 2 * time;
+    stats.sum_size2     = 2 * size * size;
+    stats.sum_size_time = 2 * size * time;
+    EXPECT_NEAR(size / time, ucp_ep_tune_stats_bw(&stats), size / time * 0.01);
+}
+
+UCS_TEST_P(test_ucp_tag_match, tune_thresh, "TUNE_THRESH=y",
+           "TUNE_THRESH_WINDOW=8", "TUNE_THRESH_RANGE=2") {
+    static const size_t sizes[] = { 1000, 10000, 100000, 1000000 };
+    ucp_ep_config_t *config = &sender().worker()->ep_config[sender().ep()->cfg_index];
+    request *my_recv_req;
+
+    if (!config->tune.enabled) {
+        UCS_TEST_SKIP_R("thresholds are not tuned");
+    }
+
+    size_t zcopy_thresh    = config->am.zcopy_thresh[0];
+    size_t rndv_rma_thresh = config->rndv.rma_thresh;
+    size_t rndv_am_thresh  = config->rndv.am_thresh;
+
+    if ((zcopy_thresh == SIZE_MAX) && (rndv_rma_thresh == SIZE_MAX) &&
+        (rndv_am_thresh == SIZE_MAX)) {
+        UCS_TEST_SKIP_R("only buffered copy is used");
+    }
+
+    for (int i = 0; i < 20; ++i) {
+        for (size_t j = 0; j < sizeof(sizes) / sizeof(sizes[0]); ++j) {
+            std::vector<char> sendbuf(sizes[j], 0);
+            std::vector<char> recvbuf(sizes[j], 0);
+
+            ucs::fill_random(sendbuf);
+            my_recv_req = recv_nb(&recvbuf[0], recvbuf.size(), DATATYPE,
+                                  0x1337, 0xffff);
+            ASSERT_TRUE(!UCS_PTR_IS_ERR(my_recv_req));
+
+            send_b(&sendbuf[0], sendbuf.size(), DATATYPE, 0x111337);
+            wait(my_recv_req);
+
+            EXPECT_EQ(sendbuf.size(), my_recv_req->info.length);
+            EXPECT_EQ(sendbuf, recvbuf);
+            request_release(my_recv_req);
+        }
+    }
+
+    /* the tuned thresholds stay within a factor of 2 of the calculated ones */
+    EXPECT_GT(config->tune.count, 0u);
+    EXPECT_TRUE(thresh_in_range(config->am.zcopy_thresh[0], zcopy_thresh));
+    EXPECT_TRUE(thresh_in_range(config->rndv.rma_thresh, rndv_rma_thresh));
+    EXPECT_TRUE(thresh_in_range(config->rndv.am_thresh, rndv_am_thresh));
+}
+
+UCS_TEST_P(test_ucp_tag_match, wildcard_recv_order) {
+    static const ucp_tag_t tag = 0x1337;
+    uint64_t send_data[2] = {0xdeadbeefdeadbeef, 0xbadc0ffebadc0ffe};
+    uint64_t recv_data[2] = {0, 0};
+    request *rreqs[2];
+
+    /* The wildcard receive is posted first, so it must get the first message
+     * even though the second receive has the exact tag */
+    rreqs[0] = recv_nb(&recv_data[0], sizeof(recv_data[0]), DATATYPE, 0, 0);
+    ASSERT_TRUE(!UCS_PTR_IS_ERR(rreqs[0]));
+    rreqs[1] = recv_nb(&recv_data[1], sizeof(recv_data[1]), DATATYPE, tag,
+                       (ucp_tag_t)-1);
+    ASSERT_TRUE(!UCS_PTR_IS_ERR(rreqs[1]));
+
+    send_b(&send_data[0], sizeof(send_data[0]), DATATYPE, tag);
+    send_b(&send_data[1], sizeof(send_data[1]), DATATYPE, tag);
+
+    for (int i = 0; i < 2; ++i) {
+        wait(rreqs[i]);
+        EXPECT_EQ(UCS_OK, rreqs[i]->status);
+        EXPECT_EQ(tag, rreqs[i]->info.sender_tag);
+        EXPECT_EQ(send_data[i], recv_data[i]);
+        request_release(rreqs[i]);
+    }
+}
+
+UCS_TEST_P(test_ucp_tag_match, match_time_vs_depth) {
+    const size_t max_depth = 4096 / ucs::test_time_multiplier();
+    uint64_t send_data = 0xdeadbeefdeadbeef;
+    std::vector<uint64_t> recv_data(max_depth);
+    std::vector<request*> rreqs(max_depth);
+    double exp_usec, unexp_usec;
+    ucp_tag_recv_info_t info;
+    ucs_status_t status;
+    ucs_time_t start;
+
+    skip_loopback();
+
+    for (size_t depth = 1; depth <= max_depth; depth *= 8) {
+        /* Post receives with distinct tags, and send the messages in reverse
+         * order, so each message matches the most recently posted receive */
+        for (size_t i = 0; i < depth; ++i) {
+            rreqs[i] = recv_nb(&recv_data[i], sizeof(recv_data[i]), DATATYPE,
+                               i, (ucp_tag_t)-1);
+            ASSERT_TRUE(!UCS_PTR_IS_ERR(rreqs[i]));
+        }
+
+        start = ucs_get_time();
+        for (size_t i = depth; i > 0; --i) {
+            send_b(&send_data, sizeof(send_data), DATATYPE, i - 1);
+        }
+        for (size_t i = 0; i < depth; ++i) {
+            wait(rreqs[i]);
+            EXPECT_EQ(UCS_OK, rreqs[i]->status);
+            EXPECT_EQ((ucp_tag_t)i, rreqs[i]->info.sender_tag);
+            EXPECT_EQ(send_data, recv_data[i]);
+            request_release(rreqs[i]);
+        }
+        exp_usec = ucs_time_to_usec(ucs_get_time() - start) / depth;
+
+        /* Same for unexpected messages */
+        for (size_t i = 0; i < depth; ++i) {
+            send_b(&send_data, sizeof(send_data), DATATYPE, i);
+        }
+        short_progress_loop();
+
+        start = ucs_get_time();
+        for (size_t i = depth; i > 0; --i) {
+            status = recv_b(&recv_data[0], sizeof(recv_data[0]), DATATYPE,
+                            i - 1, (ucp_tag_t)-1, &info);
+            ASSERT_UCS_OK(status);
+            EXPECT_EQ((ucp_tag_t)(i - 1), info.sender_tag);
+        }
+        unexp_usec = ucs_time_to_usec(ucs_get_time() - start) / depth;
+
+        UCS_TEST_MESSAGE << "depth " << depth << ": expected " << exp_usec
+                         << " usec/msg, unexpected " << unexp_usec << " usec/msg";
+    }
+}
+
 UCP_INSTANTIATE_TEST_CASE(test_ucp_tag_match)
@@ -9,11 +9,13 @@
 
 extern "C" {
 #include <ucp/core/ucp_ep.inl>
+#include <ucp/core/ucp_worker.h>
 #include <ucs/datastruct/queue.h>
 }
 
 #include <common/test_helpers.h>
 #include <iostream>
+#include <set>
 
 
 class test_ucp_tag_xfer : public test_ucp_tag {
@@ -23,6 +25,9 @@ public:
     void test_xfer_contig(size_t size, bool expected, bool sync, bool truncated);
     void test_xfer_generic(size_t size, bool expected, bool sync, bool truncated);
     void test_xfer_iov(size_t size, bool expected, bool sync, bool truncated);
+    void test_xfer_strided(size_t size, bool expected, bool sync, bool truncated);
+    void test_xfer_strided_large(size_t size, bool expected, bool sync,
+                                 bool truncated);
     void test_xfer_generic_err(size_t size, bool expected, bool sync, bool truncated);
 
 protected:
@@ -39,6 +44,16 @@ protected:
     void test_xfer_probe(bool send_contig, bool recv_contig,
                          bool expected, bool sync);
 
+    void test_xfer_strided_dt(size_t size, bool expected, bool sync,
+                              bool truncated, size_t block_size,
+                              size_t block_count, size_t block_stride,
+                              size_t row_count, size_t row_stride);
+
+    static ucs_status_t fail_chunk_alloc(ucs_mpool_t *mp, size_t *size_p,
+                                         void **chunk_p);
+
+    static unsigned m_num_failed_chunks;
+
 private:
     size_t do_xfer(const void *sendbuf, void *recvbuf, size_t count,
                    ucp_datatype_t send_dt, ucp_datatype_t recv_dt,
@@ -52,6 +67,15 @@ private:
 
 };
 
+unsigned test_ucp_tag_xfer::m_num_failed_chunks = 0;
+
+ucs_status_t test_ucp_tag_xfer::fail_chunk_alloc(ucs_mpool_t *mp, size_t *size_p,
+                                                 void **chunk_p)
+{
+    ++m_num_failed_chunks;
+    return UCS_ERR_NO_MEMORY;
+}
+
 int check_buffers(const std::vector<char> &sendbuf, const std::vector<char> &recvbuf,
                   size_t recvd, size_t send_iovcnt, size_t recv_iovcnt,
                   size_t size, bool expected, bool sync, const std::string datatype)
@@ -307,6 +331,74 @@ void test_ucp_tag_xfer::test_xfer_iov(size_t size, bool expected, bool sync,
                                size, expected, sync, "IOV"));
 }
 
+void test_ucp_tag_xfer::test_xfer_strided_dt(size_t size, bool expected,
+                                             bool sync, bool truncated,
+                                             size_t block_size,
+                                             size_t block_count,
+                                             size_t block_stride,
+                                             size_t row_count,
+                                             size_t row_stride)
+{
+    const size_t length = block_size * block_count * row_count;
+    const size_t extent = block_size + ((block_count - 1) * block_stride) +
+                          ((row_count - 1) * row_stride);
+    size_t count        = size / length;
+    ucp_datatype_t row_dt, dt;
+    ucs_status_t status;
+
+    /* if count is zero, truncation has no effect */
+    if ((truncated) && (!count)) {
+        truncated = false;
+    }
+
+    /* a matrix of blocks, described by a strided datatype of rows */
+    status = ucp_dt_create_strided(ucp_dt_make_contig(block_size), block_count,
+                                   block_stride, &row_dt);
+    ASSERT_UCS_OK(status);
+    status = ucp_dt_create_strided(row_dt, row_count, row_stride, &dt);
+    ASSERT_UCS_OK(status);
+    ucp_dt_destroy(row_dt);
+
+    std::vector<char> sendbuf(count * extent, 0);
+    std::vector<char> recvbuf(count * extent, 0);
+    std::vector<char> expbuf(count * extent, 0);
+
+    ucs::fill_random(sendbuf.begin(), sendbuf.end());
+    for (size_t i = 0; i < count; ++i) {
+        for (size_t row = 0; row < row_count; ++row) {
+            for (size_t block = 0; block < block_count; ++block) {
+                size_t offset = (i * extent) + (row * row_stride) +
+                                (block * block_stride);
+                memcpy(&expbuf[offset], &sendbuf[offset], block_size);
+            }
+        }
+    }
+
+    size_t recvd = do_xfer(sendbuf.data(), recvbuf.data(), count, dt, dt,
+                           expected, sync, truncated);
+    if (!truncated) {
+        ASSERT_EQ(count * length, recvd);
+        /* the data is placed in the blocks, and the gaps are not touched */
+        EXPECT_TRUE(!check_buffers(expbuf, recvbuf, recvbuf.size(), 1, 1,
+                                   size, expected, sync, "strided"));
+    }
+
+    ucp_dt_destroy(dt);
+}
+
+void test_ucp_tag_xfer::test_xfer_strided(size_t size, bool expected, bool sync,
+                                          bool truncated)
+{
+    test_xfer_strided_dt(size, expected, sync, truncated, 5, 4, 9, 3, 39);
+}
+
+void test_ucp_tag_xfer::test_xfer_strided_large(size_t size, bool expected,
+                                                bool sync, bool truncated)
+{
+    test_xfer_strided_dt(size, expected, sync, truncated, 1000, 4, 1536, 2,
+                         6144);
+}
+
 void test_ucp_tag_xfer::test_xfer_generic_err(size_t size, bool expected,
                                               bool sync, bool truncated)
 {
@@ -493,6 +585,43 @@ UCS_TEST_P(test_ucp_tag_xfer, iov_unexp_sync) {
     test_xfer(&test_ucp_tag_xfer::test_xfer_iov, false, true, false);
 }
 
+UCS_TEST_P(test_ucp_tag_xfer, strided_exp) {
+    test_xfer(&test_ucp_tag_xfer::test_xfer_strided, true, false, false);
+}
+
+UCS_TEST_P(test_ucp_tag_xfer, strided_exp_truncated) {
+    test_xfer(&test_ucp_tag_xfer::test_xfer_strided, true, false, true);
+}
+
+UCS_TEST_P(test_ucp_tag_xfer, strided_unexp) {
+    test_xfer(&test_ucp_tag_xfer::test_xfer_strided, false, false, false);
+}
+
+UCS_TEST_P(test_ucp_tag_xfer, strided_exp_sync) {
+    /* because ucp_tag_send_req return status (instead request) if send operation
+     * completed immediately */
+    skip_loopback();
+    test_xfer(&test_ucp_tag_xfer::test_xfer_strided, true, true, false);
+}
+
+UCS_TEST_P(test_ucp_tag_xfer, strided_unexp_sync) {
+    test_xfer(&test_ucp_tag_xfer::test_xfer_strided, false, true, false);
+}
+
+UCS_TEST_P(test_ucp_tag_xfer, strided_large_exp_zcopy, "ZCOPY_THRESH=1000",
+           "RNDV_THRESH=inf") {
+    test_xfer(&test_ucp_tag_xfer::test_xfer_strided_large, true, false, false);
+}
+
+UCS_TEST_P(test_ucp_tag_xfer, strided_large_unexp_zcopy, "ZCOPY_THRESH=1000",
+           "RNDV_THRESH=inf") {
+    test_xfer(&test_ucp_tag_xfer::test_xfer_strided_large, false, false, false);
+}
+
+UCS_TEST_P(test_ucp_tag_xfer, strided_large_exp_rndv, "RNDV_THRESH=10000") {
+    test_xfer(&test_ucp_tag_xfer::test_xfer_strided_large, true, false, false);
+}
+
 /* send_contig_recv_contig */
 
 UCS_TEST_P(test_ucp_tag_xfer, send_contig_recv_contig_exp, "RNDV_THRESH=1248576") {
@@ -597,6 +726,31 @@ UCS_TEST_P(test_ucp_tag_xfer, send_contig_recv_contig_unexp_sync_rndv_truncated,
     test_run_xfer(true, true, false, false, true);
 }
 
+UCS_TEST_P(test_ucp_tag_xfer, send_contig_recv_contig_exp_rndv_single_lane,
+           "RNDV_THRESH=1000", "MAX_RNDV_LANES=1") {
+    test_run_xfer(true, true, true, false, false);
+}
+
+UCS_TEST_P(test_ucp_tag_xfer, send_contig_recv_contig_unexp_rndv_multi_lane,
+           "RNDV_THRESH=1000", "MAX_RNDV_LANES=8") {
+    test_run_xfer(true, true, false, false, false);
+
+    /* Each rendezvous lane should use a different device */
+    ucp_ep_h ep           = sender().ep();
+    ucp_context_h context = ep->worker->context;
+    std::set<std::string> devices;
+    for (int i = 0; i < UCP_MAX_LANES; ++i) {
+        ucp_lane_index_t lane = ucp_ep_config(ep)->key.rndv_lanes[i];
+        if (lane == UCP_NULL_LANE) {
+            break;
+        }
+
+        std::string dev_name =
+            context->tl_rscs[ucp_ep_get_rsc_index(ep, lane)].tl_rsc.dev_name;
+        EXPECT_TRUE(devices.insert(dev_name).second) << dev_name;
+    }
+}
+
 UCS_TEST_P(test_ucp_tag_xfer, send_contig_recv_contig_exp_rndv_probe, "RNDV_THRESH=1000",
                                                                       "ZCOPY_THRESH=1248576") {
     test_xfer_probe(true, true, true, false);
@@ -608,6 +762,38 @@ UCS_TEST_P(test_ucp_tag_xfer, send_generic_recv_generic_exp_rndv, "RNDV_THRESH=1
     test_run_xfer(false, false, true, false, false);
 }
 
+UCS_TEST_P(test_ucp_tag_xfer, send_generic_recv_generic_unexp_rndv_pipeline,
+           "RNDV_THRESH=1000", "RNDV_FRAG_SIZE=4k", "RNDV_PIPELINE_DEPTH=2") {
+    test_run_xfer(false, false, false, false, false);
+}
+
+UCS_TEST_P(test_ucp_tag_xfer, send_generic_recv_generic_unexp_rndv_pipeline_no_frags,
+           "RNDV_THRESH=1000", "RNDV_FRAG_SIZE=4k", "RNDV_PIPELINE_DEPTH=2") {
+    /* Staging buffers can't be allocated, so the sender falls back to bcopy */
+    ucs_mpool_t *mp           = &sender().worker()->rndv_frag_mp;
+    ucs_mpool_ops_t *orig_ops = mp->data->ops;
+    ucs_mpool_ops_t ops       = *orig_ops;
+
+    ops.chunk_alloc     = fail_chunk_alloc;
+    mp->data->ops       = &ops;
+    m_num_failed_chunks = 0;
+
+    disable_errors();
+    test_run_xfer(false, false, false, false, false);
+    restore_errors();
+
+    mp->data->ops = orig_ops;
+    if (m_num_failed_chunks == 0) {
+        UCS_TEST_SKIP_R("pipelined rendezvous is not used");
+    }
+}
+
+UCS_TEST_P(test_ucp_tag_xfer, send_contig_recv_generic_exp_rndv_pipeline,
+           "RNDV_THRESH=1000", "RNDV_FRAG_SIZE=4k", "RNDV_PIPELINE_DEPTH=1",
+           "ZCOPY_THRESH=inf") {
+    test_run_xfer(true, false, true, false, false);
+}
+
 UCS_TEST_P(test_ucp_tag_xfer, send_generic_recv_generic_exp_rndv_truncated, "RNDV_THRESH=1000") {
     test_run_xfer(false, false, true, false, true);
 }
@@ -9,6 +9,10 @@
 
 #include <algorithm>
 
+extern "C" {
+#include <ucp/core/ucp_worker.h>
+}
+
 class test_ucp_wakeup : public ucp_test {
 public:
     static ucp_params_t get_ctx_params() {
@@ -27,6 +31,9 @@ protected:
         ++comp_cntr;
     }
 
+    static void timer_cb(int id, void *arg) {
+    }
+
     void wait(void *req) {
         do {
             progress();
@@ -112,6 +119,94 @@ UCS_TEST_P(test_ucp_wakeup, signal)
     close(efd);
 }
 
+UCS_TEST_P(test_ucp_wakeup, poll_wait, "WAKEUP_POLL_TIME=100ms")
+{
+    const ucp_datatype_t DATATYPE = ucp_dt_make_contig(1);
+    const uint64_t TAG = 0xdeadbeef;
+    uint64_t send_data = 0x12121212;
+    uint64_t recv_data = 0;
+    void *sreq, *rreq;
+
+    sender().connect(&receiver());
+
+    rreq = ucp_tag_recv_nb(receiver().worker(), &recv_data, sizeof(recv_data),
+                           DATATYPE, TAG, (ucp_tag_t)-1, recv_completion);
+    ASSERT_TRUE(UCS_PTR_IS_PTR(rreq));
+
+    sreq = ucp_tag_send_nb(sender().ep(), &send_data, sizeof(send_data),
+                           DATATYPE, TAG, send_completion);
+    if (UCS_PTR_IS_PTR(sreq)) {
+        while (!ucp_request_is_completed(sreq)) {
+            sender().progress();
+        }
+        ucp_request_release(sreq);
+    } else {
+        ASSERT_UCS_OK(UCS_PTR_STATUS(sreq));
+    }
+
+    /* The receive is completed by the progress calls made while polling */
+    while (!ucp_request_is_completed(rreq)) {
+        ASSERT_UCS_OK(ucp_worker_wait(receiver().worker()));
+    }
+    ucp_request_release(rreq);
+    EXPECT_EQ(send_data, recv_data);
+
+    ucp_worker_flush(sender().worker());
+}
+
+UCS_TEST_P(test_ucp_wakeup, wait_timeout)
+{
+    const int timeout_ms = 10;
+    ucs_time_t deadline  = ucs_get_time() + ucs_time_from_sec(10.0);
+    ucs_time_t start;
+    ucs_status_t status;
+
+    sender().connect(&receiver());
+    sender().flush_worker();
+
+    /* The wait may return early if there are pending events or timers */
+    do {
+        progress();
+        start  = ucs_get_time();
+        status = ucp_worker_wait_timeout(receiver().worker(), timeout_ms);
+    } while ((status == UCS_OK) && (ucs_get_time() < deadline));
+
+    ASSERT_EQ(UCS_ERR_TIMED_OUT, status);
+    EXPECT_GE(ucs_get_time() - start, ucs_time_from_msec(timeout_ms));
+}
+
+UCS_TEST_P(test_ucp_wakeup, wait_timeout_with_timer)
+{
+    const int timeout_ms    = 50;
+    ucp_worker_h worker     = receiver().worker();
+    ucs_time_t start;
+    ucs_status_t status;
+    int timer_id;
+
+    sender().connect(&receiver());
+    sender().flush_worker();
+
+    /* A timer much shorter than the timeout cuts every epoll_wait() short, but
+     * the wait should return only after the timeout, or on a missed event */
+    status = ucs_async_add_timer(worker->async.mode, ucs_time_from_msec(1),
+                                 timer_cb, NULL, &worker->async, &timer_id);
+    ASSERT_UCS_OK(status);
+
+    for (int i = 0; i < 5; ++i) {
+        progress();
+        start  = ucs_get_time();
+        status = ucp_worker_wait_timeout(worker, timeout_ms);
+        if (status != UCS_OK) {
+            break;
+        }
+    }
+
+    ucs_async_remove_handler(timer_id, 1);
+
+    ASSERT_EQ(UCS_ERR_TIMED_OUT, status);
+    EXPECT_GE(ucs_get_time() - start, ucs_time_from_msec(timeout_ms));
+}
+
 UCP_INSTANTIATE_TEST_CASE(test_ucp_wakeup)
 
 class test_ucp_wakeup_events : public test_ucp_wakeup
@@ -200,6 +200,10 @@ public:
         ucs_async_check_miss(&m_async);
     }
 
+    ucs_time_t timer_interval() {
+        return ucs_async_get_timer_interval(&m_async);
+    }
+
     virtual void poll() {
         ucs_async_poll(&m_async);
     }
@@ -427,6 +431,14 @@ UCS_TEST_P(test_async, ctx_timer) {
     EXPECT_GE(lt.count(), COUNT / 4);
 }
 
+UCS_TEST_P(test_async, ctx_timer_interval) {
+    local_event le(GetParam());
+    EXPECT_EQ(UCS_TIME_INFINITY, le.timer_interval());
+
+    local_timer lt(GetParam());
+    EXPECT_EQ(ucs_time_from_usec(1000), lt.timer_interval());
+}
+
 UCS_TEST_P(test_async, two_timers) {
     local_timer lt1(GetParam());
     local_timer lt2(GetParam());
@@ -44,10 +44,11 @@ protected:
         ucs::test_base::cleanup();
     }
 
-    static void callback_proxy(void *arg)
+    static unsigned callback_proxy(void *arg)
     {
         callback_ctx *ctx = reinterpret_cast<callback_ctx*>(arg);
         ctx->test->callback(ctx);
+        return 1;
     }
 
     static void callback_slow_proxy(ucs_callbackq_slow_elem_t *self)
@@ -101,11 +102,13 @@ protected:
         }
     }
 
-    void dispatch(unsigned count = 1)
+    unsigned dispatch(unsigned count = 1)
     {
+        unsigned num_events = 0;
         for (unsigned i = 0; i < count; ++i) {
-            ucs_callbackq_dispatch(&m_cbq);
+            num_events += ucs_callbackq_dispatch(&m_cbq);
         }
+        return num_events;
     }
 
     void purge_slow(size_t exp_count)
@@ -180,6 +183,27 @@ UCS_TEST_P(test_callbackq, multi) {
     }
 }
 
+UCS_TEST_P(test_callbackq, num_events) {
+    static const unsigned COUNT = 3;
+
+    callback_ctx ctx[COUNT];
+
+    EXPECT_EQ(0u, dispatch());
+
+    for (unsigned i = 0; i < COUNT; ++i) {
+        init_ctx(&ctx[i]);
+        add(&ctx[i]);
+    }
+
+    /* Slow path callbacks do not report events */
+    EXPECT_EQ(is_fast_path ? COUNT : 0, dispatch());
+
+    for (unsigned i = 0; i < COUNT; ++i) {
+        remove(&ctx[i]);
+    }
+    EXPECT_EQ(0u, dispatch());
+}
+
 UCS_TEST_P(test_callbackq, remove_self) {
     callback_ctx ctx;
 
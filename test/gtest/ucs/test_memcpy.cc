@@ -0,0 +1,134 @@
+/**
+* Copyright (C) Mellanox Technologies Ltd. 2001-2017.  ALL RIGHTS RESERVED.
+*
+* See file LICENSE for terms.
+*/
+
+#include <common/test.h>
+extern "C" {
+#include <ucs/arch/memcpy.h>
+#include <ucs/sys/math.h>
+#include <ucs/time/time.h>
+}
+
+#include <vector>
+
+static const size_t GUARD         = 64;
+static const char   GUARD_PATTERN = 0x5a;
+
+class test_memcpy : public ucs::test {
+protected:
+    typedef void (*copy_func_t)(void *dst, const void *src, size_t len);
+
+    /* Copy with the given alignments, and check the destination was filled and
+     * the memory around it was not touched */
+    void check_copy(copy_func_t func, size_t len, size_t src_offset,
+                    size_t dst_offset) {
+        std::vector<char> src(len + src_offset);
+        std::vector<char> dst(len + dst_offset + (2 * GUARD), GUARD_PATTERN);
+        char *dst_buf = &dst[GUARD + dst_offset];
+
+        for (size_t i = 0; i < src.size(); ++i) {
+            src[i] = rand();
+        }
+
+        func(dst_buf, &src[src_offset], len);
+
+        ASSERT_EQ(0, memcmp(dst_buf, &src[src_offset], len))
+            << "len " << len << " src_offset " << src_offset
+            << " dst_offset " << dst_offset;
+        for (size_t i = 0; i < GUARD + dst_offset; ++i) {
+            ASSERT_EQ(GUARD_PATTERN, dst[i]) << "underflow at " << i;
+        }
+        for (size_t i = GUARD + dst_offset + len; i < dst.size(); ++i) {
+            ASSERT_EQ(GUARD_PATTERN, dst[i]) << "overflow at " << i;
+        }
+    }
+
+    /* Copy bandwidth in MB/s, using a buffer which is reused between the
+     * iterations, as a pack/unpack buffer would be */
+    static double measure(copy_func_t func, char *dst, const char *src,
+                          size_t len) {
+        size_t total = ucs_max(len, 256 * UCS_MBYTE);
+        size_t iters = total / len;
+        ucs_time_t start_time;
+
+        func(dst, src, len);
+        start_time = ucs_get_time();
+        for (size_t i = 0; i < iters; ++i) {
+            func(dst, src, len);
+        }
+
+        return (iters * len) /
+               ucs_time_to_sec(ucs_get_time() - start_time) / UCS_MBYTE;
+    }
+
+    static void libc_memcpy(void *dst, const void *src, size_t len) {
+        memcpy(dst, src, len);
+    }
+
+    static void relaxed_memcpy(void *dst, const void *src, size_t len) {
+        ucs_memcpy_relaxed(dst, src, len);
+    }
+};
+
+UCS_TEST_F(test_memcpy, small) {
+    for (size_t len = 0; len <= UCS_MEMCPY_SMALL_MAX; ++len) {
+        for (size_t offset = 0; offset < 8; ++offset) {
+            check_copy(ucs_memcpy_small, len, offset, 7 - offset);
+        }
+    }
+}
+
+UCS_TEST_F(test_memcpy, nontemporal) {
+    static const size_t lengths[] = { 0, 1, 15, 63, 64, 65, 255, 256, 257,
+                                      4095, 4096, 65536 + 17 };
+
+    for (int engine = 0; engine < UCS_MEMCPY_ENGINE_LAST; ++engine) {
+        copy_func_t func = ucs_arch_memcpy_nt_func((ucs_memcpy_engine_t)engine);
+        if (func == NULL) {
+            continue;
+        }
+
+        UCS_TEST_MESSAGE << "engine " << ucs_memcpy_engine_names[engine];
+        for (size_t i = 0; i < sizeof(lengths) / sizeof(lengths[0]); ++i) {
+            for (size_t offset = 0; offset < 64; offset += 7) {
+                check_copy(func, lengths[i], offset, (offset * 3) % 64);
+            }
+        }
+    }
+}
+
+UCS_TEST_F(test_memcpy, relaxed) {
+    size_t orig_thresh = ucs_global_opts.memcpy_nt_thresh;
+
+    /* make sure the non-temporal path is taken */
+    ucs_global_opts.memcpy_nt_thresh = 4096;
+    for (size_t len = 0; len < 3 * 4096; len += 511) {
+        check_copy(relaxed_memcpy, len, len % 7, len % 5);
+    }
+    ucs_global_opts.memcpy_nt_thresh = orig_thresh;
+}
+
+UCS_TEST_F(test_memcpy, perf) {
+    if (ucs::test_time_multiplier() > 1) {
+        UCS_TEST_SKIP_R("Long run expected. Skipped.");
+    }
+
+    static const size_t max_len = 64 * UCS_MBYTE;
+    ucs_memcpy_engine_t engine  = ucs_memcpy_get_engine();
+    std::vector<char> src(max_len), dst(max_len);
+
+    UCS_TEST_MESSAGE << "non-temporal engine: "
+                     << ucs_memcpy_engine_names[engine] << ", threshold: "
+                     << ucs_global_opts.memcpy_nt_thresh;
+    UCS_TEST_MESSAGE << "size : libc MB/s : relaxed MB/s : non-temporal MB/s";
+    for (size_t len = 8; len <= max_len; len *= 4) {
+        UCS_TEST_MESSAGE << len << " : "
+                         << measure(libc_memcpy, &dst[0], &src[0], len) << " : "
+                         << measure(relaxed_memcpy, &dst[0], &src[0], len)
+                         << " : "
+                         << measure(ucs_arch_memcpy_nt_func(engine), &dst[0],
+                                    &src[0], len);
+    }
+}
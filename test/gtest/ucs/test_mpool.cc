@@ -42,7 +42,7 @@ UCS_TEST_F(test_mpool, no_allocs) {
     };
 
     status = ucs_mpool_init(&mp, 0, header_size + data_size, header_size, align,
-                             6, 18, &ops, "test");
+                             6, 18, 0, &ops, "test");
     ASSERT_UCS_OK(status);
     ucs_mpool_cleanup(&mp, 1);
 }
@@ -69,7 +69,7 @@ UCS_TEST_F(test_mpool, basic) {
         }
 #endif
         status = ucs_mpool_init(&mp, 0, header_size + data_size, header_size, align,
-                                 6, 18, &ops, "test");
+                                 6, 18, 0, &ops, "test");
         ASSERT_UCS_OK(status);
 
         for (unsigned loop = 0; loop < 10; ++loop) {
@@ -107,7 +107,7 @@ UCS_TEST_F(test_mpool, custom_alloc) {
     };
 
     status = ucs_mpool_init(&mp, 0, header_size + data_size, header_size, align,
-                            5, 18, &ops, "test");
+                            5, 18, 0, &ops, "test");
     ASSERT_UCS_OK(status);
 
     void *obj = ucs_mpool_get(&mp);
@@ -131,7 +131,7 @@ UCS_TEST_F(test_mpool, infinite) {
     };
 
     status = ucs_mpool_init(&mp, 0, header_size + data_size, header_size, align,
-                            10000, UINT_MAX, &ops, "test");
+                            10000, UINT_MAX, 0, &ops, "test");
     ASSERT_UCS_OK(status);
 
     std::queue<void*> q;
@@ -148,3 +148,169 @@ UCS_TEST_F(test_mpool, infinite) {
 
     ucs_mpool_cleanup(&mp, 1);
 }
+
+UCS_TEST_F(test_mpool, chunk_flags) {
+    static const unsigned flags[] = {
+        UCS_MPOOL_FLAG_HUGETLB,
+        UCS_MPOOL_FLAG_NUMA_LOCAL | UCS_MPOOL_FLAG_PREFAULT,
+        UCS_MPOOL_FLAG_HUGETLB | UCS_MPOOL_FLAG_NUMA_LOCAL |
+        UCS_MPOOL_FLAG_PREFAULT | UCS_MPOOL_FLAG_THREAD_SAFE
+    };
+    ucs_mpool_t mp;
+    ucs_status_t status;
+
+    ucs_mpool_ops_t ops = {
+       ucs_mpool_chunk_mmap,
+       ucs_mpool_chunk_munmap,
+       NULL,
+       NULL
+    };
+
+    for (unsigned i = 0; i < sizeof(flags) / sizeof(flags[0]); ++i) {
+        status = ucs_mpool_init(&mp, 0, header_size + data_size, header_size,
+                                align, 64, UINT_MAX, flags[i], &ops, "test");
+        ASSERT_UCS_OK(status);
+
+        std::vector<void*> objs;
+        for (unsigned j = 0; j < 1000; ++j) {
+            void *obj = ucs_mpool_get(&mp);
+            ASSERT_TRUE(obj != NULL);
+            EXPECT_EQ(0ul, ((uintptr_t)obj + header_size) % align);
+            memset(obj, 0xff, data_size);
+            objs.push_back(obj);
+        }
+
+        for (std::vector<void*>::iterator iter = objs.begin();
+             iter != objs.end(); ++iter)
+        {
+            ucs_mpool_put(*iter);
+        }
+
+        ucs_mpool_cleanup(&mp, 1);
+    }
+}
+
+
+class test_mpool_mt : public test_mpool {
+protected:
+    static const unsigned NUM_OBJS = 100;
+    static const unsigned ITERS    = 1000;
+
+    virtual void init() {
+        static ucs_mpool_ops_t ops = {
+           ucs_mpool_chunk_malloc,
+           ucs_mpool_chunk_free,
+           NULL,
+           NULL
+        };
+
+        test_mpool::init();
+        ucs_status_t status = ucs_mpool_init(&m_mp, 0, header_size + data_size,
+                                             header_size, align, 16, UINT_MAX,
+                                             UCS_MPOOL_FLAG_THREAD_SAFE, &ops,
+                                             "test_mt");
+        ASSERT_UCS_OK(status);
+        pthread_mutex_init(&m_lock, NULL);
+    }
+
+    virtual void cleanup() {
+        EXPECT_TRUE(m_shared.empty());
+        pthread_mutex_destroy(&m_lock);
+        ucs_mpool_cleanup(&m_mp, 1);
+        test_mpool::cleanup();
+    }
+
+    void *get_checked() {
+        void *obj = ucs_mpool_get(&m_mp);
+        EXPECT_TRUE(obj != NULL);
+        EXPECT_EQ(0ul, ((uintptr_t)obj + header_size) % align);
+        return obj;
+    }
+
+    ucs_mpool_t            m_mp;
+    pthread_mutex_t        m_lock;
+    std::vector<void*>     m_shared;
+};
+
+const unsigned test_mpool_mt::NUM_OBJS;
+const unsigned test_mpool_mt::ITERS;
+
+
+UCS_TEST_F(test_mpool_mt, limit) {
+    ucs_mpool_t mp;
+    ucs_status_t status;
+
+    ucs_mpool_ops_t ops = {
+       ucs_mpool_chunk_malloc,
+       ucs_mpool_chunk_free,
+       NULL,
+       NULL
+    };
+
+    status = ucs_mpool_init(&mp, 0, header_size + data_size, header_size, align,
+                            6, 18, UCS_MPOOL_FLAG_THREAD_SAFE, &ops, "test");
+    ASSERT_UCS_OK(status);
+
+    for (unsigned loop = 0; loop < 3; ++loop) {
+        std::vector<void*> objs;
+        for (unsigned i = 0; i < 18; ++i) {
+            void *obj = ucs_mpool_get(&mp);
+            ASSERT_TRUE(obj != NULL);
+            objs.push_back(obj);
+        }
+
+        EXPECT_TRUE(NULL == ucs_mpool_get(&mp));
+        EXPECT_TRUE(ucs_mpool_is_empty(&mp));
+
+        for (std::vector<void*>::iterator iter = objs.begin();
+             iter != objs.end(); ++iter)
+        {
+            ucs_mpool_put(*iter);
+        }
+    }
+
+    ucs_mpool_cleanup(&mp, 1);
+}
+
+UCS_MT_TEST_F(test_mpool_mt, get_put, 8) {
+    std::vector<void*> objs;
+    unsigned long pattern = (unsigned long)pthread_self();
+
+    for (unsigned iter = 0; iter < ITERS / ucs::test_time_multiplier(); ++iter) {
+        for (unsigned i = 0; i < NUM_OBJS; ++i) {
+            unsigned long *obj = (unsigned long*)get_checked();
+            ASSERT_TRUE(obj != NULL);
+            *obj = pattern + i;
+            objs.push_back(obj);
+        }
+
+        for (unsigned i = 0; i < NUM_OBJS; ++i) {
+            EXPECT_EQ(pattern + i, *(unsigned long*)objs[i]);
+            ucs_mpool_put(objs[i]);
+        }
+        objs.clear();
+    }
+}
+
+UCS_MT_TEST_F(test_mpool_mt, remote_put, 8) {
+    /* Objects are released by a different thread than the one which allocated
+     * them, so elements move between magazines through the depot */
+    for (unsigned iter = 0; iter < ITERS / ucs::test_time_multiplier(); ++iter) {
+        for (unsigned i = 0; i < NUM_OBJS; ++i) {
+            void *obj = get_checked();
+            ASSERT_TRUE(obj != NULL);
+            pthread_mutex_lock(&m_lock);
+            m_shared.push_back(obj);
+            pthread_mutex_unlock(&m_lock);
+        }
+
+        /* Every thread pushes before popping, so the list is not empty */
+        for (unsigned i = 0; i < NUM_OBJS; ++i) {
+            pthread_mutex_lock(&m_lock);
+            void *obj = m_shared.back();
+            m_shared.pop_back();
+            pthread_mutex_unlock(&m_lock);
+            ucs_mpool_put(obj);
+        }
+    }
+}
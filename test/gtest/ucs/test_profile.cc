@@ -12,6 +12,8 @@ extern "C" {
 
 #include <fstream>
 #include <set>
+#include <vector>
+#include <pthread.h>
 
 
 #if HAVE_PROFILING
@@ -51,10 +53,23 @@ public:
     static const char* UCS_PROFILE_FILENAME;
     static const int   MIN_LINE;
     static const int   MAX_LINE;
+    static const unsigned NUM_LOCATIONS = 12u;
+
+    struct thread_data {
+        ucs_profile_thread_header_t   *header;
+        ucs_profile_thread_location_t *locations;
+        ucs_profile_record_t          *records;
+    };
 
     void test_header(ucs_profile_header_t *hdr, unsigned exp_mode);
-    void test_locations(ucs_profile_location_t *locations, unsigned num_locations,
-                        uint64_t exp_count);
+    void test_locations(ucs_profile_location_t *locations, unsigned num_locations);
+    void test_thread_locations(thread_data *thread, unsigned num_locations,
+                               uint64_t exp_count);
+    void test_records(ucs_profile_location_t *locations, thread_data *thread);
+    std::vector<thread_data> get_threads(ucs_profile_header_t *hdr);
+
+    static void *profile_thread_func(void *arg);
+    static void *profile_loop_thread_func(void *arg);
 };
 
 const char* test_profile::UCS_PROFILE_FILENAME = "test.prof";
@@ -64,6 +79,7 @@ static int sum(int a, int b)
     return a + b;
 }
 
+const unsigned test_profile::NUM_LOCATIONS;
 const int test_profile::MIN_LINE = __LINE__;
 
 static void *test_request = &test_request;
@@ -94,7 +110,7 @@ void test_profile::test_header(ucs_profile_header_t *hdr, unsigned exp_mode)
 }
 
 void test_profile::test_locations(ucs_profile_location_t *locations,
-                                  unsigned num_locations, uint64_t exp_count)
+                                  unsigned num_locations)
 {
     std::set<std::string> loc_names;
     for (unsigned i = 0; i < num_locations; ++i) {
@@ -102,8 +118,6 @@ void test_profile::test_locations(ucs_profile_location_t *locations,
         EXPECT_EQ(std::string(basename(__FILE__)), std::string(loc->file));
         EXPECT_GE(loc->line, MIN_LINE);
         EXPECT_LE(loc->line, MAX_LINE);
-        EXPECT_LT(loc->total_time, ucs_time_from_sec(1.0) * ucs::test_time_multiplier());
-        EXPECT_EQ(exp_count, locations[i].count);
         loc_names.insert(loc->name);
     }
 
@@ -116,6 +130,86 @@ void test_profile::test_locations(ucs_profile_location_t *locations,
     EXPECT_NE(loc_names.end(), loc_names.find("work"));
 }
 
+void test_profile::test_thread_locations(thread_data *thread,
+                                         unsigned num_locations,
+                                         uint64_t exp_count)
+{
+    for (unsigned i = 0; i < num_locations; ++i) {
+        ucs_profile_thread_location_t *loc = &thread->locations[i];
+        EXPECT_LT(loc->total_time, ucs_time_from_sec(1.0) * ucs::test_time_multiplier());
+        EXPECT_EQ(exp_count, loc->count);
+    }
+}
+
+void test_profile::test_records(ucs_profile_location_t *locations,
+                                thread_data *thread)
+{
+    uint64_t prev_ts = thread->records[0].timestamp;
+    for (uint64_t i = 0; i < thread->header->num_records; ++i) {
+        ucs_profile_record_t *rec = &thread->records[i];
+        EXPECT_GE(rec->location, 0u);
+        EXPECT_LT(rec->location, NUM_LOCATIONS);
+        EXPECT_GE(rec->timestamp, prev_ts);
+        prev_ts = rec->timestamp;
+        ucs_profile_location_t *loc = &locations[rec->location];
+        if ((loc->type == UCS_PROFILE_TYPE_REQUEST_NEW) ||
+            (loc->type == UCS_PROFILE_TYPE_REQUEST_EVENT) ||
+            (loc->type == UCS_PROFILE_TYPE_REQUEST_FREE))
+        {
+            EXPECT_EQ((uintptr_t)&test_request, rec->param64);
+        }
+    }
+}
+
+/* Returns the threads which recorded data */
+std::vector<test_profile::thread_data>
+test_profile::get_threads(ucs_profile_header_t *hdr)
+{
+    std::vector<thread_data> threads;
+    ucs_profile_location_t *locations = reinterpret_cast<ucs_profile_location_t*>(hdr + 1);
+    char *ptr = reinterpret_cast<char*>(locations + hdr->num_locations);
+
+    for (unsigned i = 0; i < hdr->num_threads; ++i) {
+        thread_data thread;
+        thread.header    = reinterpret_cast<ucs_profile_thread_header_t*>(ptr);
+        thread.locations = reinterpret_cast<ucs_profile_thread_location_t*>(thread.header + 1);
+        thread.records   = reinterpret_cast<ucs_profile_record_t*>(thread.locations +
+                                                                   hdr->num_locations);
+        ptr              = reinterpret_cast<char*>(thread.records +
+                                                   thread.header->num_records);
+        EXPECT_LE(thread.header->start_time, thread.header->end_time);
+
+        bool active = (thread.header->num_records > 0);
+        for (unsigned j = 0; j < hdr->num_locations; ++j) {
+            active = active || (thread.locations[j].count > 0);
+        }
+        if (active) {
+            threads.push_back(thread);
+        }
+    }
+    return threads;
+}
+
+void *test_profile::profile_thread_func(void *arg)
+{
+    for (int i = 0; i < *reinterpret_cast<int*>(arg); ++i) {
+        profile_test_func1();
+        profile_test_func2(1, 2);
+    }
+    return NULL;
+}
+
+void *test_profile::profile_loop_thread_func(void *arg)
+{
+    volatile bool *stop = reinterpret_cast<volatile bool*>(arg);
+
+    while (!*stop) {
+        profile_test_func1();
+        profile_test_func2(1, 2);
+    }
+    return NULL;
+}
+
 UCS_TEST_F(test_profile, accum) {
     scoped_profile p(*this, UCS_PROFILE_FILENAME, "accum");
     profile_test_func1();
@@ -125,12 +219,15 @@ UCS_TEST_F(test_profile, accum) {
     ucs_profile_header_t *hdr = reinterpret_cast<ucs_profile_header_t*>(&data[0]);
     test_header(hdr, UCS_BIT(UCS_PROFILE_MODE_ACCUM));
 
-    EXPECT_EQ(12u, hdr->num_locations);
+    EXPECT_EQ(NUM_LOCATIONS, hdr->num_locations);
     test_locations(reinterpret_cast<ucs_profile_location_t*>(hdr + 1),
-                   hdr->num_locations,
-                   1);
+                   hdr->num_locations);
 
-    EXPECT_EQ(0u, hdr->num_records);
+    std::vector<thread_data> threads = get_threads(hdr);
+    ASSERT_EQ(1u, threads.size());
+    EXPECT_EQ(ucs_get_tid(), (pid_t)threads[0].header->tid);
+    test_thread_locations(&threads[0], hdr->num_locations, 1);
+    EXPECT_EQ(0u, threads[0].header->num_records);
 }
 
 UCS_TEST_F(test_profile, log) {
@@ -145,28 +242,81 @@ UCS_TEST_F(test_profile, log) {
     ucs_profile_header_t *hdr = reinterpret_cast<ucs_profile_header_t*>(&data[0]);
     test_header(hdr, UCS_BIT(UCS_PROFILE_MODE_LOG));
 
-    EXPECT_EQ(12u, hdr->num_locations);
+    EXPECT_EQ(NUM_LOCATIONS, hdr->num_locations);
     ucs_profile_location_t *locations = reinterpret_cast<ucs_profile_location_t*>(hdr + 1);
-    test_locations(locations, hdr->num_locations, 0);
-
-    EXPECT_EQ(12 * ITER, (int)hdr->num_records);
-    ucs_profile_record_t *records = reinterpret_cast<ucs_profile_record_t*>(locations +
-                                                                            hdr->num_locations);
-    uint64_t prev_ts = records[0].timestamp;
-    for (uint64_t i = 0; i < hdr->num_records; ++i) {
-        ucs_profile_record_t *rec = &records[i];
-        EXPECT_GE(rec->location, 0u);
-        EXPECT_LT(rec->location, 12u);
-        EXPECT_GE(rec->timestamp, prev_ts);
-        prev_ts = rec->timestamp;
-        ucs_profile_location_t *loc = &locations[rec->location];
-        if ((loc->type == UCS_PROFILE_TYPE_REQUEST_NEW) ||
-            (loc->type == UCS_PROFILE_TYPE_REQUEST_EVENT) ||
-            (loc->type == UCS_PROFILE_TYPE_REQUEST_FREE))
-        {
-            EXPECT_EQ((uintptr_t)&test_request, rec->param64);
-        }
+    test_locations(locations, hdr->num_locations);
+
+    std::vector<thread_data> threads = get_threads(hdr);
+    ASSERT_EQ(1u, threads.size());
+    EXPECT_EQ(ucs_get_tid(), (pid_t)threads[0].header->tid);
+    EXPECT_EQ(NUM_LOCATIONS * ITER, threads[0].header->num_records);
+    test_records(locations, &threads[0]);
+}
+
+UCS_TEST_F(test_profile, multi_thread) {
+    static const unsigned NUM_THREADS = 4;
+    static int iter = 3;
+    scoped_profile p(*this, UCS_PROFILE_FILENAME, "accum,log");
+    pthread_t threads[NUM_THREADS];
+
+    for (unsigned i = 0; i < NUM_THREADS; ++i) {
+        pthread_create(&threads[i], NULL, profile_thread_func, &iter);
+    }
+    for (unsigned i = 0; i < NUM_THREADS; ++i) {
+        pthread_join(threads[i], NULL);
     }
+
+    std::string data = p.read();
+    ucs_profile_header_t *hdr = reinterpret_cast<ucs_profile_header_t*>(&data[0]);
+    test_header(hdr, UCS_BIT(UCS_PROFILE_MODE_ACCUM) | UCS_BIT(UCS_PROFILE_MODE_LOG));
+
+    EXPECT_EQ(NUM_LOCATIONS, hdr->num_locations);
+    ucs_profile_location_t *locations = reinterpret_cast<ucs_profile_location_t*>(hdr + 1);
+    test_locations(locations, hdr->num_locations);
+
+    /* Every thread has its own records and counters */
+    std::vector<thread_data> thread_datas = get_threads(hdr);
+    ASSERT_EQ(NUM_THREADS, thread_datas.size());
+    std::set<uint32_t> tids;
+    for (unsigned i = 0; i < NUM_THREADS; ++i) {
+        tids.insert(thread_datas[i].header->tid);
+        test_thread_locations(&thread_datas[i], hdr->num_locations, iter);
+        EXPECT_EQ(NUM_LOCATIONS * iter, thread_datas[i].header->num_records);
+        test_records(locations, &thread_datas[i]);
+    }
+    EXPECT_EQ(NUM_THREADS, tids.size());
+}
+
+/* The data of a live thread is dumped and reset while it keeps recording */
+UCS_TEST_F(test_profile, dump_while_recording) {
+    const int num_dumps = 100 / ucs::test_time_multiplier();
+    scoped_profile p(*this, UCS_PROFILE_FILENAME, "accum,log");
+    volatile bool stop = false;
+    pthread_t thread;
+
+    pthread_create(&thread, NULL, profile_loop_thread_func, (void*)&stop);
+    for (int i = 0; i < num_dumps; ++i) {
+        ucs_profile_dump();
+    }
+    ucs_profile_global_cleanup();
+    ucs_profile_global_init();
+
+    /* let the thread register all locations again */
+    while (*(volatile unsigned*)&ucs_profile_ctx.num_locations < NUM_LOCATIONS) {
+        sched_yield();
+    }
+    stop = true;
+    pthread_join(thread, NULL);
+
+    std::string data = p.read();
+    ucs_profile_header_t *hdr = reinterpret_cast<ucs_profile_header_t*>(&data[0]);
+    ucs_profile_location_t *locations = reinterpret_cast<ucs_profile_location_t*>(hdr + 1);
+
+    /* The thread restarted from a clean state after the last reset */
+    std::vector<thread_data> threads = get_threads(hdr);
+    ASSERT_EQ(1u, threads.size());
+    EXPECT_EQ(NUM_LOCATIONS, hdr->num_locations);
+    test_records(locations, &threads[0]);
 }
 
 #endif
@@ -9,7 +9,9 @@ extern "C" {
 #include <ucs/arch/atomic.h>
 #include <ucs/sys/rcache.h>
 #include <ucs/sys/sys.h>
+#include <ucs/time/time.h>
 }
+#include <iomanip>
 
 
 class test_rcache : public ucs::test {
@@ -36,7 +38,9 @@ protected:
             UCS_PGT_ADDR_ALIGN,
             1000,
             &ops,
-            reinterpret_cast<void*>(this)
+            reinterpret_cast<void*>(this),
+            max_regions(),
+            max_size()
         };
         UCS_TEST_CREATE_HANDLE(ucs_rcache_t*, m_rcache, ucs_rcache_destroy,
                                ucs_rcache_create, &params, "test" UCS_STATS_ARG(NULL));
@@ -48,6 +52,14 @@ protected:
         ucs::test::cleanup();
     }
 
+    virtual unsigned max_regions() const {
+        return UINT_MAX;
+    }
+
+    virtual size_t max_size() const {
+        return SIZE_MAX;
+    }
+
     region *get(void *address, size_t length, int prot = PROT_READ|PROT_WRITE) {
         ucs_status_t status;
         ucs_rcache_region_t *r;
@@ -474,3 +486,254 @@ UCS_MT_TEST_F(test_rcache_no_register, register_failure, 10) {
 
     free(ptr);
 }
+
+class test_rcache_limit : public test_rcache {
+protected:
+    static const size_t   REGION_SIZE = 64 * 1024;
+    static const unsigned MAX_REGIONS = 4;
+
+    virtual unsigned max_regions() const {
+        return MAX_REGIONS;
+    }
+
+    /* Regions are registered and released one by one, so their order in the
+     * LRU list is the order of put() calls */
+    void fill(std::vector<void*>& ptrs, std::vector<uint32_t>& ids,
+              unsigned count) {
+        for (unsigned i = 0; i < count; ++i) {
+            void *ptr = alloc_pages(REGION_SIZE, PROT_READ|PROT_WRITE);
+            region *region = get(ptr, REGION_SIZE);
+            ptrs.push_back(ptr);
+            ids.push_back(region->id);
+            put(region);
+        }
+    }
+
+    void release(std::vector<void*>& ptrs) {
+        for (std::vector<void*>::iterator iter = ptrs.begin();
+             iter != ptrs.end(); ++iter) {
+            munmap(*iter, REGION_SIZE);
+        }
+    }
+};
+
+const size_t   test_rcache_limit::REGION_SIZE;
+const unsigned test_rcache_limit::MAX_REGIONS;
+
+UCS_TEST_F(test_rcache_limit, lru_eviction) {
+    std::vector<void*> ptrs;
+    std::vector<uint32_t> ids;
+
+    fill(ptrs, ids, MAX_REGIONS);
+    EXPECT_EQ(MAX_REGIONS, m_reg_count);
+
+    /* Touch the first region to make it the most recently used */
+    region *region = get(ptrs[0], REGION_SIZE);
+    EXPECT_EQ(ids[0], region->id);
+    put(region);
+
+    /* A new region should evict the second one, which is the least recently
+     * used now */
+    fill(ptrs, ids, 1);
+    EXPECT_EQ(MAX_REGIONS, m_reg_count);
+
+    region = get(ptrs[0], REGION_SIZE);
+    EXPECT_EQ(ids[0], region->id);
+    put(region);
+
+    region = get(ptrs[1], REGION_SIZE);
+    EXPECT_NE(ids[1], region->id);
+    put(region);
+
+    EXPECT_EQ(MAX_REGIONS, m_reg_count);
+    release(ptrs);
+}
+
+UCS_TEST_F(test_rcache_limit, in_use_not_evicted) {
+    std::vector<void*> ptrs;
+    std::vector<region*> regions;
+
+    /* Regions which are in use are never evicted, so the cache may grow above
+     * the limit */
+    for (unsigned i = 0; i < MAX_REGIONS * 2; ++i) {
+        ptrs.push_back(alloc_pages(REGION_SIZE, PROT_READ|PROT_WRITE));
+        regions.push_back(get(ptrs.back(), REGION_SIZE));
+    }
+    EXPECT_EQ(MAX_REGIONS * 2, m_reg_count);
+
+    for (unsigned i = 0; i < regions.size(); ++i) {
+        EXPECT_EQ(uint32_t(MAGIC), regions[i]->magic);
+        put(regions[i]);
+    }
+
+    /* Once released, the next registration brings the cache back to the limit */
+    std::vector<uint32_t> ids;
+    fill(ptrs, ids, 1);
+    EXPECT_EQ(MAX_REGIONS, m_reg_count);
+    release(ptrs);
+}
+
+class test_rcache_size_limit : public test_rcache_limit {
+protected:
+    virtual unsigned max_regions() const {
+        return UINT_MAX;
+    }
+
+    virtual size_t max_size() const {
+        return REGION_SIZE * 2;
+    }
+};
+
+UCS_TEST_F(test_rcache_size_limit, max_size) {
+    std::vector<void*> ptrs;
+    std::vector<uint32_t> ids;
+
+    fill(ptrs, ids, 5);
+    EXPECT_EQ(2u, m_reg_count);
+
+    /* The most recent regions are kept */
+    region *region = get(ptrs[4], REGION_SIZE);
+    EXPECT_EQ(ids[4], region->id);
+    put(region);
+
+    release(ptrs);
+}
+
+class test_rcache_no_memory : public test_rcache_limit {
+protected:
+    virtual unsigned max_regions() const {
+        return UINT_MAX;
+    }
+
+    /* Simulate a registration resource limit which is lower than the cache
+     * limit */
+    virtual ucs_status_t mem_reg(region *region) {
+        if (m_reg_count >= MAX_REGIONS) {
+            return UCS_ERR_NO_MEMORY;
+        }
+        return test_rcache::mem_reg(region);
+    }
+
+    static ucs_log_func_rc_t
+    count_errors(const char *file, unsigned line, const char *function,
+                 ucs_log_level_t level, const char *prefix,
+                 const char *message, va_list ap)
+    {
+        if (level == UCS_LOG_LEVEL_ERROR) {
+            ++m_num_errors;
+            return UCS_LOG_FUNC_RC_STOP;
+        }
+        return UCS_LOG_FUNC_RC_CONTINUE;
+    }
+
+    static unsigned m_num_errors;
+};
+
+unsigned test_rcache_no_memory::m_num_errors = 0;
+
+UCS_TEST_F(test_rcache_no_memory, evict_and_retry) {
+    std::vector<void*> ptrs;
+    std::vector<uint32_t> ids;
+
+    m_num_errors = 0;
+    ucs_log_push_handler(count_errors);
+    UCS_TEST_SCOPE_EXIT() { ucs_log_pop_handler(); } UCS_TEST_SCOPE_EXIT_END
+
+    fill(ptrs, ids, MAX_REGIONS * 2);
+    EXPECT_EQ(MAX_REGIONS, m_reg_count);
+
+    /* If all regions are in use, the failure is returned to the caller */
+    std::vector<region*> regions;
+    for (unsigned i = MAX_REGIONS; i < MAX_REGIONS * 2; ++i) {
+        regions.push_back(get(ptrs[i], REGION_SIZE));
+        EXPECT_EQ(ids[i], regions.back()->id);
+    }
+
+    /* Evictions are silent, only the final failure is reported */
+    EXPECT_EQ(0u, m_num_errors);
+
+    void *ptr = alloc_pages(REGION_SIZE, PROT_READ|PROT_WRITE);
+    ucs_rcache_region_t *r;
+    ucs_status_t status = ucs_rcache_get(m_rcache, ptr, REGION_SIZE,
+                                         PROT_READ|PROT_WRITE, NULL, &r);
+    EXPECT_EQ(UCS_ERR_NO_MEMORY, status);
+    EXPECT_EQ(1u, m_num_errors);
+
+    for (unsigned i = 0; i < regions.size(); ++i) {
+        put(regions[i]);
+    }
+
+    munmap(ptr, REGION_SIZE);
+    release(ptrs);
+}
+
+class test_rcache_perf : public test_rcache {
+protected:
+    static const size_t ITERS = 1000000;
+
+    struct thread_args {
+        test_rcache_perf *test;
+        void             *ptr;
+        size_t           size;
+        pthread_barrier_t *barrier;
+    };
+
+    static void *get_put_thread(void *arg) {
+        thread_args *args = reinterpret_cast<thread_args*>(arg);
+
+        pthread_barrier_wait(args->barrier);
+        for (size_t i = 0; i < ITERS; ++i) {
+            args->test->put(args->test->get(args->ptr, args->size));
+        }
+        return NULL;
+    }
+
+    /* Every thread looks up its own cached region, so only the page table
+     * lookup path is shared between the threads */
+    double measure_hits(unsigned num_threads, char *mem, size_t size) {
+        std::vector<pthread_t> threads(num_threads);
+        std::vector<thread_args> args(num_threads);
+        pthread_barrier_t barrier;
+        ucs_time_t start_time;
+
+        pthread_barrier_init(&barrier, NULL, num_threads + 1);
+        for (unsigned i = 0; i < num_threads; ++i) {
+            args[i].test    = this;
+            args[i].ptr     = mem + (i * size);
+            args[i].size    = size;
+            args[i].barrier = &barrier;
+            put(get(args[i].ptr, args[i].size));
+            pthread_create(&threads[i], NULL, get_put_thread, &args[i]);
+        }
+
+        pthread_barrier_wait(&barrier);
+        start_time = ucs_get_time();
+        for (unsigned i = 0; i < num_threads; ++i) {
+            pthread_join(threads[i], NULL);
+        }
+
+        double elapsed = ucs_time_to_sec(ucs_get_time() - start_time);
+        pthread_barrier_destroy(&barrier);
+        return (num_threads * ITERS) / elapsed;
+    }
+};
+
+UCS_TEST_F(test_rcache_perf, mt_hits) {
+    static const unsigned max_threads = 16;
+
+    if (ucs::test_time_multiplier() > 1) {
+        UCS_TEST_SKIP_R("Long run expected. Skipped.");
+    }
+
+    const size_t size = ucs_get_page_size();
+    unsigned num_cpus = ucs_min(sysconf(_SC_NPROCESSORS_ONLN), max_threads);
+    char *mem = (char*)alloc_pages(size * max_threads, PROT_READ|PROT_WRITE);
+
+    UCS_TEST_MESSAGE << "threads : hits/sec";
+    for (unsigned num_threads = 1; num_threads <= num_cpus; num_threads *= 2) {
+        double hits = measure_hits(num_threads, mem, size);
+        UCS_TEST_MESSAGE << std::setw(7) << num_threads << " : " << hits;
+    }
+
+    munmap(mem, size * max_threads);
+}
@@ -93,10 +93,10 @@ public:
             EXPECT_EQ(unsigned(NUM_COUNTERS),  data_node->cls->num_counters);
             EXPECT_EQ(std::string("counter0"), std::string(data_node->cls->counter_names[0]));
 
-            EXPECT_EQ((unsigned)10, data_node->counters[0]);
-            EXPECT_EQ((unsigned)20, data_node->counters[1]);
-            EXPECT_EQ((unsigned)30, data_node->counters[2]);
-            EXPECT_EQ((unsigned)40, data_node->counters[3]);
+            EXPECT_EQ((unsigned)10, UCS_STATS_GET_COUNTER(data_node, 0));
+            EXPECT_EQ((unsigned)20, UCS_STATS_GET_COUNTER(data_node, 1));
+            EXPECT_EQ((unsigned)30, UCS_STATS_GET_COUNTER(data_node, 2));
+            EXPECT_EQ((unsigned)40, UCS_STATS_GET_COUNTER(data_node, 3));
         }
     }
 
@@ -268,6 +268,57 @@ UCS_TEST_F(stats_file_test, report) {
     ucs_stats_free(root);
 }
 
+#if ENABLE_MT
+
+static void *stats_update_thread_func(void *arg)
+{
+    ucs_stats_node_t *node = (ucs_stats_node_t*)arg;
+
+    for (unsigned i = 0; i < 100000; ++i) {
+        UCS_STATS_UPDATE_COUNTER(node, 0, 1);
+        UCS_STATS_UPDATE_COUNTER(node, 1, 2);
+    }
+    return NULL;
+}
+
+UCS_TEST_F(stats_file_test, report_mt) {
+    /* More threads than shards, so some of them share a shard */
+    static const unsigned num_threads = UCS_STATS_NUM_SHARDS + 4;
+    pthread_t threads[num_threads];
+
+    prepare_nodes();
+    for (unsigned i = 0; i < num_threads; ++i) {
+        pthread_create(&threads[i], NULL, stats_update_thread_func, data_nodes[0]);
+    }
+    for (unsigned i = 0; i < num_threads; ++i) {
+        pthread_join(threads[i], NULL);
+    }
+
+    EXPECT_EQ(10 + num_threads * 100000ul, UCS_STATS_GET_COUNTER(data_nodes[0], 0));
+    EXPECT_EQ(20 + num_threads * 200000ul, UCS_STATS_GET_COUNTER(data_nodes[0], 1));
+
+    ucs_stats_dump();
+    free_nodes();
+
+    std::string data = get_data();
+    FILE *f = fmemopen(&data[0], data.size(), "rb");
+    ucs_stats_node_t *root;
+    ucs_status_t status = ucs_stats_deserialize(f, &root);
+    ASSERT_UCS_OK(status);
+    fclose(f);
+
+    ucs_stats_node_t *cat_node = ucs_list_head(&root->children[UCS_STATS_ACTIVE_CHILDREN],
+                                               ucs_stats_node_t, list);
+    ucs_stats_node_t *data_node = ucs_list_head(&cat_node->children[UCS_STATS_ACTIVE_CHILDREN],
+                                                ucs_stats_node_t, list);
+    EXPECT_EQ(10 + num_threads * 100000ul, data_node->counters[0]);
+    EXPECT_EQ(20 + num_threads * 200000ul, data_node->counters[1]);
+    EXPECT_EQ(30ul, data_node->counters[2]);
+    ucs_stats_free(root);
+}
+
+#endif
+
 UCS_TEST_F(stats_on_demand_test, report) {
     prepare_nodes();
     ucs_stats_dump();
@@ -6,8 +6,10 @@
 
 extern "C" {
 #include <uct/api/uct.h>
+#include <uct/sm/mm/mm_ep.h>
 #include <ucs/time/time.h>
 }
+#include <sys/wait.h>
 #include "uct_p2p_test.h"
 #include <common/test.h>
 #include "uct_test.h"
@@ -51,6 +53,12 @@ public:
         return UCS_OK;
     }
 
+    static ucs_status_t count_am_handler(void *arg, void *data, size_t length,
+                                         unsigned flags) {
+        ++(*(unsigned*)arg);
+        return UCS_OK;
+    }
+
     void cleanup() {
         uct_test::cleanup();
     }
@@ -99,4 +107,404 @@ UCS_TEST_P(test_uct_mm, open_for_posix) {
     }
 }
 
+UCS_TEST_P(test_uct_mm, rma_zcopy) {
+    static const size_t length = 65536;
+    static const uint64_t seed = 0x1234;
+
+    initialize();
+    check_caps(UCT_IFACE_FLAG_PUT_ZCOPY | UCT_IFACE_FLAG_GET_ZCOPY);
+
+    /* An active message is always copied to a receive descriptor, which is
+     * what bcopy does, so zcopy is not supported */
+    EXPECT_FALSE(m_e1->iface_attr().cap.flags & UCT_IFACE_FLAG_AM_ZCOPY);
+
+    mapped_buffer sendbuf(length, seed, *m_e1);
+    mapped_buffer remotebuf(length, 0, *m_e2);
+    mapped_buffer getbuf(length, 0, *m_e1);
+
+    /* The data is copied directly to the remote memory, gathered from or
+     * scattered to several buffers */
+    {
+        UCS_TEST_GET_BUFFER_IOV(iov, iovcnt, sendbuf.ptr(), sendbuf.length(),
+                                sendbuf.memh(), m_e1->iface_attr().cap.put.max_iov);
+        ASSERT_UCS_OK(uct_ep_put_zcopy(m_e1->ep(0), iov, iovcnt,
+                                       remotebuf.addr(), remotebuf.rkey(), NULL));
+        remotebuf.pattern_check(seed);
+    }
+
+    {
+        UCS_TEST_GET_BUFFER_IOV(iov, iovcnt, getbuf.ptr(), getbuf.length(),
+                                getbuf.memh(), m_e1->iface_attr().cap.get.max_iov);
+        ASSERT_UCS_OK(uct_ep_get_zcopy(m_e1->ep(0), iov, iovcnt,
+                                       remotebuf.addr(), remotebuf.rkey(), NULL));
+        getbuf.pattern_check(seed);
+    }
+
+    /* Strided elements are gathered to, and scattered from, a contiguous
+     * region of the remote memory */
+    {
+        static const size_t elem_size = 8;
+        uct_iov_t iov;
+
+        iov.buffer = sendbuf.ptr();
+        iov.length = elem_size;
+        iov.memh   = sendbuf.memh();
+        iov.stride = elem_size * 2;
+        iov.count  = length / iov.stride;
+        ASSERT_UCS_OK(uct_ep_put_zcopy(m_e1->ep(0), &iov, 1, remotebuf.addr(),
+                                       remotebuf.rkey(), NULL));
+
+        memset(getbuf.ptr(), 0, length);
+        iov.buffer = getbuf.ptr();
+        iov.memh   = getbuf.memh();
+        ASSERT_UCS_OK(uct_ep_get_zcopy(m_e1->ep(0), &iov, 1, remotebuf.addr(),
+                                       remotebuf.rkey(), NULL));
+
+        std::vector<char> zeros(elem_size, 0);
+        for (unsigned i = 0; i < iov.count; ++i) {
+            char *send_elem   = (char*)sendbuf.ptr() + (i * iov.stride);
+            char *remote_elem = (char*)remotebuf.ptr() + (i * elem_size);
+            char *get_elem    = (char*)getbuf.ptr() + (i * iov.stride);
+
+            ASSERT_EQ(0, memcmp(remote_elem, send_elem, elem_size)) << i;
+            ASSERT_EQ(0, memcmp(get_elem, send_elem, elem_size)) << i;
+            ASSERT_EQ(0, memcmp(get_elem + elem_size, &zeros[0], elem_size)) << i;
+        }
+    }
+}
+
+/* Messages which were left in the FIFO by a limited progress call must keep
+ * the receiver from sleeping */
+UCS_TEST_P(test_uct_mm, wakeup_arm_leftovers, "RX_MAX_POLL=16")
+{
+    const unsigned num_sends = 16 + 8;
+    ucs::handle<uct_wakeup_h> wakeup_handle;
+    unsigned am_count = 0;
+
+    initialize();
+    check_caps(UCT_IFACE_FLAG_WAKEUP | UCT_IFACE_FLAG_AM_SHORT |
+               UCT_IFACE_FLAG_AM_CB_SYNC);
+
+    uct_iface_set_am_handler(m_e2->iface(), 0, count_am_handler, &am_count,
+                             UCT_AM_CB_FLAG_SYNC);
+    UCS_TEST_CREATE_HANDLE(uct_wakeup_h, wakeup_handle, uct_wakeup_close,
+                           uct_wakeup_open, m_e2->iface(),
+                           UCT_WAKEUP_RX_SIGNALED_AM);
+
+    for (unsigned i = 0; i < num_sends; ++i) {
+        ASSERT_UCS_OK(uct_ep_am_short(m_e1->ep(0), 0, 0, NULL, 0));
+    }
+
+    /* a single progress call does not consume all messages */
+    m_e2->progress();
+    ASSERT_LT(am_count, num_sends);
+
+    /* arming again and again does not make the leftovers disappear */
+    for (int i = 0; i < 3; ++i) {
+        EXPECT_EQ(UCS_ERR_BUSY, uct_wakeup_efd_arm(wakeup_handle));
+    }
+
+    while (am_count < num_sends) {
+        m_e2->progress();
+    }
+    EXPECT_EQ(UCS_OK, uct_wakeup_efd_arm(wakeup_handle));
+}
+
 _UCT_INSTANTIATE_TEST_CASE(test_uct_mm, mm)
+
+
+class test_uct_mm_rings : public uct_test {
+public:
+    static const uint8_t  AM_ID       = 1;
+    static const unsigned NUM_SENDERS = 8;
+
+    void init() {
+        if (GetParam()->dev_name == "posix") {
+            set_config("USE_SHM_OPEN=no");
+        }
+        uct_test::init();
+    }
+
+    static ucs_status_t am_handler(void *arg, void *data, size_t length,
+                                   unsigned flags) {
+        test_uct_mm_rings *self = reinterpret_cast<test_uct_mm_rings*>(arg);
+        uint64_t hdr            = *(uint64_t*)data;
+        unsigned sender         = hdr >> 32;
+
+        if (sender < self->m_expected_sn.size()) {
+            EXPECT_EQ(self->m_expected_sn[sender], hdr & UCS_MASK(32))
+                << "sender " << sender;
+            ++self->m_expected_sn[sender];
+        }
+        ++self->m_am_count;
+        return UCS_OK;
+    }
+
+protected:
+    typedef struct {
+        entity            *sender;
+        unsigned          count;
+        pthread_barrier_t *barrier;
+    } thread_args_t;
+
+    void create_receiver() {
+        m_receiver = create_entity(0);
+        m_entities.push_back(m_receiver);
+        ASSERT_UCS_OK(uct_iface_set_am_handler(m_receiver->iface(), AM_ID,
+                                               am_handler, this,
+                                               UCT_AM_CB_FLAG_SYNC));
+    }
+
+    entity* create_sender(unsigned index) {
+        entity *sender = create_entity(0);
+        m_entities.push_back(sender);
+        sender->connect(0, *m_receiver, index);
+        return sender;
+    }
+
+    static void send_am(entity *sender, uint64_t hdr) {
+        ucs_status_t status;
+
+        for (;;) {
+            status = uct_ep_am_short(sender->ep(0), AM_ID, hdr, NULL, 0);
+            if (status != UCS_ERR_NO_RESOURCE) {
+                break;
+            }
+            sender->progress();
+        }
+        ASSERT_UCS_OK(status);
+    }
+
+    static void *send_thread(void *arg) {
+        thread_args_t *args = reinterpret_cast<thread_args_t*>(arg);
+
+        pthread_barrier_wait(args->barrier);
+        for (unsigned i = 0; i < args->count; ++i) {
+            send_am(args->sender, 0);
+        }
+        return NULL;
+    }
+
+    /* Every sender sends from its own thread, and the receiver is progressed
+     * by the calling thread */
+    double measure_msg_rate(unsigned num_senders, unsigned count) {
+        std::vector<thread_args_t> args(num_senders);
+        std::vector<pthread_t> threads(num_senders);
+        pthread_barrier_t barrier;
+        ucs_time_t start_time;
+
+        create_receiver();
+        m_expected_sn.clear();
+        m_am_count = 0;
+
+        pthread_barrier_init(&barrier, NULL, num_senders + 1);
+        for (unsigned i = 0; i < num_senders; ++i) {
+            args[i].sender  = create_sender(i);
+            args[i].count   = count;
+            args[i].barrier = &barrier;
+            pthread_create(&threads[i], NULL, send_thread, &args[i]);
+        }
+
+        pthread_barrier_wait(&barrier);
+        start_time = ucs_get_time();
+        while (m_am_count < (num_senders * count)) {
+            m_receiver->progress();
+        }
+        double elapsed = ucs_time_to_sec(ucs_get_time() - start_time);
+
+        for (unsigned i = 0; i < num_senders; ++i) {
+            pthread_join(threads[i], NULL);
+        }
+        pthread_barrier_destroy(&barrier);
+
+        m_entities.clear();
+        return (num_senders * count) / elapsed;
+    }
+
+    entity                *m_receiver;
+    std::vector<uint64_t> m_expected_sn;
+    unsigned              m_am_count;
+};
+
+const unsigned test_uct_mm_rings::NUM_SENDERS;
+
+/* More senders than rings, so some of them use the shared FIFO */
+UCS_TEST_P(test_uct_mm_rings, many_senders, "SENDER_RINGS=4", "FIFO_SIZE=8")
+{
+    const unsigned num_sends = 1000 / ucs::test_time_multiplier();
+    std::vector<entity*> senders;
+
+    create_receiver();
+    check_caps(UCT_IFACE_FLAG_AM_SHORT | UCT_IFACE_FLAG_AM_CB_SYNC);
+
+    for (unsigned i = 0; i < NUM_SENDERS; ++i) {
+        senders.push_back(create_sender(i));
+    }
+
+    m_expected_sn.resize(NUM_SENDERS, 0);
+    m_am_count = 0;
+
+    std::vector<uint64_t> sn(NUM_SENDERS, 0);
+    for (unsigned i = 0; i < num_sends; ++i) {
+        unsigned sender = ucs::rand() % NUM_SENDERS;
+        uint64_t hdr    = ((uint64_t)sender << 32) | sn[sender]++;
+        ucs_status_t status;
+
+        for (;;) {
+            status = uct_ep_am_short(senders[sender]->ep(0), AM_ID, hdr, NULL, 0);
+            if (status != UCS_ERR_NO_RESOURCE) {
+                break;
+            }
+            senders[sender]->progress();
+            m_receiver->progress();
+        }
+        ASSERT_UCS_OK(status);
+    }
+
+    while (m_am_count < num_sends) {
+        m_receiver->progress();
+    }
+
+    for (unsigned i = 0; i < NUM_SENDERS; ++i) {
+        EXPECT_EQ(sn[i], m_expected_sn[i]);
+    }
+
+    /* a new sender takes the ring of a destroyed one and continues from its
+     * head */
+    senders[0]->destroy_ep(0);
+    senders[0]->connect(0, *m_receiver, 0);
+    for (unsigned i = 0; i < num_sends; ++i) {
+        send_am(senders[0], sn[0]++);
+        m_receiver->progress();
+    }
+
+    while (m_expected_sn[0] < sn[0]) {
+        m_receiver->progress();
+    }
+}
+
+/* Senders attach and claim rings according to the receiver's configuration */
+UCS_TEST_P(test_uct_mm_rings, peer_rings, "FIFO_SIZE=8")
+{
+    const unsigned num_sends = 1000 / ucs::test_time_multiplier();
+    std::vector<entity*> senders;
+
+    set_config("SENDER_RINGS=0");
+    create_receiver();
+    check_caps(UCT_IFACE_FLAG_AM_SHORT | UCT_IFACE_FLAG_AM_CB_SYNC);
+
+    set_config("SENDER_RINGS=" + ucs::to_string(NUM_SENDERS));
+    for (unsigned i = 0; i < NUM_SENDERS; ++i) {
+        senders.push_back(create_sender(i));
+    }
+
+    m_expected_sn.resize(NUM_SENDERS, 0);
+    m_am_count = 0;
+
+    for (unsigned i = 0; i < num_sends; ++i) {
+        unsigned sender = i % NUM_SENDERS;
+        send_am(senders[sender], ((uint64_t)sender << 32) | (i / NUM_SENDERS));
+        m_receiver->progress();
+    }
+
+    while (m_am_count < num_sends) {
+        m_receiver->progress();
+    }
+}
+
+/* A ring whose owner exited is taken over by a new sender, and an element the
+ * owner did not finish writing is written again */
+UCS_TEST_P(test_uct_mm_rings, orphaned_ring, "SENDER_RINGS=1", "FIFO_SIZE=8")
+{
+    /* fewer than the ring size, so a stuck ring does not block the sender */
+    const unsigned num_sends = 6;
+
+    create_receiver();
+    check_caps(UCT_IFACE_FLAG_AM_SHORT | UCT_IFACE_FLAG_AM_CB_SYNC);
+
+    uct_mm_iface_t *iface = ucs_derived_of(m_receiver->iface(), uct_mm_iface_t);
+    uct_mm_fifo_ctl_t *ring_ctl = uct_mm_get_ring_ctl(iface,
+                                                      iface->recv_fifo_ctl, 0);
+
+    /* a live owner keeps its ring */
+    ring_ctl->ring_owner = getppid();
+    entity *sender = create_sender(0);
+    EXPECT_EQ(-1, ucs_derived_of(sender->ep(0), uct_mm_ep_t)->ring_index);
+    sender->destroy_ep(0);
+
+    /* the owner exits after advancing the head, before writing the element */
+    pid_t pid = fork();
+    if (pid == 0) {
+        _exit(0);
+    }
+    ASSERT_GT(pid, 0);
+    ASSERT_EQ(pid, waitpid(pid, NULL, 0));
+
+    ring_ctl->ring_owner = pid;
+    ring_ctl->head       = 1;
+    iface->recv_fifo_ctl->ring_map |= UCS_BIT(0);
+
+    sender->connect(0, *m_receiver, 0);
+    EXPECT_EQ(0, ucs_derived_of(sender->ep(0), uct_mm_ep_t)->ring_index);
+    uint32_t owner = ring_ctl->ring_owner;
+    EXPECT_EQ((uint32_t)getpid(), owner);
+
+    m_expected_sn.resize(1, 0);
+    m_am_count = 0;
+    for (unsigned i = 0; i < num_sends; ++i) {
+        send_am(sender, i);
+        m_receiver->progress();
+    }
+
+    ucs_time_t deadline = ucs_get_time() + ucs_time_from_sec(10.0);
+    while ((m_am_count < num_sends) && (ucs_get_time() < deadline)) {
+        m_receiver->progress();
+    }
+    EXPECT_EQ(num_sends, m_expected_sn[0]);
+}
+
+/* A peer whose FIFO has a different layout is not reachable */
+UCS_TEST_P(test_uct_mm_rings, fifo_mismatch, "FIFO_SIZE=8")
+{
+    create_receiver();
+
+    set_config("FIFO_SIZE=16");
+    entity *sender = create_entity(0);
+    m_entities.push_back(sender);
+
+    std::vector<char> dev_addr(m_receiver->iface_attr().device_addr_len);
+    std::vector<char> iface_addr(m_receiver->iface_attr().iface_addr_len);
+    ASSERT_UCS_OK(uct_iface_get_device_address(m_receiver->iface(),
+                                               (uct_device_addr_t*)&dev_addr[0]));
+    ASSERT_UCS_OK(uct_iface_get_address(m_receiver->iface(),
+                                        (uct_iface_addr_t*)&iface_addr[0]));
+    EXPECT_FALSE(uct_iface_is_reachable(sender->iface(),
+                                        (uct_device_addr_t*)&dev_addr[0],
+                                        (uct_iface_addr_t*)&iface_addr[0]));
+}
+
+UCS_TEST_P(test_uct_mm_rings, many2one_msg_rate)
+{
+    const unsigned count = 10000;
+
+    if (ucs::test_time_multiplier() > 1) {
+        UCS_TEST_SKIP_R("Long run expected. Skipped.");
+    }
+
+    unsigned max_senders = ucs_min(sysconf(_SC_NPROCESSORS_ONLN), NUM_SENDERS);
+
+    UCS_TEST_MESSAGE << "senders : shared FIFO msg/sec : sender rings msg/sec";
+    for (unsigned num_senders = 1; num_senders <= max_senders; num_senders *= 2) {
+        set_config("SENDER_RINGS=0");
+        double shared_rate = measure_msg_rate(num_senders, count);
+
+        set_config("SENDER_RINGS=" + ucs::to_string(NUM_SENDERS));
+        double rings_rate  = measure_msg_rate(num_senders, count);
+
+        UCS_TEST_MESSAGE << std::setw(7) << num_senders << " : "
+                         << std::setw(19) << shared_rate << " : "
+                         << std::setw(20) << rings_rate;
+    }
+}
+
+_UCT_INSTANTIATE_TEST_CASE(test_uct_mm_rings, mm)